@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_STREAM_BUFFER_H
+#define ASYNC_STREAM_BUFFER_H
+
+#include <streambuf>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ *
+ * \brief A stream buffer handing large blocks of data to a background
+ * writer thread.
+ *
+ * The data written to this stream buffer is copied into blocks of a
+ * fixed size.  When a block is full, it is queued for a writer thread,
+ * shared by all the instances, which writes it to the sink stream
+ * buffer (typically the std::filebuf of a trace file), and the
+ * writing goes on in a free block.  At most a given number of blocks
+ * is allocated per instance: when all of them are queued, the writing
+ * thread waits for the writer to release one, hence the memory used is
+ * bounded.  The blocks of an instance are written to its sink in order,
+ * so that the content of the sink is the same as if the data was
+ * written to it directly.
+ *
+ * Synchronizing the stream (e.g., with std::flush or std::endl) does
+ * not wait for the writer.  The data reaches the sink when Flush is
+ * called, when the instance is destroyed and, unless disabled at
+ * construction, upon Simulator::Destroy.
+ *
+ * Filling and queueing the blocks do not log, so that the log messages
+ * themselves may be written through an instance (see LogSetBufferSize).
+ *
+ * If threads are not supported, the blocks are written to the sink
+ * synchronously, as soon as they are full.
+ */
+class AsyncStreamBuffer : public std::streambuf
+{
+public:
+  /**
+   * Constructor
+   * \param sink the stream buffer the data is written to
+   * \param blockSize the size of the blocks, in bytes
+   * \param maxBlocks the maximum number of blocks
+   * \param flushOnDestroy whether to flush the instance upon Simulator::Destroy
+   */
+  AsyncStreamBuffer (std::streambuf *sink, uint32_t blockSize, uint32_t maxBlocks,
+                     bool flushOnDestroy = true);
+  virtual ~AsyncStreamBuffer ();
+
+  /**
+   * \brief Write all the data to the sink and synchronize it
+   * \return false if writing to the sink failed
+   */
+  bool Flush (void);
+
+  /**
+   * \return true if writing to the sink failed
+   */
+  bool IsFailed (void) const;
+
+  /**
+   * \brief Flush all the instances flushed upon Simulator::Destroy
+   */
+  static void FlushAll (void);
+
+protected:
+  virtual int_type overflow (int_type c);
+  virtual std::streamsize xsputn (const char *s, std::streamsize n);
+  virtual int sync (void);
+
+private:
+  /// Disable copy, the blocks are owned by the instance
+  AsyncStreamBuffer (const AsyncStreamBuffer &);
+  /// Disable assignment, the blocks are owned by the instance
+  AsyncStreamBuffer & operator = (const AsyncStreamBuffer &);
+
+  /**
+   * \brief Queue the current block, if not empty, and continue in a free block
+   */
+  void Submit (void);
+
+  /**
+   * \return a free block, waiting for the writer if all the blocks are queued
+   */
+  char * AcquireBlock (void);
+
+  /**
+   * \brief Write a block to the sink and release it
+   * \param block the block
+   * \param size the number of bytes in the block
+   */
+  void WriteBlock (char *block, uint32_t size);
+
+  /**
+   * \brief The loop of the writer thread
+   */
+  static void Run (void);
+
+  std::streambuf *m_sink;      //!< the sink
+  uint32_t m_blockSize;        //!< the size of the blocks
+  uint32_t m_maxBlocks;        //!< the maximum number of blocks
+  uint32_t m_nBlocks;          //!< the number of blocks allocated
+  std::vector<char *> m_free;  //!< the free blocks
+  uint32_t m_pending;          //!< the number of blocks queued for the writer
+  bool m_failed;               //!< whether writing to the sink failed
+  char *m_block;               //!< the block being filled
+  bool m_flushOnDestroy;       //!< whether to flush upon Simulator::Destroy
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_STREAM_BUFFER_H */
@@ -0,0 +1,169 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EPC_FAST_PATH_H
+#define EPC_FAST_PATH_H
+
+#include <ns3/object.h>
+#include <ns3/ptr.h>
+#include <ns3/nstime.h>
+#include <ns3/data-rate.h>
+#include <ns3/traced-callback.h>
+
+#include <map>
+
+namespace ns3 {
+
+class Packet;
+class EpcEnbApplication;
+class EpcPgwApplication;
+
+/**
+ * \ingroup lte
+ *
+ * \brief Tunnel-less user plane between the eNBs and the PGW.
+ *
+ * When the EPC helper enables the fast path, user plane packets are
+ * handed directly from the EpcEnbApplication to the EpcPgwApplication
+ * (and vice versa) instead of being encapsulated in GTP-U/UDP/IP and
+ * forwarded through the S1-U and S5 sockets of the SGW. Each eNB is
+ * connected to the PGW by its own link, as with the S1-U links of the
+ * EPC helpers, and each direction of a link is modeled as a pipe with
+ * a fixed propagation delay and a serialization rate; packets are
+ * identified by the TEID of their EPS bearer, and per-bearer packet
+ * and byte counters are kept.
+ *
+ * The control plane (S1-AP, S11, S5-C) is not affected.
+ */
+class EpcFastPath : public Object
+{
+public:
+  EpcFastPath ();
+  virtual ~EpcFastPath ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// Per-bearer counters
+  struct BearerStats
+  {
+    BearerStats ();
+    uint64_t ulPackets; ///< number of packets sent in uplink
+    uint64_t ulBytes;   ///< number of bytes sent in uplink
+    uint64_t dlPackets; ///< number of packets sent in downlink
+    uint64_t dlBytes;   ///< number of bytes sent in downlink
+  };
+
+  /**
+   * Set the PGW terminating all the bearers
+   *
+   * \param pgwApp the PGW application
+   */
+  void SetPgw (Ptr<EpcPgwApplication> pgwApp);
+
+  /**
+   * Bind a bearer to the eNB currently serving it. A bearer can be
+   * rebound to a different eNB, e.g., upon a path switch.
+   *
+   * \param teid the TEID of the bearer
+   * \param enbApp the eNB application serving the bearer
+   */
+  void AddBearer (uint32_t teid, Ptr<EpcEnbApplication> enbApp);
+
+  /**
+   * Unbind a bearer, if it is still bound to the given eNB
+   *
+   * \param teid the TEID of the bearer
+   * \param enbApp the eNB application releasing the bearer
+   */
+  void RemoveBearer (uint32_t teid, Ptr<EpcEnbApplication> enbApp);
+
+  /**
+   * Send an uplink packet from an eNB to the PGW
+   *
+   * \param packet the IP packet
+   * \param teid the TEID of the bearer
+   * \param enbApp the eNB application sending the packet
+   */
+  void SendUplink (Ptr<Packet> packet, uint32_t teid, Ptr<EpcEnbApplication> enbApp);
+
+  /**
+   * Send a downlink packet from the PGW to the eNB serving the bearer
+   *
+   * \param packet the IP packet
+   * \param teid the TEID of the bearer
+   */
+  void SendDownlink (Ptr<Packet> packet, uint32_t teid);
+
+  /**
+   * \param teid the TEID of the bearer
+   * \return the counters of the bearer (all zero if unknown)
+   */
+  BearerStats GetBearerStats (uint32_t teid) const;
+
+  /**
+   * TracedCallback signature for packets traversing the fast path.
+   *
+   * \param [in] packet the IP packet
+   * \param [in] teid the TEID of the bearer
+   */
+  typedef void (* PacketTracedCallback)
+    (Ptr<const Packet> packet, uint32_t teid);
+
+protected:
+  // inherited from Object
+  virtual void DoDispose (void);
+
+private:
+  /// State of the link between an eNB and the PGW
+  struct Link
+  {
+    Time ulBusyUntil; ///< time at which the uplink pipe becomes idle
+    Time dlBusyUntil; ///< time at which the downlink pipe becomes idle
+  };
+
+  /**
+   * Compute the time at which a packet entering a pipe now leaves it
+   * at the far end, and update the time at which the pipe becomes idle.
+   *
+   * \param busyUntil the time at which the pipe becomes idle
+   * \param bytes the size of the packet
+   * \return the delay until the packet is delivered
+   */
+  Time Transmit (Time &busyUntil, uint32_t bytes);
+
+  Ptr<EpcPgwApplication> m_pgwApp; ///< the PGW
+  std::map<uint32_t, Ptr<EpcEnbApplication> > m_enbByTeid; ///< serving eNB of each bearer
+  std::map<uint32_t, BearerStats> m_stats; ///< counters of each bearer
+  std::map<Ptr<EpcEnbApplication>, Link> m_links; ///< link of each eNB
+
+  Time m_delay;        ///< one-way delay
+  DataRate m_dataRate; ///< serialization rate of each direction of a link
+
+  /// Trace of the packets sent in uplink
+  TracedCallback<Ptr<const Packet>, uint32_t> m_ulTxTrace;
+  /// Trace of the packets sent in downlink
+  TracedCallback<Ptr<const Packet>, uint32_t> m_dlTxTrace;
+  /// Trace of the downlink packets dropped because the bearer is unknown
+  TracedCallback<Ptr<const Packet>, uint32_t> m_dropTrace;
+};
+
+} // namespace ns3
+
+#endif // EPC_FAST_PATH_H
@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include "ptr.h"
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+class DefaultSimulatorImpl;
+
+/**
+ * \ingroup core
+ * \ingroup debugging
+ *
+ * Attribute the wall clock time spent executing the events to the
+ * functions they call and to the nodes they run on.
+ *
+ * While an EventProfiler is started, the DefaultSimulatorImpl hands
+ * it every event to execute.  The events are counted by bound
+ * function and node context, and for each function and node, the
+ * first event and then one event out of the sampling period is timed:
+ * the time of the events which were not timed is estimated from the
+ * events of the same function and node which were.  Since each
+ * function and node has its own countdown, events of different
+ * functions or nodes that alternate periodically are all timed.
+ *
+ * The function of an event is identified by the type built by
+ * MakeEvent, i.e., the signature of the function or method and,
+ * for methods, the class: the methods of a class with the same
+ * signature are not told apart.  The module of a method is the group
+ * name of the TypeId of its class, if any.
+ *
+ * The profile can be written as a report, or as folded stacks
+ * (module;function;node value), the input of flame graph tools
+ * such as flamegraph.pl or speedscope.
+ *
+ * Example usage:
+ *
+ * \code
+ *     int main (int arg, char ** argv)
+ *     {
+ *       // Create your model
+ *
+ *       EventProfiler profiler;
+ *       Simulator::Run ();
+ *       profiler.WriteReport (std::cout);
+ *       std::ofstream folded ("profile.folded");
+ *       profiler.WriteFolded (folded);
+ *       Simulator::Destroy ();
+ *     }
+ * \endcode
+ *
+ * Only the DefaultSimulatorImpl supports profiling.
+ */
+class EventProfiler
+{
+public:
+  /**
+   * Constructor, starting the profiler.
+   * \param [in] samplingPeriod One event out of samplingPeriod is timed,
+   *            for each function and node.
+   */
+  EventProfiler (uint32_t samplingPeriod = 16);
+  /** Destructor, stopping the profiler. */
+  ~EventProfiler ();
+
+  /**
+   * Set the sampling period.
+   * \param [in] samplingPeriod One event out of samplingPeriod is timed,
+   *            for each function and node.
+   */
+  void SetSamplingPeriod (uint32_t samplingPeriod);
+  /** Profile the events executed by the current simulator implementation. */
+  void Start (void);
+  /** Stop profiling the events, keeping the profile. */
+  void Stop (void);
+  /** Forget the profile. */
+  void Clear (void);
+
+  /**
+   * Execute an event, profiling it.
+   * \param [in] event The event.
+   * \param [in] context The node context of the event.
+   */
+  void Invoke (EventImpl *event, uint32_t context);
+
+  /** The profile of the events of a function on a node. */
+  struct Entry
+  {
+    std::string function; //!< The bound function
+    std::string module;   //!< The module of the function, or "unknown"
+    uint32_t context;     //!< The node context
+    uint64_t events;      //!< The number of events
+    double seconds;       //!< The estimated wall clock time of the events, in seconds
+  };
+
+  /**
+   * Get the profile.
+   * \returns The entries, by decreasing time.
+   */
+  std::vector<Entry> GetEntries (void) const;
+  /**
+   * Get the number of events profiled.
+   * \returns The number of events.
+   */
+  uint64_t GetEventCount (void) const;
+
+  /**
+   * Write the profile as folded stacks, one line per function and node.
+   * \param [in] os The output stream.
+   * \param [in] events Whether to weigh the stacks by number of events
+   *             instead of microseconds.
+   */
+  void WriteFolded (std::ostream &os, bool events = false) const;
+  /**
+   * Write the heaviest functions, modules and nodes.
+   * \param [in] os The output stream.
+   * \param [in] maxLines The maximum number of lines of each table.
+   */
+  void WriteReport (std::ostream &os, uint32_t maxLines = 20) const;
+
+private:
+  /**
+   * Copy constructor, not implemented.
+   * \param [in] other The profiler to copy.
+   */
+  EventProfiler (const EventProfiler &other);
+  /**
+   * Assignment operator, not implemented.
+   * \param [in] other The profiler to copy.
+   * \returns This profiler.
+   */
+  EventProfiler & operator = (const EventProfiler &other);
+
+  /** The identifier of a function on a node. */
+  struct Key
+  {
+    const std::type_info *type; //!< The type of the events
+    uint32_t context;           //!< The node context
+    /**
+     * Equality operator.
+     * \param [in] other The other key.
+     * \returns true if the keys are equal.
+     */
+    bool operator == (const Key &other) const
+    {
+      return type == other.type && context == other.context;
+    }
+  };
+  /** Hash of a Key. */
+  struct KeyHash
+  {
+    /**
+     * Hash a Key.
+     * \param [in] key The key.
+     * \returns The hash.
+     */
+    size_t operator () (const Key &key) const
+    {
+      return reinterpret_cast<size_t> (key.type) * 31 + key.context;
+    }
+  };
+  /** The events of a function on a node. */
+  struct Stats
+  {
+    uint64_t events;      //!< The number of events
+    uint64_t sampled;     //!< The number of events timed
+    int64_t nanoseconds;  //!< The wall clock time of the events timed
+    uint32_t countdown;   //!< The number of events before the next one timed
+  };
+
+  /**
+   * Get the function and the module of a type of event.
+   * \param [in] type The type of the event.
+   * \param [out] function The bound function.
+   * \param [out] module The module of the function.
+   */
+  static void GetFunction (const std::type_info &type, std::string &function, std::string &module);
+
+  /** The statistics, by function and node. */
+  std::unordered_map<Key, Stats, KeyHash> m_stats;
+  Key m_lastKey;                //!< The key of the last event
+  Stats *m_lastStats;           //!< The statistics of the last event
+  uint32_t m_samplingPeriod;    //!< One event out of m_samplingPeriod is timed
+  uint64_t m_events;            //!< The number of events profiled
+  Ptr<DefaultSimulatorImpl> m_impl; //!< The simulator implementation, while started
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 Universita' degli Studi di Napoli Federico II
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Pasquale Imputato <p.imputato@gmail.com>
+ *          Stefano Avallone <stefano.avallone@unina.it>
+ */
+
+#ifndef FQ_CODEL_QUEUE_DISC
+#define FQ_CODEL_QUEUE_DISC
+
+#include "ns3/queue-disc.h"
+#include "ns3/object-factory.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A flow queue used by the FqCoDel queue disc
+ */
+
+class FqCoDelFlow : public QueueDiscClass {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief FqCoDelFlow constructor
+   */
+  FqCoDelFlow ();
+
+  virtual ~FqCoDelFlow ();
+
+  /**
+   * \enum FlowStatus
+   * \brief Used to determine the status of this flow queue
+   */
+  enum FlowStatus
+    {
+      INACTIVE,
+      NEW_FLOW,
+      OLD_FLOW
+    };
+
+  /**
+   * \brief Set the deficit for this flow
+   * \param deficit the deficit for this flow
+   */
+  void SetDeficit (uint32_t deficit);
+  /**
+   * \brief Get the deficit for this flow
+   * \return the deficit for this flow
+   */
+  int32_t GetDeficit (void) const;
+  /**
+   * \brief Increase the deficit for this flow
+   * \param deficit the amount by which the deficit is to be increased
+   */
+  void IncreaseDeficit (int32_t deficit);
+  /**
+   * \brief Set the status for this flow
+   * \param status the status for this flow
+   */
+  void SetStatus (FlowStatus status);
+  /**
+   * \brief Get the status of this flow
+   * \return the status of this flow
+   */
+  FlowStatus GetStatus (void) const;
+
+private:
+  friend class FqCoDelQueueDisc;
+
+  int32_t m_deficit;    //!< the deficit for this flow
+  FlowStatus m_status;  //!< the status of this flow
+  FqCoDelFlow *m_next;  //!< the next flow in the list of new or old flows
+};
+
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A FqCoDel packet queue disc
+ */
+
+class FqCoDelQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief FqCoDelQueueDisc constructor
+   */
+  FqCoDelQueueDisc ();
+
+  virtual ~FqCoDelQueueDisc ();
+
+   /**
+    * \brief Set the quantum value.
+    *
+    * \param quantum The number of bytes each queue gets to dequeue on each round of the scheduling algorithm
+    */
+   void SetQuantum (uint32_t quantum);
+
+   /**
+    * \brief Get the quantum value.
+    *
+    * \returns The number of bytes each queue gets to dequeue on each round of the scheduling algorithm
+    */
+   uint32_t GetQuantum (void) const;
+
+  // Reasons for dropping packets
+  static constexpr const char* UNCLASSIFIED_DROP = "Unclassified drop";  //!< No packet filter able to classify packet
+  static constexpr const char* OVERLIMIT_DROP = "Overlimit drop";        //!< Overlimit dropped packets
+
+protected:
+  /**
+   * \brief Dispose of the object
+   */
+  virtual void DoDispose (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /**
+   * \brief Drop a packet from the head of the queue with the largest current byte count
+   * \return the index of the queue with the largest current byte count
+   */
+  uint32_t FqCoDelDrop (void);
+
+  /**
+   * \brief Compute the index of the flow queue of a flow, sharing the
+   * queues of a set among the flows hashed to it
+   * \param flowHash the hash of the flow
+   * \return the index of the flow queue
+   */
+  uint32_t SetAssociativeHash (uint32_t flowHash);
+
+  /**
+   * \brief A FIFO list of flows, linked through the flows themselves
+   */
+  struct FlowList
+  {
+    FqCoDelFlow *head {nullptr}; //!< the first flow
+    FqCoDelFlow *tail {nullptr}; //!< the last flow
+
+    /**
+     * \return true if the list is empty
+     */
+    bool Empty (void) const { return head == nullptr; }
+    /**
+     * \param flow the flow to append
+     */
+    void PushBack (FqCoDelFlow *flow);
+    /**
+     * \return the first flow, removed from the list
+     */
+    FqCoDelFlow * PopFront (void);
+  };
+
+  std::string m_interval;    //!< CoDel interval attribute
+  std::string m_target;      //!< CoDel target attribute
+  uint32_t m_quantum;        //!< Deficit assigned to flows at each round
+  uint32_t m_flows;          //!< Number of flow queues
+  uint32_t m_dropBatchSize;  //!< Max number of packets dropped from the fat flow
+  uint32_t m_perturbation;   //!< hash perturbation value
+  bool m_enableSetAssociativeHash; //!< whether to enable set associative hash
+  uint32_t m_setWays;        //!< size of a set of queues (used by set associative hash)
+
+  FlowList m_newFlows;    //!< The list of new flows
+  FlowList m_oldFlows;    //!< The list of old flows
+
+  std::vector<FqCoDelFlow *> m_flowsIndices; //!< Flow queue of each flow index, null until created
+  std::vector<uint32_t> m_tags;              //!< Hash of the flow last assigned to each flow index
+  std::vector<FqCoDelFlow *> m_flowQueues;   //!< Flow queues, in the order of the classes
+
+  ObjectFactory m_flowFactory;         //!< Factory to create a new flow
+  ObjectFactory m_queueDiscFactory;    //!< Factory to create a new queue
+};
+
+} // namespace ns3
+
+#endif /* FQ_CODEL_QUEUE_DISC */
@@ -0,0 +1,383 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IP_PREFIX_TRIE_H
+#define IP_PREFIX_TRIE_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/assert.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Path-compressed binary trie for longest prefix match lookups.
+ *
+ * Each node of the trie stores a prefix and the values (e.g., the
+ * routes, possibly several equal-cost ones) associated with that
+ * prefix, in insertion order. Nodes with a single child and no values
+ * are never kept, hence the depth of the trie is bounded by the number
+ * of distinct prefixes along a path rather than by the address length,
+ * and a lookup visits at most one node per matching prefix.
+ *
+ * IPv4 and IPv6 prefixes share the same representation (a 16 byte
+ * array in network byte order, IPv4 addresses filling the first four
+ * bytes), but a trie is expected to hold prefixes of a single address
+ * family.
+ *
+ * \tparam T the type of the values; it must support operator ==
+ */
+template <typename T>
+class IpPrefixTrie
+{
+public:
+  /// The maximum prefix length
+  static const uint32_t MAX_BITS = 128;
+
+  /// The value lists of the prefixes matching an address, longest first
+  typedef const std::vector<T> * MatchArray[MAX_BITS + 1];
+
+  IpPrefixTrie ();
+  ~IpPrefixTrie ();
+
+  /**
+   * \brief Add a value to the list of values of a prefix
+   * \param prefix the prefix, whose bits beyond the prefix length are ignored
+   * \param length the prefix length
+   * \param value the value
+   */
+  void Insert (const uint8_t prefix[16], uint32_t length, const T &value);
+
+  /**
+   * \brief Remove the first occurrence of a value from the list of
+   * values of a prefix
+   * \param prefix the prefix
+   * \param length the prefix length
+   * \param value the value
+   * \return true if the value was found
+   */
+  bool Remove (const uint8_t prefix[16], uint32_t length, const T &value);
+
+  /**
+   * \brief Remove all the prefixes
+   */
+  void Clear (void);
+
+  /**
+   * \return the number of values stored
+   */
+  uint32_t GetNValues (void) const;
+
+  /**
+   * \brief Find the prefixes matching an address
+   * \param addr the address
+   * \param matches the value lists of the matching prefixes, ordered
+   * from the longest to the shortest prefix
+   * \return the number of matching prefixes
+   */
+  uint32_t Lookup (const uint8_t addr[16], MatchArray &matches) const;
+
+  /**
+   * \param addr the IPv4 address
+   * \param buf the 16 byte buffer to fill
+   */
+  static void Serialize (Ipv4Address addr, uint8_t buf[16]);
+
+  /**
+   * \param addr the IPv6 address
+   * \param buf the 16 byte buffer to fill
+   */
+  static void Serialize (Ipv6Address addr, uint8_t buf[16]);
+
+private:
+  /// A node of the trie
+  struct Node
+  {
+    uint8_t prefix[16];   //!< the prefix, with the bits beyond the length cleared
+    uint32_t length;      //!< the prefix length
+    Node *child[2];       //!< the children, by value of the bit following the prefix
+    std::vector<T> values; //!< the values of the prefix (empty for branching nodes)
+  };
+
+  /// Disable copy, the nodes are owned by the trie
+  IpPrefixTrie (const IpPrefixTrie &);
+  /// Disable assignment, the nodes are owned by the trie
+  IpPrefixTrie & operator = (const IpPrefixTrie &);
+
+  /**
+   * \param prefix the prefix
+   * \param length the prefix length
+   * \return a new node without children nor values
+   */
+  static Node * CreateNode (const uint8_t prefix[16], uint32_t length);
+
+  /**
+   * \param node the root of the subtree to delete
+   */
+  static void DeleteSubtree (Node *node);
+
+  /**
+   * \param addr an address
+   * \param bit the bit index, starting from the most significant one
+   * \return the value of the bit
+   */
+  static uint32_t GetBit (const uint8_t addr[16], uint32_t bit);
+
+  /**
+   * \param a the first address
+   * \param b the second address
+   * \param maxLength the maximum number of bits to compare
+   * \return the length of the longest common prefix, up to maxLength
+   */
+  static uint32_t GetCommonLength (const uint8_t a[16], const uint8_t b[16], uint32_t maxLength);
+
+  Node *m_root;     //!< the root of the trie
+  uint32_t m_nValues; //!< the number of values stored
+};
+
+template <typename T>
+IpPrefixTrie<T>::IpPrefixTrie ()
+  : m_root (0),
+    m_nValues (0)
+{
+}
+
+template <typename T>
+IpPrefixTrie<T>::~IpPrefixTrie ()
+{
+  Clear ();
+}
+
+template <typename T>
+void
+IpPrefixTrie<T>::Serialize (Ipv4Address addr, uint8_t buf[16])
+{
+  std::memset (buf, 0, 16);
+  addr.Serialize (buf);
+}
+
+template <typename T>
+void
+IpPrefixTrie<T>::Serialize (Ipv6Address addr, uint8_t buf[16])
+{
+  addr.Serialize (buf);
+}
+
+template <typename T>
+typename IpPrefixTrie<T>::Node *
+IpPrefixTrie<T>::CreateNode (const uint8_t prefix[16], uint32_t length)
+{
+  Node *node = new Node;
+  std::memset (node->prefix, 0, 16);
+  std::memcpy (node->prefix, prefix, length / 8);
+  if (length % 8)
+    {
+      node->prefix[length / 8] = prefix[length / 8] & (0xff00 >> (length % 8));
+    }
+  node->length = length;
+  node->child[0] = 0;
+  node->child[1] = 0;
+  return node;
+}
+
+template <typename T>
+void
+IpPrefixTrie<T>::DeleteSubtree (Node *node)
+{
+  if (node != 0)
+    {
+      DeleteSubtree (node->child[0]);
+      DeleteSubtree (node->child[1]);
+      delete node;
+    }
+}
+
+template <typename T>
+uint32_t
+IpPrefixTrie<T>::GetBit (const uint8_t addr[16], uint32_t bit)
+{
+  return (addr[bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+template <typename T>
+uint32_t
+IpPrefixTrie<T>::GetCommonLength (const uint8_t a[16], const uint8_t b[16], uint32_t maxLength)
+{
+  uint32_t length = 0;
+  for (uint32_t i = 0; i < 16 && length < maxLength; ++i)
+    {
+      uint8_t diff = a[i] ^ b[i];
+      if (diff == 0)
+        {
+          length += 8;
+          continue;
+        }
+      while ((diff & 0x80) == 0)
+        {
+          ++length;
+          diff <<= 1;
+        }
+      break;
+    }
+  return std::min (length, maxLength);
+}
+
+template <typename T>
+void
+IpPrefixTrie<T>::Insert (const uint8_t prefix[16], uint32_t length, const T &value)
+{
+  NS_ASSERT (length <= MAX_BITS);
+  ++m_nValues;
+  Node **link = &m_root;
+  while (true)
+    {
+      Node *node = *link;
+      if (node == 0)
+        {
+          node = CreateNode (prefix, length);
+          node->values.push_back (value);
+          *link = node;
+          return;
+        }
+      uint32_t common = GetCommonLength (node->prefix, prefix, std::min (node->length, length));
+      if (common == node->length && common == length)
+        {
+          node->values.push_back (value);
+          return;
+        }
+      if (common == node->length)
+        {
+          // the node prefix is a prefix of the new one
+          link = &node->child[GetBit (prefix, common)];
+          continue;
+        }
+      Node *parent = CreateNode (prefix, common);
+      parent->child[GetBit (node->prefix, common)] = node;
+      if (common == length)
+        {
+          // the new prefix is a prefix of the node one
+          parent->values.push_back (value);
+        }
+      else
+        {
+          Node *leaf = CreateNode (prefix, length);
+          leaf->values.push_back (value);
+          parent->child[GetBit (prefix, common)] = leaf;
+        }
+      *link = parent;
+      return;
+    }
+}
+
+template <typename T>
+bool
+IpPrefixTrie<T>::Remove (const uint8_t prefix[16], uint32_t length, const T &value)
+{
+  Node **path[MAX_BITS + 2];
+  uint32_t depth = 0;
+  Node **link = &m_root;
+  while (*link != 0)
+    {
+      Node *node = *link;
+      if (node->length > length
+          || GetCommonLength (node->prefix, prefix, node->length) < node->length)
+        {
+          return false;
+        }
+      path[depth++] = link;
+      if (node->length == length)
+        {
+          break;
+        }
+      link = &node->child[GetBit (prefix, node->length)];
+    }
+  if (*link == 0)
+    {
+      return false;
+    }
+
+  Node *node = *link;
+  typename std::vector<T>::iterator it = std::find (node->values.begin (), node->values.end (), value);
+  if (it == node->values.end ())
+    {
+      return false;
+    }
+  node->values.erase (it);
+  --m_nValues;
+
+  // remove the nodes that are neither holding values nor branching
+  while (depth > 0)
+    {
+      link = path[--depth];
+      node = *link;
+      if (!node->values.empty () || (node->child[0] != 0 && node->child[1] != 0))
+        {
+          break;
+        }
+      *link = (node->child[0] != 0) ? node->child[0] : node->child[1];
+      delete node;
+    }
+  return true;
+}
+
+template <typename T>
+void
+IpPrefixTrie<T>::Clear (void)
+{
+  DeleteSubtree (m_root);
+  m_root = 0;
+  m_nValues = 0;
+}
+
+template <typename T>
+uint32_t
+IpPrefixTrie<T>::GetNValues (void) const
+{
+  return m_nValues;
+}
+
+template <typename T>
+uint32_t
+IpPrefixTrie<T>::Lookup (const uint8_t addr[16], MatchArray &matches) const
+{
+  uint32_t n = 0;
+  const Node *node = m_root;
+  while (node != 0 && GetCommonLength (node->prefix, addr, node->length) == node->length)
+    {
+      if (!node->values.empty ())
+        {
+          matches[n++] = &node->values;
+        }
+      if (node->length == MAX_BITS)
+        {
+          break;
+        }
+      node = node->child[GetBit (addr, node->length)];
+    }
+  std::reverse (matches, matches + n);
+  return n;
+}
+
+} // namespace ns3
+
+#endif /* IP_PREFIX_TRIE_H */
@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef IPV4_END_POINT_DEMUX_H
+#define IPV4_END_POINT_DEMUX_H
+
+#include <stdint.h>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include "ns3/ipv4-address.h"
+#include "ipv4-interface.h"
+
+namespace ns3 {
+
+class Ipv4EndPoint;
+
+/**
+ * \ingroup ipv4
+ *
+ * \brief Demultiplexes packets to various transport layer endpoints
+ *
+ * This class serves as a lookup table to match partial or full information
+ * about a four-tuple to an ns3::Ipv4EndPoint.  It internally contains a list
+ * of endpoints, and has APIs to add and find endpoints in this demux.  This
+ * code is shared in common to TCP and UDP protocols in ns3.  This demux
+ * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are indexed by their four-tuple when they have a peer, and
+ * by their local port otherwise, so that a lookup only looks at the few
+ * endpoints that could match the packet, whatever the number of connections
+ * on the node.  The endpoints notify the demux when their addresses, ports
+ * or bound NetDevice change.
+ */
+
+class Ipv4EndPointDemux {
+public:
+  /**
+   * \brief Container of the IPv4 endpoints.
+   */
+  typedef std::list<Ipv4EndPoint *> EndPoints;
+
+  /**
+   * \brief Iterator to the container of the IPv4 endpoints.
+   */
+  typedef std::list<Ipv4EndPoint *>::iterator EndPointsI;
+
+  Ipv4EndPointDemux ();
+  ~Ipv4EndPointDemux ();
+
+  /**
+   * \brief Get the entire list of end points registered.
+   * \return list of Ipv4EndPoint
+   */
+  EndPoints GetAllEndPoints (void);
+
+  /**
+   * \brief Lookup for port local.
+   * \param port port to test
+   * \return true if a port local is in EndPoints, false otherwise
+   */
+  bool LookupPortLocal (uint16_t port);
+
+  /**
+   * \brief Lookup for address and port.
+   * \param boundNetDevice Bound NetDevice (if any)
+   * \param addr address to test
+   * \param port port to test
+   * \return true if there is a match in EndPoints, false otherwise
+   */
+  bool LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port);
+
+  /**
+   * \brief lookup for a match with all the parameters.
+   *
+   * The function will return a list of most-matching EndPoints, in this order:
+   *   -# Full match
+   *   -# All but local address
+   *   -# Only local port and local address match
+   *   -# Only local port match
+   *
+   * EndPoint with disabled Rx are skipped.
+   *
+   * \param daddr destination address to test
+   * \param dport destination port to test
+   * \param saddr source address to test
+   * \param sport source port to test
+   * \param incomingInterface the incoming interface
+   * \return list of IPv4EndPoints (could be 0 element)
+   */
+  EndPoints Lookup (Ipv4Address daddr, 
+                    uint16_t dport, 
+                    Ipv4Address saddr, 
+                    uint16_t sport,
+                    Ptr<Ipv4Interface> incomingInterface);
+
+  /**
+   * \brief simple lookup for a match with all the parameters.
+   * \param daddr destination address to test
+   * \param dport destination port to test
+   * \param saddr source address to test
+   * \param sport source port to test
+   * \return IPv4EndPoint (0 if not found)
+   */
+  Ipv4EndPoint *SimpleLookup (Ipv4Address daddr, 
+                              uint16_t dport, 
+                              Ipv4Address saddr, 
+                              uint16_t sport);
+
+  /**
+   * \brief Allocate a Ipv4EndPoint.
+   * \return an empty Ipv4EndPoint instance
+   */
+  Ipv4EndPoint *Allocate (void);
+
+  /**
+   * \brief Allocate a Ipv4EndPoint.
+   * \param address IPv4 address
+   * \return an Ipv4EndPoint instance
+   */
+  Ipv4EndPoint *Allocate (Ipv4Address address);
+
+  /**
+   * \brief Allocate a Ipv4EndPoint.
+   * \param boundNetDevice Bound NetDevice (if any)
+   * \param port local port
+   * \return an Ipv4EndPoint instance
+   */
+  Ipv4EndPoint *Allocate (Ptr<NetDevice> boundNetDevice, uint16_t port);
+
+  /**
+   * \brief Allocate a Ipv4EndPoint.
+   * \param boundNetDevice Bound NetDevice (if any)
+   * \param address local address
+   * \param port local port
+   * \return an Ipv4EndPoint instance
+   */
+  Ipv4EndPoint *Allocate (Ptr<NetDevice> boundNetDevice, Ipv4Address address, uint16_t port);
+
+  /**
+   * \brief Allocate a Ipv4EndPoint.
+   * \param boundNetDevice Bound NetDevice (if any)
+   * \param localAddress local address
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return an Ipv4EndPoint instance
+   */
+  Ipv4EndPoint *Allocate (Ptr<NetDevice> boundNetDevice,
+                          Ipv4Address localAddress, uint16_t localPort,
+                          Ipv4Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Remove a end point.
+   * \param endPoint the end point to remove
+   */
+  void DeAllocate (Ipv4EndPoint *endPoint);
+
+private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief Key of the endpoints having a peer.
+   */
+  struct ConnectionKey
+  {
+    Ipv4Address localAddress; //!< local address
+    uint16_t localPort;       //!< local port
+    Ipv4Address peerAddress;  //!< peer address
+    uint16_t peerPort;        //!< peer port
+
+    /**
+     * \param other the other key
+     * \return true if the keys are equal
+     */
+    bool operator == (const ConnectionKey &other) const;
+  };
+
+  /**
+   * \brief Hash of a ConnectionKey.
+   */
+  struct ConnectionKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator () (const ConnectionKey &key) const;
+  };
+
+  /**
+   * \brief Key of the endpoints by local address, port and bound NetDevice.
+   */
+  struct LocalKey
+  {
+    Ipv4Address address; //!< local address
+    uint16_t port;       //!< local port
+    NetDevice *device;   //!< bound NetDevice (if any)
+
+    /**
+     * \param other the other key
+     * \return true if the keys are equal
+     */
+    bool operator == (const LocalKey &other) const;
+  };
+
+  /**
+   * \brief Hash of a LocalKey.
+   */
+  struct LocalKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator () (const LocalKey &key) const;
+  };
+
+  /**
+   * \brief Container of the endpoints sharing an index key.
+   */
+  typedef std::vector<Ipv4EndPoint *> EndPointVector;
+
+  /**
+   * \brief Add a newly created endpoint to the list and to the indexes.
+   * \param endPoint the endpoint
+   * \return the endpoint
+   */
+  Ipv4EndPoint *Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Add an endpoint to the indexes.
+   * \param endPoint the endpoint
+   */
+  void AddToIndex (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an endpoint from the indexes.
+   * \param endPoint the endpoint
+   */
+  void RemoveFromIndex (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Allocate an ephemeral port.
+   * \returns the ephemeral port
+   */
+  uint16_t AllocateEphemeralPort (void);
+
+  /**
+   * \brief The ephemeral port.
+   */
+  uint16_t m_ephemeral;
+
+  /**
+   * \brief The last ephemeral port.
+   */
+  uint16_t m_portLast;
+
+  /**
+   * \brief The first ephemeral port.
+   */
+  uint16_t m_portFirst;
+
+  /**
+   * \brief A list of IPv4 end points.
+   */
+  EndPoints m_endPoints;
+
+  /**
+   * \brief Position of each endpoint in the list.
+   */
+  std::unordered_map<Ipv4EndPoint *, EndPointsI> m_positions;
+
+  /**
+   * \brief Endpoints having a peer, by four-tuple.
+   */
+  std::unordered_map<ConnectionKey, EndPointVector, ConnectionKeyHash> m_connections;
+
+  /**
+   * \brief Endpoints without peer, by local port.
+   */
+  std::unordered_map<uint16_t, EndPointVector> m_listeners;
+
+  /**
+   * \brief Number of endpoints by local address, port and bound NetDevice.
+   */
+  std::unordered_map<LocalKey, uint32_t, LocalKeyHash> m_locals;
+
+  /**
+   * \brief Number of endpoints by local port.
+   */
+  std::unordered_map<uint16_t, uint32_t> m_ports;
+};
+
+} // namespace ns3
+
+#endif /* IPV4_END_POINTS_H */
@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_FIVE_TUPLE_PACKET_FILTER_H
+#define IPV4_FIVE_TUPLE_PACKET_FILTER_H
+
+#include "ns3/ipv4-packet-filter.h"
+#include "ns3/tuple-space-classifier.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv4
+ * \ingroup traffic-control
+ *
+ * Ipv4FiveTuplePacketFilter classifies IPv4 packets according to a set
+ * of rules on the source and destination addresses, the source and
+ * destination ports, the protocol and the type of service. The value
+ * of the best matching rule (see TupleSpaceClassifier) is returned as
+ * the classification result.
+ *
+ * The rules are compiled into a TupleSpaceClassifier when they are
+ * added, hence the classification cost does not grow linearly with the
+ * number of rules.
+ */
+class Ipv4FiveTuplePacketFilter: public Ipv4PacketFilter {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  Ipv4FiveTuplePacketFilter ();
+  virtual ~Ipv4FiveTuplePacketFilter ();
+
+  /**
+   * \brief Add a rule. The value of the rule must be a valid class
+   * index, i.e., it cannot exceed the maximum int32_t value.
+   *
+   * \param rule the rule
+   */
+  void AddRule (const TupleSpaceClassifier::Rule &rule);
+
+  /**
+   * \brief Remove all the rules
+   */
+  void ClearRules (void);
+
+  /**
+   * \return the number of rules
+   */
+  uint32_t GetNRules (void) const;
+
+private:
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const;
+
+  TupleSpaceClassifier m_classifier; ///< the compiled rules
+};
+
+} // namespace ns3
+
+#endif /* IPV4_FIVE_TUPLE_PACKET_FILTER_H */
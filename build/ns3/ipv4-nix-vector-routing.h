@@ -0,0 +1,336 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 The Georgia Institute of Technology 
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Josh Pelkey <jpelkey@gatech.edu>
+ */
+
+#ifndef IPV4_NIX_VECTOR_ROUTING_H
+#define IPV4_NIX_VECTOR_ROUTING_H
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ns3/channel.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/nix-vector.h"
+#include "ns3/bridge-net-device.h"
+#include "ns3/nstime.h"
+
+class NixVectorRoutingPathTestCase;
+
+namespace ns3 {
+
+/**
+ * \defgroup nix-vector-routing Nix-Vector Routing
+ *
+ * Nix-vector routing is a simulation specific routing protocol and is
+ * intended for large network topologies.
+ */
+
+/**
+ * \ingroup nix-vector-routing
+ * Map of Ipv4Address to NixVector
+ */
+typedef std::map<Ipv4Address, Ptr<NixVector> > NixMap_t;
+/**
+ * \ingroup nix-vector-routing
+ * Map of Ipv4Address to Ipv4Route
+ */
+typedef std::map<Ipv4Address, Ptr<Ipv4Route> > Ipv4RouteMap_t;
+
+/**
+ * \ingroup nix-vector-routing
+ * Nix-vector routing protocol
+ */
+class Ipv4NixVectorRouting : public Ipv4RoutingProtocol
+{
+  /// allow NixVectorRoutingPathTestCase class friend access
+  friend class ::NixVectorRoutingPathTestCase;
+
+public:
+  Ipv4NixVectorRouting ();
+  ~Ipv4NixVectorRouting ();
+  /**
+   * @brief The Interface ID of the Global Router interface.
+   * @return The Interface ID
+   * @see Object::GetObject ()
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * @brief Set the Node pointer of the node for which this
+   * routing protocol is to be placed
+   *
+   * @param node Node pointer
+   */
+  void SetNode (Ptr<Node> node);
+
+  /**
+   * @brief Called when run-time link topology change occurs
+   * which invalidates the shared topology and the nix vector
+   * caches of all the nodes.  The caches are flushed lazily,
+   * by each node upon its next route lookup.
+   *
+   * \internal
+   * \c const is used here due to need to potentially flush the cache
+   * in const methods such as PrintRoutingTable.  Caches are stored in
+   * mutable variables and flushed in const methods.
+   */
+  void FlushGlobalNixRoutingCache (void) const;
+
+private:
+
+  /**
+   * Flushes the cache which stores nix-vector based on
+   * destination IP
+   */
+  void FlushNixCache (void) const;
+
+  /**
+   * Flushes the cache which stores the Ipv4 route
+   * based on the destination IP
+   */
+  void FlushIpv4RouteCache (void) const;
+
+  /**
+   * Takes in the source node and dest IP and calls GetNodeByIp,
+   * BFS, accounting for any output interface specified, and finally
+   * BuildNixVector to return the built nix-vector
+   *
+   * \param source Source node
+   * \param dest Destination node address
+   * \param oif Preferred output interface
+   * \returns The NixVector to be used in routing.
+   */
+  Ptr<NixVector> GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetDevice> oif);
+
+  /**
+   * Checks the cache based on dest IP for the nix-vector
+   * \param address Address to check
+   * \returns The NixVector to be used in routing.
+   */
+  Ptr<NixVector> GetNixVectorInCache (Ipv4Address address);
+
+  /**
+   * Checks the cache based on dest IP for the Ipv4Route
+   * \param address Address to check
+   * \returns The cached route.
+   */
+  Ptr<Ipv4Route> GetIpv4RouteInCache (Ipv4Address address);
+
+  /**
+   * Given a net-device returns all the adjacent net-devices,
+   * essentially getting the neighbors on that channel
+   * \param [in] netDevice the NetDevice attached to the channel.
+   * \param [in] channel the channel to check
+   * \param [out] netDeviceContainer the NetDeviceContainer of the NetDevices in the channel.
+   */
+  void GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer) const;
+
+  /**
+   * Looks up the node corresponding to the given Ipv4Address
+   * in the shared address map
+   * \param dest destination node IP
+   * \return The node with the specified IP.
+   */
+  Ptr<Node> GetNodeByIp (Ipv4Address dest);
+
+  /**
+   * Walks the parent vector, created by BFS, from the destination
+   * back to the source and actually builds the nixvector
+   * \param [in] parentVector Parent vector for retracing routes
+   * \param [in] source Source Node index
+   * \param [in] dest Destination Node index
+   * \param [out] nixVector the NixVector to be used for routing
+   * \returns true on success, false otherwise.
+   */
+  bool BuildNixVector (const std::vector<uint32_t> & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
+
+  /**
+   * Special variation of BuildNixVector for when a node is sending to itself
+   * \param [out] nixVector the NixVector to be used for routing
+   * \returns true on success, false otherwise.
+   */
+  bool BuildNixVectorLocal (Ptr<NixVector> nixVector);
+
+  /**
+   * Determines from the shared adjacency how many neighbors
+   * the node has
+   * \returns the number of neighbors.
+   */
+  uint32_t FindTotalNeighbors (void);
+
+  /**
+   * Determine if the NetDevice is bridged
+   * \param nd the NetDevice to check
+   * \returns the bridging NetDevice (or null if the NetDevice is not bridged)
+   */
+  Ptr<BridgeNetDevice> NetDeviceIsBridged (Ptr<NetDevice> nd) const;
+
+
+  /**
+   * Nix index is with respect to the neighbors.  The net-device index must be
+   * derived from this
+   * \param [in] nodeIndex Nix Node index
+   * \param [out] gatewayIp IP address of the gateway
+   * \returns the index of the NetDevice in the node.
+   */
+  uint32_t FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv4Address & gatewayIp);
+
+  /**
+   * \brief Breadth first search algorithm over the shared adjacency.
+   *
+   * The search is not stopped when the destination is found, so that
+   * the parent vector holds the whole shortest path tree of the source.
+   *
+   * \param [in] source Source Node index
+   * \param [out] parentVector Parent vector for retracing routes
+   * \param [in] oif specific output interface to use from source node, if not null
+   */
+  void BFS (uint32_t source,
+            std::vector<uint32_t> & parentVector,
+            Ptr<NetDevice> oif);
+
+  /**
+   * Returns the shortest path tree of a source node, running
+   * the BFS only if the tree is not already in the shared cache
+   * \param source Source Node index
+   * \returns the parent vector of the tree.
+   */
+  const std::vector<uint32_t> & GetShortestPathTree (uint32_t source);
+
+  /**
+   * Records the nodes along a path, so that their caches are
+   * flushed if any of them changes.  A path already recorded
+   * between the same nodes is extended rather than duplicated.
+   * \param parentVector Parent vector of the path
+   * \param source Source Node index
+   * \param dest Destination Node index
+   */
+  static void RegisterPath (const std::vector<uint32_t> & parentVector, uint32_t source, uint32_t dest);
+
+  /**
+   * Releases the slots of the recorded paths of a source, whose
+   * caches have just been flushed
+   * \param source Source Node index
+   */
+  static void ReleasePaths (uint32_t source);
+
+  /**
+   * Flushes the caches of the nodes on the recorded paths
+   * going through a node
+   * \param node index of the node that changed
+   */
+  static void InvalidatePathsThrough (uint32_t node);
+
+  /**
+   * Drops the cached shortest path trees that use the links
+   * through a device of a node
+   * \param node index of the node
+   * \param ifIndex index of the device in the node
+   */
+  static void InvalidateTrees (uint32_t node, uint32_t ifIndex);
+
+  /**
+   * Marks the shared topology as changed, so that it is rebuilt
+   * and the caches of all the nodes are flushed upon the next
+   * route lookup
+   */
+  static void InvalidateTopology (void);
+
+  /**
+   * Rebuilds the shared adjacency and address map, if needed
+   */
+  void UpdateTopology (void) const;
+
+  void DoDispose (void);
+
+  /* From Ipv4RoutingProtocol */
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                           UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                           LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+ 
+  /**
+   * Flushes routing caches if required.
+   */
+  void CheckCacheStateAndFlush (void) const;
+
+  /**
+   * \brief Topology-wide state shared by the nix-vector routing
+   * instances of all the nodes.
+   *
+   * The adjacency is stored in compressed sparse row form: the links
+   * (devices attached to a channel) of node n are numbered from
+   * nodeOffset[n] to nodeOffset[n+1]-1, and the neighbors reached
+   * through link l are numbered from neighborOffset[l] to
+   * neighborOffset[l+1]-1, in neighbor index order.
+   */
+  struct NixTopology
+  {
+    NixTopology ();
+
+    uint64_t epoch;                      //!< Incremented whenever all the caches must be flushed
+    bool adjacencyDirty;                 //!< Whether the adjacency must be rebuilt
+    bool addressesDirty;                 //!< Whether the address map must be rebuilt
+    std::vector<uint32_t> nodeOffset;    //!< First link of each node
+    std::vector<uint32_t> linkDevice;    //!< Index of the device of each link in its node
+    std::vector<bool> linkBridge;        //!< Whether the device of each link is a bridge
+    std::vector<uint32_t> neighborOffset; //!< First neighbor of each link
+    std::vector<uint32_t> neighborNode;  //!< Node of each neighbor
+    std::vector<uint32_t> neighborDevice; //!< Index of the device of each neighbor in its node
+    /** Map of the interface addresses to the node index */
+    std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash> nodeByIp;
+    /** Shortest path trees of the sources, computed on demand */
+    std::unordered_map<uint32_t, std::vector<uint32_t> > trees;
+    std::vector<std::vector<uint32_t> > paths;        //!< Nodes of the recorded paths, by path slot
+    std::vector<uint32_t> freePaths;                  //!< Released path slots
+    /** Path slot of each destination, for each source */
+    std::vector<std::unordered_map<uint32_t, uint32_t> > pathsFrom;
+    /** Path slots of the recorded paths going through each node */
+    std::vector<std::unordered_set<uint32_t> > pathsThrough;
+  };
+
+  /** The state shared by all the nodes */
+  static NixTopology g_topology;
+
+  /** Epoch of the shared topology the caches were built for */
+  mutable uint64_t m_epoch;
+
+  /** Cache stores nix-vectors based on destination ip */
+  mutable NixMap_t m_nixCache;
+
+  /** Cache stores Ipv4Routes based on destination ip */
+  mutable Ipv4RouteMap_t m_ipv4RouteCache;
+
+  Ptr<Ipv4> m_ipv4; //!< IPv4 object
+  Ptr<Node> m_node; //!< Node object
+};
+} // namespace ns3
+
+#endif /* IPV4_NIX_VECTOR_ROUTING_H */
@@ -0,0 +1,301 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2007-2009 Strasbourg University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sebastien Vincent <vincent@clarinet.u-strasbg.fr>
+ */
+
+#ifndef IPV6_END_POINT_DEMUX_H
+#define IPV6_END_POINT_DEMUX_H
+
+#include <stdint.h>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include "ns3/ipv6-address.h"
+#include "ipv6-interface.h"
+
+namespace ns3 {
+
+class Ipv6EndPoint;
+
+/**
+ * \ingroup ipv6
+ *
+ * \brief Demultiplexer for end points.
+ *
+ * The endpoints are indexed by their four-tuple when they have a peer, and
+ * by their local port otherwise, so that a lookup only looks at the few
+ * endpoints that could match the packet.  The endpoints notify the demux
+ * when their addresses, ports or bound NetDevice change.
+ */
+class Ipv6EndPointDemux
+{
+public:
+  /**
+   * \brief Container of the IPv6 endpoints.
+   */
+  typedef std::list<Ipv6EndPoint *>EndPoints;
+
+  /**
+   * \brief Iterator to the container of the IPv6 endpoints.
+   */
+  typedef std::list<Ipv6EndPoint *>::iterator EndPointsI;
+
+  Ipv6EndPointDemux ();
+  ~Ipv6EndPointDemux ();
+
+  /**
+   * \brief Lookup for port local.
+   * \param port port to test
+   * \return true if a port local is in EndPoints, false otherwise
+   */
+  bool LookupPortLocal (uint16_t port);
+
+  /**
+   * \brief Lookup for address and port.
+   * \param boundNetDevice Bound NetDevice (if any)
+   * \param addr address to test
+   * \param port port to test
+   * \return true if there is a match in EndPoints, false otherwise
+   */
+  bool LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port);
+
+  /**
+   * \brief lookup for a match with all the parameters.
+   *
+   * The function will return a list of most-matching EndPoints, in this order:
+   *   -# Full match
+   *   -# All but local address
+   *   -# Only local port and local address match
+   *   -# Only local port match
+   *
+   * EndPoint with disabled Rx are skipped.
+   *
+   * \param dst destination address to test
+   * \param dport destination port to test
+   * \param src source address to test
+   * \param sport source port to test
+   * \param incomingInterface the incoming interface
+   * \return list of IPv6EndPoints (could be 0 element)
+   */
+  EndPoints Lookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport, Ptr<Ipv6Interface> incomingInterface);
+
+  /**
+   * \brief Simple lookup for a four-tuple match.
+   * \param dst destination address to test
+   * \param dport destination port to test
+   * \param src source address to test
+   * \param sport source port to test
+   * \return match or 0 if not found
+   */
+  Ipv6EndPoint* SimpleLookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \return an empty Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (void);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param address IPv6 address
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (Ipv6Address address);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param boundNetDevice Bound NetDevice (if any)
+   * \param port local port
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (Ptr<NetDevice> boundNetDevice, uint16_t port);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param boundNetDevice Bound NetDevice (if any)
+   * \param address local address
+   * \param port local port
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (Ptr<NetDevice> boundNetDevice, Ipv6Address address, uint16_t port);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param boundNetDevice Bound NetDevice (if any)
+   * \param localAddress local address
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (Ptr<NetDevice> boundNetDevice,
+                           Ipv6Address localAddress, uint16_t localPort,
+                           Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Remove a end point.
+   * \param endPoint the end point to remove
+   */
+  void DeAllocate (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Get the entire list of end points registered.
+   * \return list of Ipv6EndPoint
+   */
+  EndPoints GetEndPoints () const;
+
+private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief Key of the endpoints having a peer.
+   */
+  struct ConnectionKey
+  {
+    Ipv6Address localAddress; //!< local address
+    uint16_t localPort;       //!< local port
+    Ipv6Address peerAddress;  //!< peer address
+    uint16_t peerPort;        //!< peer port
+
+    /**
+     * \param other the other key
+     * \return true if the keys are equal
+     */
+    bool operator == (const ConnectionKey &other) const;
+  };
+
+  /**
+   * \brief Hash of a ConnectionKey.
+   */
+  struct ConnectionKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator () (const ConnectionKey &key) const;
+  };
+
+  /**
+   * \brief Key of the endpoints by local address, port and bound NetDevice.
+   */
+  struct LocalKey
+  {
+    Ipv6Address address; //!< local address
+    uint16_t port;       //!< local port
+    NetDevice *device;   //!< bound NetDevice (if any)
+
+    /**
+     * \param other the other key
+     * \return true if the keys are equal
+     */
+    bool operator == (const LocalKey &other) const;
+  };
+
+  /**
+   * \brief Hash of a LocalKey.
+   */
+  struct LocalKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator () (const LocalKey &key) const;
+  };
+
+  /**
+   * \brief Container of the endpoints sharing an index key.
+   */
+  typedef std::vector<Ipv6EndPoint *> EndPointVector;
+
+  /**
+   * \brief Add a newly created endpoint to the list and to the indexes.
+   * \param endPoint the endpoint
+   * \return the endpoint
+   */
+  Ipv6EndPoint *Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add an endpoint to the indexes.
+   * \param endPoint the endpoint
+   */
+  void AddToIndex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an endpoint from the indexes.
+   * \param endPoint the endpoint
+   */
+  void RemoveFromIndex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Allocate a ephemeral port.
+   * \return a port
+   */
+  uint16_t AllocateEphemeralPort ();
+
+  /**
+   * \brief The ephemeral port.
+   */
+  uint16_t m_ephemeral;
+
+  /**
+   * \brief The first ephemeral port.
+   */
+  uint16_t m_portFirst;
+
+  /**
+   * \brief The last ephemeral port.
+   */
+  uint16_t m_portLast;
+
+  /**
+   * \brief A list of IPv6 end points.
+   */
+  EndPoints m_endPoints;
+
+  /**
+   * \brief Position of each endpoint in the list.
+   */
+  std::unordered_map<Ipv6EndPoint *, EndPointsI> m_positions;
+
+  /**
+   * \brief Endpoints having a peer, by four-tuple.
+   */
+  std::unordered_map<ConnectionKey, EndPointVector, ConnectionKeyHash> m_connections;
+
+  /**
+   * \brief Endpoints without peer, by local port.
+   */
+  std::unordered_map<uint16_t, EndPointVector> m_listeners;
+
+  /**
+   * \brief Number of endpoints by local address, port and bound NetDevice.
+   */
+  std::unordered_map<LocalKey, uint32_t, LocalKeyHash> m_locals;
+
+  /**
+   * \brief Number of endpoints by local port.
+   */
+  std::unordered_map<uint16_t, uint32_t> m_ports;
+};
+
+} /* namespace ns3 */
+
+#endif /* IPV6_END_POINT_DEMUX_H */
+
@@ -0,0 +1,140 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_LTE
+    
+
+// Module headers:
+#include "a2-a4-rsrq-handover-algorithm.h"
+#include "a3-rsrp-handover-algorithm.h"
+#include "cc-helper.h"
+#include "component-carrier-enb.h"
+#include "component-carrier-ue.h"
+#include "component-carrier.h"
+#include "cqa-ff-mac-scheduler.h"
+#include "emu-epc-helper.h"
+#include "epc-enb-application.h"
+#include "epc-enb-s1-sap.h"
+#include "epc-fast-path.h"
+#include "epc-gtpc-header.h"
+#include "epc-gtpu-header.h"
+#include "epc-helper.h"
+#include "epc-mme-application.h"
+#include "epc-pgw-application.h"
+#include "epc-s11-sap.h"
+#include "epc-s1ap-sap.h"
+#include "epc-sgw-application.h"
+#include "epc-tft-classifier.h"
+#include "epc-tft.h"
+#include "epc-ue-nas.h"
+#include "epc-x2-header.h"
+#include "epc-x2-sap.h"
+#include "epc-x2.h"
+#include "eps-bearer-tag.h"
+#include "eps-bearer.h"
+#include "fdbet-ff-mac-scheduler.h"
+#include "fdmt-ff-mac-scheduler.h"
+#include "fdtbfq-ff-mac-scheduler.h"
+#include "ff-mac-common.h"
+#include "ff-mac-csched-sap.h"
+#include "ff-mac-sched-sap.h"
+#include "ff-mac-scheduler.h"
+#include "lte-amc.h"
+#include "lte-anr-sap.h"
+#include "lte-anr.h"
+#include "lte-as-sap.h"
+#include "lte-asn1-header.h"
+#include "lte-ccm-mac-sap.h"
+#include "lte-ccm-rrc-sap.h"
+#include "lte-chunk-processor.h"
+#include "lte-common.h"
+#include "lte-control-messages.h"
+#include "lte-enb-cmac-sap.h"
+#include "lte-enb-component-carrier-manager.h"
+#include "lte-enb-cphy-sap.h"
+#include "lte-enb-mac.h"
+#include "lte-enb-net-device.h"
+#include "lte-enb-phy-sap.h"
+#include "lte-enb-phy.h"
+#include "lte-enb-rrc.h"
+#include "lte-ffr-algorithm.h"
+#include "lte-ffr-distributed-algorithm.h"
+#include "lte-ffr-enhanced-algorithm.h"
+#include "lte-ffr-rrc-sap.h"
+#include "lte-ffr-sap.h"
+#include "lte-ffr-soft-algorithm.h"
+#include "lte-fr-hard-algorithm.h"
+#include "lte-fr-no-op-algorithm.h"
+#include "lte-fr-soft-algorithm.h"
+#include "lte-fr-strict-algorithm.h"
+#include "lte-gain-map.h"
+#include "lte-global-pathloss-database.h"
+#include "lte-handover-algorithm.h"
+#include "lte-handover-management-sap.h"
+#include "lte-harq-phy.h"
+#include "lte-helper.h"
+#include "lte-hex-grid-enb-topology-helper.h"
+#include "lte-interference.h"
+#include "lte-mac-sap.h"
+#include "lte-mi-error-model.h"
+#include "lte-net-device.h"
+#include "lte-pdcp-header.h"
+#include "lte-pdcp-sap.h"
+#include "lte-pdcp-tag.h"
+#include "lte-pdcp.h"
+#include "lte-phy-tag.h"
+#include "lte-phy.h"
+#include "lte-radio-bearer-info.h"
+#include "lte-radio-bearer-tag.h"
+#include "lte-rlc-am-header.h"
+#include "lte-rlc-am.h"
+#include "lte-rlc-header.h"
+#include "lte-rlc-sap.h"
+#include "lte-rlc-sdu-status-tag.h"
+#include "lte-rlc-sequence-number.h"
+#include "lte-rlc-tag.h"
+#include "lte-rlc-tm.h"
+#include "lte-rlc-um.h"
+#include "lte-rlc.h"
+#include "lte-rrc-header.h"
+#include "lte-rrc-protocol-ideal.h"
+#include "lte-rrc-protocol-real.h"
+#include "lte-rrc-sap.h"
+#include "lte-spectrum-phy.h"
+#include "lte-spectrum-signal-parameters.h"
+#include "lte-spectrum-value-helper.h"
+#include "lte-stats-calculator.h"
+#include "lte-ue-ccm-rrc-sap.h"
+#include "lte-ue-cmac-sap.h"
+#include "lte-ue-component-carrier-manager.h"
+#include "lte-ue-cphy-sap.h"
+#include "lte-ue-mac.h"
+#include "lte-ue-net-device.h"
+#include "lte-ue-phy-sap.h"
+#include "lte-ue-phy.h"
+#include "lte-ue-power-control.h"
+#include "lte-ue-rrc.h"
+#include "lte-vendor-specific-parameters.h"
+#include "mac-stats-calculator.h"
+#include "no-backhaul-epc-helper.h"
+#include "no-op-component-carrier-manager.h"
+#include "no-op-handover-algorithm.h"
+#include "pf-ff-mac-scheduler.h"
+#include "phy-rx-stats-calculator.h"
+#include "phy-stats-calculator.h"
+#include "phy-tx-stats-calculator.h"
+#include "point-to-point-epc-helper.h"
+#include "pss-ff-mac-scheduler.h"
+#include "radio-bearer-stats-calculator.h"
+#include "radio-bearer-stats-connector.h"
+#include "radio-environment-map-helper.h"
+#include "rem-spectrum-phy.h"
+#include "rr-ff-mac-scheduler.h"
+#include "simple-ue-component-carrier-manager.h"
+#include "tdbet-ff-mac-scheduler.h"
+#include "tdmt-ff-mac-scheduler.h"
+#include "tdtbfq-ff-mac-scheduler.h"
+#include "tta-ff-mac-scheduler.h"
+#endif
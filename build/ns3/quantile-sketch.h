@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef NS3_QUANTILE_SKETCH_H
+#define NS3_QUANTILE_SKETCH_H
+
+#include <vector>
+#include <utility>
+#include <stdint.h>
+#include <ostream>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \brief Compact summary of a data distribution, used to estimate its quantiles.
+ *
+ * Unlike the Histogram, whose bins have a fixed width and whose memory
+ * grows with the largest value added, the QuantileSketch groups the data
+ * in log-linear buckets (as the HDR histograms do): each power of two is
+ * split into 2^precision buckets of the same width.  Hence the quantiles
+ * are estimated with a relative error lower than 2^-precision, whatever
+ * the range of the data, and only the buckets which hold data are stored.
+ *
+ * Negative values are counted as zero.
+ */
+class QuantileSketch
+{
+public:
+  /**
+   * \brief Constructor
+   * \param precision log2 of the number of buckets for each power of two (at most 16).
+   */
+  QuantileSketch (uint8_t precision = 5);
+
+  /**
+   * \brief Add a value to the sketch
+   * \param value the value to add
+   */
+  void AddValue (double value);
+
+  /**
+   * \brief Add the data of another sketch with the same precision
+   * \param other the sketch to merge
+   */
+  void Merge (const QuantileSketch &other);
+
+  /**
+   * \brief Remove all the data from the sketch
+   */
+  void Clear (void);
+
+  /**
+   * \brief Returns the number of values added to the sketch
+   * \return the number of values
+   */
+  uint64_t GetCount (void) const;
+  /**
+   * \brief Returns the smallest value added to the sketch
+   * \return the smallest value, or 0 if the sketch is empty
+   */
+  double GetMin (void) const;
+  /**
+   * \brief Returns the largest value added to the sketch
+   * \return the largest value, or 0 if the sketch is empty
+   */
+  double GetMax (void) const;
+  /**
+   * \brief Returns the mean of the values added to the sketch
+   * \return the mean, or 0 if the sketch is empty
+   */
+  double GetMean (void) const;
+  /**
+   * \brief Estimates a quantile of the values added to the sketch
+   * \param quantile the quantile, between 0 and 1 (e.g., 0.99)
+   * \return the estimated quantile, or 0 if the sketch is empty
+   */
+  double GetQuantile (double quantile) const;
+  /**
+   * \brief Returns the number of buckets in use, i.e., the memory used by the sketch
+   * \return the number of buckets in use
+   */
+  uint32_t GetNBuckets (void) const;
+
+  /**
+   * \brief Serializes the main quantiles to an std::ostream in XML format.
+   * \param os the output stream
+   * \param indent number of spaces to use as base indentation level
+   * \param elementName name of the element to serialize.
+   */
+  void SerializeToXmlStream (std::ostream &os, uint16_t indent, std::string elementName) const;
+
+private:
+  /**
+   * \brief Returns the index of the bucket of a positive value
+   * \param value the value
+   * \return the bucket index
+   */
+  int32_t GetIndex (double value) const;
+  /**
+   * \brief Returns the value representing a bucket, i.e., its middle
+   * \param index the bucket index
+   * \return the value representing the bucket
+   */
+  double GetValue (int32_t index) const;
+  /**
+   * \brief Counts values in a bucket
+   * \param index the bucket index
+   * \param count the number of values to count
+   */
+  void AddToBucket (int32_t index, uint64_t count);
+
+  /// Bucket index --> number of values, sorted by index
+  typedef std::vector<std::pair<int32_t, uint64_t> > Buckets;
+
+  Buckets m_buckets;  //!< the non empty buckets
+  uint64_t m_zeros;   //!< the number of values lower or equal to zero
+  uint64_t m_count;   //!< the number of values
+  double m_sum;       //!< the sum of the values
+  double m_min;       //!< the smallest value
+  double m_max;       //!< the largest value
+  uint8_t m_precision; //!< log2 of the number of buckets for each power of two
+};
+
+
+} // namespace ns3
+
+#endif /* NS3_QUANTILE_SKETCH_H */
@@ -0,0 +1,243 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2012 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Nicola Baldo <nbaldo@cttc.es>
+ */
+
+
+#ifndef RADIO_ENVIRONMENT_MAP_HELPER_H
+#define RADIO_ENVIRONMENT_MAP_HELPER_H
+
+
+#include <ns3/object.h>
+#include <ns3/vector.h>
+#include <fstream>
+#include <vector>
+
+
+namespace ns3 {
+
+class RemSpectrumPhy;
+class Node;
+class NetDevice;
+class SpectrumChannel;
+//class BuildingsMobilityModel;
+class MobilityModel;
+class AntennaModel;
+class PropagationLossModel;
+
+/** 
+ * \ingroup lte
+ *
+ * Generates a 2D map of the SINR from the strongest transmitter in the
+ * downlink of an LTE FDD system. For instructions on usage, please refer to
+ * the User Documentation.
+ *
+ * If the `RasterFile` attribute is set, the map is also written as a
+ * binary raster: a 64 byte header (the 8 characters "LTEREM01", the
+ * number of points along x and y as uint32_t, then XMin, XMax, YMin,
+ * YMax and Z as double, zero padded) followed by the linear SINR of
+ * each point as float, in the same order as the text output (x major),
+ * all in host byte order.
+ */
+class RadioEnvironmentMapHelper : public Object
+{
+public:  
+
+  RadioEnvironmentMapHelper ();
+  virtual ~RadioEnvironmentMapHelper ();
+  
+  // inherited from Object
+  virtual void DoDispose (void);
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** 
+   * \return the bandwidth (in num of RBs) over which SINR is calculated
+   */
+  uint8_t GetBandwidth () const;
+
+  /** 
+   *
+   * \param bw  the bandwidth (in num of RBs) over which SINR is calculated
+   */
+  void SetBandwidth (uint8_t bw);
+
+  /** 
+   * Deploy the RemSpectrumPhy objects that generate the map according to the specified settings.
+   * 
+   */
+  void Install ();
+
+private:
+
+  /**
+   * Scheduled by Install() to perform the actual generation of map.
+   *
+   * If control channel is used for SINR calculation (the default), the delay
+   * is 2.6 milliseconds from the start of simulation. Otherwise, if data
+   * channel is used, the delay is 500.1 milliseconds from the start of
+   * simulation.
+   *
+   * The method will divide the whole map into parts (each contains at most a
+   * certain number of SINR listening points), and then call RunOneIteration()
+   * on each part, one by one.
+   */
+  void DelayedInstall ();
+
+  /**
+   * Mobilize all the listeners to a specified area. Afterwards, schedule a
+   * call to PrintAndReset() in 0.5 milliseconds.
+   *
+   * \param xMin X coordinate of the first SINR listening point to deploy.
+   * \param xMax X coordinate of the last SINR listening point to deploy.
+   * \param yMin Y coordinate of the first SINR listening point to deploy.
+   * \param yMax Y coordinate of the last SINR listening point to deploy.
+   */
+  void RunOneIteration (double xMin, double xMax, double yMin, double yMax);
+
+  /// Go through every listener, write the computed SINR, and then reset it.
+  void PrintAndReset ();
+
+  /// Called when the map generation procedure has been completed.
+  void Finalize ();
+
+  /**
+   * Generate the whole map in a single event, computing the SINR of
+   * each point directly from the propagation loss model of the channel
+   * and from the PSD of each eNB, without deploying RemSpectrumPhy
+   * listeners. Used when the `ComputeDirectly` attribute is true.
+   */
+  void ComputeDirectly ();
+
+  /// Create the binary raster file and map it in memory.
+  void OpenRaster ();
+
+  /// Flush and unmap the binary raster file.
+  void CloseRaster ();
+
+  /// An eNB transmitting on the channel, as seen by ComputeDirectly ().
+  struct RemTransmitter
+  {
+    /// Antenna of the eNB, or 0 if isotropic.
+    Ptr<AntennaModel> antenna;
+    /// Position of the eNB.
+    Vector position;
+    /// TX power of each RB, in Watts, over the REM spectrum model.
+    std::vector<double> rbPower;
+    /// TX power over the whole bandwidth, in Watts.
+    double totalPower;
+  };
+
+  /// Objects owned by each worker of ComputeDirectly ().
+  struct RemWorker
+  {
+    /// Back pointer to the helper.
+    RadioEnvironmentMapHelper *helper;
+    /// Index of this worker.
+    uint32_t index;
+    /// Position of the point currently computed.
+    Ptr<MobilityModel> rxMobility;
+    /// Private copy of the position of each transmitter.
+    std::vector<Ptr<MobilityModel> > txMobility;
+    /// Entry point of the worker thread.
+    void Run ();
+  };
+
+  /**
+   * Compute the SINR of the points of the current block assigned to a
+   * worker. Only touches objects owned by the worker, so that
+   * several workers can run in parallel.
+   *
+   * \param worker the worker
+   */
+  void ComputeBlock (RemWorker &worker);
+
+  /// A complete Radio Environment Map is composed of many of this structure.
+  struct RemPoint 
+  {
+    /// Simplified listener which compute SINR over the DL channel.
+    Ptr<RemSpectrumPhy> phy;
+    /// Position of the listener in the environment.
+    Ptr<MobilityModel> bmm;
+  };
+
+  /// List of listeners in the environment.
+  std::list<RemPoint> m_rem;
+
+  double m_xMin;   ///< The `XMin` attribute.
+  double m_xMax;   ///< The `XMax` attribute.
+  uint16_t m_xRes; ///< The `XRes` attribute.
+  double m_xStep;  ///< Distance along X axis between adjacent listening points.
+
+  double m_yMin;   ///< The `YMin` attribute.
+  double m_yMax;   ///< The `YMax` attribute.
+  uint16_t m_yRes; ///< The `YRes` attribute.
+  double m_yStep;  ///< Distance along Y axis between adjacent listening points.
+
+  uint32_t m_maxPointsPerIteration;  ///< The `MaxPointsPerIteration` attribute.
+
+  uint16_t m_earfcn;     ///< The `Earfcn` attribute.
+  uint16_t m_bandwidth;  ///< The `Bandwidth` attribute.
+ 
+  double m_z;  ///< The `Z` attribute.
+
+  std::string m_channelPath;  ///< The `ChannelPath` attribute.
+  std::string m_outputFile;   ///< The `OutputFile` attribute.
+
+  bool m_stopWhenDone;   ///< The `StopWhenDone` attribute.
+  
+  /// The channel object taken from the `ChannelPath` attribute.
+  Ptr<SpectrumChannel> m_channel;
+
+  double m_noisePower;  ///< The `NoisePower` attribute.
+
+  std::ofstream m_outFile;  ///< Stream the output to a file.
+
+  bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
+  int32_t m_rbId;         ///< The `RbId` attribute.
+
+  bool m_computeDirectly;     ///< The `ComputeDirectly` attribute.
+  uint32_t m_numThreads;      ///< The `NumThreads` attribute.
+  std::string m_rasterFile;   ///< The `RasterFile` attribute.
+
+  /// Transmitters found on the channel by ComputeDirectly ().
+  std::vector<RemTransmitter> m_transmitters;
+  /// Propagation loss model of the channel.
+  Ptr<PropagationLossModel> m_propagationLoss;
+  /// Maximum loss (dB) beyond which signals are ignored by the channel.
+  double m_maxLossDb;
+  /// Number of workers used by ComputeDirectly ().
+  uint32_t m_numWorkers;
+  /// Index of the first point of the block being computed.
+  uint64_t m_blockStart;
+  /// SINR of the points of the block being computed.
+  std::vector<double> m_blockSinr;
+
+  int m_rasterFd;                ///< File descriptor of the raster file.
+  uint8_t *m_raster;             ///< Memory mapping of the raster file.
+  uint64_t m_rasterSize;         ///< Size of the raster file, in bytes.
+
+}; // end of `class RadioEnvironmentMapHelper`
+
+
+} // end of `namespace ns3`
+
+#endif /* RADIO_ENVIRONMENT_MAP_HELPER_H */
@@ -0,0 +1,226 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TUPLE_SPACE_CLASSIFIER_H
+#define TUPLE_SPACE_CLASSIFIER_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+
+#include <vector>
+#include <unordered_map>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Multi-field packet classifier based on tuple space search.
+ *
+ * A rule matches a packet if the masked source and destination
+ * addresses, the masked protocol and the masked type of service of the
+ * packet are equal to those of the rule, and if the ports of the packet
+ * are within the port ranges of the rule. Among all the matching rules,
+ * the one with the lowest priority value wins; ties are broken in favor
+ * of the rule added first.
+ *
+ * Rules are grouped into tuples, i.e., sets of rules sharing the same
+ * address, protocol and type of service masks and the same kind of port
+ * ranges (single port or range). Each tuple is a hash table indexed by
+ * the masked header fields, so that a lookup costs one hash probe per
+ * tuple, independently of the number of rules. Tuples are visited in
+ * order of their best priority and the search stops as soon as no
+ * remaining tuple can hold a better rule. Rules are compiled into
+ * tuples when they are added.
+ *
+ * IPv4 addresses are stored in the first four bytes of the address
+ * fields. A classifier is expected to hold rules of a single address
+ * family.
+ */
+class TupleSpaceClassifier
+{
+public:
+  /// Header fields of the packet to classify
+  struct Key
+  {
+    Key ();
+
+    /**
+     * \param addr the IPv4 source address
+     */
+    void SetSource (Ipv4Address addr);
+    /**
+     * \param addr the IPv6 source address
+     */
+    void SetSource (Ipv6Address addr);
+    /**
+     * \param addr the IPv4 destination address
+     */
+    void SetDestination (Ipv4Address addr);
+    /**
+     * \param addr the IPv6 destination address
+     */
+    void SetDestination (Ipv6Address addr);
+
+    /**
+     * \param other the key to compare with
+     * \return true if all the fields are equal
+     */
+    bool operator == (const Key &other) const;
+
+    uint8_t source[16];       ///< source address
+    uint8_t destination[16];  ///< destination address
+    uint16_t sourcePort;      ///< source port
+    uint16_t destinationPort; ///< destination port
+    uint8_t protocol;         ///< protocol number
+    uint8_t tos;              ///< type of service or traffic class
+  };
+
+  /// A classification rule. A default constructed rule matches any packet.
+  struct Rule
+  {
+    Rule ();
+
+    /**
+     * \param addr the IPv4 source address
+     * \param mask the mask applied to the source address
+     */
+    void SetSource (Ipv4Address addr, Ipv4Mask mask);
+    /**
+     * \param addr the IPv6 source address
+     * \param prefix the prefix applied to the source address
+     */
+    void SetSource (Ipv6Address addr, Ipv6Prefix prefix);
+    /**
+     * \param addr the IPv4 destination address
+     * \param mask the mask applied to the destination address
+     */
+    void SetDestination (Ipv4Address addr, Ipv4Mask mask);
+    /**
+     * \param addr the IPv6 destination address
+     * \param prefix the prefix applied to the destination address
+     */
+    void SetDestination (Ipv6Address addr, Ipv6Prefix prefix);
+
+    uint8_t source[16];            ///< source address
+    uint8_t sourceMask[16];        ///< source address mask
+    uint8_t destination[16];       ///< destination address
+    uint8_t destinationMask[16];   ///< destination address mask
+    uint16_t sourcePortStart;      ///< first source port
+    uint16_t sourcePortEnd;        ///< last source port
+    uint16_t destinationPortStart; ///< first destination port
+    uint16_t destinationPortEnd;   ///< last destination port
+    uint8_t protocol;              ///< protocol number
+    uint8_t protocolMask;          ///< protocol number mask
+    uint8_t tos;                   ///< type of service
+    uint8_t tosMask;               ///< type of service mask
+    uint32_t priority;             ///< rules with lower values take precedence
+    uint32_t value;                ///< value associated with the rule
+  };
+
+  TupleSpaceClassifier ();
+
+  /**
+   * \brief Add a rule and compile it into the matching tuple
+   * \param rule the rule
+   */
+  void Add (const Rule &rule);
+
+  /**
+   * \brief Remove all the rules
+   */
+  void Clear (void);
+
+  /**
+   * \return the number of rules
+   */
+  uint32_t GetNRules (void) const;
+
+  /**
+   * \return the number of tuples the rules are grouped into
+   */
+  uint32_t GetNTuples (void) const;
+
+  /**
+   * \brief Find the best rule matching a packet
+   * \param key the header fields of the packet
+   * \return the best matching rule, or 0 if no rule matches
+   */
+  const Rule * Lookup (const Key &key) const;
+
+  /**
+   * \brief Find the best rule matching a packet by checking every rule.
+   *
+   * This is the reference implementation of Lookup, which returns the
+   * same rule.
+   *
+   * \param key the header fields of the packet
+   * \return the best matching rule, or 0 if no rule matches
+   */
+  const Rule * LookupLinear (const Key &key) const;
+
+  /**
+   * \param rule the rule
+   * \param key the header fields of the packet
+   * \return true if the rule matches the packet
+   */
+  static bool Matches (const Rule &rule, const Key &key);
+
+private:
+  /// Hash function of the masked header fields
+  struct KeyHash
+  {
+    /**
+     * \param key the masked header fields
+     * \return the hash value
+     */
+    std::size_t operator () (const Key &key) const;
+  };
+
+  /// A set of rules sharing the same masks
+  struct Tuple
+  {
+    uint8_t sourceMask[16];      ///< source address mask
+    uint8_t destinationMask[16]; ///< destination address mask
+    uint8_t protocolMask;        ///< protocol number mask
+    uint8_t tosMask;             ///< type of service mask
+    bool exactSourcePort;        ///< whether the rules match a single source port
+    bool exactDestinationPort;   ///< whether the rules match a single destination port
+    uint64_t bestRank;           ///< lowest rank of the rules of the tuple
+    /// indices of the rules, sorted by rank, by masked header fields
+    std::unordered_map<Key, std::vector<uint32_t>, KeyHash> buckets;
+  };
+
+  /**
+   * \param index the index of a rule
+   * \return the rank of the rule: lower ranks take precedence
+   */
+  uint64_t GetRank (uint32_t index) const;
+
+  /**
+   * \param tuple the tuple
+   * \param key the header fields of a packet
+   * \return the header fields masked according to the tuple
+   */
+  static Key MaskKey (const Tuple &tuple, const Key &key);
+
+  std::vector<Rule> m_rules;   ///< rules, in insertion order
+  std::vector<Tuple> m_tuples; ///< tuples, sorted by best rank
+};
+
+} // namespace ns3
+
+#endif /* TUPLE_SPACE_CLASSIFIER_H */
@@ -0,0 +1,384 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-stream-buffer.h"
+#include "ns3/core-config.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <set>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsyncStreamBuffer");
+
+namespace {
+
+/// Maximum time a thread waits on a condition before checking it again, in ns
+const uint64_t WAIT_NS = 100000000;
+
+/// A block queued for the writer thread
+struct Job
+{
+  AsyncStreamBuffer *buffer; //!< the owner of the block
+  char *block;               //!< the block
+  uint32_t size;             //!< the number of bytes in the block
+};
+
+/// The state shared by all the instances
+struct Writer
+{
+  Writer ()
+    : destroyScheduled (false)
+#ifdef HAVE_PTHREAD_H
+      , stop (false)
+#endif
+  {
+  }
+
+  std::set<AsyncStreamBuffer *> buffers; //!< the live instances
+  bool destroyScheduled;                 //!< whether FlushAll is scheduled at Simulator::Destroy
+#ifdef HAVE_PTHREAD_H
+  SystemMutex mutex;                     //!< protects the shared state and the block lists
+  SystemCondition work;                  //!< signalled when a job is queued
+  SystemCondition done;                  //!< signalled when a job is completed
+  std::deque<Job> jobs;                  //!< the jobs of the writer thread
+  Ptr<SystemThread> thread;              //!< the writer thread
+  bool stop;                             //!< whether the writer thread must exit
+#endif
+};
+
+/**
+ * \return the state shared by all the instances, which is never
+ * destroyed so as not to depend on the order of static destruction
+ */
+Writer *
+GetWriter (void)
+{
+  static Writer *writer = new Writer ();
+  return writer;
+}
+
+} // anonymous namespace
+
+AsyncStreamBuffer::AsyncStreamBuffer (std::streambuf *sink, uint32_t blockSize, uint32_t maxBlocks,
+                                      bool flushOnDestroy)
+  : m_sink (sink),
+    m_blockSize (blockSize),
+    m_maxBlocks (maxBlocks),
+    m_nBlocks (0),
+    m_pending (0),
+    m_failed (false),
+    m_block (0),
+    m_flushOnDestroy (flushOnDestroy)
+{
+  NS_LOG_FUNCTION (this << sink << blockSize << maxBlocks << flushOnDestroy);
+  NS_ASSERT_MSG (blockSize > 0 && maxBlocks > 0, "At least one non-empty block is needed");
+
+  Writer *writer = GetWriter ();
+  bool scheduleDestroy = false;
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (writer->mutex);
+    if (writer->thread == 0)
+      {
+        writer->stop = false;
+        writer->thread = Create<SystemThread> (MakeCallback (&AsyncStreamBuffer::Run));
+        writer->thread->Start ();
+      }
+#endif
+    writer->buffers.insert (this);
+    scheduleDestroy = flushOnDestroy && !writer->destroyScheduled;
+    writer->destroyScheduled = writer->destroyScheduled || flushOnDestroy;
+  }
+  if (scheduleDestroy)
+    {
+      Simulator::ScheduleDestroy (&AsyncStreamBuffer::FlushAll);
+    }
+
+  m_block = AcquireBlock ();
+  setp (m_block, m_block + m_blockSize);
+}
+
+AsyncStreamBuffer::~AsyncStreamBuffer ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+
+  Writer *writer = GetWriter ();
+  bool last = false;
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (writer->mutex);
+#endif
+    writer->buffers.erase (this);
+    last = writer->buffers.empty ();
+    m_free.push_back (m_block);
+    NS_ASSERT (m_free.size () == m_nBlocks);
+    for (std::vector<char *>::iterator it = m_free.begin (); it != m_free.end (); ++it)
+      {
+        delete [] *it;
+      }
+    m_free.clear ();
+    m_block = 0;
+#ifdef HAVE_PTHREAD_H
+    writer->stop = last;
+#endif
+  }
+
+#ifdef HAVE_PTHREAD_H
+  if (last)
+    {
+      // stop the writer thread along with the last instance
+      writer->work.SetCondition (true);
+      writer->work.Signal ();
+      writer->thread->Join ();
+      writer->thread = 0;
+    }
+#endif
+}
+
+AsyncStreamBuffer::int_type
+AsyncStreamBuffer::overflow (int_type c)
+{
+  Submit ();
+  if (!traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      *pptr () = traits_type::to_char_type (c);
+      pbump (1);
+    }
+  return traits_type::not_eof (c);
+}
+
+std::streamsize
+AsyncStreamBuffer::xsputn (const char *s, std::streamsize n)
+{
+  std::streamsize written = 0;
+  while (written < n)
+    {
+      std::streamsize room = epptr () - pptr ();
+      if (room == 0)
+        {
+          Submit ();
+          room = m_blockSize;
+        }
+      std::streamsize chunk = std::min (room, n - written);
+      std::memcpy (pptr (), s + written, chunk);
+      pbump (static_cast<int> (chunk));
+      written += chunk;
+    }
+  return written;
+}
+
+int
+AsyncStreamBuffer::sync (void)
+{
+  // do not wait for the writer, see Flush
+  return IsFailed () ? -1 : 0;
+}
+
+void
+AsyncStreamBuffer::Submit (void)
+{
+  uint32_t size = static_cast<uint32_t> (pptr () - pbase ());
+  if (size == 0)
+    {
+      return;
+    }
+
+#ifdef HAVE_PTHREAD_H
+  Writer *writer = GetWriter ();
+  {
+    CriticalSection cs (writer->mutex);
+    Job job = {this, m_block, size};
+    writer->jobs.push_back (job);
+    m_pending++;
+  }
+  writer->work.SetCondition (true);
+  writer->work.Signal ();
+#else
+  WriteBlock (m_block, size);
+#endif
+
+  m_block = AcquireBlock ();
+  setp (m_block, m_block + m_blockSize);
+}
+
+char *
+AsyncStreamBuffer::AcquireBlock (void)
+{
+#ifdef HAVE_PTHREAD_H
+  Writer *writer = GetWriter ();
+  while (true)
+    {
+      writer->done.SetCondition (false);
+      {
+        CriticalSection cs (writer->mutex);
+        if (!m_free.empty ())
+          {
+            char *block = m_free.back ();
+            m_free.pop_back ();
+            return block;
+          }
+        if (m_nBlocks < m_maxBlocks)
+          {
+            m_nBlocks++;
+            return new char [m_blockSize];
+          }
+      }
+      // all the blocks are queued, wait for the writer
+      writer->done.TimedWait (WAIT_NS);
+    }
+#else
+  if (!m_free.empty ())
+    {
+      char *block = m_free.back ();
+      m_free.pop_back ();
+      return block;
+    }
+  m_nBlocks++;
+  return new char [m_blockSize];
+#endif
+}
+
+void
+AsyncStreamBuffer::WriteBlock (char *block, uint32_t size)
+{
+  bool ok = m_sink->sputn (block, size) == static_cast<std::streamsize> (size);
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (GetWriter ()->mutex);
+#endif
+    m_failed = m_failed || !ok;
+    m_free.push_back (block);
+  }
+}
+
+bool
+AsyncStreamBuffer::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  Submit ();
+
+#ifdef HAVE_PTHREAD_H
+  Writer *writer = GetWriter ();
+  while (true)
+    {
+      writer->done.SetCondition (false);
+      {
+        CriticalSection cs (writer->mutex);
+        if (m_pending == 0)
+          {
+            break;
+          }
+      }
+      writer->done.TimedWait (WAIT_NS);
+    }
+#endif
+
+  // the writer is done with the sink
+  bool ok = m_sink->pubsync () == 0;
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (writer->mutex);
+#endif
+    m_failed = m_failed || !ok;
+    return !m_failed;
+  }
+}
+
+bool
+AsyncStreamBuffer::IsFailed (void) const
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (GetWriter ()->mutex);
+#endif
+  return m_failed;
+}
+
+void
+AsyncStreamBuffer::FlushAll (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Writer *writer = GetWriter ();
+  std::set<AsyncStreamBuffer *> buffers;
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (writer->mutex);
+#endif
+    buffers = writer->buffers;
+    writer->destroyScheduled = false;
+  }
+  for (std::set<AsyncStreamBuffer *>::iterator it = buffers.begin (); it != buffers.end (); ++it)
+    {
+      if ((*it)->m_flushOnDestroy)
+        {
+          (*it)->Flush ();
+        }
+    }
+}
+
+void
+AsyncStreamBuffer::Run (void)
+{
+#ifdef HAVE_PTHREAD_H
+  Writer *writer = GetWriter ();
+  while (true)
+    {
+      writer->work.SetCondition (false);
+      Job job;
+      bool haveJob = false;
+      {
+        CriticalSection cs (writer->mutex);
+        if (!writer->jobs.empty ())
+          {
+            job = writer->jobs.front ();
+            writer->jobs.pop_front ();
+            haveJob = true;
+          }
+        else if (writer->stop)
+          {
+            return;
+          }
+      }
+      if (!haveJob)
+        {
+          writer->work.TimedWait (WAIT_NS);
+          continue;
+        }
+
+      job.buffer->WriteBlock (job.block, job.size);
+      {
+        CriticalSection cs (writer->mutex);
+        job.buffer->m_pending--;
+      }
+      writer->done.SetCondition (true);
+      writer->done.Broadcast ();
+    }
+#endif
+}
+
+} // namespace ns3
@@ -26,6 +26,7 @@
 #include "pointer.h"
 #include "log.h"
 
+#include <map>
 #include <sstream>
 
 /**
@@ -150,6 +151,9 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, into a list of index ranges,
+ * so that matching an index does not involve any string operation.
  */
 class ArrayMatcher
 {
@@ -168,6 +172,12 @@ public:
    */
   bool Matches (std::size_t i) const;
 private:
+  /**
+   * Parse a Config path specification into index ranges.
+   *
+   * \param [in] element The Config path specification.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -178,75 +188,78 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** Whether every index matches. */
+  bool m_all;
+  /** The inclusive ranges of matching indexes. */
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 
 };  // class ArrayMatcher
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (std::size_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      m_all = true;
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      Parse (element.substr (0, tmp-0));
+      Parse (element.substr (tmp+1, element.size () - (tmp + 1)));
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
-      if (StringToUint32 (lowerBound, &min) && 
-          StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
+      if (StringToUint32 (lowerBound, &min) &&
+          StringToUint32 (upperBound, &max))
         {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+      NS_LOG_DEBUG ("Array "<<i<<" matches *");
       return true;
     }
+  for (std::size_t j = 0; j < m_ranges.size (); j++)
+    {
+      if (i >= m_ranges[j].first && i <= m_ranges[j].second)
+        {
+          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+          return true;
+        }
+    }
   NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
   return false;
 }
@@ -261,9 +274,116 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * \ingroup config-impl
+ * A pointer or container attribute through which a Config path
+ * element leads to other objects.
+ */
+struct PathAttribute
+{
+  std::string name;                       //!< The attribute name.
+  bool isContainer;                       //!< Whether the attribute is an ObjectPtrContainer.
+  bool isGettable;                        //!< Whether the accessor can get the attribute.
+  Ptr<const AttributeAccessor> accessor;  //!< The accessor of the attribute.
+};
+
+/** The attributes matched by a Config path element in a TypeId. */
+typedef std::vector<PathAttribute> PathAttributes;
+
+/**
+ * \ingroup config-impl
+ * Find the pointer and container attributes of a TypeId, and of its
+ * parents, matching a Config path element.
+ *
+ * The attributes of a TypeId do not change once it is registered, so
+ * the result is computed once for each TypeId and path element.
+ *
+ * \param [in] tid The TypeId of the object.
+ * \param [in] item The Config path element, an attribute name or "*".
+ * \returns The matching attributes, in the order of the TypeId hierarchy.
+ */
+static const PathAttributes &
+LookupPathAttributes (TypeId tid, const std::string &item)
+{
+  NS_LOG_FUNCTION (tid << item);
+  typedef std::map<std::pair<uint16_t, std::string>, PathAttributes> Cache;
+  static Cache cache;
+
+  std::pair<Cache::iterator, bool> result =
+    cache.insert (std::make_pair (std::make_pair (tid.GetUid (), item), PathAttributes ()));
+  PathAttributes &attributes = result.first->second;
+  if (!result.second)
+    {
+      return attributes;
+    }
+
+  TypeId level;
+  TypeId nextTid = tid;
+  do
+    {
+      level = nextTid;
+      for (uint32_t i = 0; i < level.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = level.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          PathAttribute attribute;
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = false;
+            }
+          else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = true;
+            }
+          else
+            {
+              // this could be anything else and we don't know what to do with it.
+              // So, we just ignore it.
+              continue;
+            }
+          // the value is read as ObjectBase::GetAttribute would, which
+          // finds the attribute from the most derived TypeId.
+          struct TypeId::AttributeInformation found;
+          tid.LookupAttributeByName (info.name, &found);
+          attribute.name = info.name;
+          attribute.isGettable = (found.flags & TypeId::ATTR_GET) && found.accessor->HasGetter ();
+          attribute.accessor = found.accessor;
+          attributes.push_back (attribute);
+        }
+      nextTid = level.GetParent ();
+    } while (nextTid != level);
+  return attributes;
+}
+
+/**
+ * \ingroup config-impl
+ * Get the value of a pointer or container attribute of an object.
+ *
+ * \param [in] object The object.
+ * \param [in] attribute The attribute.
+ * \param [out] value The value of the attribute.
+ */
+static void
+GetPathAttribute (Ptr<Object> object, const PathAttribute &attribute, AttributeValue &value)
+{
+  if (!attribute.isGettable || !attribute.accessor->Get (PeekPointer (object), value))
+    {
+      // report the error as ObjectBase::GetAttribute does
+      object->GetAttribute (attribute.name, value);
+    }
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The path is split once into its elements, with the TypeIds of the
+ * GetObject elements and the indexes of the array elements already
+ * parsed, so that walking the object graph only compares integers
+ * in the common cases.
  */
 class Resolver
 {
@@ -285,25 +405,67 @@ public:
    *                  in the Config path.
    */
   void Resolve (Ptr<Object> root);
-  
+  /**
+   * Parse the stored Config path into an object reference,
+   * beginning at an object already matched by a leading Config path.
+   *
+   * \param [in] root The object matched by the leading Config path.
+   * \param [in] context The matched leading Config path, ending
+   *                     with a '/'.
+   */
+  void Resolve (Ptr<Object> root, std::string context);
+  /**
+   * Check if the objects matching the longer Config paths are all found
+   * from the objects matching this Config path.
+   *
+   * This is not the case when the path ended on an object container,
+   * whose objects are only reached through a further index element,
+   * or on the "/Names" namespace, which is not an object.
+   *
+   * \returns \c true if the longer Config paths may be resolved from
+   *          the matched objects.
+   */
+  bool IsExtensible (void) const;
+
 private:
+  /** A Config path element. */
+  struct Element
+  {
+    std::string item;      //!< The path element.
+    bool isNames;          //!< Whether the element may enter the "/Names" namespace.
+    bool isGetObject;      //!< Whether the element is a "$TypeId" GetObject call.
+    bool isTidFound;       //!< Whether the TypeId of a GetObject call is registered.
+    TypeId tid;            //!< The TypeId of a GetObject call.
+    ArrayMatcher matcher;  //!< The element as an array index.
+    uint16_t lastUid;      //!< The TypeId uid of the last attribute lookup.
+    const PathAttributes *lastAttributes;  //!< The last attribute lookup.
+
+    /**
+     * Construct from a path element.
+     * \param [in] element The path element.
+     */
+    Element (std::string element);
+  };
+
   /** Ensure the Config path starts and ends with a '/'. */
   void Canonicalize (void);
+  /** Split the Config path into its elements. */
+  void Compile (void);
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] index The index of the next element of the Config path.
    * \param [in] root The object corresponding to the current position
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t index, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
+   * \param [in] index The index of the next element of the Config path.
    * \param [in,out] vector The resulting list of matching objects.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::size_t index, const ObjectPtrContainerValue &vector);
   /**
    * Handle one object found on the path.
    *
@@ -328,14 +490,38 @@ private:
   std::vector<std::string> m_workStack;
   /** The Config path. */
   std::string m_path;
+  /** The elements of the Config path. */
+  std::vector<Element> m_elements;
+  /** The Config path leading to the root object. */
+  std::string m_context;
+  /** Whether the longer Config paths may be resolved from the matches. */
+  bool m_extensible;
 
 };  // class Resolver
 
+Resolver::Element::Element (std::string element)
+  : item (element),
+    isNames (element.compare (0, 5, "Names") == 0),
+    isGetObject (element.find ("$") == 0),
+    isTidFound (false),
+    matcher (element),
+    lastUid (0),
+    lastAttributes (0)
+{
+  if (isGetObject)
+    {
+      isTidFound = TypeId::LookupByNameFailSafe (element.substr (1, element.size () - 1), &tid);
+    }
+}
+
 Resolver::Resolver (std::string path)
-  : m_path (path)
+  : m_path (path),
+    m_context ("/"),
+    m_extensible (true)
 {
   NS_LOG_FUNCTION (this << path);
   Canonicalize ();
+  Compile ();
 }
 Resolver::~Resolver ()
 {
@@ -361,12 +547,43 @@ Resolver::Canonicalize (void)
     }
 }
 
-void 
+void
+Resolver::Compile (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::string::size_type cur = 0;
+  std::string::size_type next = m_path.find ("/", 1);
+  while (next != std::string::npos)
+    {
+      m_elements.push_back (Element (m_path.substr (cur + 1, next - (cur + 1))));
+      cur = next;
+      next = m_path.find ("/", cur + 1);
+    }
+}
+
+void
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  Resolve (root, "/");
+}
+
+void
+Resolver::Resolve (Ptr<Object> root, std::string context)
+{
+  NS_LOG_FUNCTION (this << root << context);
+
+  m_context = context;
+  DoResolve (0, root);
+}
+
+bool
+Resolver::IsExtensible (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_extensible;
 }
 
 std::string
@@ -374,7 +591,7 @@ Resolver::GetResolvedPath (void) const
 {
   NS_LOG_FUNCTION (this);
 
-  std::string fullPath = "/";
+  std::string fullPath = m_context;
   for (std::vector<std::string>::const_iterator i = m_workStack.begin (); i != m_workStack.end (); i++)
     {
       fullPath += *i + "/";
@@ -382,7 +599,7 @@ Resolver::GetResolvedPath (void) const
   return fullPath;
 }
 
-void 
+void
 Resolver::DoResolveOne (Ptr<Object> object)
 {
   NS_LOG_FUNCTION (this << object);
@@ -392,45 +609,46 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (std::size_t index, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << index << root);
 
-  if (next == std::string::npos)
+  if (index == m_elements.size ())
     {
       //
-      // If root is zero, we're beginning to see if we can use the object name 
-      // service to resolve this path.  It is impossible to have a object name 
+      // If root is zero, we're beginning to see if we can use the object name
+      // service to resolve this path.  It is impossible to have a object name
       // associated with the root of the object name service since that root
       // is not an object.  This path must be referring to something in another
       // namespace and it will have been found already since the name service
       // is always consulted last.
-      // 
+      //
       if (root)
         {
           DoResolveOne (root);
         }
+      else
+        {
+          m_extensible = false;
+        }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  Element &element = m_elements[index];
+  const std::string &item = element.item;
 
   //
-  // If root is zero, we're beginning to see if we can use the object name 
-  // service to resolve this path.  In this case, we must see the name space 
-  // "/Names" on the front of this path.  There is no object associated with 
-  // the root of the "/Names" namespace, so we just ignore it and move on to 
+  // If root is zero, we're beginning to see if we can use the object name
+  // service to resolve this path.  In this case, we must see the name space
+  // "/Names" on the front of this path.  There is no object associated with
+  // the root of the "/Names" namespace, so we just ignore it and move on to
   // the next segment.
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (element.isNames)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (index + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -447,7 +665,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (index + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -463,83 +681,66 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (element.isGetObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
-      Ptr<Object> object = root->GetObject<Object> (tid);
+      NS_LOG_DEBUG ("GetObject="<<item.substr (1)<<" on path="<<GetResolvedPath ());
+      if (!element.isTidFound)
+        {
+          // report the unknown TypeId
+          TypeId::LookupByName (item.substr (1, item.size () - 1));
+        }
+      Ptr<Object> object = root->GetObject<Object> (element.tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject ("<<item.substr (1)<<") failed on path="<<GetResolvedPath ());
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (index + 1, object);
       m_workStack.pop_back ();
     }
-  else 
+  else
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
-      bool foundMatch = false;
-      
-      do
+      uint16_t uid = root->GetInstanceTypeId ().GetUid ();
+      if (element.lastAttributes == 0 || element.lastUid != uid)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          element.lastAttributes = &LookupPathAttributes (root->GetInstanceTypeId (), item);
+          element.lastUid = uid;
+        }
+      const PathAttributes &attributes = *element.lastAttributes;
+      for (PathAttributes::const_iterator i = attributes.begin (); i != attributes.end (); i++)
+        {
+          if (!i->isContainer)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)="<<i->name<<" on path="<<GetResolvedPath ());
+              PointerValue pValue;
+              GetPathAttribute (root, *i, pValue);
+              Ptr<Object> object = pValue.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\""<<item<<
+                                "\" exists on path=\""<<GetResolvedPath ()<<"\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer(info.checker));
-              if (pChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              m_workStack.push_back (i->name);
+              DoResolve (index + 1, object);
+              m_workStack.pop_back ();
             }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<i->name<<" on path="<<GetResolvedPath ());
+              ObjectPtrContainerValue vector;
+              GetPathAttribute (root, *i, vector);
+              m_workStack.push_back (i->name);
+              DoArrayResolve (index + 1, vector);
+              m_workStack.pop_back ();
+            }
+        }
 
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
-      
-      if (!foundMatch)
+      if (attributes.empty ())
         {
           NS_LOG_DEBUG ("Requested item="<<item<<" does not exist on path="<<GetResolvedPath ());
           return;
@@ -547,21 +748,17 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     }
 }
 
-void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+void
+Resolver::DoArrayResolve (std::size_t index, const ObjectPtrContainerValue &container)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION(this << index << &container);
+  if (index == m_elements.size ())
     {
+      m_extensible = false;
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  const ArrayMatcher &matcher = m_elements[index].matcher;
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
@@ -570,12 +767,36 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (index + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
 }
 
+/**
+ * \ingroup config-impl
+ * Resolver collecting the matched objects and their contexts.
+ */
+class LookupMatchesResolver : public Resolver
+{
+public:
+  /**
+   * Construct from a Config path.
+   *
+   * \param [in] path The Config path.
+   */
+  LookupMatchesResolver (std::string path)
+    : Resolver (path)
+  {}
+  virtual void DoOne (Ptr<Object> object, std::string path)
+  {
+    m_objects.push_back (object);
+    m_contexts.push_back (path);
+  }
+  std::vector<Ptr<Object> > m_objects;  //!< The matched objects.
+  std::vector<std::string> m_contexts;  //!< The contexts of the matched objects.
+};
+
 /**
  * \ingroup config-impl
  * Config system implementation class.
@@ -595,6 +816,26 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc Config::LookupMatches() */
   MatchContainer LookupMatches (std::string path);
+  /**
+   * Lookup the objects matching a Config path.
+   *
+   * \param [in] path The Config path.
+   * \param [out] extensible Whether the objects matching the longer
+   *   paths are those found from the returned matches.
+   * \returns The matches.
+   */
+  MatchContainer LookupMatches (std::string path, bool *extensible);
+  /**
+   * Lookup the objects matching a Config path, starting from the
+   * objects matching its leading part.
+   *
+   * \param [in] from The matches of the leading part of the Config path.
+   * \param [in] path The trailing part of the Config path.
+   * \param [out] extensible Whether the objects matching the longer
+   *   paths are those found from the returned matches.
+   * \returns The matches.
+   */
+  MatchContainer LookupMatches (const MatchContainer &from, std::string path, bool *extensible);
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -717,20 +958,15 @@ MatchContainer
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
-  class LookupMatchesResolver : public Resolver 
-  {
-  public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
-    {}
-    virtual void DoOne (Ptr<Object> object, std::string path)
-    {
-      m_objects.push_back (object);
-      m_contexts.push_back (path);
-    }
-    std::vector<Ptr<Object> > m_objects;
-    std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  bool extensible;
+  return LookupMatches (path, &extensible);
+}
+
+MatchContainer
+ConfigImpl::LookupMatches (std::string path, bool *extensible)
+{
+  NS_LOG_FUNCTION (this << path << extensible);
+  LookupMatchesResolver resolver = LookupMatchesResolver (path);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -743,9 +979,24 @@ ConfigImpl::LookupMatches (std::string path)
   //
   resolver.Resolve (0);
 
+  *extensible = resolver.IsExtensible ();
   return MatchContainer (resolver.m_objects, resolver.m_contexts, path);
 }
 
+MatchContainer
+ConfigImpl::LookupMatches (const MatchContainer &from, std::string path, bool *extensible)
+{
+  NS_LOG_FUNCTION (this << &from << path << extensible);
+  LookupMatchesResolver resolver = LookupMatchesResolver (path);
+  for (std::size_t i = 0; i < from.GetN (); i++)
+    {
+      resolver.Resolve (from.Get (i), from.GetMatchedPath (i));
+    }
+
+  *extensible = resolver.IsExtensible ();
+  return MatchContainer (resolver.m_objects, resolver.m_contexts, from.GetPath () + path);
+}
+
 void 
 ConfigImpl::RegisterRootNamespaceObject (Ptr<Object> obj)
 {
@@ -782,6 +1033,137 @@ ConfigImpl::GetRootNamespaceObject (std::size_t i) const
 }
 
 
+void
+Batch::ParsePath (std::string path, std::string *root, std::string *leaf) const
+{
+  NS_LOG_FUNCTION (this << path << root << leaf);
+
+  std::string::size_type slash = path.find_last_of ("/");
+  NS_ASSERT (slash != std::string::npos);
+  *root = path.substr (0, slash);
+  *leaf = path.substr (slash+1, path.size ()-(slash+1));
+}
+
+void
+Batch::Set (std::string path, const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (this << path << &value);
+
+  std::string root, leaf;
+  ParsePath (path, &root, &leaf);
+  MatchContainer container = LookupMatches (root);
+  container.Set (leaf, value);
+}
+void
+Batch::Connect (std::string path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path << &cb);
+
+  std::string root, leaf;
+  ParsePath (path, &root, &leaf);
+  MatchContainer container = LookupMatches (root);
+  if (container.GetN () == 0)
+    {
+      NS_LOG_WARN ("Failed to connect " << leaf << ", no object matches " << root);
+    }
+  container.Connect (leaf, cb);
+}
+void
+Batch::ConnectWithoutContext (std::string path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path << &cb);
+
+  std::string root, leaf;
+  ParsePath (path, &root, &leaf);
+  MatchContainer container = LookupMatches (root);
+  if (container.GetN () == 0)
+    {
+      NS_LOG_WARN ("Failed to connect " << leaf << ", no object matches " << root);
+    }
+  container.ConnectWithoutContext (leaf, cb);
+}
+void
+Batch::Disconnect (std::string path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path << &cb);
+
+  std::string root, leaf;
+  ParsePath (path, &root, &leaf);
+  MatchContainer container = LookupMatches (root);
+  if (container.GetN () == 0)
+    {
+      NS_LOG_WARN ("Failed to disconnect " << leaf << ", no object matches " << root);
+    }
+  container.Disconnect (leaf, cb);
+}
+void
+Batch::DisconnectWithoutContext (std::string path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path << &cb);
+
+  std::string root, leaf;
+  ParsePath (path, &root, &leaf);
+  MatchContainer container = LookupMatches (root);
+  if (container.GetN () == 0)
+    {
+      NS_LOG_WARN ("Failed to disconnect " << leaf << ", no object matches " << root);
+    }
+  container.DisconnectWithoutContext (leaf, cb);
+}
+
+MatchContainer
+Batch::LookupMatches (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+
+  // the paths are remembered with a leading slash and without a trailing one
+  if (path.find ("/") != 0)
+    {
+      path = "/" + path;
+    }
+  if (path[path.size () - 1] == '/')
+    {
+      path.erase (path.size () - 1);
+    }
+
+  std::map<std::string, Matches>::const_iterator i = m_matches.find (path);
+  if (i != m_matches.end ())
+    {
+      return i->second.container;
+    }
+
+  // start from the objects matching the longest known leading path
+  Matches matches;
+  bool found = false;
+  std::string::size_type slash = path.size ();
+  while (!found && slash > 0)
+    {
+      slash = path.rfind ("/", slash - 1);
+      i = m_matches.find (path.substr (0, slash));
+      if (i != m_matches.end () && i->second.extensible)
+        {
+          NS_LOG_DEBUG ("Resolve " << path.substr (slash) << " from " << i->first);
+          matches.container = ConfigImpl::Get ()->LookupMatches (i->second.container, path.substr (slash),
+                                                                 &matches.extensible);
+          found = true;
+        }
+    }
+  if (!found)
+    {
+      matches.container = ConfigImpl::Get ()->LookupMatches (path, &matches.extensible);
+    }
+  m_matches[path] = matches;
+  return matches.container;
+}
+
+void
+Batch::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_matches.clear ();
+}
+
+
 void Reset (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -21,6 +21,7 @@
 #define CONFIG_H
 
 #include "ptr.h"
+#include <map>
 #include <string>
 #include <vector>
 
@@ -258,6 +259,94 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+/**
+ * \ingroup config
+ * \brief perform many configuration operations, matching each path
+ * against the object graph as little as possible.
+ *
+ * The objects matching the leading part of each path, up to the
+ * final attribute or trace source name, are remembered by the Batch.
+ * Another operation on the same objects reuses them, and an operation
+ * on a longer path only matches its trailing part, starting from the
+ * objects already found.  For example, connecting to the trace sources
+ * of the Phy and of the Mac of the WifiNetDevices walks the NodeList
+ * and the DeviceLists once:
+ *
+ * \code
+ *   Config::Batch batch;
+ *   batch.Connect ("/NodeList/[0-99]/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyTxBegin", MakeCallback (&PhyTx));
+ *   batch.Connect ("/NodeList/[0-99]/DeviceList/0/$ns3::WifiNetDevice/Mac/MacTx", MakeCallback (&MacTx));
+ * \endcode
+ *
+ * The matches are not updated when objects are added to or removed
+ * from the object graph: a Batch is meant to configure a topology once
+ * it is built, and should be cleared or discarded if it changes.
+ */
+class Batch
+{
+public:
+  /**
+   * \param [in] path A path to match attributes.
+   * \param [in] value The value to set in all matching attributes.
+   * \sa ns3::Config::Set
+   */
+  void Set (std::string path, const AttributeValue &value);
+  /**
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to connect to the matching trace sources.
+   * \sa ns3::Config::Connect
+   */
+  void Connect (std::string path, const CallbackBase &cb);
+  /**
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to connect to the matching trace sources.
+   * \sa ns3::Config::ConnectWithoutContext
+   */
+  void ConnectWithoutContext (std::string path, const CallbackBase &cb);
+  /**
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to disconnect from the matching trace sources.
+   * \sa ns3::Config::Disconnect
+   */
+  void Disconnect (std::string path, const CallbackBase &cb);
+  /**
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to disconnect from the matching trace sources.
+   * \sa ns3::Config::DisconnectWithoutContext
+   */
+  void DisconnectWithoutContext (std::string path, const CallbackBase &cb);
+  /**
+   * \param [in] path The path to perform a match against
+   * \returns A container which contains all the objects which match the input
+   *          path.
+   * \sa ns3::Config::LookupMatches
+   */
+  MatchContainer LookupMatches (std::string path);
+  /**
+   * Forget the objects matched so far.
+   */
+  void Clear (void);
+
+private:
+  /**
+   * Break a Config path into the leading path and the last leaf token.
+   * \param [in] path The Config path.
+   * \param [in,out] root The leading part of the \p path,
+   *   up to the final slash.
+   * \param [in,out] leaf The trailing part of the \p path.
+   */
+  void ParsePath (std::string path, std::string *root, std::string *leaf) const;
+
+  /** The objects matching a path. */
+  struct Matches
+  {
+    MatchContainer container;  //!< The matching objects.
+    bool extensible;           //!< Whether longer paths may start from them.
+  };
+  /** The objects matching each path, without its final slash. */
+  std::map<std::string, Matches> m_matches;
+};
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
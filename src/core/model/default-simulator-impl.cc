@@ -22,6 +22,7 @@
 #include "default-simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 
 #include "ptr.h"
 #include "pointer.h"
@@ -74,6 +75,7 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_eventCount = 0;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
+  m_profiler = 0;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
@@ -128,6 +130,13 @@ DefaultSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
   m_events = scheduler;
 }
 
+void
+DefaultSimulatorImpl::SetEventProfiler (EventProfiler *profiler)
+{
+  NS_LOG_FUNCTION (this << profiler);
+  m_profiler = profiler;
+}
+
 // System ID for non-distributed simulation is always zero
 uint32_t 
 DefaultSimulatorImpl::GetSystemId (void) const
@@ -148,7 +157,14 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_profiler == 0)
+    {
+      next.impl->Invoke ();
+    }
+  else
+    {
+      m_profiler->Invoke (next.impl, m_currentContext);
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -39,6 +39,8 @@
 
 namespace ns3 {
 
+class EventProfiler;
+
 /**
  * \ingroup simulator
  *
@@ -79,6 +81,12 @@ public:
   virtual uint32_t GetContext (void) const;
   virtual uint64_t GetEventCount (void) const;
 
+  /**
+   * Hand the events to a profiler, which executes them.
+   * \param [in] profiler The profiler, or 0 to execute the events directly.
+   */
+  void SetEventProfiler (EventProfiler *profiler);
+
 private:
   virtual void DoDispose (void);
 
@@ -135,6 +143,8 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+  /** The profiler executing the events, if any. */
+  EventProfiler *m_profiler;
 };
 
 } // namespace ns3
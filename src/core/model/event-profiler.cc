@@ -0,0 +1,419 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "default-simulator-impl.h"
+#include "simulator.h"
+#include "event-impl.h"
+#include "type-id.h"
+#include "log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility>
+
+#if (__GNUC__ >= 3)
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+namespace {
+
+/**
+ * Demangle a type name, if supported by the compiler.
+ * \param [in] mangled The mangled name.
+ * \returns The demangled name, or the mangled name if it cannot be demangled.
+ */
+std::string
+Demangle (const char *mangled)
+{
+  std::string ret = mangled;
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, NULL, NULL, &status);
+  if (status == 0 && demangled)
+    {
+      ret = demangled;
+    }
+  std::free (demangled);
+#endif
+  return ret;
+}
+
+/**
+ * Find the end of a bracketed expression.
+ * \param [in] s The string.
+ * \param [in] pos The position of the opening bracket.
+ * \returns The position after the closing bracket, or npos.
+ */
+std::string::size_type
+SkipBrackets (const std::string &s, std::string::size_type pos)
+{
+  int depth = 0;
+  for (; pos < s.size (); pos++)
+    {
+      if (s[pos] == '<' || s[pos] == '(')
+        {
+          depth++;
+        }
+      else if ((s[pos] == '>' || s[pos] == ')') && --depth == 0)
+        {
+          return pos + 1;
+        }
+    }
+  return std::string::npos;
+}
+
+/**
+ * \param [in] context A node context.
+ * \returns The name of the context in the outputs.
+ */
+std::string
+ContextName (uint32_t context)
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return "no node";
+    }
+  std::ostringstream oss;
+  oss << "node " << context;
+  return oss.str ();
+}
+
+/** The events and the time of a function, module or node. */
+typedef std::pair<uint64_t, double> Total;
+
+/**
+ * Write the heaviest lines of a table.
+ * \param [in] os The output stream.
+ * \param [in] title The title of the table.
+ * \param [in] totals The events and the time, by name.
+ * \param [in] seconds The time of all the events.
+ * \param [in] maxLines The maximum number of lines.
+ */
+void
+WriteTable (std::ostream &os, std::string title, const std::map<std::string, Total> &totals,
+            double seconds, uint32_t maxLines)
+{
+  std::vector<std::pair<double, std::string> > order;
+  for (std::map<std::string, Total>::const_iterator i = totals.begin (); i != totals.end (); ++i)
+    {
+      order.push_back (std::make_pair (-i->second.second, i->first));
+    }
+  std::sort (order.begin (), order.end ());
+
+  os << title << std::endl
+     << std::setw (12) << "seconds" << std::setw (8) << "%"
+     << std::setw (14) << "events" << std::setw (12) << "ns/event" << "  name" << std::endl;
+  for (uint32_t i = 0; i < order.size () && i < maxLines; i++)
+    {
+      const Total &total = totals.find (order[i].second)->second;
+      os << std::fixed << std::setprecision (6)
+         << std::setw (12) << total.second
+         << std::setw (8) << std::setprecision (1) << (seconds > 0 ? 100 * total.second / seconds : 0)
+         << std::setw (14) << total.first
+         << std::setw (12) << std::setprecision (0) << (total.first ? 1e9 * total.second / total.first : 0)
+         << "  " << order[i].second << std::endl;
+    }
+  os.unsetf (std::ios::floatfield);
+}
+
+} // anonymous namespace
+
+
+EventProfiler::EventProfiler (uint32_t samplingPeriod)
+  : m_lastStats (0),
+    m_samplingPeriod (1),
+    m_events (0)
+{
+  NS_LOG_FUNCTION (this << samplingPeriod);
+  m_lastKey.type = 0;
+  m_lastKey.context = 0;
+  SetSamplingPeriod (samplingPeriod);
+  Start ();
+}
+
+EventProfiler::~EventProfiler ()
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+}
+
+void
+EventProfiler::SetSamplingPeriod (uint32_t samplingPeriod)
+{
+  NS_LOG_FUNCTION (this << samplingPeriod);
+  NS_ASSERT_MSG (samplingPeriod > 0, "The sampling period must be positive");
+  m_samplingPeriod = samplingPeriod;
+  for (std::unordered_map<Key, Stats, KeyHash>::iterator i = m_stats.begin (); i != m_stats.end (); ++i)
+    {
+      i->second.countdown = std::min (i->second.countdown, samplingPeriod - 1);
+    }
+}
+
+void
+EventProfiler::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+  m_impl = DynamicCast<DefaultSimulatorImpl> (Simulator::GetImplementation ());
+  if (m_impl == 0)
+    {
+      NS_FATAL_ERROR ("The EventProfiler requires the DefaultSimulatorImpl");
+    }
+  m_impl->SetEventProfiler (this);
+}
+
+void
+EventProfiler::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_impl != 0)
+    {
+      m_impl->SetEventProfiler (0);
+      m_impl = 0;
+    }
+}
+
+void
+EventProfiler::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stats.clear ();
+  m_lastKey.type = 0;
+  m_lastStats = 0;
+  m_events = 0;
+}
+
+void
+EventProfiler::Invoke (EventImpl *event, uint32_t context)
+{
+  Key key;
+  key.type = &typeid (*event);
+  key.context = context;
+  if (m_lastStats == 0 || !(key == m_lastKey))
+    {
+      // the first event of a new key is timed: its countdown is 0
+      Stats &stats = m_stats[key];
+      m_lastKey = key;
+      m_lastStats = &stats;
+    }
+  Stats *stats = m_lastStats;
+  stats->events++;
+  m_events++;
+
+  if (stats->countdown > 0)
+    {
+      stats->countdown--;
+      event->Invoke ();
+      return;
+    }
+  stats->countdown = m_samplingPeriod - 1;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  event->Invoke ();
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now ();
+  if (m_lastStats != stats)
+    {
+      // cleared by the event
+      return;
+    }
+  stats->sampled++;
+  stats->nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds> (end - start).count ();
+}
+
+void
+EventProfiler::GetFunction (const std::type_info &type, std::string &function, std::string &module)
+{
+  // e.g., ns3::MakeEvent<void (ns3::Foo::*)(int), ns3::Foo*, int>
+  //         (void (ns3::Foo::*)(int), ns3::Foo*, int)::EventMemberImpl1
+  std::string name = Demangle (type.name ());
+  function = name;
+  module = "unknown";
+
+  std::string::size_type pos = name.find ("MakeEvent");
+  if (pos == std::string::npos)
+    {
+      return;
+    }
+  pos += 9;
+  if (pos < name.size () && name[pos] == '<')
+    {
+      pos = SkipBrackets (name, pos);
+    }
+  if (pos >= name.size () || name[pos] != '(')
+    {
+      return;
+    }
+  // the first parameter of MakeEvent is the bound function
+  std::string::size_type begin = pos + 1;
+  int depth = 0;
+  for (pos = begin; pos < name.size (); pos++)
+    {
+      char c = name[pos];
+      if (c == '<' || c == '(')
+        {
+          depth++;
+        }
+      else if (c == '>' || c == ')')
+        {
+          if (depth-- == 0)
+            {
+              break;
+            }
+        }
+      else if (c == ',' && depth == 0)
+        {
+          break;
+        }
+    }
+  if (pos >= name.size ())
+    {
+      return;
+    }
+  function = name.substr (begin, pos - begin);
+
+  // the class of a method, e.g., void (ns3::Foo::*)(int)
+  std::string::size_type member = function.find ("::*)");
+  std::string::size_type open = function.find ('(');
+  if (member != std::string::npos && open != std::string::npos && open < member)
+    {
+      std::string className = function.substr (open + 1, member - open - 1);
+      TypeId tid;
+      if (TypeId::LookupByNameFailSafe (className, &tid) && !tid.GetGroupName ().empty ())
+        {
+          module = tid.GetGroupName ();
+        }
+    }
+}
+
+std::vector<EventProfiler::Entry>
+EventProfiler::GetEntries (void) const
+{
+  NS_LOG_FUNCTION (this);
+  // the same type may have several type_info, hence the entries are merged by name
+  std::map<const std::type_info *, std::pair<std::string, std::string> > names;
+  std::map<std::pair<std::string, uint32_t>, Entry> entries;
+  for (std::unordered_map<Key, Stats, KeyHash>::const_iterator i = m_stats.begin (); i != m_stats.end (); ++i)
+    {
+      std::pair<std::string, std::string> &name = names[i->first.type];
+      if (name.first.empty ())
+        {
+          GetFunction (*i->first.type, name.first, name.second);
+        }
+      Entry &entry = entries[std::make_pair (name.first, i->first.context)];
+      if (entry.function.empty ())
+        {
+          entry.function = name.first;
+          entry.module = name.second;
+          entry.context = i->first.context;
+          entry.events = 0;
+          entry.seconds = 0;
+        }
+      entry.events += i->second.events;
+      if (i->second.sampled > 0)
+        {
+          entry.seconds += 1e-9 * i->second.nanoseconds * i->second.events / i->second.sampled;
+        }
+    }
+
+  std::vector<std::pair<double, Entry> > order;
+  for (std::map<std::pair<std::string, uint32_t>, Entry>::const_iterator i = entries.begin (); i != entries.end (); ++i)
+    {
+      order.push_back (std::make_pair (-i->second.seconds, i->second));
+    }
+  std::stable_sort (order.begin (), order.end (),
+                    [] (const std::pair<double, Entry> &a, const std::pair<double, Entry> &b)
+                    {
+                      return a.first < b.first;
+                    });
+  std::vector<Entry> result;
+  for (uint32_t i = 0; i < order.size (); i++)
+    {
+      result.push_back (order[i].second);
+    }
+  return result;
+}
+
+uint64_t
+EventProfiler::GetEventCount (void) const
+{
+  return m_events;
+}
+
+void
+EventProfiler::WriteFolded (std::ostream &os, bool events) const
+{
+  NS_LOG_FUNCTION (this << events);
+  std::vector<Entry> entries = GetEntries ();
+  for (uint32_t i = 0; i < entries.size (); i++)
+    {
+      uint64_t value = events ? entries[i].events : static_cast<uint64_t> (1e6 * entries[i].seconds + 0.5);
+      if (value == 0)
+        {
+          continue;
+        }
+      // the frames are separated by semicolons
+      std::string function = entries[i].function;
+      std::replace (function.begin (), function.end (), ';', ',');
+      os << entries[i].module << ";" << function << ";" << ContextName (entries[i].context)
+         << " " << value << "\n";
+    }
+}
+
+void
+EventProfiler::WriteReport (std::ostream &os, uint32_t maxLines) const
+{
+  NS_LOG_FUNCTION (this << maxLines);
+  std::vector<Entry> entries = GetEntries ();
+  std::map<std::string, Total> functions;
+  std::map<std::string, Total> modules;
+  std::map<std::string, Total> nodes;
+  double seconds = 0;
+  for (uint32_t i = 0; i < entries.size (); i++)
+    {
+      const Entry &entry = entries[i];
+      Total *totals[] = { &functions[entry.module + " " + entry.function],
+                          &modules[entry.module],
+                          &nodes[ContextName (entry.context)] };
+      for (uint32_t j = 0; j < 3; j++)
+        {
+          totals[j]->first += entry.events;
+          totals[j]->second += entry.seconds;
+        }
+      seconds += entry.seconds;
+    }
+
+  os << "Event profile: " << m_events << " events, " << seconds << " s"
+     << " (one event out of " << m_samplingPeriod << " timed)" << std::endl;
+  WriteTable (os, "By function:", functions, seconds, maxLines);
+  WriteTable (os, "By module:", modules, seconds, maxLines);
+  WriteTable (os, "By node:", nodes, seconds, maxLines);
+}
+
+} // namespace ns3
@@ -149,6 +149,7 @@ void
 FlushStreams (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  LogFlush ();
   std::list<std::ostream*> **pl = PeekStreamList ();
   if (*pl == 0)
     {
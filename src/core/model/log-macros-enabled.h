@@ -29,6 +29,20 @@
 
 #ifdef NS3_LOG_ENABLE
 
+/**
+ * \ingroup logging
+ * Tell the compiler that a log message is unlikely to be enabled, so
+ * that the code printing it is moved out of the way of the hot path.
+ * \internal
+ * Logging implementation macro; should not be called directly.
+ *
+ * \param [in] cond The condition enabling the message.
+ */
+#if defined (__GNUC__)
+#define NS_LOG_UNLIKELY(cond) __builtin_expect (!!(cond), 0)
+#else
+#define NS_LOG_UNLIKELY(cond) (cond)
+#endif
 
 /**
  * \ingroup logging
@@ -153,7 +167,7 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (level))                              \
+      if (NS_LOG_UNLIKELY (g_log.IsEnabled (level)))            \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -177,7 +191,7 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (NS_LOG_UNLIKELY (g_log.IsEnabled (ns3::LOG_FUNCTION))) \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -214,7 +228,7 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (NS_LOG_UNLIKELY (g_log.IsEnabled (ns3::LOG_FUNCTION))) \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -24,16 +24,15 @@
 #include <iostream>
 #include "assert.h"
 #include <stdexcept>
+#include <cstdlib>
 #include "ns3/core-config.h"
 #include "fatal-error.h"
+#include "async-stream-buffer.h"
 
 #ifdef HAVE_GETENV
 #include <cstring>
 #endif
 
-#ifdef HAVE_STDLIB_H
-#include <cstdlib>
-#endif
 
 /**
  * \file
@@ -286,19 +285,6 @@ LogComponent::EnvVarCheck (void)
 }
 
 
-bool 
-LogComponent::IsEnabled (const enum LogLevel level) const
-{
-  //  LogComponentEnableEnvVar ();
-  return (level & m_levels) ? 1 : 0;
-}
-
-bool
-LogComponent::IsNoneEnabled (void) const
-{
-  return m_levels == 0;
-}
-
 void
 LogComponent::SetMask (const enum LogLevel level)
 {
@@ -649,6 +635,61 @@ NodePrinter LogGetNodePrinter (void)
   return g_logNodePrinter;
 }
 
+/**
+ * \ingroup logging
+ * The buffer of the log messages, if any.
+ */
+static AsyncStreamBuffer *g_logBuffer = 0;
+/**
+ * \ingroup logging
+ * The stream buffer of \c std::clog replaced by g_logBuffer.
+ */
+static std::streambuf *g_logSink = 0;
+
+/**
+ * \ingroup logging
+ * Write the buffered log messages and stop buffering, at exit.
+ */
+static void
+LogStopBuffering (void)
+{
+  LogSetBufferSize (0);
+}
+
+void
+LogSetBufferSize (uint32_t blockSize, uint32_t maxBlocks)
+{
+  static bool atExitRegistered = false;
+  if (g_logBuffer != 0)
+    {
+      std::clog.rdbuf (g_logSink);
+      delete g_logBuffer;
+      g_logBuffer = 0;
+      g_logSink = 0;
+    }
+  if (blockSize > 0)
+    {
+      g_logSink = std::clog.rdbuf ();
+      // the buffer must outlive the simulator, it is flushed at exit
+      g_logBuffer = new AsyncStreamBuffer (g_logSink, blockSize, maxBlocks, false);
+      std::clog.rdbuf (g_logBuffer);
+      if (!atExitRegistered)
+        {
+          std::atexit (&LogStopBuffering);
+          atExitRegistered = true;
+        }
+    }
+}
+
+void
+LogFlush (void)
+{
+  if (g_logBuffer != 0)
+    {
+      g_logBuffer->Flush ();
+    }
+}
+
 
 ParameterLogger::ParameterLogger (std::ostream &os)
   : m_first (true),
@@ -202,7 +202,7 @@ void LogComponentDisableAll (enum LogLevel level);
  * \param [in] name The log component name.
  */
 #define NS_LOG_COMPONENT_DEFINE(name)                           \
-  static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__)
+  static ns3::StaticLogComponent<NS_LOG_COMPILED (name)> g_log (name, __FILE__)
 
 /**
  * Define a logging component with a mask.
@@ -213,7 +213,27 @@ void LogComponentDisableAll (enum LogLevel level);
  * \param [in] mask The default mask.
  */
 #define NS_LOG_COMPONENT_DEFINE_MASK(name, mask)                \
-  static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__, mask)
+  static ns3::StaticLogComponent<NS_LOG_COMPILED (name)> g_log (name, __FILE__, mask)
+
+/**
+ * Check whether the messages of a log component are compiled in.
+ *
+ * When ns-3 is configured with \c --log-components=Component1,Component2
+ * only the messages of the listed components are compiled in: the
+ * logging macros of the other components, which can not be enabled,
+ * reduce to a constant false condition removed by the compiler.
+ * Without this option, the messages of all the components are compiled
+ * in (in builds with logging).
+ *
+ * \param [in] name The log component name, as a string literal.
+ * \returns \c true if the messages of the component are compiled in.
+ */
+#ifdef NS3_LOG_COMPONENTS
+#define NS_LOG_COMPILED(name)                                   \
+  ns3::LogListContains (NS3_LOG_COMPONENTS, name)
+#else
+#define NS_LOG_COMPILED(name) true
+#endif
 
 /**
  * Declare a reference to a Log component.
@@ -291,6 +311,28 @@ void LogComponentDisableAll (enum LogLevel level);
 
 namespace ns3 {
 
+/**
+ * Write the log messages through blocks handed to a background writer
+ * thread (see AsyncStreamBuffer), rather than directly to \c std::clog.
+ *
+ * The messages are then written to the stream buffer \c std::clog had
+ * when this function was called.  They reach it, in order, when a block
+ * is full, upon LogFlush(), when the buffering is disabled, on fatal
+ * errors and when the program exits.  Messages written to other streams,
+ * such as \c std::cerr, may hence appear earlier than the log messages
+ * preceding them.
+ *
+ * \param [in] blockSize The size of the blocks, in bytes, or 0 to write
+ *                       the messages directly again.
+ * \param [in] maxBlocks The maximum number of blocks.
+ */
+void LogSetBufferSize (uint32_t blockSize, uint32_t maxBlocks = 4);
+
+/**
+ * Write the buffered log messages, if any, and wait for them to be written.
+ */
+void LogFlush (void);
+
 /**
  * Print the list of logging messages available.
  * Same as running your program with the NS_LOG environment
@@ -434,6 +476,98 @@ private:
 
 };  // class LogComponent
 
+inline bool
+LogComponent::IsEnabled (const enum LogLevel level) const
+{
+  return (level & m_levels) != 0;
+}
+
+inline bool
+LogComponent::IsNoneEnabled (void) const
+{
+  return m_levels == 0;
+}
+
+/**
+ * A log component defined by NS_LOG_COMPONENT_DEFINE.
+ *
+ * The messages of the component are compiled in, or not, as given by
+ * NS_LOG_COMPILED.  When they are not, no log level can be enabled and
+ * the checks of the logging macros are constant.
+ *
+ * \tparam compiled Whether the messages of the component are compiled in.
+ */
+template <bool compiled>
+class StaticLogComponent : public LogComponent
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] name The user-visible name for this component.
+   * \param [in] file The source code file which defined this LogComponent.
+   * \param [in] mask LogLevels blocked for this LogComponent.
+   */
+  StaticLogComponent (const std::string & name,
+                      const std::string & file,
+                      const enum LogLevel mask = LOG_NONE)
+    : LogComponent (name, file,
+                    compiled ? mask : static_cast<LogLevel> (LOG_LEVEL_ALL | LOG_PREFIX_ALL))
+  {
+  }
+  /**
+   * Check if this LogComponent is enabled for \c level
+   *
+   * \param [in] level The level to check for.
+   * \return \c true if we are enabled at \c level.
+   */
+  bool IsEnabled (const enum LogLevel level) const
+  {
+    return compiled && LogComponent::IsEnabled (level);
+  }
+};
+
+/**
+ * Check whether a list of log component names starts with a name.
+ *
+ * \param [in] list The comma-separated list of names.
+ * \param [in] name The name.
+ * \returns \c true if the first name of the list is \p name.
+ */
+constexpr bool
+LogListStartsWith (const char *list, const char *name)
+{
+  return *name == '\0'
+         ? (*list == ',' || *list == '\0')
+         : (*list == *name && LogListStartsWith (list + 1, name + 1));
+}
+
+/**
+ * Skip the first name of a list of log component names.
+ *
+ * \param [in] list The comma-separated list of names.
+ * \returns The list of the next names.
+ */
+constexpr const char *
+LogListNext (const char *list)
+{
+  return *list == '\0' ? list : (*list == ',' ? list + 1 : LogListNext (list + 1));
+}
+
+/**
+ * Check whether a list of log component names contains a name.
+ *
+ * \param [in] list The comma-separated list of names.
+ * \param [in] name The name.
+ * \returns \c true if \p name is in the list.
+ */
+constexpr bool
+LogListContains (const char *list, const char *name)
+{
+  return *list != '\0'
+         && (LogListStartsWith (list, name) || LogListContains (LogListNext (list), name));
+}
+
 /**
  * Get the LogComponent registered with the given name.
  *
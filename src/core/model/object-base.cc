@@ -79,90 +79,112 @@ ObjectBase::NotifyConstructionCompleted (void)
 void
 ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
 {
-  // loop over the inheritance tree back to the Object base class.
+  // loop over the attributes of the inheritance tree, flattened by TypeId.
   NS_LOG_FUNCTION (this << &attributes);
   TypeId tid = GetInstanceTypeId ();
-  do {
-      // loop over all attributes in object type
-      NS_LOG_DEBUG ("construct tid="<<tid.GetName ()<<", params="<<tid.GetAttributeN ());
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+  // keep the list alive, should it be rebuilt while constructing.
+  Ptr<const TypeId::FlatAttributeList> list = tid.GetFlatAttributeList ();
+  bool hasAttributes = attributes.Begin () != attributes.End ();
+  char *envVar = 0;
+#ifdef HAVE_GETENV
+  envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+#endif /* HAVE_GETENV */
+  NS_LOG_DEBUG ("construct tid="<<tid.GetName ()<<", params="<<list->attributes.size ());
+  for (std::vector<struct TypeId::FlatAttributeInformation>::const_iterator i = list->attributes.begin ();
+       i != list->attributes.end (); ++i)
+    {
+      const struct TypeId::AttributeInformation &info = i->info;
+      NS_LOG_DEBUG ("try to construct \""<< i->fullName <<"\"");
+      if (!hasAttributes && envVar == 0)
         {
-          struct TypeId::AttributeInformation info = tid.GetAttribute(i);
-          NS_LOG_DEBUG ("try to construct \""<< tid.GetName ()<<"::"<<
-                        info.name <<"\"");
-          // is this attribute stored in this AttributeConstructionList instance ?
-          Ptr<AttributeValue> value = attributes.Find(info.checker);
-          // See if this attribute should not be set here in the
-          // constructor.
+          // Fast path: only the initial values are used.
           if (!(info.flags & TypeId::ATTR_CONSTRUCT))
             {
-              // Handle this attribute if it should not be 
-              // set here.
-              if (value == 0)
-                {
-                  // Skip this attribute if it's not in the
-                  // AttributeConstructionList.
-                  continue;
-                }              
-              else
-                {
-                  // This is an error because this attribute is not
-                  // settable in its constructor but is present in
-                  // the AttributeConstructionList.
-                  NS_FATAL_ERROR ("Attribute name="<<info.name<<" tid="<<tid.GetName () << ": initial value cannot be set using attributes");
-                }
+              continue;
+            }
+          if (i->isInitialValueChecked)
+            {
+              info.accessor->Set (this, *info.initialValue);
             }
+          else
+            {
+              DoSet (info.accessor, info.checker, *info.initialValue);
+            }
+          NS_LOG_DEBUG ("construct \""<< i->fullName <<"\" from initial value.");
+          continue;
+        }
 
-          if (value != 0)
+      // is this attribute stored in this AttributeConstructionList instance ?
+      Ptr<AttributeValue> value = attributes.Find(info.checker);
+      // See if this attribute should not be set here in the
+      // constructor.
+      if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+        {
+          // Handle this attribute if it should not be 
+          // set here.
+          if (value == 0)
             {
-              // We have a matching attribute value.
-              if (DoSet (info.accessor, info.checker, *value))
-                {
-                  NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                info.name<<"\"");
-                  continue;
-                }
+              // Skip this attribute if it's not in the
+              // AttributeConstructionList.
+              continue;
+            }              
+          else
+            {
+              // This is an error because this attribute is not
+              // settable in its constructor but is present in
+              // the AttributeConstructionList.
+              NS_FATAL_ERROR ("Attribute name="<<info.name<<" tid="<<tid.GetName () << ": initial value cannot be set using attributes");
             }
+        }
 
-#ifdef HAVE_GETENV
-          // No matching attribute value so we try to look at the env var.
-          char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
-          if (envVar != 0)
+      if (value != 0)
+        {
+          // We have a matching attribute value.
+          if (DoSet (info.accessor, info.checker, *value))
+            {
+              NS_LOG_DEBUG ("construct \""<< i->fullName <<"\"");
+              continue;
+            }
+        }
+
+      // No matching attribute value so we try to look at the env var.
+      bool found = false;
+      if (envVar != 0)
+        {
+          std::string env = std::string (envVar);
+          std::string::size_type cur = 0;
+          std::string::size_type next = 0;
+          while (next != std::string::npos)
             {
-              std::string env = std::string (envVar);
-              std::string::size_type cur = 0;
-              std::string::size_type next = 0;
-              while (next != std::string::npos)
+              next = env.find (";", cur);
+              std::string tmp = std::string (env, cur, next-cur);
+              std::string::size_type equal = tmp.find ("=");
+              if (equal != std::string::npos)
                 {
-                  next = env.find (";", cur);
-                  std::string tmp = std::string (env, cur, next-cur);
-                  std::string::size_type equal = tmp.find ("=");
-                  if (equal != std::string::npos)
+                  std::string name = tmp.substr (0, equal);
+                  std::string envval = tmp.substr (equal+1, tmp.size () - equal - 1);
+                  if (name == i->fullName)
                     {
-                      std::string name = tmp.substr (0, equal);
-                      std::string envval = tmp.substr (equal+1, tmp.size () - equal - 1);
-                      if (name == tid.GetAttributeFullName (i))
+                      if (DoSet (info.accessor, info.checker, StringValue (envval)))
                         {
-                          if (DoSet (info.accessor, info.checker, StringValue (envval)))
-                            {
-                              NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                            info.name <<"\" from env var");
-                              break;
-                            }
+                          NS_LOG_DEBUG ("construct \""<< i->fullName <<"\" from env var");
+                          found = true;
+                          break;
                         }
                     }
-                  cur = next + 1;
                 }
+              cur = next + 1;
             }
-#endif /* HAVE_GETENV */
-
-          // No matching attribute value so we try to set the default value.
-          DoSet (info.accessor, info.checker, *info.initialValue);
-          NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                        info.name <<"\" from initial value.");
         }
-      tid = tid.GetParent ();
-    } while (tid != ObjectBase::GetTypeId ());
+      if (found)
+        {
+          continue;
+        }
+
+      // No matching attribute value so we try to set the default value.
+      DoSet (info.accessor, info.checker, *info.initialValue);
+      NS_LOG_DEBUG ("construct \""<< i->fullName <<"\" from initial value.");
+    }
   NotifyConstructionCompleted ();
 }
 
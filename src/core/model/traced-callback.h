@@ -21,7 +21,7 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -93,6 +93,17 @@ public:
    * \param [in] path Context path which was used to connect the Callback.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * Check whether no Callback is connected.
+   *
+   * Invoking an empty chain does nothing, but the arguments of the
+   * invocation are still built: models may check this first, so as not
+   * to copy a packet or to look up an object just for a trace source
+   * nobody listens to.
+   *
+   * \return \c true if the chain of Callbacks is empty.
+   */
+  bool IsEmpty (void) const;
   /**
    * \name Functors taking various numbers of arguments.
    *
@@ -222,21 +233,47 @@ public:
 
   
 private:
+  /** The type of the Callbacks of the chain. */
+  typedef Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> ChainCallback;
+
   /**
-   * Container type for holding the chain of Callbacks.
+   * The number of Callbacks stored in the TracedCallback itself.
    *
-   * \tparam T1 \deduced Type of the first argument to the functor.
-   * \tparam T2 \deduced Type of the second argument to the functor.
-   * \tparam T3 \deduced Type of the third argument to the functor.
-   * \tparam T4 \deduced Type of the fourth argument to the functor.
-   * \tparam T5 \deduced Type of the fifth argument to the functor.
-   * \tparam T6 \deduced Type of the sixth argument to the functor.
-   * \tparam T7 \deduced Type of the seventh argument to the functor.
-   * \tparam T8 \deduced Type of the eighth argument to the functor.
+   * Most trace sources have no or few Callbacks connected: the first ones
+   * are stored in place, only the following ones are allocated.
+   */
+  static const uint32_t N_INLINE = 2;
+
+  /**
+   * Append a Callback to the chain.
+   *
+   * \param [in] cb The Callback.
+   */
+  void Append (const ChainCallback & cb);
+  /**
+   * Get a Callback of the chain.
+   *
+   * \param [in] i The index of the Callback in the chain.
+   * \return The Callback.
+   */
+  const ChainCallback & GetCallback (uint32_t i) const
+  {
+    return i < N_INLINE ? m_inline[i] : m_more[i - N_INLINE];
+  }
+  /**
+   * \copydoc GetCallback(uint32_t)const
    */
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
-  /** The chain of Callbacks. */
-  CallbackList m_callbackList;
+  ChainCallback & GetCallback (uint32_t i)
+  {
+    return i < N_INLINE ? m_inline[i] : m_more[i - N_INLINE];
+  }
+
+  /** The first Callbacks of the chain. */
+  ChainCallback m_inline[N_INLINE];
+  /** The Callbacks of the chain following the first N_INLINE ones. */
+  std::vector<ChainCallback> m_more;
+  /** The number of Callbacks in the chain. */
+  uint32_t m_nCallbacks;
 };
 
 } // namespace ns3
@@ -253,7 +290,7 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
-  : m_callbackList () 
+  : m_nCallbacks (0)
 {
 }
 template<typename T1, typename T2,
@@ -261,12 +298,29 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Append (const ChainCallback & cb)
+{
+  if (m_nCallbacks < N_INLINE)
+    {
+      m_inline[m_nCallbacks] = cb;
+    }
+  else
+    {
+      m_more.push_back (cb);
+    }
+  m_nCallbacks++;
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::ConnectWithoutContext (const CallbackBase & callback)
 {
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> cb;
+  ChainCallback cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR_NO_MSG();
-  m_callbackList.push_back (cb);
+  Append (cb);
 }
 template<typename T1, typename T2,
          typename T3, typename T4,
@@ -278,8 +332,8 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Connect (const CallbackBase & callback,
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when connecting to " << path);
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  ChainCallback realCb = cb.Bind (path);
+  Append (realCb);
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -288,18 +342,25 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const CallbackBase & callback)
 {
-  for (typename CallbackList::iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); /* empty */)
+  // keep the order of the remaining Callbacks
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
     {
-      if ((*i).IsEqual (callback))
-        {
-          i = m_callbackList.erase (i);
-        }
-      else
+      if (!GetCallback (i).IsEqual (callback))
         {
-          i++;
+          if (kept != i)
+            {
+              GetCallback (kept) = GetCallback (i);
+            }
+          kept++;
         }
     }
+  for (uint32_t i = kept; i < m_nCallbacks && i < N_INLINE; i++)
+    {
+      m_inline[i] = ChainCallback ();
+    }
+  m_more.resize (kept > N_INLINE ? kept - N_INLINE : 0);
+  m_nCallbacks = kept;
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -311,9 +372,18 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callba
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when disconnecting from " << path);
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
+  ChainCallback realCb = cb.Bind (path);
   DisconnectWithoutContext (realCb);
 }
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+inline bool
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::IsEmpty (void) const
+{
+  return m_nCallbacks == 0;
+}
 template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
@@ -321,10 +391,10 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  // the chain may be modified by the Callbacks, hence it is indexed
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
     {
-      (*i)();
+      GetCallback (i)();
     }
 }
 template<typename T1, typename T2, 
@@ -334,10 +404,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
     {
-      (*i)(a1);
+      GetCallback (i)(a1);
     }
 }
 template<typename T1, typename T2, 
@@ -347,10 +416,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
     {
-      (*i)(a1, a2);
+      GetCallback (i)(a1, a2);
     }
 }
 template<typename T1, typename T2, 
@@ -360,10 +428,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
     {
-      (*i)(a1, a2, a3);
+      GetCallback (i)(a1, a2, a3);
     }
 }
 template<typename T1, typename T2, 
@@ -373,10 +440,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
     {
-      (*i)(a1, a2, a3, a4);
+      GetCallback (i)(a1, a2, a3, a4);
     }
 }
 template<typename T1, typename T2, 
@@ -386,10 +452,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
     {
-      (*i)(a1, a2, a3, a4, a5);
+      GetCallback (i)(a1, a2, a3, a4, a5);
     }
 }
 template<typename T1, typename T2, 
@@ -399,10 +464,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      GetCallback (i)(a1, a2, a3, a4, a5, a6);
     }
 }
 template<typename T1, typename T2, 
@@ -412,10 +476,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      GetCallback (i)(a1, a2, a3, a4, a5, a6, a7);
     }
 }
 template<typename T1, typename T2, 
@@ -425,10 +488,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nCallbacks; i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      GetCallback (i)(a1, a2, a3, a4, a5, a6, a7, a8);
     }
 }
 
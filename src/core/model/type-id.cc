@@ -24,6 +24,7 @@
 #include "trace-source-accessor.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <sstream>
 #include <iomanip>
@@ -51,7 +52,12 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
  * \brief TypeId information manager
  *
  * Information records are stored in a vector.  Name and hash lookup
- * are performed by maps to the vector index.
+ * are performed by hash tables to the vector index.
+ *
+ * The Attributes and TraceSources of a type id and of its parents are
+ * also gathered, on demand, into flat lists indexed by name, so that
+ * looking them up does not walk the parent chain.  These lists are kept
+ * until one of the type ids of the chain changes.
  *
  * \internal
  * <b>Hash Chaining</b>
@@ -271,6 +277,29 @@ public:
    */
   bool MustHideFromDocumentation (uint16_t uid) const;
 
+  /**
+   * Find an Attribute of a type id or of its parents.
+   * \param [in] uid The id.
+   * \param [in] name The Attribute name.
+   * \returns The first Attribute named \p name, from \p uid up to
+   *          the root type id, or null if there is none.
+   */
+  const struct TypeId::AttributeInformation *LookupAttribute (uint16_t uid, const std::string &name);
+  /**
+   * Find a TraceSource of a type id or of its parents.
+   * \param [in] uid The id.
+   * \param [in] name The TraceSource name.
+   * \returns The first TraceSource named \p name, from \p uid up to
+   *          the root type id, or null if there is none.
+   */
+  const struct TypeId::TraceSourceInformation *LookupTraceSource (uint16_t uid, const std::string &name);
+  /**
+   * Get the Attributes of a type id and of its parents.
+   * \param [in] uid The id.
+   * \returns The Attributes, most derived first.
+   */
+  Ptr<const TypeId::FlatAttributeList> GetFlatAttributeList (uint16_t uid);
+
 private:
   /**
    * Check if a type id has a given TraceSource.
@@ -319,6 +348,8 @@ private:
     TypeId::SupportLevel supportLevel;
     /** Support message. */
     std::string supportMsg;
+    /** Incremented whenever the parent, Attributes or TraceSources change. */
+    uint32_t version;
   };
   /** Iterator type. */
   typedef std::vector<struct IidInformation>::const_iterator Iterator;
@@ -334,15 +365,40 @@ private:
   std::vector<struct IidInformation> m_information;
 
   /** Type of the by-name index. */
-  typedef std::map<std::string, uint16_t> namemap_t;
+  typedef std::unordered_map<std::string, uint16_t> namemap_t;
   /** The by-name index. */
   namemap_t m_namemap;
 
   /** Type of the by-hash index. */
-  typedef std::map<TypeId::hash_t, uint16_t> hashmap_t;
+  typedef std::unordered_map<TypeId::hash_t, uint16_t> hashmap_t;
   /** The by-hash index. */
   hashmap_t m_hashmap;
 
+  /** The Attributes and TraceSources of a type id and of its parents. */
+  struct FlatInformation {
+    /** The uid and version of each type id of the chain, most derived first. */
+    std::vector<std::pair<uint16_t, uint32_t> > chain;
+    /** The Attributes. */
+    Ptr<TypeId::FlatAttributeList> attributes;
+    /** The index of the first Attribute with each name. */
+    std::unordered_map<std::string, std::size_t> attributeIndexes;
+    /** The TraceSources. */
+    std::vector<struct TypeId::TraceSourceInformation> traceSources;
+    /** The index of the first TraceSource with each name. */
+    std::unordered_map<std::string, std::size_t> traceSourceIndexes;
+  };
+
+  /**
+   * Get the flat lists of a type id, building them if they are missing
+   * or out of date.
+   * \param [in] uid The id.
+   * \returns The flat lists.
+   */
+  struct FlatInformation *GetFlatInformation (uint16_t uid);
+
+  /** The flat lists of each type id, indexed by uid - 1. */
+  std::vector<struct FlatInformation> m_flat;
+
 
   /** IidManager constants. */
   enum {
@@ -439,6 +495,7 @@ IidManager::AllocateUid (std::string name)
   information.size = (std::size_t)(-1);
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
+  information.version = 0;
   m_information.push_back (information);
   std::size_t tuid = m_information.size();
   NS_ASSERT (tuid <= 0xffff);
@@ -467,6 +524,7 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  information->version++;
 }
 void 
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -676,6 +734,7 @@ IidManager::AddAttribute (uint16_t uid,
   info.supportLevel = supportLevel;
   info.supportMsg = supportMsg;
   information->attributes.push_back (info);
+  information->version++;
   NS_LOG_LOGIC (IIDL << information->attributes.size () - 1);
 }
 void 
@@ -687,6 +746,7 @@ IidManager::SetAttributeInitialValue (uint16_t uid,
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
+  information->version++;
 }
 
 
@@ -767,6 +827,7 @@ IidManager::AddTraceSource (uint16_t uid,
   source.supportLevel = supportLevel;
   source.supportMsg = supportMsg;
   information->traceSources.push_back (source);
+  information->version++;
   NS_LOG_LOGIC (IIDL << information->traceSources.size () - 1);
 }
 std::size_t
@@ -797,6 +858,96 @@ IidManager::MustHideFromDocumentation (uint16_t uid) const
   return hide;
 }
 
+struct IidManager::FlatInformation *
+IidManager::GetFlatInformation (uint16_t uid)
+{
+  NS_LOG_FUNCTION (IID << uid);
+  NS_ASSERT (uid <= m_information.size () && uid != 0);
+  if (m_flat.size () < m_information.size ())
+    {
+      m_flat.resize (m_information.size ());
+    }
+  struct FlatInformation *flat = &m_flat[uid-1];
+
+  bool upToDate = !flat->chain.empty ();
+  for (std::size_t i = 0; upToDate && i < flat->chain.size (); i++)
+    {
+      upToDate = m_information[flat->chain[i].first-1].version == flat->chain[i].second;
+    }
+  if (upToDate)
+    {
+      return flat;
+    }
+
+  NS_LOG_LOGIC (IIDL << "build the flat lists of " << m_information[uid-1].name);
+  flat->chain.clear ();
+  // a new list, since the previous one may still be in use
+  flat->attributes = Create<TypeId::FlatAttributeList> ();
+  flat->attributeIndexes.clear ();
+  flat->traceSources.clear ();
+  flat->traceSourceIndexes.clear ();
+  uint16_t current = uid;
+  while (true)
+    {
+      struct IidInformation *information = LookupInformation (current);
+      flat->chain.push_back (std::make_pair (current, information->version));
+      for (std::size_t i = 0; i < information->attributes.size (); i++)
+        {
+          struct TypeId::FlatAttributeInformation item;
+          item.info = information->attributes[i];
+          item.fullName = information->name + "::" + item.info.name;
+          item.isInitialValueChecked = item.info.checker->Check (*item.info.initialValue);
+          // the most derived Attribute wins
+          flat->attributeIndexes.insert (std::make_pair (item.info.name, flat->attributes->attributes.size ()));
+          flat->attributes->attributes.push_back (item);
+        }
+      for (std::size_t i = 0; i < information->traceSources.size (); i++)
+        {
+          flat->traceSourceIndexes.insert (std::make_pair (information->traceSources[i].name, flat->traceSources.size ()));
+          flat->traceSources.push_back (information->traceSources[i]);
+        }
+      if (information->parent == current || information->parent == 0)
+        {
+          break;
+        }
+      current = information->parent;
+    }
+  return flat;
+}
+
+const struct TypeId::AttributeInformation *
+IidManager::LookupAttribute (uint16_t uid, const std::string &name)
+{
+  NS_LOG_FUNCTION (IID << uid << name);
+  struct FlatInformation *flat = GetFlatInformation (uid);
+  std::unordered_map<std::string, std::size_t>::const_iterator i = flat->attributeIndexes.find (name);
+  if (i == flat->attributeIndexes.end ())
+    {
+      return 0;
+    }
+  return &flat->attributes->attributes[i->second].info;
+}
+
+const struct TypeId::TraceSourceInformation *
+IidManager::LookupTraceSource (uint16_t uid, const std::string &name)
+{
+  NS_LOG_FUNCTION (IID << uid << name);
+  struct FlatInformation *flat = GetFlatInformation (uid);
+  std::unordered_map<std::string, std::size_t>::const_iterator i = flat->traceSourceIndexes.find (name);
+  if (i == flat->traceSourceIndexes.end ())
+    {
+      return 0;
+    }
+  return &flat->traceSources[i->second];
+}
+
+Ptr<const TypeId::FlatAttributeList>
+IidManager::GetFlatAttributeList (uint16_t uid)
+{
+  NS_LOG_FUNCTION (IID << uid);
+  return GetFlatInformation (uid)->attributes;
+}
+
 } // namespace ns3
 
 namespace ns3 {
@@ -877,38 +1028,31 @@ bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
   NS_LOG_FUNCTION (this << name << info);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
-        {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute (i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "Attribute '" << name << "' is deprecated: "
-                                 << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("Attribute '" << name
-                                  << "' is obsolete, with no fallback: "
-                                  << tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return false;
+  const struct TypeId::AttributeInformation *tmp = IidManager::Get ()->LookupAttribute (m_tid, name);
+  if (tmp == 0)
+    {
+      return false;
+    }
+  if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "Attribute '" << name << "' is deprecated: "
+                << tmp->supportMsg << std::endl;
+    }
+  else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("Attribute '" << name
+                      << "' is obsolete, with no fallback: "
+                      << tmp->supportMsg);
+    }
+  *info = *tmp;
+  return true;
+}
+
+Ptr<const TypeId::FlatAttributeList>
+TypeId::GetFlatAttributeList (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return IidManager::Get ()->GetFlatAttributeList (m_tid);
 }
 
 TypeId 
@@ -1137,39 +1281,24 @@ TypeId::LookupTraceSourceByName (std::string name,
                                  struct TraceSourceInformation *info) const
 {
   NS_LOG_FUNCTION (this << name);
-  TypeId tid;
-  TypeId nextTid = *this;
-  struct TypeId::TraceSourceInformation tmp;
-  do {
-      tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetTraceSourceN(); i++)
-        {
-          tmp = tid.GetTraceSource (i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                   return tmp.accessor;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "TraceSource '" << name << "' is deprecated: "
-                                 << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return tmp.accessor;
-                }
-              else  if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("TraceSource '" << name
-                                  << "' is obsolete, with no fallback: "
-                                  << tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return 0;
+  const struct TypeId::TraceSourceInformation *tmp = IidManager::Get ()->LookupTraceSource (m_tid, name);
+  if (tmp == 0)
+    {
+      return 0;
+    }
+  if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "TraceSource '" << name << "' is deprecated: "
+                << tmp->supportMsg << std::endl;
+    }
+  else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("TraceSource '" << name
+                      << "' is obsolete, with no fallback: "
+                      << tmp->supportMsg);
+    }
+  *info = *tmp;
+  return tmp->accessor;
 }
 
 Ptr<const TraceSourceAccessor> 
@@ -28,6 +28,7 @@
 #include "deprecated.h"
 #include "hash.h"
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 /**
@@ -108,6 +109,22 @@ public:
     /** Support message. */
     std::string supportMsg;
   };
+  /** Attribute of a TypeId or of one of its parents. */
+  struct FlatAttributeInformation {
+    /** The Attribute. */
+    struct AttributeInformation info;
+    /** The Attribute name, prefixed by the name of the TypeId which registered it. */
+    std::string fullName;
+    /** \c true if the checker accepts the initial value as it is. */
+    bool isInitialValueChecked;
+  };
+  /** The Attributes of a TypeId and of its parents, most derived first. */
+  class FlatAttributeList : public SimpleRefCount<FlatAttributeList>
+  {
+  public:
+    /** The Attributes. */
+    std::vector<struct FlatAttributeInformation> attributes;
+  };
 
   /** Type of hash values. */
   typedef uint32_t hash_t;
@@ -485,6 +502,16 @@ public:
    * \returns \c true if the requested attribute could be found.
    */
   bool LookupAttributeByName (std::string name, struct AttributeInformation *info) const;
+  /**
+   * Get the Attributes of this TypeId and of its parents.
+   *
+   * The list is built once, and built again only when an Attribute is
+   * added to one of these TypeIds or when an initial value changes.
+   *
+   * \returns The Attributes, most derived first, in the order in which
+   *          ObjectBase::ConstructSelf sets them.
+   */
+  Ptr<const FlatAttributeList> GetFlatAttributeList (void) const;
   /**
    * Find a TraceSource by name.
    *
@@ -830,6 +830,99 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * Test for the matches of a Config::Batch, which resolves paths from
+ * the objects matching their leading parts.
+ */
+class BatchConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  BatchConfigTestCase ();
+  /** Destructor. */
+  virtual ~BatchConfigTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check that a Batch matches the objects Config::LookupMatches does.
+   * \param [in] batch The batch.
+   * \param [in] path The path to match.
+   * \param [in] n The expected number of matches.
+   */
+  void CheckMatches (Config::Batch &batch, std::string path, std::size_t n);
+};
+
+BatchConfigTestCase::BatchConfigTestCase ()
+  : TestCase ("Check that Config::Batch matches the objects Config::LookupMatches does")
+{
+}
+
+void
+BatchConfigTestCase::CheckMatches (Config::Batch &batch, std::string path, std::size_t n)
+{
+  Config::MatchContainer expected = Config::LookupMatches (path);
+  Config::MatchContainer matches = batch.LookupMatches (path);
+  NS_TEST_ASSERT_MSG_EQ (expected.GetN (), n, "Unexpected number of objects matching " << path);
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), n, "Unexpected number of objects in the batch matching " << path);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (matches.Get (i), expected.Get (i), "Unexpected object " << i << " matching " << path);
+      NS_TEST_EXPECT_MSG_EQ (matches.GetMatchedPath (i), expected.GetMatchedPath (i),
+                             "Unexpected context " << i << " matching " << path);
+    }
+}
+
+void
+BatchConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  //
+  // Build /NodeA/NodesB/{0,1,2,3}/NodeA with names for the leaves.
+  //
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  std::vector<Ptr<ConfigTestObject> > leaves;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject> ();
+      Ptr<ConfigTestObject> leaf = CreateObject<ConfigTestObject> ();
+      a->AddNodeB (b);
+      b->SetNodeA (leaf);
+      leaves.push_back (leaf);
+    }
+  Names::Add ("BatchLeaf", leaves[2]);
+
+  Config::Batch batch;
+  CheckMatches (batch, "/NodeA/NodesB/*", 4);
+  CheckMatches (batch, "/NodeA/NodesB/[1-2]|0/NodeA", 3);
+  CheckMatches (batch, "/NodeA/NodesB/*|1/*", 4);
+  CheckMatches (batch, "/NodeA/NodesB/5/NodeA", 0);
+  // the container does not match any object, but its elements do
+  CheckMatches (batch, "/NodeA/NodesB", 0);
+  CheckMatches (batch, "/NodeA/NodesB/3", 1);
+  CheckMatches (batch, "/NodeA/NodesB/3/NodeA/", 1);
+  // the "/Names" namespace is not an object either
+  CheckMatches (batch, "/Names", 0);
+  CheckMatches (batch, "/Names/BatchLeaf", 1);
+
+  batch.Set ("/NodeA/NodesB/[0-1]/NodeA/A", IntegerValue (5));
+  batch.Set ("/Names/BatchLeaf/A", IntegerValue (6));
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      leaves[i]->GetAttribute ("A", iv);
+      NS_TEST_EXPECT_MSG_EQ (iv.Get (), (i < 2 ? 5 : (i == 2 ? 6 : 10)), "Unexpected value of leaf " << i);
+    }
+
+  Names::Clear ();
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -848,6 +941,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new BatchConfigTestCase);
 }
 
 /**
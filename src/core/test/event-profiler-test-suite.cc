@@ -0,0 +1,239 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/event-profiler.h"
+#include "ns3/object.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <chrono>
+#include <map>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * EventProfiler test suite.
+ */
+
+namespace ns3 {
+
+  namespace tests {
+
+
+/**
+ * \ingroup core-tests
+ * An object whose events take some time.
+ */
+class EventProfilerTestObject : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::tests::EventProfilerTestObject")
+      .SetParent<Object> ()
+      .SetGroupName ("Core")
+    ;
+    return tid;
+  }
+
+  /** Spin for a few microseconds. */
+  void Work (void)
+  {
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now ()
+      + std::chrono::microseconds (20);
+    while (std::chrono::steady_clock::now () < end)
+      {
+      }
+  }
+};
+
+/** A function scheduled without context. */
+static void
+EventProfilerTestFunction (int)
+{
+}
+
+/**
+ * \ingroup core-tests
+ * Check the attribution of the events to functions, modules and nodes
+ */
+class EventProfilerTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param samplingPeriod the sampling period of the profiler
+   */
+  EventProfilerTestCase (uint32_t samplingPeriod);
+  virtual ~EventProfilerTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_samplingPeriod; //!< the sampling period of the profiler
+};
+
+EventProfilerTestCase::EventProfilerTestCase (uint32_t samplingPeriod)
+  : TestCase ("Check the event profiler with sampling period " + std::to_string (samplingPeriod)),
+    m_samplingPeriod (samplingPeriod)
+{
+}
+
+void
+EventProfilerTestCase::DoRun (void)
+{
+  Ptr<EventProfilerTestObject> object = CreateObject<EventProfilerTestObject> ();
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::ScheduleWithContext (1, MicroSeconds (i), &EventProfilerTestObject::Work, object);
+    }
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Simulator::ScheduleWithContext (2, MicroSeconds (i), &EventProfilerTestObject::Work, object);
+    }
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &EventProfilerTestFunction, 3);
+    }
+
+  EventProfiler profiler (m_samplingPeriod);
+  Simulator::Run ();
+  profiler.Stop ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetEventCount (), 18, "Unexpected number of events");
+  std::vector<EventProfiler::Entry> entries = profiler.GetEntries ();
+  NS_TEST_ASSERT_MSG_EQ (entries.size (), 3, "Unexpected number of entries");
+  std::map<uint32_t, EventProfiler::Entry> byContext;
+  for (uint32_t i = 0; i < entries.size (); i++)
+    {
+      byContext[entries[i].context] = entries[i];
+      if (i > 0)
+        {
+          NS_TEST_EXPECT_MSG_GT_OR_EQ (entries[i - 1].seconds, entries[i].seconds, "The entries must be sorted by time");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (byContext.size (), 3, "One entry per context expected");
+
+  std::string work = "void (ns3::tests::EventProfilerTestObject::*)()";
+  NS_TEST_EXPECT_MSG_EQ (byContext[1].function, work, "Unexpected function on node 1");
+  NS_TEST_EXPECT_MSG_EQ (byContext[1].module, "Core", "The module of the method is its TypeId group");
+  NS_TEST_EXPECT_MSG_EQ (byContext[1].events, 10, "Unexpected number of events on node 1");
+  NS_TEST_EXPECT_MSG_GT (byContext[1].seconds, 10 * 20e-6 * 0.9, "The time of the events on node 1 is too short");
+  NS_TEST_EXPECT_MSG_EQ (byContext[2].function, work, "Unexpected function on node 2");
+  NS_TEST_EXPECT_MSG_EQ (byContext[2].events, 5, "Unexpected number of events on node 2");
+  NS_TEST_EXPECT_MSG_EQ (byContext[Simulator::NO_CONTEXT].function, "void (*)(int)", "Unexpected function without context");
+  NS_TEST_EXPECT_MSG_EQ (byContext[Simulator::NO_CONTEXT].module, "unknown", "A function has no module");
+  NS_TEST_EXPECT_MSG_EQ (byContext[Simulator::NO_CONTEXT].events, 3, "Unexpected number of events without context");
+
+  std::ostringstream folded;
+  profiler.WriteFolded (folded, true);
+  NS_TEST_EXPECT_MSG_NE (folded.str ().find ("Core;" + work + ";node 1 10\n"), std::string::npos,
+                         "Stack of node 1 not found in " << folded.str ());
+  NS_TEST_EXPECT_MSG_NE (folded.str ().find ("unknown;void (*)(int);no node 3\n"), std::string::npos,
+                         "Stack of the function not found in " << folded.str ());
+
+  profiler.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetEntries ().size (), 0, "The profile must be cleared");
+}
+
+/**
+ * \ingroup core-tests
+ * Check that the events of functions and nodes which alternate
+ * periodically are all timed
+ */
+class EventProfilerSamplingTestCase : public TestCase
+{
+public:
+  EventProfilerSamplingTestCase ();
+  virtual ~EventProfilerSamplingTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+EventProfilerSamplingTestCase::EventProfilerSamplingTestCase ()
+  : TestCase ("Check the event profiler with alternating events")
+{
+}
+
+void
+EventProfilerSamplingTestCase::DoRun (void)
+{
+  // nodes 1 and 2 alternate with the sampling period: a single
+  // countdown would only time the events of node 1
+  Ptr<EventProfilerTestObject> object = CreateObject<EventProfilerTestObject> ();
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      Simulator::ScheduleWithContext (1, MicroSeconds (i), &EventProfilerTestObject::Work, object);
+      Simulator::ScheduleWithContext (2, MicroSeconds (i), &EventProfilerTestObject::Work, object);
+    }
+  // node 3 has a single event, far fewer than the sampling period
+  Simulator::ScheduleWithContext (3, MicroSeconds (10), &EventProfilerTestObject::Work, object);
+
+  EventProfiler profiler (2);
+  Simulator::Run ();
+  profiler.Stop ();
+  Simulator::Destroy ();
+
+  std::vector<EventProfiler::Entry> entries = profiler.GetEntries ();
+  NS_TEST_ASSERT_MSG_EQ (entries.size (), 3, "Unexpected number of entries");
+  std::map<uint32_t, EventProfiler::Entry> byContext;
+  for (uint32_t i = 0; i < entries.size (); i++)
+    {
+      byContext[entries[i].context] = entries[i];
+    }
+  NS_TEST_EXPECT_MSG_EQ (byContext[1].events, 8, "Unexpected number of events on node 1");
+  NS_TEST_EXPECT_MSG_EQ (byContext[2].events, 8, "Unexpected number of events on node 2");
+  NS_TEST_EXPECT_MSG_EQ (byContext[3].events, 1, "Unexpected number of events on node 3");
+  NS_TEST_EXPECT_MSG_GT (byContext[1].seconds, 8 * 20e-6 * 0.9, "The time of the events on node 1 is too short");
+  NS_TEST_EXPECT_MSG_GT (byContext[2].seconds, 8 * 20e-6 * 0.9, "The time of the events on node 2 is too short");
+  NS_TEST_EXPECT_MSG_GT (byContext[3].seconds, 20e-6 * 0.9, "The event on node 3 was not timed");
+}
+
+/**
+ * \ingroup core-tests
+ * EventProfiler test suite
+ */
+class EventProfilerTestSuite : public TestSuite
+{
+public:
+  EventProfilerTestSuite ();
+};
+
+EventProfilerTestSuite::EventProfilerTestSuite ()
+  : TestSuite ("event-profiler")
+{
+  AddTestCase (new EventProfilerTestCase (1));
+  AddTestCase (new EventProfilerTestCase (4));
+  AddTestCase (new EventProfilerSamplingTestCase ());
+}
+
+/**
+ * \ingroup core-tests
+ * EventProfilerTestSuite instance variable.
+ */
+static EventProfilerTestSuite g_eventProfilerTestSuite;
+
+
+  }  // namespace tests
+
+}  // namespace ns3
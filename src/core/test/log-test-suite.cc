@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup logging
+ * \ingroup logging-tests
+ * Logging test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup logging-tests Logging test suite
+ */
+
+namespace ns3 {
+
+  namespace tests {
+
+
+/**
+ * \ingroup logging-tests
+ * A log component whose messages are compiled out.
+ */
+static StaticLogComponent<false> g_compiledOut ("LogTestCompiledOut", __FILE__);
+
+/**
+ * \ingroup logging-tests
+ * A log component whose messages are compiled in.
+ */
+static StaticLogComponent<true> g_compiledIn ("LogTestCompiledIn", __FILE__);
+
+static_assert (LogListContains ("Packet,Buffer,Node", "Buffer"), "Buffer is in the list");
+static_assert (!LogListContains ("Packet,Buffer,Node", "Buff"), "Buff is not in the list");
+
+
+/**
+ * \ingroup logging-tests
+ * Check the compile-time filtering of the log components
+ */
+class LogCompiledTestCase : public TestCase
+{
+public:
+  LogCompiledTestCase ();
+  virtual ~LogCompiledTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+LogCompiledTestCase::LogCompiledTestCase (void)
+  : TestCase ("Check the compile-time filtering of log components")
+{
+}
+
+void
+LogCompiledTestCase::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (LogListContains ("Packet,Buffer", "Packet"), true, "First name not found");
+  NS_TEST_EXPECT_MSG_EQ (LogListContains ("Packet,Buffer", "Buffer"), true, "Last name not found");
+  NS_TEST_EXPECT_MSG_EQ (LogListContains ("Packet,Buffer", "PacketBuffer"), false, "Longer name found");
+  NS_TEST_EXPECT_MSG_EQ (LogListContains ("Packet,Buffer", "Pack"), false, "Prefix found");
+  NS_TEST_EXPECT_MSG_EQ (LogListContains ("", "Packet"), false, "Name found in an empty list");
+
+  g_compiledOut.Enable (LOG_LEVEL_ALL);
+  NS_TEST_EXPECT_MSG_EQ (g_compiledOut.IsEnabled (LOG_DEBUG), false,
+                         "A compiled out component must not be enabled");
+  NS_TEST_EXPECT_MSG_EQ (g_compiledOut.LogComponent::IsEnabled (LOG_DEBUG), false,
+                         "A compiled out component must not be enabled at runtime either");
+
+  g_compiledIn.Enable (LOG_DEBUG);
+  NS_TEST_EXPECT_MSG_EQ (g_compiledIn.IsEnabled (LOG_DEBUG), true, "The component must be enabled");
+  NS_TEST_EXPECT_MSG_EQ (g_compiledIn.IsEnabled (LOG_INFO), false, "The level must not be enabled");
+  g_compiledIn.Disable (LOG_DEBUG);
+  NS_TEST_EXPECT_MSG_EQ (g_compiledIn.IsNoneEnabled (), true, "The component must be disabled");
+}
+
+/**
+ * \ingroup logging-tests
+ * Check the buffering of the log output
+ */
+class LogBufferTestCase : public TestCase
+{
+public:
+  LogBufferTestCase ();
+  virtual ~LogBufferTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+LogBufferTestCase::LogBufferTestCase (void)
+  : TestCase ("Check the buffering of the log output")
+{
+}
+
+void
+LogBufferTestCase::DoRun (void)
+{
+  std::ostringstream output;
+  std::streambuf *clog = std::clog.rdbuf (output.rdbuf ());
+
+  std::ostringstream expected;
+  LogSetBufferSize (64, 2);
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      std::clog << "message " << i << std::endl;
+      expected << "message " << i << std::endl;
+    }
+  LogFlush ();
+  std::string flushed = output.str ();
+  std::string expectedFlushed = expected.str ();
+  std::clog << "last message" << std::endl;
+  expected << "last message" << std::endl;
+  LogSetBufferSize (0);
+  std::clog << "direct message" << std::endl;
+  expected << "direct message" << std::endl;
+
+  std::clog.rdbuf (clog);
+  NS_TEST_EXPECT_MSG_EQ (flushed, expectedFlushed, "The messages must be written upon LogFlush");
+  NS_TEST_EXPECT_MSG_EQ (output.str (), expected.str (), "Unexpected log output");
+}
+
+/**
+ * \ingroup logging-tests
+ * Logging test suite
+ */
+class LogTestSuite : public TestSuite
+{
+public:
+  LogTestSuite ();
+};
+
+LogTestSuite::LogTestSuite ()
+  : TestSuite ("log")
+{
+  AddTestCase (new LogCompiledTestCase);
+  AddTestCase (new LogBufferTestCase);
+}
+
+/**
+ * \ingroup logging-tests
+ * LogTestSuite instance variable.
+ */
+static LogTestSuite g_logTestSuite;
+
+
+  }  // namespace tests
+
+}  // namespace ns3
@@ -19,6 +19,7 @@
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
 #include "ns3/unused.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -113,6 +114,83 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+/**
+ * Record the invocation of a callback
+ *
+ * \param order the identifiers of the callbacks invoked
+ * \param id the identifier of the callback
+ * \param a the first argument of the trace
+ * \param b the second argument of the trace
+ */
+static void
+RecordCallback (std::vector<int> *order, int id, uint8_t a, double b)
+{
+  NS_UNUSED (a);
+  NS_UNUSED (b);
+  order->push_back (id);
+}
+
+class ChainTracedCallbackTestCase : public TestCase
+{
+public:
+  ChainTracedCallbackTestCase ();
+  virtual ~ChainTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+ChainTracedCallbackTestCase::ChainTracedCallbackTestCase ()
+  : TestCase ("Check the chain of callbacks of a TracedCallback")
+{
+}
+
+void
+ChainTracedCallbackTestCase::DoRun (void)
+{
+  TracedCallback<uint8_t, double> trace;
+  std::vector<int> order;
+
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "A new trace must be empty");
+  trace (1, 2);
+
+  //
+  // Connect more callbacks than stored in place.  They must be called in the
+  // order they were connected.
+  //
+  for (int i = 0; i < 5; i++)
+    {
+      trace.ConnectWithoutContext (MakeBoundCallback (&RecordCallback, &order, i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), false, "The trace must not be empty");
+  trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (order.size (), 5, "Unexpected number of callbacks called");
+  for (int i = 0; i < 5; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (order[i], i, "Callbacks not called in order");
+    }
+
+  //
+  // Disconnecting callbacks keeps the order of the others.
+  //
+  trace.DisconnectWithoutContext (MakeBoundCallback (&RecordCallback, &order, 0));
+  trace.DisconnectWithoutContext (MakeBoundCallback (&RecordCallback, &order, 3));
+  order.clear ();
+  trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (order.size (), 3, "Unexpected number of callbacks called");
+  NS_TEST_EXPECT_MSG_EQ (order[0], 1, "Callbacks not called in order");
+  NS_TEST_EXPECT_MSG_EQ (order[1], 2, "Callbacks not called in order");
+  NS_TEST_EXPECT_MSG_EQ (order[2], 4, "Callbacks not called in order");
+
+  trace.DisconnectWithoutContext (MakeBoundCallback (&RecordCallback, &order, 1));
+  trace.DisconnectWithoutContext (MakeBoundCallback (&RecordCallback, &order, 2));
+  trace.DisconnectWithoutContext (MakeBoundCallback (&RecordCallback, &order, 4));
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "The trace must be empty again");
+  order.clear ();
+  trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (order.size (), 0, "No callback must be called");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -123,6 +201,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ChainTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
@@ -24,6 +24,7 @@
 
 #include "ns3/integer.h"
 #include "ns3/double.h"
+#include "ns3/string.h"
 #include "ns3/object.h"
 #include "ns3/traced-value.h"
 #include "ns3/type-id.h"
@@ -325,6 +326,111 @@ DeprecatedAttributeTestCase::DoRun (void)
        << endl;
 }
 
+
+//----------------------------
+//
+// Test of the flat Attribute lists
+
+class FlatBaseObject : public Object
+{
+public:
+  FlatBaseObject () : m_a (0), m_late (0) {}
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("FlatBaseObject")
+      .SetParent<Object> ()
+      .AddAttribute ("A", "an attribute of the base class",
+                     IntegerValue (1),
+                     MakeIntegerAccessor (&FlatBaseObject::m_a),
+                     MakeIntegerChecker<int> ());
+    return tid;
+  }
+  int m_a;
+  int m_late;
+};
+
+class FlatDerivedObject : public FlatBaseObject
+{
+public:
+  FlatDerivedObject () : m_b (0) {}
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("FlatDerivedObject")
+      .SetParent<FlatBaseObject> ()
+      .AddConstructor<FlatDerivedObject> ()
+      .AddAttribute ("B", "an attribute whose initial value is a string",
+                     StringValue ("3"),
+                     MakeIntegerAccessor (&FlatDerivedObject::m_b),
+                     MakeIntegerChecker<int> ())
+      .AddTraceSource ("Trace", "a trace source",
+                       MakeTraceSourceAccessor (&FlatDerivedObject::m_trace),
+                       "ns3::TracedValueCallback::Int32");
+    return tid;
+  }
+  int m_b;
+  TracedValue<int32_t> m_trace;
+};
+
+class FlatAttributeListTestCase : public TestCase
+{
+public:
+  FlatAttributeListTestCase ();
+  virtual ~FlatAttributeListTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+FlatAttributeListTestCase::FlatAttributeListTestCase ()
+  : TestCase ("Check the flat Attribute lists and the lookups by name")
+{
+}
+
+FlatAttributeListTestCase::~FlatAttributeListTestCase ()
+{
+}
+
+void
+FlatAttributeListTestCase::DoRun (void)
+{
+  TypeId tid = FlatDerivedObject::GetTypeId ();
+  Ptr<const TypeId::FlatAttributeList> list = tid.GetFlatAttributeList ();
+  NS_TEST_ASSERT_MSG_EQ (list->attributes.size (), 2, "Unexpected number of attributes");
+  NS_TEST_EXPECT_MSG_EQ (list->attributes[0].fullName, "FlatDerivedObject::B", "The most derived attribute comes first");
+  NS_TEST_EXPECT_MSG_EQ (list->attributes[0].isInitialValueChecked, false, "A string initial value must be converted");
+  NS_TEST_EXPECT_MSG_EQ (list->attributes[1].fullName, "FlatBaseObject::A", "The base attribute comes last");
+  NS_TEST_EXPECT_MSG_EQ (list->attributes[1].isInitialValueChecked, true, "An integer initial value is valid");
+  NS_TEST_EXPECT_MSG_EQ (tid.GetFlatAttributeList (), list, "The list must be built once");
+
+  struct TypeId::AttributeInformation info;
+  NS_TEST_EXPECT_MSG_EQ (tid.LookupAttributeByName ("A", &info), true, "Base attribute not found");
+  NS_TEST_EXPECT_MSG_EQ (info.name, "A", "Unexpected attribute found");
+  NS_TEST_EXPECT_MSG_EQ (tid.LookupAttributeByName ("C", &info), false, "Unknown attribute found");
+  NS_TEST_EXPECT_MSG_NE (tid.LookupTraceSourceByName ("Trace"), 0, "Trace source not found");
+  NS_TEST_EXPECT_MSG_EQ (tid.LookupTraceSourceByName ("Other"), 0, "Unknown trace source found");
+
+  Ptr<FlatDerivedObject> object = CreateObject<FlatDerivedObject> ();
+  NS_TEST_EXPECT_MSG_EQ (object->m_a, 1, "Unexpected initial value of A");
+  NS_TEST_EXPECT_MSG_EQ (object->m_b, 3, "Unexpected initial value of B");
+
+  // changing an initial value of a parent rebuilds the list
+  TypeId base = FlatBaseObject::GetTypeId ();
+  base.SetAttributeInitialValue (0, Create<IntegerValue> (7));
+  NS_TEST_EXPECT_MSG_NE (tid.GetFlatAttributeList (), list, "The list must be rebuilt");
+  object = CreateObject<FlatDerivedObject> ();
+  NS_TEST_EXPECT_MSG_EQ (object->m_a, 7, "The new initial value of A must be used");
+  base.SetAttributeInitialValue (0, Create<IntegerValue> (1));
+
+  // so does adding an attribute to a parent
+  base.AddAttribute ("Late", "an attribute added after the first lookup",
+                     IntegerValue (5),
+                     MakeIntegerAccessor (&FlatBaseObject::m_late),
+                     MakeIntegerChecker<int> ());
+  NS_TEST_EXPECT_MSG_EQ (tid.LookupAttributeByName ("Late", &info), true, "Late attribute not found");
+  NS_TEST_EXPECT_MSG_EQ (tid.GetFlatAttributeList ()->attributes.size (), 3, "Unexpected number of attributes");
+  object = CreateObject<FlatDerivedObject> ();
+  NS_TEST_EXPECT_MSG_EQ (object->m_late, 5, "Unexpected initial value of Late");
+}
+
   
 //----------------------------
 //
@@ -437,6 +543,7 @@ TypeIdTestSuite::TypeIdTestSuite ()
   AddTestCase (new UniqueTypeIdTestCase, QUICK);
   AddTestCase (new CollisionTestCase, QUICK);
   AddTestCase (new DeprecatedAttributeTestCase, QUICK);
+  AddTestCase (new FlatAttributeListTestCase, QUICK);
 }
 
 static TypeIdTestSuite g_TypeIdTestSuite;  
@@ -29,6 +29,7 @@
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/queue-item.h"
 #include "ns3/trace-source-accessor.h"
 #include "csma-net-device.h"
 #include "csma-channel.h"
@@ -997,6 +998,60 @@ CsmaNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address&
   return true;
 }
 
+bool
+CsmaNetDevice::SupportsSendBatch (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return true;
+}
+
+uint32_t
+CsmaNetDevice::SendBatch (const std::vector<Ptr<QueueDiscItem> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+  NS_ASSERT (IsLinkUp ());
+
+  uint32_t nSent = 0;
+  for (const auto &item : items)
+    {
+      Ptr<Packet> packet = item->GetPacket ();
+      NS_LOG_LOGIC ("UID is " << packet->GetUid ());
+
+      if (IsSendEnabled () == false)
+        {
+          m_macTxDropTrace (packet);
+          continue;
+        }
+
+      Mac48Address destination = Mac48Address::ConvertFrom (item->GetAddress ());
+      AddHeader (packet, m_address, destination, item->GetProtocol ());
+      m_macTxTrace (packet);
+
+      if (m_queue->Enqueue (packet))
+        {
+          nSent++;
+        }
+      else
+        {
+          m_macTxDropTrace (packet);
+        }
+    }
+
+  //
+  // If the device is idle, start a transmission once for the whole batch.
+  // The other packets are sent when the current one finished transmission
+  // (see TransmitCompleteEvent)
+  //
+  if (m_txMachineState == READY && m_queue->IsEmpty () == false)
+    {
+      m_currentPkt = m_queue->Dequeue ();
+      m_promiscSnifferTrace (m_currentPkt);
+      m_snifferTrace (m_currentPkt);
+      TransmitStart ();
+    }
+  return nSent;
+}
+
 Ptr<Node>
 CsmaNetDevice::GetNode (void) const
 {
@@ -327,6 +327,17 @@ public:
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
 
+  virtual bool SupportsSendBatch (void) const;
+
+  /**
+   * Enqueue a batch of packets and start the transmission of the first one,
+   * if the device is idle, only once all the packets have been enqueued.
+   *
+   * \param items the packets to send
+   * \return the number of packets accepted by the device
+   */
+  virtual uint32_t SendBatch (const std::vector<Ptr<QueueDiscItem> > &items);
+
  /**
   * Assign a fixed random variable stream number to the random variables
   * used by this model.  Return the number of streams (possibly zero) that
@@ -22,6 +22,9 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -33,6 +36,18 @@ NS_LOG_COMPONENT_DEFINE ("FlowMonitor");
 
 NS_OBJECT_ENSURE_REGISTERED (FlowMonitor);
 
+/**
+ * \brief Get the key of a tracked packet
+ * \param flowId the Flow identification
+ * \param packetId the Packet identification
+ * \returns the key of the packet in the tracked packets
+ */
+static inline uint64_t
+GetTrackedPacketKey (FlowId flowId, FlowPacketId packetId)
+{
+  return (static_cast<uint64_t> (flowId) << 32) | packetId;
+}
+
 TypeId 
 FlowMonitor::GetTypeId (void)
 {
@@ -69,6 +84,16 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("EnableHistograms", ("Fill the fixed-bin histograms of the flows.  "
+                                        "The quantiles of the delays and jitters are estimated in any case."),
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&FlowMonitor::m_enableHistograms),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxTrackedPackets", ("The maximum number of packets tracked in flight, or 0 for no limit.  "
+                                         "Beyond it, the packet tracked for the longest time is considered lost."),
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FlowMonitor::m_maxTrackedPackets),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -80,7 +105,8 @@ FlowMonitor::GetInstanceTypeId (void) const
 }
 
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_wheelStart (0),
+    m_enabled (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -91,6 +117,8 @@ FlowMonitor::DoDispose (void)
   NS_LOG_FUNCTION (this);
   Simulator::Cancel (m_startEvent);
   Simulator::Cancel (m_stopEvent);
+  Simulator::Cancel (m_streamEvent);
+  m_stream = 0;
   for (std::list<Ptr<FlowClassifier> >::iterator iter = m_classifiers.begin ();
       iter != m_classifiers.end ();
       iter ++)
@@ -135,6 +163,104 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
     }
 }
 
+FlowMonitor::IntervalStats&
+FlowMonitor::GetIntervalStatsForFlow (FlowId flowId)
+{
+  std::map<FlowId, IntervalStats>::iterator iter = m_intervalStats.find (flowId);
+  if (iter == m_intervalStats.end ())
+    {
+      IntervalStats &ref = m_intervalStats[flowId];
+      ref.txBytes = 0;
+      ref.rxBytes = 0;
+      ref.txPackets = 0;
+      ref.rxPackets = 0;
+      ref.lostPackets = 0;
+      return ref;
+    }
+  return iter->second;
+}
+
+void
+FlowMonitor::AddToWheel (uint64_t key, TrackedPacket &tracked, int64_t slot)
+{
+  // the slots before m_wheelStart were already checked
+  slot = std::max (slot, m_wheelStart);
+  if (m_wheel.empty ())
+    {
+      m_wheelStart = slot;
+    }
+  uint64_t index = slot - m_wheelStart;
+  if (index >= m_wheel.size ())
+    {
+      m_wheel.resize (index + 1);
+    }
+  tracked.wheelSlot = slot;
+  tracked.wheelIndex = m_wheel[index].size ();
+  m_wheel[index].push_back (key);
+}
+
+void
+FlowMonitor::RemoveFromWheel (const TrackedPacket &tracked)
+{
+  NS_ASSERT (tracked.wheelSlot >= m_wheelStart
+             && tracked.wheelSlot - m_wheelStart < static_cast<int64_t> (m_wheel.size ()));
+  std::vector<uint64_t> &keys = m_wheel[tracked.wheelSlot - m_wheelStart];
+  NS_ASSERT (tracked.wheelIndex < keys.size ());
+  // move the last key of the slot in place of the removed one
+  if (tracked.wheelIndex + 1 < keys.size ())
+    {
+      uint64_t moved = keys.back ();
+      keys[tracked.wheelIndex] = moved;
+      m_trackedPackets.find (moved)->second.wheelIndex = tracked.wheelIndex;
+    }
+  keys.pop_back ();
+  // the empty slots at the front are dropped by the periodic check
+  while (!m_wheel.empty () && m_wheel.back ().empty ())
+    {
+      m_wheel.pop_back ();
+    }
+}
+
+void
+FlowMonitor::EraseTrackedPacket (TrackedPacketMap::iterator tracked)
+{
+  RemoveFromWheel (tracked->second);
+  m_trackedPackets.erase (tracked);
+}
+
+void
+FlowMonitor::NotifyLost (uint64_t key)
+{
+  FlowId flowId = key >> 32;
+  FlowStatsContainerI flow = m_flowStats.find (flowId);
+  NS_ASSERT (flow != m_flowStats.end ());
+  flow->second.lostPackets++;
+  if (m_stream)
+    {
+      GetIntervalStatsForFlow (flowId).lostPackets++;
+    }
+}
+
+void
+FlowMonitor::EvictOldestPacket ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_wheel.empty () && m_wheel.front ().empty ())
+    {
+      m_wheel.pop_front ();
+      m_wheelStart++;
+    }
+  if (m_wheel.empty ())
+    {
+      return;
+    }
+  uint64_t key = m_wheel.front ().front ();
+  NS_LOG_DEBUG ("EvictOldestPacket: removing tracked packet (flowId=" << (key >> 32)
+                << ", packetId=" << (key & 0xffffffff) << ").");
+  NotifyLost (key);
+  EraseTrackedPacket (m_trackedPackets.find (key));
+}
+
 
 void
 FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
@@ -146,10 +272,22 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  if (m_maxTrackedPackets > 0 && m_trackedPackets.size () >= m_maxTrackedPackets)
+    {
+      EvictOldestPacket ();
+    }
+  uint64_t key = GetTrackedPacketKey (flowId, packetId);
+  TrackedPacketMap::iterator previous = m_trackedPackets.find (key);
+  if (previous != m_trackedPackets.end ())
+    {
+      // tracked again from now on
+      RemoveFromWheel (previous->second);
+    }
+  TrackedPacket &tracked = m_trackedPackets[key];
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
+  AddToWheel (key, tracked, now.GetTimeStep () / PERIODIC_CHECK_INTERVAL.GetTimeStep ());
   NS_LOG_DEBUG ("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId=" << packetId
                                                                 << ").");
 
@@ -163,6 +301,13 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       stats.timeFirstTxPacket = now;
     }
   stats.timeLastTxPacket = now;
+
+  if (m_stream)
+    {
+      IntervalStats &interval = GetIntervalStatsForFlow (flowId);
+      interval.txBytes += packetSize;
+      interval.txPackets++;
+    }
 }
 
 
@@ -175,8 +320,7 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
       NS_LOG_DEBUG ("FlowMonitor not enabled; returning");
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetTrackedPacketKey (flowId, packetId));
   if (tracked == m_trackedPackets.end ())
     {
       NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
@@ -201,7 +345,7 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
       NS_LOG_DEBUG ("FlowMonitor not enabled; returning");
       return;
     }
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetTrackedPacketKey (flowId, packetId));
   if (tracked == m_trackedPackets.end ())
     {
       NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
@@ -215,25 +359,28 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
 
   FlowStats &stats = GetStatsForFlow (flowId);
   stats.delaySum += delay;
-  stats.delayHistogram.AddValue (delay.GetSeconds ());
+  stats.delaySketch.AddValue (delay.GetSeconds ());
+  if (m_enableHistograms)
+    {
+      stats.delayHistogram.AddValue (delay.GetSeconds ());
+    }
   if (stats.rxPackets > 0 )
     {
-      Time jitter = stats.lastDelay - delay;
-      if (jitter > Seconds (0))
+      Time jitter = stats.lastDelay > delay ? stats.lastDelay - delay : delay - stats.lastDelay;
+      stats.jitterSum += jitter;
+      stats.jitterSketch.AddValue (jitter.GetSeconds ());
+      if (m_enableHistograms)
         {
-          stats.jitterSum += jitter;
           stats.jitterHistogram.AddValue (jitter.GetSeconds ());
         }
-      else 
-        {
-          stats.jitterSum -= jitter;
-          stats.jitterHistogram.AddValue (-jitter.GetSeconds ());
-        }
     }
   stats.lastDelay = delay;
 
   stats.rxBytes += packetSize;
-  stats.packetSizeHistogram.AddValue ((double) packetSize);
+  if (m_enableHistograms)
+    {
+      stats.packetSizeHistogram.AddValue ((double) packetSize);
+    }
   stats.rxPackets++;
   if (stats.rxPackets == 1)
     {
@@ -243,7 +390,7 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     {
       // measure possible flow interruptions
       Time interArrivalTime = now - stats.timeLastRxPacket;
-      if (interArrivalTime > m_flowInterruptionsMinTime)
+      if (m_enableHistograms && interArrivalTime > m_flowInterruptionsMinTime)
         {
           stats.flowInterruptionsHistogram.AddValue (interArrivalTime.GetSeconds ());
         }
@@ -251,10 +398,18 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
   stats.timeLastRxPacket = now;
   stats.timesForwarded += tracked->second.timesForwarded;
 
+  if (m_stream)
+    {
+      IntervalStats &interval = GetIntervalStatsForFlow (flowId);
+      interval.rxBytes += packetSize;
+      interval.rxPackets++;
+      interval.delaySketch.AddValue (delay.GetSeconds ());
+    }
+
   NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
                 << flowId << ", packetId=" << packetId << ").");
 
-  m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
+  EraseTrackedPacket (tracked); // we don't need to track this packet anymore
 }
 
 void
@@ -272,6 +427,10 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
 
   FlowStats &stats = GetStatsForFlow (flowId);
   stats.lostPackets++;
+  if (m_stream)
+    {
+      GetIntervalStatsForFlow (flowId).lostPackets++;
+    }
   if (stats.packetsDropped.size () < reasonCode + 1)
     {
       stats.packetsDropped.resize (reasonCode + 1, 0);
@@ -281,14 +440,14 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
   stats.bytesDropped[reasonCode] += packetSize;
   NS_LOG_DEBUG ("++stats.packetsDropped[" << reasonCode<< "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetTrackedPacketKey (flowId, packetId));
   if (tracked != m_trackedPackets.end ())
     {
       // we don't need to track this packet anymore
       // FIXME: this will not necessarily be true with broadcast/multicast
       NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
                     << flowId << ", packetId=" << packetId << ").");
-      m_trackedPackets.erase (tracked);
+      EraseTrackedPacket (tracked);
     }
 }
 
@@ -311,12 +470,10 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
       if (now - iter->second.lastSeenTime >= maxDelay)
         {
           // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
+          NotifyLost (iter->first);
 
           // we won't track it anymore
-          m_trackedPackets.erase (iter++);
+          EraseTrackedPacket (iter++);
         }
       else
         {
@@ -334,10 +491,80 @@ FlowMonitor::CheckForLostPackets ()
 void
 FlowMonitor::PeriodicCheckForLostPackets ()
 {
-  CheckForLostPackets ();
+  NS_LOG_FUNCTION (this);
+  // Same as CheckForLostPackets (), but only the packets of the wheel
+  // slots which started at least m_maxPerHopDelay ago may be lost.
+  Time now = Simulator::Now ();
+  int64_t interval = PERIODIC_CHECK_INTERVAL.GetTimeStep ();
+  int64_t limit = (now - m_maxPerHopDelay).GetTimeStep ();
+  while (!m_wheel.empty () && limit >= 0 && m_wheelStart * interval <= limit)
+    {
+      std::vector<uint64_t> keys;
+      keys.swap (m_wheel.front ());
+      m_wheel.pop_front ();
+      m_wheelStart++;
+      for (std::vector<uint64_t>::const_iterator key = keys.begin (); key != keys.end (); key++)
+        {
+          TrackedPacketMap::iterator tracked = m_trackedPackets.find (*key);
+          NS_ASSERT (tracked != m_trackedPackets.end ());
+          if (now - tracked->second.lastSeenTime >= m_maxPerHopDelay)
+            {
+              // the key is not in the wheel anymore
+              NotifyLost (*key);
+              m_trackedPackets.erase (tracked);
+            }
+          else
+            {
+              // check it again once it was not seen for m_maxPerHopDelay
+              int64_t slot = tracked->second.lastSeenTime.GetTimeStep () / interval;
+              AddToWheel (*key, tracked->second, std::max (slot, limit / interval + 1));
+            }
+        }
+    }
   Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
 }
 
+void
+FlowMonitor::EnableStreaming (Ptr<OutputStreamWrapper> stream, Time interval)
+{
+  NS_LOG_FUNCTION (this << stream << interval.GetSeconds ());
+  NS_ASSERT_MSG (!stream || interval.IsStrictlyPositive (), "The streaming interval must be positive");
+  Simulator::Cancel (m_streamEvent);
+  m_intervalStats.clear ();
+  m_stream = stream;
+  m_streamInterval = interval;
+  if (m_stream)
+    {
+      *m_stream->GetStream () << "# time flowId txPackets txBytes rxPackets rxBytes lostPackets "
+                              << "delayMean delayP50 delayP99" << std::endl;
+      m_streamEvent = Simulator::Schedule (m_streamInterval, &FlowMonitor::StreamIntervalStats, this);
+    }
+}
+
+void
+FlowMonitor::StreamIntervalStats ()
+{
+  NS_LOG_FUNCTION (this);
+  std::ostream &os = *m_stream->GetStream ();
+  double now = Simulator::Now ().GetSeconds ();
+  for (std::map<FlowId, IntervalStats>::const_iterator iter = m_intervalStats.begin ();
+       iter != m_intervalStats.end (); iter++)
+    {
+      const IntervalStats &stats = iter->second;
+      os << now << " " << iter->first
+         << " " << stats.txPackets << " " << stats.txBytes
+         << " " << stats.rxPackets << " " << stats.rxBytes
+         << " " << stats.lostPackets
+         << " " << stats.delaySketch.GetMean ()
+         << " " << stats.delaySketch.GetQuantile (0.5)
+         << " " << stats.delaySketch.GetQuantile (0.99) << "\n";
+    }
+  os.flush ();
+  // only the flows active during the next interval will be kept
+  m_intervalStats.clear ();
+  m_streamEvent = Simulator::Schedule (m_streamInterval, &FlowMonitor::StreamIntervalStats, this);
+}
+
 void
 FlowMonitor::NotifyConstructionCompleted ()
 {
@@ -468,6 +695,8 @@ FlowMonitor::SerializeToXmlStream (std::ostream &os, uint16_t indent, bool enabl
           flowI->second.jitterHistogram.SerializeToXmlStream (os, indent, "jitterHistogram");
           flowI->second.packetSizeHistogram.SerializeToXmlStream (os, indent, "packetSizeHistogram");
           flowI->second.flowInterruptionsHistogram.SerializeToXmlStream (os, indent, "flowInterruptionsHistogram");
+          flowI->second.delaySketch.SerializeToXmlStream (os, indent, "delayQuantiles");
+          flowI->second.jitterSketch.SerializeToXmlStream (os, indent, "jitterQuantiles");
         }
       indent -= 2;
 
@@ -23,15 +23,21 @@
 
 #include <vector>
 #include <map>
+#include <deque>
+#include <unordered_map>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
 #include "ns3/flow-probe.h"
 #include "ns3/flow-classifier.h"
 #include "ns3/histogram.h"
+#include "ns3/quantile-sketch.h"
+#include "ns3/output-stream-wrapper.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 
+class FlowMonitorWheelTestCase;
+
 namespace ns3 {
 
 /**
@@ -46,9 +52,18 @@ namespace ns3 {
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * The memory used by the FlowMonitor can be bounded for large
+ * simulations: the fixed-bin histograms can be disabled (the delay and
+ * jitter quantiles are always estimated by compact sketches), the
+ * number of packets tracked in flight can be limited, and the
+ * statistics can be streamed periodically while the simulation runs
+ * (see EnableStreaming) instead of only serialized at the end.
  */
 class FlowMonitor : public Object
 {
+  /// allow FlowMonitorWheelTestCase to check the timing wheel
+  friend class ::FlowMonitorWheelTestCase;
+
 public:
 
   /// \brief Structure that represents the measured metrics of an individual packet flow
@@ -110,6 +125,11 @@ public:
     /// forwarded, summed for all received packets in the flow
     uint32_t timesForwarded;
 
+    /// Quantiles of the packet delays (in seconds)
+    QuantileSketch delaySketch;
+    /// Quantiles of the packet jitters (in seconds)
+    QuantileSketch jitterSketch;
+
     /// Histogram of the packet delays
     Histogram delayHistogram;
     /// Histogram of the packet jitters
@@ -212,6 +232,16 @@ public:
   /// \param maxDelay the max delay for a packet
   void CheckForLostPackets (Time maxDelay);
 
+  /// Write the statistics of the flows active during each interval to
+  /// a stream, while the simulation runs.  Each line holds the end of
+  /// the interval (in seconds), the flow identifier, the packets and
+  /// bytes transmitted and received, the packets lost, and the mean,
+  /// median and 99th percentile of the delays (in seconds) of the
+  /// packets received during the interval.
+  /// \param stream the output stream, or 0 to stop streaming
+  /// \param interval the duration of the intervals
+  void EnableStreaming (Ptr<OutputStreamWrapper> stream, Time interval);
+
   // --- methods to get the results ---
 
   /// Container: FlowId, FlowStats
@@ -272,15 +302,35 @@ private:
     Time firstSeenTime; //!< absolute time when the packet was first seen by a probe
     Time lastSeenTime; //!< absolute time when the packet was last seen by a probe
     uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
+    int64_t wheelSlot; //!< check interval of the timing wheel slot holding the packet
+    uint32_t wheelIndex; //!< index of the packet in its timing wheel slot
   };
 
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
 
-  /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  /// Structure to represent the statistics of a flow during a streaming interval
+  struct IntervalStats
+  {
+    uint64_t txBytes; //!< bytes transmitted during the interval
+    uint64_t rxBytes; //!< bytes received during the interval
+    uint32_t txPackets; //!< packets transmitted during the interval
+    uint32_t rxPackets; //!< packets received during the interval
+    uint32_t lostPackets; //!< packets lost during the interval
+    QuantileSketch delaySketch; //!< delays of the packets received during the interval
+  };
+
+  /// (FlowId,PacketId) --> TrackedPacket, with the key (FlowId << 32) | PacketId
+  typedef std::unordered_map<uint64_t, TrackedPacket> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
+  /// Timing wheel: slot i holds the keys of the tracked packets
+  /// to check for loss after the check interval m_wheelStart + i.
+  /// Each tracked packet is in exactly one slot, at the position
+  /// recorded in its TrackedPacket.
+  std::deque<std::vector<uint64_t> > m_wheel;
+  int64_t m_wheelStart; //!< Check interval of the first slot of the wheel
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
+  uint32_t m_maxTrackedPackets; //!< Maximum number of packets tracked in flight (0 for no limit)
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
 
   // note: this is needed only for serialization
@@ -294,6 +344,12 @@ private:
   double m_packetSizeBinWidth;  //!< packet size bin width (for histograms)
   double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
   Time m_flowInterruptionsMinTime; //!< Flow interruptions minimum time
+  bool m_enableHistograms;  //!< Fill the fixed-bin histograms
+
+  std::map<FlowId, IntervalStats> m_intervalStats; //!< Statistics of the flows active in the streaming interval
+  Ptr<OutputStreamWrapper> m_stream; //!< Streaming output
+  Time m_streamInterval;    //!< Streaming interval
+  EventId m_streamEvent;    //!< Next streaming event
 
   /// Get the stats for a given flow
   /// \param flowId the Flow identification
@@ -302,6 +358,35 @@ private:
 
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
+
+  /// Get the statistics of a given flow during the streaming interval
+  /// \param flowId the Flow identification
+  /// \returns the interval stats of the flow
+  IntervalStats& GetIntervalStatsForFlow (FlowId flowId);
+
+  /// Account a tracked packet as lost
+  /// \param key the key of the tracked packet
+  void NotifyLost (uint64_t key);
+
+  /// Add a tracked packet to the timing wheel
+  /// \param key the key of the tracked packet
+  /// \param tracked the tracked packet
+  /// \param slot the check interval when the packet may be lost
+  void AddToWheel (uint64_t key, TrackedPacket &tracked, int64_t slot);
+
+  /// Remove a tracked packet from the timing wheel
+  /// \param tracked the tracked packet
+  void RemoveFromWheel (const TrackedPacket &tracked);
+
+  /// Stop tracking a packet, removing it from the timing wheel
+  /// \param tracked the tracked packet
+  void EraseTrackedPacket (TrackedPacketMap::iterator tracked);
+
+  /// Account the oldest tracked packet as lost, to bound the number of tracked packets
+  void EvictOldestPacket ();
+
+  /// Write the statistics of the streaming interval and schedule the next one
+  void StreamIntervalStats ();
 };
 
 
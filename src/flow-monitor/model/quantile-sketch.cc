@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <cmath>
+#include <algorithm>
+
+#include "quantile-sketch.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("QuantileSketch");
+
+QuantileSketch::QuantileSketch (uint8_t precision)
+  : m_zeros (0),
+    m_count (0),
+    m_sum (0),
+    m_min (0),
+    m_max (0),
+    m_precision (precision)
+{
+  NS_ASSERT_MSG (precision <= 16, "The precision of a QuantileSketch is at most 16 bits");
+}
+
+int32_t
+QuantileSketch::GetIndex (double value) const
+{
+  // value = mantissa * 2^exponent, with mantissa in [0.5, 1)
+  int exponent;
+  double mantissa = std::frexp (value, &exponent);
+  int32_t buckets = 1 << m_precision;
+  int32_t sub = static_cast<int32_t> ((2 * mantissa - 1) * buckets);
+  return exponent * buckets + std::min (sub, buckets - 1);
+}
+
+double
+QuantileSketch::GetValue (int32_t index) const
+{
+  int32_t buckets = 1 << m_precision;
+  int32_t exponent = index >= 0 ? index / buckets : -((buckets - 1 - index) / buckets);
+  int32_t sub = index - exponent * buckets;
+  // the middle of [2^(exponent-1) (1 + sub/buckets), 2^(exponent-1) (1 + (sub+1)/buckets))
+  return std::ldexp (1 + (sub + 0.5) / buckets, exponent - 1);
+}
+
+void
+QuantileSketch::AddToBucket (int32_t index, uint64_t count)
+{
+  Buckets::iterator it = std::lower_bound (m_buckets.begin (), m_buckets.end (),
+                                           std::make_pair (index, uint64_t (0)));
+  if (it != m_buckets.end () && it->first == index)
+    {
+      it->second += count;
+    }
+  else
+    {
+      m_buckets.insert (it, std::make_pair (index, count));
+    }
+}
+
+void
+QuantileSketch::AddValue (double value)
+{
+  NS_LOG_FUNCTION (this << value);
+  if (m_count == 0 || value < m_min)
+    {
+      m_min = value;
+    }
+  if (m_count == 0 || value > m_max)
+    {
+      m_max = value;
+    }
+  m_count++;
+  m_sum += value;
+  if (value <= 0)
+    {
+      m_zeros++;
+    }
+  else
+    {
+      AddToBucket (GetIndex (value), 1);
+    }
+}
+
+void
+QuantileSketch::Merge (const QuantileSketch &other)
+{
+  NS_ASSERT_MSG (m_precision == other.m_precision, "Only sketches with the same precision can be merged");
+  if (other.m_count == 0)
+    {
+      return;
+    }
+  if (m_count == 0 || other.m_min < m_min)
+    {
+      m_min = other.m_min;
+    }
+  if (m_count == 0 || other.m_max > m_max)
+    {
+      m_max = other.m_max;
+    }
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+  m_zeros += other.m_zeros;
+  for (Buckets::const_iterator it = other.m_buckets.begin (); it != other.m_buckets.end (); it++)
+    {
+      AddToBucket (it->first, it->second);
+    }
+}
+
+void
+QuantileSketch::Clear (void)
+{
+  m_buckets.clear ();
+  m_zeros = 0;
+  m_count = 0;
+  m_sum = 0;
+  m_min = 0;
+  m_max = 0;
+}
+
+uint64_t
+QuantileSketch::GetCount (void) const
+{
+  return m_count;
+}
+
+double
+QuantileSketch::GetMin (void) const
+{
+  return m_min;
+}
+
+double
+QuantileSketch::GetMax (void) const
+{
+  return m_max;
+}
+
+double
+QuantileSketch::GetMean (void) const
+{
+  return m_count ? m_sum / m_count : 0;
+}
+
+double
+QuantileSketch::GetQuantile (double quantile) const
+{
+  if (m_count == 0 || quantile <= 0)
+    {
+      return m_min;
+    }
+  if (quantile >= 1)
+    {
+      return m_max;
+    }
+  // the position of the quantile among the sorted values
+  double rank = quantile * (m_count - 1);
+  uint64_t count = m_zeros;
+  double value = 0;
+  for (Buckets::const_iterator it = m_buckets.begin (); rank >= count && it != m_buckets.end (); it++)
+    {
+      count += it->second;
+      value = GetValue (it->first);
+    }
+  // the extreme buckets may be much larger than the extreme values
+  return std::max (m_min, std::min (m_max, value));
+}
+
+uint32_t
+QuantileSketch::GetNBuckets (void) const
+{
+  return m_buckets.size () + (m_zeros ? 1 : 0);
+}
+
+void
+QuantileSketch::SerializeToXmlStream (std::ostream &os, uint16_t indent, std::string elementName) const
+{
+  os << std::string (indent, ' ') << "<" << elementName
+     << " count=\"" << m_count << "\""
+     << " min=\"" << GetMin () << "\""
+     << " mean=\"" << GetMean () << "\""
+     << " p50=\"" << GetQuantile (0.5) << "\""
+     << " p90=\"" << GetQuantile (0.9) << "\""
+     << " p99=\"" << GetQuantile (0.99) << "\""
+     << " max=\"" << GetMax () << "\""
+     << " />\n";
+}
+
+
+} // namespace ns3
@@ -0,0 +1,299 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <sstream>
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowProbe whose packet events are reported by the test
+ */
+class FlowMonitorTestProbe : public FlowProbe
+{
+public:
+  /**
+   * Constructor
+   * \param monitor the FlowMonitor this probe is associated with
+   */
+  FlowMonitorTestProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor lost packets Test
+ */
+class FlowMonitorLostPacketsTestCase : public ns3::TestCase {
+public:
+  FlowMonitorLostPacketsTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Check the statistics of a flow
+   * \param monitor the FlowMonitor
+   * \param flowId the flow identification
+   * \param rxPackets the expected number of received packets
+   * \param lostPackets the expected number of lost packets
+   */
+  void CheckFlow (Ptr<FlowMonitor> monitor, FlowId flowId, uint32_t rxPackets, uint32_t lostPackets);
+};
+
+FlowMonitorLostPacketsTestCase::FlowMonitorLostPacketsTestCase ()
+  : ns3::TestCase ("FlowMonitor lost packets")
+{
+}
+
+void
+FlowMonitorLostPacketsTestCase::CheckFlow (Ptr<FlowMonitor> monitor, FlowId flowId,
+                                           uint32_t rxPackets, uint32_t lostPackets)
+{
+  const FlowMonitor::FlowStats &stats = monitor->GetFlowStats ().find (flowId)->second;
+  NS_TEST_EXPECT_MSG_EQ (stats.rxPackets, rxPackets, "Unexpected received packets at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ (stats.lostPackets, lostPackets, "Unexpected lost packets at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+FlowMonitorLostPacketsTestCase::DoRun (void)
+{
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  monitor->SetAttribute ("MaxPerHopDelay", TimeValue (Seconds (2.5)));
+  monitor->SetAttribute ("EnableHistograms", BooleanValue (false));
+  Ptr<FlowProbe> probe = CreateObject<FlowMonitorTestProbe> (monitor);
+  monitor->StartRightNow ();
+
+  // the losses are checked every second: packet 1 is lost at 3 s, packet 3 at 5 s
+  Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportFirstTx, monitor, probe, 1, 1, 100);
+  Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportFirstTx, monitor, probe, 1, 2, 100);
+  Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportFirstTx, monitor, probe, 1, 3, 100);
+  Simulator::Schedule (Seconds (0.5), &FlowMonitor::ReportLastRx, monitor, probe, 1, 2, 100);
+  Simulator::Schedule (Seconds (2.0), &FlowMonitor::ReportForwarding, monitor, probe, 1, 3, 100);
+  Simulator::Schedule (Seconds (2.5), &FlowMonitorLostPacketsTestCase::CheckFlow, this, monitor, 1, 1, 0);
+  Simulator::Schedule (Seconds (3.5), &FlowMonitorLostPacketsTestCase::CheckFlow, this, monitor, 1, 1, 1);
+  Simulator::Schedule (Seconds (4.5), &FlowMonitorLostPacketsTestCase::CheckFlow, this, monitor, 1, 1, 1);
+  Simulator::Schedule (Seconds (5.5), &FlowMonitorLostPacketsTestCase::CheckFlow, this, monitor, 1, 1, 2);
+  // a lost packet is not tracked anymore
+  Simulator::Schedule (Seconds (6.0), &FlowMonitor::ReportLastRx, monitor, probe, 1, 1, 100);
+  Simulator::Schedule (Seconds (6.5), &FlowMonitorLostPacketsTestCase::CheckFlow, this, monitor, 1, 1, 2);
+
+  // with at most two packets in flight, packet 1 is lost when packet 3 is sent
+  Ptr<FlowMonitor> bounded = CreateObject<FlowMonitor> ();
+  bounded->SetAttribute ("MaxTrackedPackets", UintegerValue (2));
+  Ptr<FlowProbe> boundedProbe = CreateObject<FlowMonitorTestProbe> (bounded);
+  bounded->StartRightNow ();
+  Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportFirstTx, bounded, boundedProbe, 1, 1, 100);
+  Simulator::Schedule (Seconds (0.2), &FlowMonitor::ReportFirstTx, bounded, boundedProbe, 1, 2, 100);
+  Simulator::Schedule (Seconds (0.3), &FlowMonitor::ReportFirstTx, bounded, boundedProbe, 1, 3, 100);
+  Simulator::Schedule (Seconds (0.4), &FlowMonitor::ReportLastRx, bounded, boundedProbe, 1, 1, 100);
+  Simulator::Schedule (Seconds (0.4), &FlowMonitor::ReportLastRx, bounded, boundedProbe, 1, 2, 100);
+  Simulator::Schedule (Seconds (0.4), &FlowMonitor::ReportLastRx, bounded, boundedProbe, 1, 3, 100);
+  Simulator::Schedule (Seconds (0.5), &FlowMonitorLostPacketsTestCase::CheckFlow, this, bounded, 1, 2, 1);
+
+  Simulator::Stop (Seconds (7));
+  Simulator::Run ();
+
+  const FlowMonitor::FlowStats &stats = monitor->GetFlowStats ().find (1)->second;
+  NS_TEST_EXPECT_MSG_EQ (stats.delayHistogram.GetNBins (), 0, "The histograms must not be filled");
+  NS_TEST_EXPECT_MSG_EQ (stats.delaySketch.GetCount (), 1, "The delays must be in the sketch");
+  NS_TEST_EXPECT_MSG_EQ_TOL (stats.delaySketch.GetMax (), 0.4, 1e-9, "Unexpected delay");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor streaming Test
+ */
+class FlowMonitorStreamingTestCase : public ns3::TestCase {
+public:
+  FlowMonitorStreamingTestCase ();
+  virtual void DoRun (void);
+};
+
+FlowMonitorStreamingTestCase::FlowMonitorStreamingTestCase ()
+  : ns3::TestCase ("FlowMonitor streaming")
+{
+}
+
+void
+FlowMonitorStreamingTestCase::DoRun (void)
+{
+  std::ostringstream output;
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  Ptr<FlowProbe> probe = CreateObject<FlowMonitorTestProbe> (monitor);
+  monitor->EnableStreaming (Create<OutputStreamWrapper> (&output), Seconds (1));
+  monitor->StartRightNow ();
+
+  Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportFirstTx, monitor, probe, 1, 1, 100);
+  Simulator::Schedule (Seconds (0.3), &FlowMonitor::ReportLastRx, monitor, probe, 1, 1, 100);
+  Simulator::Schedule (Seconds (0.5), &FlowMonitor::ReportFirstTx, monitor, probe, 2, 1, 200);
+  Simulator::Schedule (Seconds (1.5), &FlowMonitor::ReportFirstTx, monitor, probe, 2, 2, 200);
+  Simulator::Schedule (Seconds (1.5), &FlowMonitor::ReportDrop, monitor, probe, 2, 2, 200, 0);
+  Simulator::Stop (Seconds (3.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::string expected =
+    "# time flowId txPackets txBytes rxPackets rxBytes lostPackets delayMean delayP50 delayP99\n"
+    "1 1 1 100 1 100 0 0.2 0.2 0.2\n"
+    "1 2 1 200 0 0 0 0 0 0\n"
+    "2 2 1 200 0 0 1 0 0 0\n";
+  NS_TEST_EXPECT_MSG_EQ (output.str (), expected, "Unexpected streamed statistics");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor timing wheel Test
+ *
+ * The packets received, dropped or evicted leave the timing wheel at
+ * once, so that the wheel never holds more keys than packets in flight.
+ */
+class FlowMonitorWheelTestCase : public ns3::TestCase {
+public:
+  FlowMonitorWheelTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Check that the timing wheel holds exactly the tracked packets
+   * \param monitor the FlowMonitor
+   * \param maxTracked the maximum expected number of tracked packets
+   */
+  void CheckWheel (Ptr<FlowMonitor> monitor, uint32_t maxTracked);
+};
+
+FlowMonitorWheelTestCase::FlowMonitorWheelTestCase ()
+  : ns3::TestCase ("FlowMonitor timing wheel")
+{
+}
+
+void
+FlowMonitorWheelTestCase::CheckWheel (Ptr<FlowMonitor> monitor, uint32_t maxTracked)
+{
+  uint32_t keys = 0;
+  for (uint32_t i = 0; i < monitor->m_wheel.size (); i++)
+    {
+      for (uint32_t j = 0; j < monitor->m_wheel[i].size (); j++)
+        {
+          keys++;
+          FlowMonitor::TrackedPacketMap::const_iterator tracked =
+            monitor->m_trackedPackets.find (monitor->m_wheel[i][j]);
+          NS_TEST_ASSERT_MSG_EQ ((tracked != monitor->m_trackedPackets.end ()), true,
+                                 "Key of an untracked packet in the wheel at " << Simulator::Now ().GetSeconds ());
+          NS_TEST_EXPECT_MSG_EQ (tracked->second.wheelSlot, monitor->m_wheelStart + i, "Unexpected wheel slot");
+          NS_TEST_EXPECT_MSG_EQ (tracked->second.wheelIndex, j, "Unexpected wheel index");
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (keys, monitor->m_trackedPackets.size (),
+                         "Wheel and tracked packets differ at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (keys, maxTracked,
+                               "Too many packets in the wheel at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+FlowMonitorWheelTestCase::DoRun (void)
+{
+  // 1000 packets received after 5 ms, one every 2 ms: at most 3 in flight,
+  // well below the default MaxPerHopDelay of 10 s
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  Ptr<FlowProbe> probe = CreateObject<FlowMonitorTestProbe> (monitor);
+  monitor->StartRightNow ();
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Time tx = MilliSeconds (1 + 2 * i);
+      Simulator::Schedule (tx, &FlowMonitor::ReportFirstTx, monitor, probe, 1, i, 100);
+      if (i % 100 == 99)
+        {
+          // dropped instead of received
+          Simulator::Schedule (tx + MilliSeconds (5), &FlowMonitor::ReportDrop, monitor, probe, 1, i, 100, 0);
+        }
+      else
+        {
+          Simulator::Schedule (tx + MilliSeconds (5), &FlowMonitor::ReportLastRx, monitor, probe, 1, i, 100);
+        }
+      Simulator::Schedule (tx + MicroSeconds (500), &FlowMonitorWheelTestCase::CheckWheel, this, monitor, 3);
+    }
+  // a packet reported twice is tracked once
+  Simulator::Schedule (Seconds (2.5), &FlowMonitor::ReportFirstTx, monitor, probe, 2, 1, 100);
+  Simulator::Schedule (Seconds (3.5), &FlowMonitor::ReportFirstTx, monitor, probe, 2, 1, 100);
+  Simulator::Schedule (Seconds (3.6), &FlowMonitorWheelTestCase::CheckWheel, this, monitor, 1);
+  Simulator::Schedule (Seconds (3.7), &FlowMonitor::ReportLastRx, monitor, probe, 2, 1, 100);
+  Simulator::Schedule (Seconds (3.8), &FlowMonitorWheelTestCase::CheckWheel, this, monitor, 0);
+
+  // with at most 10 packets in flight, the wheel holds at most 10 keys
+  Ptr<FlowMonitor> bounded = CreateObject<FlowMonitor> ();
+  bounded->SetAttribute ("MaxTrackedPackets", UintegerValue (10));
+  Ptr<FlowProbe> boundedProbe = CreateObject<FlowMonitorTestProbe> (bounded);
+  bounded->StartRightNow ();
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Time tx = MilliSeconds (30 * i);
+      Simulator::Schedule (tx, &FlowMonitor::ReportFirstTx, bounded, boundedProbe, 1, i, 100);
+      Simulator::Schedule (tx + MilliSeconds (1), &FlowMonitorWheelTestCase::CheckWheel, this, bounded, 10);
+    }
+
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (monitor->m_wheel.size (), 0, "Slots left in the wheel");
+  const FlowMonitor::FlowStats &stats = monitor->GetFlowStats ().find (1)->second;
+  NS_TEST_EXPECT_MSG_EQ (stats.rxPackets, 990, "Unexpected received packets");
+  NS_TEST_EXPECT_MSG_EQ (stats.lostPackets, 10, "Unexpected lost packets");
+  const FlowMonitor::FlowStats &boundedStats = bounded->GetFlowStats ().find (1)->second;
+  NS_TEST_EXPECT_MSG_EQ (boundedStats.lostPackets, 90, "Unexpected evicted packets");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor TestSuite
+ */
+class FlowMonitorTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTestSuite ();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite ()
+  : TestSuite ("flow-monitor", UNIT)
+{
+  AddTestCase (new FlowMonitorLostPacketsTestCase, TestCase::QUICK);
+  AddTestCase (new FlowMonitorStreamingTestCase, TestCase::QUICK);
+  AddTestCase (new FlowMonitorWheelTestCase, TestCase::QUICK);
+}
+
+static FlowMonitorTestSuite g_FlowMonitorTestSuite; //!< Static variable for test initialization
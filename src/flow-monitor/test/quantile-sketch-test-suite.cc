@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "ns3/quantile-sketch.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor QuantileSketch Test
+ */
+class QuantileSketchTestCase : public ns3::TestCase {
+public:
+  QuantileSketchTestCase ();
+  virtual void DoRun (void);
+};
+
+QuantileSketchTestCase::QuantileSketchTestCase ()
+  : ns3::TestCase ("QuantileSketch")
+{
+}
+
+void
+QuantileSketchTestCase::DoRun (void)
+{
+  QuantileSketch empty;
+  NS_TEST_EXPECT_MSG_EQ (empty.GetCount (), 0, "");
+  NS_TEST_EXPECT_MSG_EQ (empty.GetQuantile (0.5), 0, "");
+  NS_TEST_EXPECT_MSG_EQ (empty.GetNBuckets (), 0, "");
+
+  // Testing the relative error of the quantiles
+  QuantileSketch s0;
+  QuantileSketch low;
+  QuantileSketch high;
+  for (int i = 1; i <= 10000; i++)
+    {
+      s0.AddValue (i);
+      if (i <= 5000)
+        {
+          low.AddValue (i);
+        }
+      else
+        {
+          high.AddValue (i);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (s0.GetCount (), 10000, "");
+  NS_TEST_EXPECT_MSG_EQ (s0.GetMin (), 1, "");
+  NS_TEST_EXPECT_MSG_EQ (s0.GetMax (), 10000, "");
+  NS_TEST_EXPECT_MSG_EQ_TOL (s0.GetMean (), 5000.5, 1e-6, "");
+  NS_TEST_EXPECT_MSG_EQ_TOL (s0.GetQuantile (0.5), 5000.5, 5000.5 / 32, "");
+  NS_TEST_EXPECT_MSG_EQ_TOL (s0.GetQuantile (0.9), 9000.1, 9000.1 / 32, "");
+  NS_TEST_EXPECT_MSG_EQ_TOL (s0.GetQuantile (0.99), 9900.01, 9900.01 / 32, "");
+  NS_TEST_EXPECT_MSG_EQ (s0.GetQuantile (0), 1, "");
+  NS_TEST_EXPECT_MSG_EQ (s0.GetQuantile (1), 10000, "");
+  // at most 32 buckets per power of two
+  NS_TEST_EXPECT_MSG_LT (s0.GetNBuckets (), 14 * 32, "");
+
+  // Testing the merge of sketches
+  low.Merge (high);
+  NS_TEST_EXPECT_MSG_EQ (low.GetCount (), s0.GetCount (), "");
+  NS_TEST_EXPECT_MSG_EQ (low.GetNBuckets (), s0.GetNBuckets (), "");
+  NS_TEST_EXPECT_MSG_EQ (low.GetQuantile (0.5), s0.GetQuantile (0.5), "");
+  NS_TEST_EXPECT_MSG_EQ (low.GetQuantile (0.99), s0.GetQuantile (0.99), "");
+
+  // Testing a wide range of values, and the values lower or equal to zero
+  QuantileSketch s1;
+  s1.AddValue (0);
+  s1.AddValue (-1);
+  s1.AddValue (1e-6);
+  s1.AddValue (1e-6);
+  s1.AddValue (1e3);
+  NS_TEST_EXPECT_MSG_EQ (s1.GetNBuckets (), 3, "");
+  NS_TEST_EXPECT_MSG_EQ (s1.GetQuantile (0.25), 0, "");
+  NS_TEST_EXPECT_MSG_EQ_TOL (s1.GetQuantile (0.5), 1e-6, 1e-6 / 32, "");
+  NS_TEST_EXPECT_MSG_EQ (s1.GetQuantile (1), 1e3, "");
+
+  s1.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (s1.GetCount (), 0, "");
+  NS_TEST_EXPECT_MSG_EQ (s1.GetNBuckets (), 0, "");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor QuantileSketch TestSuite
+ */
+class QuantileSketchTestSuite : public TestSuite
+{
+public:
+  QuantileSketchTestSuite ();
+};
+
+QuantileSketchTestSuite::QuantileSketchTestSuite ()
+  : TestSuite ("quantile-sketch", UNIT)
+{
+  AddTestCase (new QuantileSketchTestCase, TestCase::QUICK);
+}
+
+static QuantileSketchTestSuite g_QuantileSketchTestSuite; //!< Static variable for test initialization
@@ -84,6 +84,17 @@ public:
    *
    */
   static void RecomputeRoutingTables (void);
+  /**
+   * \brief Update the routes that were previously installed in a prior call
+   * to PopulateRoutingTables(), RecomputeRoutingTables() or
+   * UpdateRoutingTables(), after a change of the topology.
+   *
+   * Unlike RecomputeRoutingTables(), only the routing tables of the nodes
+   * whose shortest path tree may have changed are recomputed.  This is
+   * what is done on interface events when the
+   * Ipv4GlobalRouting::RespondToInterfaceEvents attribute is set.
+   */
+  static void UpdateRoutingTables (void);
 private:
   /**
    * \brief Assignment operator declared private and not implemented to disallow
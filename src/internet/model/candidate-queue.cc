@@ -49,24 +49,38 @@ operator<< (std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream& 
 operator<< (std::ostream& os, const CandidateQueue& q)
 {
-  typedef CandidateQueue::CandidateList_t List_t;
-  typedef List_t::const_iterator CIter_t;
-  const CandidateQueue::CandidateList_t& list = q.m_candidates;
+  std::vector<CandidateQueue::HeapEntry> entries;
+  for (std::vector<CandidateQueue::HeapEntry>::const_iterator iter = q.m_heap.begin ();
+       iter != q.m_heap.end (); iter++)
+    {
+      std::unordered_map<SPFVertex*, uint64_t>::const_iterator seq = q.m_sequences.find (iter->vertex);
+      if (seq != q.m_sequences.end () && seq->second == iter->sequence)
+        {
+          entries.push_back (*iter);
+        }
+    }
+  // the heap entries in popping order
+  std::sort (entries.begin (), entries.end (), &CandidateQueue::CompareHeapEntry);
+  std::reverse (entries.begin (), entries.end ());
 
   os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
-  for (CIter_t iter = list.begin (); iter != list.end (); iter++)
+  for (std::vector<CandidateQueue::HeapEntry>::const_iterator iter = entries.begin ();
+       iter != entries.end (); iter++)
     {
       os << "<" 
-      << (*iter)->GetVertexId () << ", "
-      << (*iter)->GetDistanceFromRoot () << ", "
-      << (*iter)->GetVertexType () << ">" << std::endl;
+      << iter->vertex->GetVertexId () << ", "
+      << iter->vertex->GetDistanceFromRoot () << ", "
+      << iter->vertex->GetVertexType () << ">" << std::endl;
     }
   os << "*** CandidateQueue End ***";
   return os;
 }
 
 CandidateQueue::CandidateQueue()
-  : m_candidates ()
+  : m_heap (),
+    m_sequences (),
+    m_vertices (),
+    m_nextSequence (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -81,12 +95,41 @@ void
 CandidateQueue::Clear (void)
 {
   NS_LOG_FUNCTION (this);
-  while (!m_candidates.empty ())
+  while (!m_sequences.empty ())
     {
       SPFVertex *p = Pop ();
       delete p;
       p = 0;
     }
+  m_heap.clear ();
+}
+
+void
+CandidateQueue::PushEntry (SPFVertex *vertex)
+{
+  HeapEntry entry;
+  entry.distance = vertex->GetDistanceFromRoot ();
+  entry.network = (vertex->GetVertexType () == SPFVertex::VertexNetwork);
+  entry.sequence = m_nextSequence++;
+  entry.vertex = vertex;
+  m_sequences[vertex] = entry.sequence;
+  m_heap.push_back (entry);
+  std::push_heap (m_heap.begin (), m_heap.end (), &CandidateQueue::CompareHeapEntry);
+}
+
+void
+CandidateQueue::PurgeTop (void)
+{
+  while (!m_heap.empty ())
+    {
+      std::unordered_map<SPFVertex*, uint64_t>::const_iterator seq = m_sequences.find (m_heap.front ().vertex);
+      if (seq != m_sequences.end () && seq->second == m_heap.front ().sequence)
+        {
+          return;
+        }
+      std::pop_heap (m_heap.begin (), m_heap.end (), &CandidateQueue::CompareHeapEntry);
+      m_heap.pop_back ();
+    }
 }
 
 void
@@ -94,24 +137,31 @@ CandidateQueue::Push (SPFVertex *vNew)
 {
   NS_LOG_FUNCTION (this << vNew);
 
-  CandidateList_t::iterator i = std::upper_bound (
-      m_candidates.begin (), m_candidates.end (), vNew,
-      &CandidateQueue::CompareSPFVertex
-      );
-  m_candidates.insert (i, vNew);
+  PushEntry (vNew);
+  // keep the first vertex pushed with a given ID, as Find () did when the
+  // queue was a sorted list
+  m_vertices.insert (std::make_pair (vNew->GetVertexId (), vNew));
 }
 
 SPFVertex *
 CandidateQueue::Pop (void)
 {
   NS_LOG_FUNCTION (this);
-  if (m_candidates.empty ())
+  if (m_heap.empty ())
     {
       return 0;
     }
 
-  SPFVertex *v = m_candidates.front ();
-  m_candidates.pop_front ();
+  SPFVertex *v = m_heap.front ().vertex;
+  std::pop_heap (m_heap.begin (), m_heap.end (), &CandidateQueue::CompareHeapEntry);
+  m_heap.pop_back ();
+  m_sequences.erase (v);
+  std::unordered_map<Ipv4Address, SPFVertex*, Ipv4AddressHash>::iterator i = m_vertices.find (v->GetVertexId ());
+  if (i != m_vertices.end () && i->second == v)
+    {
+      m_vertices.erase (i);
+    }
+  PurgeTop ();
   return v;
 }
 
@@ -119,41 +169,36 @@ SPFVertex *
 CandidateQueue::Top (void) const
 {
   NS_LOG_FUNCTION (this);
-  if (m_candidates.empty ())
+  if (m_heap.empty ())
     {
       return 0;
     }
 
-  return m_candidates.front ();
+  return m_heap.front ().vertex;
 }
 
 bool
 CandidateQueue::Empty (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_candidates.empty ();
+  return m_sequences.empty ();
 }
 
 uint32_t
 CandidateQueue::Size (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_candidates.size ();
+  return m_sequences.size ();
 }
 
 SPFVertex *
 CandidateQueue::Find (const Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this);
-  CandidateList_t::const_iterator i = m_candidates.begin ();
-
-  for (; i != m_candidates.end (); i++)
+  std::unordered_map<Ipv4Address, SPFVertex*, Ipv4AddressHash>::const_iterator i = m_vertices.find (addr);
+  if (i != m_vertices.end ())
     {
-      SPFVertex *v = *i;
-      if (v->GetVertexId () == addr)
-        {
-          return v;
-        }
+      return i->second;
     }
 
   return 0;
@@ -164,11 +209,35 @@ CandidateQueue::Reorder (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_candidates.sort (&CandidateQueue::CompareSPFVertex);
+  std::vector<HeapEntry> heap;
+  heap.reserve (m_sequences.size ());
+  for (std::vector<HeapEntry>::iterator i = m_heap.begin (); i != m_heap.end (); i++)
+    {
+      std::unordered_map<SPFVertex*, uint64_t>::const_iterator seq = m_sequences.find (i->vertex);
+      if (seq != m_sequences.end () && seq->second == i->sequence)
+        {
+          i->distance = i->vertex->GetDistanceFromRoot ();
+          i->network = (i->vertex->GetVertexType () == SPFVertex::VertexNetwork);
+          heap.push_back (*i);
+        }
+    }
+  std::make_heap (heap.begin (), heap.end (), &CandidateQueue::CompareHeapEntry);
+  m_heap.swap (heap);
   NS_LOG_LOGIC ("After reordering the CandidateQueue");
   NS_LOG_LOGIC (*this);
 }
 
+void
+CandidateQueue::Update (SPFVertex *vertex)
+{
+  NS_LOG_FUNCTION (this << vertex);
+  NS_ASSERT_MSG (m_sequences.find (vertex) != m_sequences.end (), "Vertex not in the candidate queue");
+
+  // the former entry of the vertex is discarded when it reaches the top
+  PushEntry (vertex);
+  PurgeTop ();
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
@@ -197,4 +266,20 @@ CandidateQueue::CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2)
   return result;
 }
 
+bool
+CandidateQueue::CompareHeapEntry (const HeapEntry &e1, const HeapEntry &e2)
+{
+  // std::push_heap () and std::pop_heap () keep the greatest entry on top:
+  // an entry is "less" than another if it is popped after it
+  if (e1.distance != e2.distance)
+    {
+      return e1.distance > e2.distance;
+    }
+  if (e1.network != e2.network)
+    {
+      return e2.network;
+    }
+  return e1.sequence > e2.sequence;
+}
+
 } // namespace ns3
@@ -22,7 +22,8 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <vector>
+#include <unordered_map>
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -47,6 +48,14 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple 
  * enhanced priority queue.
+ *
+ * The queue is a binary heap of the vertices, together with a hash table
+ * of the vertices by vertex ID, so that Push (), Pop () and Update () take
+ * logarithmic time and Find () constant time.  When the distance of a
+ * vertex decreases, Update () pushes a new heap entry and the former one is
+ * discarded lazily, when it reaches the top of the heap.  Vertices having
+ * the same distance and type are popped in the order they were pushed (or
+ * last updated), as the SPF calculation expects.
  */
 class CandidateQueue
 {
@@ -154,6 +163,16 @@ public:
  */
   void Reorder (void);
 
+/**
+ * @brief Restore the priority of a vertex after its distance from the root
+ * decreased during the routing calculations.
+ * On completion, the vertex is ordered after the vertices of the queue
+ * having the same distance and type.
+ * @see SPFVertex
+ * @param vertex The vertex, which must be in the queue.
+ */
+  void Update (SPFVertex *vertex);
+
 private:
 /**
  * Candidate Queue copy construction is disallowed (not implemented) to 
@@ -184,8 +203,43 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-  CandidateList_t m_candidates;  //!< SPFVertex candidates
+  /**
+   * \brief An entry of the heap.
+   *
+   * The sort key of the vertex is copied into the entry, so that the heap
+   * stays consistent when the distance of the vertex is later changed.
+   */
+  struct HeapEntry
+  {
+    uint32_t distance; //!< distance of the vertex from the root when pushed
+    bool network;      //!< whether the vertex is a network vertex
+    uint64_t sequence; //!< order of the push, to break ties
+    SPFVertex *vertex; //!< the vertex
+  };
+
+  /**
+   * \brief Compare two heap entries
+   * \param e1 first operand
+   * \param e2 second operand
+   * \return True if e1 should be popped after e2; false otherwise
+   */
+  static bool CompareHeapEntry (const HeapEntry &e1, const HeapEntry &e2);
+
+  /**
+   * \brief Add a heap entry for a vertex
+   * \param vertex the vertex
+   */
+  void PushEntry (SPFVertex *vertex);
+
+  /**
+   * \brief Pop the discarded entries from the top of the heap
+   */
+  void PurgeTop (void);
+
+  std::vector<HeapEntry> m_heap;  //!< binary heap of the SPFVertex candidates
+  std::unordered_map<SPFVertex*, uint64_t> m_sequences; //!< sequence number of the valid entry of each vertex
+  std::unordered_map<Ipv4Address, SPFVertex*, Ipv4AddressHash> m_vertices; //!< candidates by vertex ID
+  uint64_t m_nextSequence; //!< sequence number of the next entry
 
   /**
    * \brief Stream insertion operator.
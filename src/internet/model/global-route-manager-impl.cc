@@ -27,6 +27,7 @@
 #include <queue>
 #include <algorithm>
 #include <iostream>
+#include <set>
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
@@ -35,6 +36,9 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/system-thread.h"
 #include "global-router-interface.h"
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
@@ -44,6 +48,16 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * The number of threads computing the shortest path trees of the routers.
+ */
+static GlobalValue g_globalRoutingThreads =
+  GlobalValue ("GlobalRoutingThreads",
+               "The number of threads computing the shortest path trees of global routing",
+               UintegerValue (1),
+               MakeUintegerChecker<uint32_t> (1));
+
 /**
  * \brief Stream insertion operator.
  *
@@ -88,6 +102,7 @@ operator<< (std::ostream& os, const SPFVertex::ListOfSPFVertex_t& vs)
 SPFVertex::SPFVertex () : 
   m_vertexType (VertexUnknown), 
   m_vertexId ("255.255.255.255"), 
+  m_vertexIndex (0),
   m_lsa (0),
   m_distanceFromRoot (SPF_INFINITY), 
   m_rootOif (SPF_INFINITY),
@@ -101,6 +116,7 @@ SPFVertex::SPFVertex () :
 
 SPFVertex::SPFVertex (GlobalRoutingLSA* lsa) : 
   m_vertexId (lsa->GetLinkStateId ()),
+  m_vertexIndex (0),
   m_lsa (lsa),
   m_distanceFromRoot (SPF_INFINITY), 
   m_rootOif (SPF_INFINITY),
@@ -202,6 +218,20 @@ SPFVertex::GetVertexId (void) const
   return m_vertexId;
 }
 
+void
+SPFVertex::SetVertexIndex (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  m_vertexIndex = index;
+}
+
+uint32_t
+SPFVertex::GetVertexIndex (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_vertexIndex;
+}
+
 void
 SPFVertex::SetLSA (GlobalRoutingLSA* lsa)
 {
@@ -423,7 +453,9 @@ SPFVertex::ClearVertexProcessed (void)
 GlobalRouteManagerLSDB::GlobalRouteManagerLSDB ()
   :
     m_database (),
-    m_extdatabase ()
+    m_extdatabase (),
+    m_linkDataIndex (),
+    m_adjacencyValid (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -468,9 +500,31 @@ GlobalRouteManagerLSDB::Insert (Ipv4Address addr, GlobalRoutingLSA* lsa)
     {
       m_extdatabase.push_back (lsa);
     } 
-  else
+  else if (m_database.insert (LSDBPair_t (addr, lsa)).second)
     {
-      m_database.insert (LSDBPair_t (addr, lsa));
+//
+// Index the LSA by the link data of its transit network link records.  As
+// GetLSAByLinkData () used to return the first LSA in the order of the
+// database, an LSA with a lower link state ID takes precedence.
+//
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+          if (lr->GetLinkType () != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              continue;
+            }
+          LSDBMap_t::iterator i = m_linkDataIndex.find (lr->GetLinkData ());
+          if (i == m_linkDataIndex.end ())
+            {
+              m_linkDataIndex.insert (LSDBPair_t (lr->GetLinkData (), lsa));
+            }
+          else if (addr < i->second->GetLinkStateId ())
+            {
+              i->second = lsa;
+            }
+        }
+      m_adjacencyValid = false;
     }
 }
 
@@ -495,13 +549,10 @@ GlobalRouteManagerLSDB::GetLSA (Ipv4Address addr) const
 //
 // Look up an LSA by its address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_database.find (addr);
+  if (i != m_database.end ())
     {
-      if (i->first == addr)
-        {
-          return i->second;
-        }
+      return i->second;
     }
   return 0;
 }
@@ -511,24 +562,126 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this << addr);
 //
-// Look up an LSA by its address.
+// Look up an LSA by the link data of its transit network link records.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_linkDataIndex.find (addr);
+  if (i != m_linkDataIndex.end ())
     {
-      GlobalRoutingLSA* temp = i->second;
-// Iterate among temp's Link Records
-      for (uint32_t j = 0; j < temp->GetNLinkRecords (); j++)
+      return i->second;
+    }
+  return 0;
+}
+
+void
+GlobalRouteManagerLSDB::BuildAdjacencyArrays ()
+{
+  NS_LOG_FUNCTION (this);
+  m_vertices.clear ();
+  m_vertexIndices.clear ();
+  m_edgeOffsets.clear ();
+  m_edges.clear ();
+  for (LSDBMap_t::const_iterator i = m_database.begin (); i != m_database.end (); i++)
+    {
+      m_vertexIndices[i->first] = m_vertices.size ();
+      m_vertices.push_back (i->second);
+    }
+//
+// The edges are resolved as SPFNext () walks them: the point-to-point and
+// transit network link records of a router LSA lead to the LSA whose link
+// state ID is the link ID, and the attached routers of a network LSA lead to
+// the router LSAs having a transit network link record with that address.
+//
+  for (uint32_t v = 0; v < m_vertices.size (); v++)
+    {
+      m_edgeOffsets.push_back (m_edges.size ());
+      GlobalRoutingLSA *lsa = m_vertices[v];
+      if (lsa->GetLSType () == GlobalRoutingLSA::RouterLSA)
         {
-          GlobalRoutingLinkRecord *lr = temp->GetLinkRecord (j);
-          if ( lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork &&
-               lr->GetLinkData () == addr)
+          for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
             {
-              return temp;
+              GlobalRoutingLinkRecord *l = lsa->GetLinkRecord (j);
+              if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
+                {
+                  continue;
+                }
+              NS_ASSERT_MSG (l->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint
+                             || l->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork,
+                             "illegal Link Type");
+              std::map<Ipv4Address, uint32_t>::const_iterator w = m_vertexIndices.find (l->GetLinkId ());
+              if (w == m_vertexIndices.end ())
+                {
+                  NS_ASSERT_MSG (false, "No LSA for link ID " << l->GetLinkId ());
+                  continue;
+                }
+              Edge edge;
+              edge.vertex = w->second;
+              edge.link = l;
+              m_edges.push_back (edge);
+            }
+        }
+      else if (lsa->GetLSType () == GlobalRoutingLSA::NetworkLSA)
+        {
+          for (uint32_t j = 0; j < lsa->GetNAttachedRouters (); j++)
+            {
+              GlobalRoutingLSA *w_lsa = GetLSAByLinkData (lsa->GetAttachedRouter (j));
+              if (w_lsa == 0)
+                {
+                  continue;
+                }
+              Edge edge;
+              edge.vertex = m_vertexIndices[w_lsa->GetLinkStateId ()];
+              edge.link = 0;
+              m_edges.push_back (edge);
             }
         }
     }
-  return 0;
+  m_edgeOffsets.push_back (m_edges.size ());
+  m_adjacencyValid = true;
+  NS_LOG_LOGIC ("Built adjacency arrays of " << m_vertices.size () <<
+                " vertices and " << m_edges.size () << " edges");
+}
+
+bool
+GlobalRouteManagerLSDB::HasAdjacencyArrays () const
+{
+  return m_adjacencyValid;
+}
+
+uint32_t
+GlobalRouteManagerLSDB::GetNVertices () const
+{
+  NS_ASSERT (m_adjacencyValid);
+  return m_vertices.size ();
+}
+
+int32_t
+GlobalRouteManagerLSDB::GetVertexIndex (Ipv4Address addr) const
+{
+  NS_ASSERT (m_adjacencyValid);
+  std::map<Ipv4Address, uint32_t>::const_iterator i = m_vertexIndices.find (addr);
+  if (i == m_vertexIndices.end ())
+    {
+      return -1;
+    }
+  return i->second;
+}
+
+GlobalRoutingLSA*
+GlobalRouteManagerLSDB::GetVertexLSA (uint32_t index) const
+{
+  return m_vertices[index];
+}
+
+uint32_t
+GlobalRouteManagerLSDB::GetNEdges (uint32_t index) const
+{
+  return m_edgeOffsets[index + 1] - m_edgeOffsets[index];
+}
+
+const GlobalRouteManagerLSDB::Edge&
+GlobalRouteManagerLSDB::GetEdge (uint32_t index, uint32_t i) const
+{
+  return m_edges[m_edgeOffsets[index] + i];
 }
 
 // ---------------------------------------------------------------------------
@@ -539,7 +692,10 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_root (0),
+    m_checkStubNodes (false),
+    m_incremental (false)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
@@ -563,6 +719,8 @@ GlobalRouteManagerImpl::DebugUseLsdb (GlobalRouteManagerLSDB* lsdb)
       delete m_lsdb;
     }
   m_lsdb = lsdb;
+  m_dependencies.clear ();
+  m_incremental = false;
 }
 
 void
@@ -579,18 +737,8 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
           continue;
         }
       Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-      uint32_t j = 0;
-      uint32_t nRoutes = gr->GetNRoutes ();
       NS_LOG_LOGIC ("Deleting " << gr->GetNRoutes ()<< " routes from node " << node->GetId ());
-      // Each time we delete route 0, the route index shifts downward
-      // We can delete all routes if we delete the route numbered 0
-      // nRoutes times
-      for (j = 0; j < nRoutes; j++)
-        {
-          NS_LOG_LOGIC ("Deleting global route " << j << " from node " << node->GetId ());
-          gr->RemoveRoute (0);
-        }
-      NS_LOG_LOGIC ("Deleted " << j << " global routes from node "<< node->GetId ());
+      DeleteRoutes (gr);
     }
   if (m_lsdb)
     {
@@ -598,6 +746,22 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
       delete m_lsdb;
       m_lsdb = new GlobalRouteManagerLSDB ();
     }
+  m_dependencies.clear ();
+  m_incremental = false;
+}
+
+void
+GlobalRouteManagerImpl::DeleteRoutes (Ptr<Ipv4GlobalRouting> gr)
+{
+  NS_LOG_FUNCTION (gr);
+  uint32_t nRoutes = gr->GetNRoutes ();
+  // Each time we delete route 0, the route index shifts downward
+  // We can delete all routes if we delete the route numbered 0
+  // nRoutes times
+  for (uint32_t j = 0; j < nRoutes; j++)
+    {
+      gr->RemoveRoute (0);
+    }
 }
 
 //
@@ -696,10 +860,174 @@ void
 GlobalRouteManagerImpl::InitializeRoutes ()
 {
   NS_LOG_FUNCTION (this);
+  NS_LOG_INFO ("About to start SPF calculation");
+  m_dependencies.clear ();
+  CalculateRoutes (GetRoots ());
+  m_incremental = true;
+  NS_LOG_INFO ("Finished SPF calculation");
+}
+
+//
+// Rebuild the LSDB and compare it with the previous one.  The routes of a
+// router only depend on the LSAs of the vertices of its shortest path tree
+// (a vertex whose LSA changes in a way that affects the tree is either in
+// the tree or gets connected to a vertex of the tree, whose LSA changes
+// too), on the AS external LSAs and on the addresses of its interfaces.
+// Only the routers for which one of these changed are recomputed.
+//
+void
+GlobalRouteManagerImpl::UpdateRoutes ()
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_incremental)
+    {
+      DeleteGlobalRoutes ();
+      BuildGlobalRoutingDatabase ();
+      InitializeRoutes ();
+      return;
+    }
+
+  GlobalRouteManagerLSDB *previous = m_lsdb;
+  m_lsdb = new GlobalRouteManagerLSDB ();
+  BuildGlobalRoutingDatabase ();
+  if (!previous->HasAdjacencyArrays ())
+    {
+      previous->BuildAdjacencyArrays ();
+    }
+  m_lsdb->BuildAdjacencyArrays ();
+
+//
+// Walk both databases, sorted by link state ID, to find the LSAs which
+// were added, removed or modified.
+//
+  std::set<Ipv4Address> changed;
+  uint32_t i = 0;
+  uint32_t j = 0;
+  while (i < previous->GetNVertices () || j < m_lsdb->GetNVertices ())
+    {
+      GlobalRoutingLSA *a = (i < previous->GetNVertices ()) ? previous->GetVertexLSA (i) : 0;
+      GlobalRoutingLSA *b = (j < m_lsdb->GetNVertices ()) ? m_lsdb->GetVertexLSA (j) : 0;
+      if (b == 0 || (a != 0 && a->GetLinkStateId () < b->GetLinkStateId ()))
+        {
+          changed.insert (a->GetLinkStateId ());
+          i++;
+        }
+      else if (a == 0 || b->GetLinkStateId () < a->GetLinkStateId ())
+        {
+          changed.insert (b->GetLinkStateId ());
+          j++;
+        }
+      else
+        {
+          if (!IsSameLSA (a, b))
+            {
+              changed.insert (a->GetLinkStateId ());
+            }
+          i++;
+          j++;
+        }
+    }
+  bool externalsChanged = (previous->GetNumExtLSAs () != m_lsdb->GetNumExtLSAs ());
+  for (uint32_t k = 0; !externalsChanged && k < m_lsdb->GetNumExtLSAs (); k++)
+    {
+      externalsChanged = !IsSameLSA (previous->GetExtLSA (k), m_lsdb->GetExtLSA (k));
+    }
+  delete previous;
+  NS_LOG_LOGIC (changed.size () << " LSAs changed, AS external LSAs " <<
+                (externalsChanged ? "changed" : "unchanged"));
+
+  std::vector<SPFRoot> roots = GetRoots ();
+  std::vector<SPFRoot> affected;
+  std::set<Ipv4Address> rootIds;
+  for (std::vector<SPFRoot>::const_iterator root = roots.begin (); root != roots.end (); root++)
+    {
+      rootIds.insert (root->routerId);
+      std::map<Ipv4Address, SPFDependencies>::const_iterator deps = m_dependencies.find (root->routerId);
+      bool update = externalsChanged || deps == m_dependencies.end ()
+        || deps->second.interfaces != root->interfaces;
+      for (uint32_t k = 0; !update && k < deps->second.lsas.size (); k++)
+        {
+          update = (changed.count (deps->second.lsas[k]) != 0);
+        }
+      if (update)
+        {
+          NS_LOG_LOGIC ("Recomputing the routes of router " << root->routerId);
+          DeleteRoutes (root->routing);
+          affected.push_back (*root);
+        }
+    }
+
+//
+// The routers which no longer have LSAs lose their routes.
+//
+  std::map<Ipv4Address, SPFDependencies>::iterator deps = m_dependencies.begin ();
+  while (deps != m_dependencies.end ())
+    {
+      if (rootIds.count (deps->first) != 0)
+        {
+          deps++;
+          continue;
+        }
+      NodeList::Iterator listEnd = NodeList::End ();
+      for (NodeList::Iterator n = NodeList::Begin (); n != listEnd; n++)
+        {
+          Ptr<GlobalRouter> rtr = (*n)->GetObject<GlobalRouter> ();
+          if (rtr && rtr->GetRouterId () == deps->first)
+            {
+              NS_LOG_LOGIC ("Deleting the routes of router " << deps->first);
+              DeleteRoutes (rtr->GetRoutingProtocol ());
+              break;
+            }
+        }
+      m_dependencies.erase (deps++);
+    }
+
+  CalculateRoutes (affected);
+}
+
+bool
+GlobalRouteManagerImpl::IsSameLSA (const GlobalRoutingLSA *a, const GlobalRoutingLSA *b)
+{
+  if (a->GetLSType () != b->GetLSType ()
+      || a->GetLinkStateId () != b->GetLinkStateId ()
+      || a->GetAdvertisingRouter () != b->GetAdvertisingRouter ()
+      || a->GetNetworkLSANetworkMask () != b->GetNetworkLSANetworkMask ()
+      || a->GetNLinkRecords () != b->GetNLinkRecords ()
+      || a->GetNAttachedRouters () != b->GetNAttachedRouters ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < a->GetNLinkRecords (); i++)
+    {
+      GlobalRoutingLinkRecord *la = a->GetLinkRecord (i);
+      GlobalRoutingLinkRecord *lb = b->GetLinkRecord (i);
+      if (la->GetLinkType () != lb->GetLinkType ()
+          || la->GetLinkId () != lb->GetLinkId ()
+          || la->GetLinkData () != lb->GetLinkData ()
+          || la->GetMetric () != lb->GetMetric ())
+        {
+          return false;
+        }
+    }
+  for (uint32_t i = 0; i < a->GetNAttachedRouters (); i++)
+    {
+      if (a->GetAttachedRouter (i) != b->GetAttachedRouter (i))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+std::vector<GlobalRouteManagerImpl::SPFRoot>
+GlobalRouteManagerImpl::GetRoots (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<SPFRoot> roots;
+  uint32_t systemId = MpiInterface::GetSystemId ();
 //
 // Walk the list of nodes in the system.
 //
-  NS_LOG_INFO ("About to start SPF calculation");
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -711,7 +1039,6 @@ GlobalRouteManagerImpl::InitializeRoutes ()
       Ptr<GlobalRouter> rtr = 
         node->GetObject<GlobalRouter> ();
 
-      uint32_t systemId = MpiInterface::GetSystemId ();
       // Ignore nodes that are not assigned to our systemId (distributed sim)
       if (node->GetSystemId () != systemId) 
         {
@@ -720,14 +1047,150 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 
 //
 // if the node has a global router interface, then run the global routing
-// algorithms.
+// algorithms.  The routing protocol and the interface addresses are looked
+// up here once, so that the SPF calculation itself does not access the node.
 //
       if (rtr && rtr->GetNumLSAs () )
         {
-          SPFCalculate (rtr->GetRouterId ());
+          roots.push_back (SPFRoot ());
+          SPFRoot &root = roots.back ();
+          root.routerId = rtr->GetRouterId ();
+          root.routing = rtr->GetRoutingProtocol ();
+          NS_ASSERT (root.routing);
+          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+          NS_ASSERT_MSG (ipv4, 
+                         "GlobalRouteManagerImpl::GetRoots (): "
+                         "GetObject for <Ipv4> interface failed");
+          root.interfaces.resize (ipv4->GetNInterfaces ());
+          for (uint32_t j = 0; j < ipv4->GetNInterfaces (); j++)
+            {
+              for (uint32_t k = 0; k < ipv4->GetNAddresses (j); k++)
+                {
+                  root.interfaces[j].push_back (ipv4->GetAddress (j, k).GetLocal ());
+                }
+            }
         }
     }
-  NS_LOG_INFO ("Finished SPF calculation");
+  return roots;
+}
+
+void
+GlobalRouteManagerImpl::CalculateRoutes (const std::vector<SPFRoot> &roots)
+{
+  NS_LOG_FUNCTION (this << roots.size ());
+  if (!m_lsdb->HasAdjacencyArrays ())
+    {
+      m_lsdb->BuildAdjacencyArrays ();
+    }
+  m_checkStubNodes = (NodeList::GetNNodes () > 0);
+
+  UintegerValue threads;
+  g_globalRoutingThreads.GetValue (threads);
+  uint32_t nThreads = std::min<uint32_t> (threads.Get (), roots.size ());
+  if (nThreads > 1 && !g_log.IsNoneEnabled ())
+    {
+      NS_LOG_LOGIC ("Logging is enabled, computing the SPF trees in a single thread");
+      nThreads = 1;
+    }
+
+  if (nThreads <= 1)
+    {
+      for (uint32_t i = 0; i < roots.size (); i++)
+        {
+          SPFCalculate (roots[i]);
+          AddRoutes (roots[i], m_result.routes);
+          std::swap (m_dependencies[roots[i].routerId], m_result.dependencies);
+        }
+      return;
+    }
+
+//
+// Each worker owns the state of its SPF calculations and shares the LSDB,
+// which is only read.  The roots are dealt to the workers in turn, and the
+// routes are added to the routing tables from this thread once all the
+// calculations are done.
+//
+  NS_LOG_LOGIC ("Computing " << roots.size () << " SPF trees in " << nThreads << " threads");
+  std::vector<SPFResult> results (roots.size ());
+  std::vector<GlobalRouteManagerImpl *> workers;
+  std::vector<Ptr<SystemThread> > workerThreads;
+  for (uint32_t w = 0; w < nThreads; w++)
+    {
+      GlobalRouteManagerImpl *worker = new GlobalRouteManagerImpl ();
+      delete worker->m_lsdb;
+      worker->m_lsdb = m_lsdb;
+      worker->m_checkStubNodes = m_checkStubNodes;
+      worker->m_job.roots = &roots;
+      worker->m_job.results = &results;
+      worker->m_job.first = w;
+      worker->m_job.stride = nThreads;
+      workers.push_back (worker);
+      workerThreads.push_back (Create<SystemThread> (MakeCallback (&GlobalRouteManagerImpl::RunJob, worker)));
+      workerThreads.back ()->Start ();
+    }
+  for (uint32_t w = 0; w < nThreads; w++)
+    {
+      workerThreads[w]->Join ();
+      workers[w]->m_lsdb = 0;
+      delete workers[w];
+    }
+
+  for (uint32_t i = 0; i < roots.size (); i++)
+    {
+      AddRoutes (roots[i], results[i].routes);
+      std::swap (m_dependencies[roots[i].routerId], results[i].dependencies);
+    }
+}
+
+void
+GlobalRouteManagerImpl::RunJob (void)
+{
+  // this runs outside of the main thread: no access to the nodes, and no
+  // copy of the Ptr shared with the other threads
+  for (uint32_t i = m_job.first; i < m_job.roots->size (); i += m_job.stride)
+    {
+      SPFCalculate ((*m_job.roots)[i]);
+      std::swap ((*m_job.results)[i], m_result);
+    }
+}
+
+void
+GlobalRouteManagerImpl::AddRoutes (const SPFRoot &root, const std::vector<SPFRoute> &routes)
+{
+  NS_LOG_FUNCTION (root.routerId << routes.size ());
+  if (root.routing == 0)
+    {
+      NS_LOG_LOGIC ("Can't find root node " << root.routerId);
+      return;
+    }
+  for (std::vector<SPFRoute>::const_iterator i = routes.begin (); i != routes.end (); i++)
+    {
+      switch (i->type)
+        {
+        case SPFRoute::HOST:
+          root.routing->AddHostRouteTo (i->dest, i->nextHop, i->outIf);
+          break;
+        case SPFRoute::NETWORK:
+          root.routing->AddNetworkRouteTo (i->dest, i->mask, i->nextHop, i->outIf);
+          break;
+        case SPFRoute::EXTERNAL:
+          root.routing->AddASExternalRouteTo (i->dest, i->mask, i->nextHop, i->outIf);
+          break;
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::AddSPFRoute (SPFRoute::Type type, Ipv4Address dest, Ipv4Mask mask,
+                                     Ipv4Address nextHop, int32_t outIf)
+{
+  SPFRoute route;
+  route.type = type;
+  route.dest = dest;
+  route.mask = mask;
+  route.nextHop = nextHop;
+  route.outIf = outIf;
+  m_result.routes.push_back (route);
 }
 
 //
@@ -752,81 +1215,27 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
   GlobalRoutingLSA* w_lsa = 0;
   GlobalRoutingLinkRecord *l = 0;
   uint32_t distance = 0;
-  uint32_t numRecordsInVertex = 0;
 //
 // V points to a Router-LSA or Network-LSA
-// Loop over the links in router LSA or attached routers in Network LSA
-//
-  if (v->GetVertexType () == SPFVertex::VertexRouter)
-    {
-      numRecordsInVertex = v->GetLSA ()->GetNLinkRecords (); 
-    }
-  if (v->GetVertexType () == SPFVertex::VertexNetwork)
-    {
-      numRecordsInVertex = v->GetLSA ()->GetNAttachedRouters (); 
-    }
-
-  for (uint32_t i = 0; i < numRecordsInVertex; i++)
-    {
-// Get w_lsa:  In case of V is Router-LSA
-      if (v->GetVertexType () == SPFVertex::VertexRouter) 
-        {
-          NS_LOG_LOGIC ("Examining link " << i << " of " << 
-                        v->GetVertexId () << "'s " <<
-                        v->GetLSA ()->GetNLinkRecords () << " link records");
-//
-// (a) If this is a link to a stub network, examine the next link in V's LSA.
-// Links to stub networks will be considered in the second stage of the
-// shortest path calculation.
-//
-          l = v->GetLSA ()->GetLinkRecord (i);
-          NS_ASSERT (l != 0);
-          if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
-            {
-              NS_LOG_LOGIC ("Found a Stub record to " << l->GetLinkId ());
-              continue;
-            }
+// Loop over the links in router LSA or attached routers in Network LSA.
 //
-// (b) Otherwise, W is a transit vertex (router or transit network).  Look up
-// the vertex W's LSA (router-LSA or network-LSA) in Area A's link state
-// database. 
-//
-          if (l->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
-            {
+// (a) Links to stub networks are not in the adjacency arrays of the LSDB:
+// they will be considered in the second stage of the shortest path
+// calculation.
 //
-// Lookup the link state advertisement of the new link -- we call it <w> in
-// the link state database.
+// (b) The other links lead to a transit vertex W (router or transit
+// network), whose LSA (router-LSA or network-LSA) was looked up in Area A's
+// link state database when the adjacency arrays were built.  If V is a
+// network, the link record is null.
 //
-              w_lsa = m_lsdb->GetLSA (l->GetLinkId ());
-              NS_ASSERT (w_lsa);
-              NS_LOG_LOGIC ("Found a P2P record from " << 
-                            v->GetVertexId () << " to " << w_lsa->GetLinkStateId ());
-            }
-          else if (l->GetLinkType () == 
-                   GlobalRoutingLinkRecord::TransitNetwork)
-            {
-              w_lsa = m_lsdb->GetLSA (l->GetLinkId ());
-              NS_ASSERT (w_lsa);
-              NS_LOG_LOGIC ("Found a Transit record from " << 
-                            v->GetVertexId () << " to " << w_lsa->GetLinkStateId ());
-            }
-          else 
-            {
-              NS_ASSERT_MSG (0, "illegal Link Type");
-            }
-        }
-// Get w_lsa:  In case of V is Network-LSA
-      if (v->GetVertexType () == SPFVertex::VertexNetwork) 
-        {
-          w_lsa = m_lsdb->GetLSAByLinkData 
-              (v->GetLSA ()->GetAttachedRouter (i));
-          if (!w_lsa)
-            {
-              continue;
-            }
-          NS_LOG_LOGIC ("Found a Network LSA from " << 
-                        v->GetVertexId () << " to " << w_lsa->GetLinkStateId ());
-        }
+  uint32_t numEdges = m_lsdb->GetNEdges (v->GetVertexIndex ());
+  for (uint32_t i = 0; i < numEdges; i++)
+    {
+      const GlobalRouteManagerLSDB::Edge &edge = m_lsdb->GetEdge (v->GetVertexIndex (), i);
+      l = edge.link;
+      w_lsa = m_lsdb->GetVertexLSA (edge.vertex);
+      NS_LOG_LOGIC ("Found a record from " << 
+                    v->GetVertexId () << " to " << w_lsa->GetLinkStateId ());
 
 // Note:  w_lsa at this point may be either RouterLSA or NetworkLSA
 //
@@ -836,7 +1245,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // If the link is to a router that is already in the shortest path first tree
 // then we have it covered -- ignore it.
 //
-      if (w_lsa->GetStatus () == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE) 
+      if (m_status[edge.vertex] == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE) 
         {
           NS_LOG_LOGIC ("Skipping ->  LSA "<< 
                         w_lsa->GetLinkStateId () << " already in SPF tree");
@@ -861,7 +1270,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
       NS_LOG_LOGIC ("Considering w_lsa " << w_lsa->GetLinkStateId ());
 
 // Is there already vertex w in candidate list?
-      if (w_lsa->GetStatus () == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+      if (m_status[edge.vertex] == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
         {
 // Calculate nexthop to w
 // We need to figure out how to actually get to the new router represented
@@ -871,9 +1280,10 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 
 // prepare vertex w
           w = new SPFVertex (w_lsa);
+          w->SetVertexIndex (edge.vertex);
           if (SPFNexthopCalculation (v, w, l, distance))
             {
-              w_lsa->SetStatus (GlobalRoutingLSA::LSA_SPF_CANDIDATE);
+              m_status[edge.vertex] = GlobalRoutingLSA::LSA_SPF_CANDIDATE;
 //
 // Push this new vertex onto the priority queue (ordered by distance from the
 // root node).
@@ -888,7 +1298,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
             NS_ASSERT_MSG (0, "SPFNexthopCalculation never " 
                            << "return false, but it does now!");
         }
-      else if (w_lsa->GetStatus () == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
+      else if (m_status[edge.vertex] == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
         {
 //
 // We have already considered the link represented by <w>.  What wse have to
@@ -935,6 +1345,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 
 // prepare vertex w
               w = new SPFVertex (w_lsa);
+              w->SetVertexIndex (edge.vertex);
               SPFNexthopCalculation (v, w, l, distance);
               cw->MergeRootExitDirections (w);
               cw->MergeParent (w);
@@ -960,7 +1371,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // If we've changed the cost to get to the vertex represented by <w>, we 
 // must reorder the priority queue keyed to that cost.
 //
-                  candidate.Reorder ();
+                  candidate.Update (cw);
                 }
             } // new lower cost path found
         } // end W is already on the candidate list
@@ -1250,6 +1661,26 @@ GlobalRouteManagerImpl::DebugSPFCalculate (Ipv4Address root)
   SPFCalculate (root);
 }
 
+void
+GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
+{
+  NS_LOG_FUNCTION (this << root);
+  std::vector<SPFRoot> roots = GetRoots ();
+  SPFRoot spfRoot;
+  spfRoot.routerId = root;
+  for (std::vector<SPFRoot>::const_iterator i = roots.begin (); i != roots.end (); i++)
+    {
+      if (i->routerId == root)
+        {
+          spfRoot = *i;
+          break;
+        }
+    }
+  m_checkStubNodes = (NodeList::GetNNodes () > 0);
+  SPFCalculate (spfRoot);
+  AddRoutes (spfRoot, m_result.routes);
+}
+
 //
 // Used to test if a node is a stub, from an OSPF sense.
 // If there is only one link of type 1 or 2, then a default route
@@ -1305,6 +1736,7 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
           // The link record LinkID is the router ID of the peer.
           // The Link Data is the local IP interface address
           GlobalRoutingLSA *w_lsa = m_lsdb->GetLSA (transitLink->GetLinkId ());
+          m_result.dependencies.lsas.push_back (w_lsa->GetLinkStateId ());
           uint32_t nLinkRecords = w_lsa->GetNLinkRecords ();
           for (uint32_t j = 0; j < nLinkRecords; ++j)
             {
@@ -1320,12 +1752,8 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
               if (lr->GetLinkId () == myRouterId)
                 {
                   // Next hop is stored in the LinkID field of lr
-                  Ptr<GlobalRouter> router = rlsa->GetNode ()->GetObject<GlobalRouter> ();
-                  NS_ASSERT (router);
-                  Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-                  NS_ASSERT (gr);
-                  gr->AddNetworkRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (), 
-                                         FindOutgoingInterfaceId (transitLink->GetLinkData ()));
+                  AddSPFRoute (SPFRoute::NETWORK, Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (), 
+                               FindOutgoingInterfaceId (transitLink->GetLinkData ()));
                   NS_LOG_LOGIC ("Inserting default route for node " << myRouterId << " to next hop " << 
                                 lr->GetLinkData () << " via interface " << 
                                 FindOutgoingInterfaceId (transitLink->GetLinkData ()));
@@ -1339,15 +1767,27 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
 
 // quagga ospf_spf_calculate
 void
-GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
+GlobalRouteManagerImpl::SPFCalculate (const SPFRoot &spfRoot)
 {
+  Ipv4Address root = spfRoot.routerId;
   NS_LOG_FUNCTION (this << root);
 
   SPFVertex *v;
+  m_root = &spfRoot;
+  m_result.routes.clear ();
+  m_result.dependencies.lsas.clear ();
+  m_result.dependencies.interfaces = spfRoot.interfaces;
 //
-// Initialize the Link State Database.
+// Initialize the status of the vertices.  It is kept here rather than in the
+// LSAs, so that the Link State Database is not modified by the calculation.
 //
-  m_lsdb->Initialize ();
+  if (!m_lsdb->HasAdjacencyArrays ())
+    {
+      m_lsdb->BuildAdjacencyArrays ();
+    }
+  int32_t rootIndex = m_lsdb->GetVertexIndex (root);
+  NS_ASSERT_MSG (rootIndex >= 0, "No LSA for root " << root);
+  m_status.assign (m_lsdb->GetNVertices (), GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
 //
 // The candidate queue is a priority queue of SPFVertex objects, with the top
 // of the queue being the closest vertex in terms of distance from the root
@@ -1360,14 +1800,16 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // calculation.  Each router (and corresponding network) is a vertex in the
 // shortest path first (SPF) tree.
 //
-  v = new SPFVertex (m_lsdb->GetLSA (root));
+  v = new SPFVertex (m_lsdb->GetVertexLSA (rootIndex));
+  v->SetVertexIndex (rootIndex);
 // 
 // This vertex is the root of the SPF tree and it is distance 0 from the root.
 // We also mark this vertex as being in the SPF tree.
 //
   m_spfroot= v;
   v->SetDistanceFromRoot (0);
-  v->GetLSA ()->SetStatus (GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+  m_status[rootIndex] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+  m_result.dependencies.lsas.push_back (root);
   NS_LOG_LOGIC ("Starting SPFCalculate for node " << root);
 
 //
@@ -1377,10 +1819,13 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // reached.  Instead, short-circuit this computation and just install
 // a default route in the CheckForStubNode() method.
 //
-  if (NodeList::GetNNodes () > 0 && CheckForStubNode (root))
+  if (m_checkStubNodes && CheckForStubNode (root))
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
       delete m_spfroot;
+      m_spfroot = 0;
+      m_root = 0;
+      std::sort (m_result.dependencies.lsas.begin (), m_result.dependencies.lsas.end ());
       return;
     }
 
@@ -1428,7 +1873,8 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // Update the status field of the vertex to indicate that it is in the SPF
 // tree.
 //
-      v->GetLSA ()->SetStatus (GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+      m_status[v->GetVertexIndex ()] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+      m_result.dependencies.lsas.push_back (v->GetVertexId ());
 //
 // The current vertex has a parent pointer.  By calling this rather oddly 
 // named method (blame quagga) we add the current vertex to the list of 
@@ -1502,6 +1948,8 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 //
   delete m_spfroot;
   m_spfroot = 0;
+  m_root = 0;
+  std::sort (m_result.dependencies.lsas.begin (), m_result.dependencies.lsas.end ());
 }
 
 void
@@ -1560,105 +2008,40 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
+// The routes are recorded in the result of the calculation, and added to the
+// routing table of the node at the root of the SPF tree once the
+// calculation is done.
 //
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
+  NS_ASSERT_MSG (v->GetLSA (), 
+                 "GlobalRouteManagerImpl::SPFAddASExternal (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = extlsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
 
-      if (rtr == 0)
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
         {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << node->GetId ());
-          continue;
+          AddSPFRoute (SPFRoute::EXTERNAL, tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Router " << routerId <<
+                        " add external network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
         }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
+      else
         {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
-//
-// Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = extlsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-
-//
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddASExternalRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add external network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+          NS_LOG_LOGIC ("(Route " << i << ") Router " << routerId <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative");
+        }
+    }
 }
 
 
@@ -1720,122 +2103,57 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
   NS_LOG_LOGIC ("Stub is on remote host: " << v->GetVertexId () << "; installing");
 //
 // The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
+// going to write the actual routing table entries.  The routes are recorded
+// in the result of the calculation, and added to the routing table of the
+// node having the router ID of the root vertex once the calculation is done.
 //
   Ipv4Address routerId = m_spfroot->GetVertexId ();
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  NS_ASSERT_MSG (v->GetLSA (), 
+                 "GlobalRouteManagerImpl::SPFIntraAddStub (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask (l->GetLinkData ().Get ());
+  Ipv4Address tempip = l->GetLinkId ();
+  tempip = tempip.CombineMask (tempmask);
+//
+// We're going to add a network route to the stub network found in the link
+// record.  The vertex <v> (corresponding to the node that has this stub
+// link) has an m_nextHop address precalculated for us that is the address
+// to which the root node should send packets to be forwarded to this
+// network.  Similarly, the vertex <v> has an m_rootOif (outbound interface
+// index) to which the packets should be send for forwarding.
+//
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
         {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
+          AddSPFRoute (SPFRoute::NETWORK, tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Router " << routerId <<
+                        " add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
         }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
+      else
         {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
-//
-// Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask (l->GetLinkData ().Get ());
-          Ipv4Address tempip = l->GetLinkId ();
-          tempip = tempip.CombineMask (tempmask);
-//
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+          NS_LOG_LOGIC ("(Route " << i << ") Router " << routerId <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
 // Return the interface number corresponding to a given IP address and mask
-// This is a wrapper around GetInterfaceForPrefix(), but we first
-// have to find the right node pointer to pass to that function.
+// This is equivalent to GetInterfaceForPrefix() on the node at the root of
+// the SPF tree, using the addresses of its interfaces collected before the
+// calculation.
 // If no such interface is found, return -1 (note:  unit test framework
 // for routing assumes -1 to be a legal return value)
 //
@@ -1843,70 +2161,27 @@ int32_t
 GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
 {
   NS_LOG_FUNCTION (this << a << amask);
+  NS_ASSERT_MSG (m_root, 
+                 "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): Root not set");
 //
-// We have an IP address <a> and a vertex ID of the root of the SPF tree.
-// The question is what interface index does this address correspond to.
-// The answer is a little complicated since we have to find a pointer to
-// the node corresponding to the vertex ID, find the Ipv4 interface on that
-// node in order to iterate the interfaces and find the one corresponding to
-// the address in question.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
+// Look through the interfaces of the root node for one that has the IP
+// address we're looking for.  If we find one, return the corresponding
+// interface index, or -1 if not found.
 //
-// Walk the list of nodes in the system looking for the one corresponding to
-// the node at the root of the SPF tree.  This is the node for which we are
-// building the routing table.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  for (uint32_t i = 0; i < m_root->interfaces.size (); i++)
     {
-      Ptr<Node> node = *i;
-
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-//
-// If the node doesn't have a GlobalRouter interface it can't be the one
-// we're interested in.
-//
-      if (rtr == 0)
+      for (uint32_t j = 0; j < m_root->interfaces[i].size (); j++)
         {
-          continue;
-        }
-
-      if (rtr->GetRouterId () == routerId)
-        {
-//
-// This is the node we're building the routing table for.  We're going to need
-// the Ipv4 interface to look for the ipv4 interface index.  Since this node
-// is participating in routing IP version 4 packets, it certainly must have 
-// an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                         "GetObject for <Ipv4> interface failed");
-//
-// Look through the interfaces on this node for one that has the IP address
-// we're looking for.  If we find one, return the corresponding interface
-// index, or -1 if not found.
-//
-          int32_t interface = ipv4->GetInterfaceForPrefix (a, amask);
-
-#if 0
-          if (interface < 0)
+          if (m_root->interfaces[i][j].CombineMask (amask) == a.CombineMask (amask))
             {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
+              return i;
             }
-#endif 
-          return interface;
         }
     }
 //
 // Couldn't find it.
 //
-  NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << routerId);
+  NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find interface of root node " << m_root->routerId);
   return -1;
 }
 
@@ -1935,69 +2210,25 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
 //
 // The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
+// going to write the actual routing table entries.  The routes are recorded
+// in the result of the calculation, and added to the routing table of the
+// node having the router ID of the root vertex once the calculation is done.
 //
   Ipv4Address routerId = m_spfroot->GetVertexId ();
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "GetObject for <Ipv4> interface failed");
-//
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
+  GlobalRoutingLSA *lsa = v->GetLSA ();
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
 
-          uint32_t nLinkRecords = lsa->GetNLinkRecords ();
+  uint32_t nLinkRecords = lsa->GetNLinkRecords ();
 //
 // Iterate through the link records on the vertex to which we're going to add
 // routes.  To make sure we're being clear, we're going to add routing table
@@ -2006,18 +2237,18 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // the local side of the point-to-point links found on the node described by
 // the vertex <v>.
 //
-          NS_LOG_LOGIC (" Node " << node->GetId () <<
-                        " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
-          for (uint32_t j = 0; j < nLinkRecords; ++j)
-            {
+  NS_LOG_LOGIC (" Router " << routerId <<
+                " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
+  for (uint32_t j = 0; j < nLinkRecords; ++j)
+    {
 //
 // We are only concerned about point-to-point links
 //
-              GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
-              if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                  continue;
-                }
+      GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+      if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+        {
+          continue;
+        }
 //
 // Here's why we did all of that work.  We're going to add a host route to the
 // host address found in the m_linkData field of the point-to-point link
@@ -2031,46 +2262,33 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
 // which the packets should be send for forwarding.
 //
-              Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-              if (router == 0)
-                {
-                  continue;
-                }
-              Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-              NS_ASSERT (gr);
-              // walk through all available exit directions due to ECMP,
-              // and add host route for each of the exit direction toward
-              // the vertex 'v'
-              for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-                {
-                  SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-                  Ipv4Address nextHop = exit.first;
-                  int32_t outIf = exit.second;
-                  if (outIf >= 0)
-                    {
-                      gr->AddHostRouteTo (lr->GetLinkData (), nextHop,
-                                          outIf);
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " adding host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " and outgoing interface " << outIf);
-                    }
-                  else
-                    {
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " NOT able to add host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " since outgoing interface id is negative " << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+      // walk through all available exit directions due to ECMP,
+      // and add host route for each of the exit direction toward
+      // the vertex 'v'
+      for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+        {
+          SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+          Ipv4Address nextHop = exit.first;
+          int32_t outIf = exit.second;
+          if (outIf >= 0)
+            {
+              AddSPFRoute (SPFRoute::HOST, lr->GetLinkData (), Ipv4Mask::GetOnes (), nextHop, outIf);
+              NS_LOG_LOGIC ("(Route " << i << ") Router " << routerId <<
+                            " adding host route to " << lr->GetLinkData () <<
+                            " using next hop " << nextHop <<
+                            " and outgoing interface " << outIf);
             }
-//
-// Done adding the routes for the selected node.
-//
-          return;
-        }
+          else
+            {
+              NS_LOG_LOGIC ("(Route " << i << ") Router " << routerId <<
+                            " NOT able to add host route to " << lr->GetLinkData () <<
+                            " using next hop " << nextHop <<
+                            " since outgoing interface id is negative " << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
 }
+
 void
 GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
 {
@@ -2080,104 +2298,50 @@ GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
 //
 // The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
+// going to write the actual routing table entries.  The routes are recorded
+// in the result of the calculation, and added to the routing table of the
+// node having the router ID of the root vertex once the calculation is done.
 //
   Ipv4Address routerId = m_spfroot->GetVertexId ();
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+// Get the Global Router Link State Advertisement from the vertex we're
+// adding the routes to.  The network LSA gives the address and mask of the
+// transit network.
+//
+  GlobalRoutingLSA *lsa = v->GetLSA ();
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = lsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
+  // walk through all available exit directions due to ECMP,
+  // and add host route for each of the exit direction toward
+  // the vertex 'v'
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
 
-      if (rtr == 0)
+      if (outIf >= 0)
         {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
+          AddSPFRoute (SPFRoute::NETWORK, tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Router " << routerId <<
+                        " add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
         }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
+      else
         {
-          NS_LOG_LOGIC ("setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "GetObject for <Ipv4> interface failed");
-//
-// Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = lsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all available exit directions due to ECMP,
-          // and add host route for each of the exit direction toward
-          // the vertex 'v'
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative " << outIf);
-                }
-            }
+          NS_LOG_LOGIC ("(Route " << i << ") Router " << routerId <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative " << outIf);
         }
-    } 
+    }
 }
 
 // Derived from quagga ospf_vertex_add_parents ()
@@ -175,6 +175,23 @@ public:
  */
   void SetVertexId (Ipv4Address id);
 
+/**
+ * @brief Get the index of the vertex in the adjacency arrays of the Link
+ * State Database.
+ *
+ * @see GlobalRouteManagerLSDB::GetVertexIndex ()
+ * @returns The index of the vertex.
+ */
+  uint32_t GetVertexIndex (void) const;
+
+/**
+ * @brief Set the index of the vertex in the adjacency arrays of the Link
+ * State Database.
+ *
+ * @param index The index of the vertex.
+ */
+  void SetVertexIndex (uint32_t index);
+
 /**
  * @brief Get the Global Router Link State Advertisement returned by the 
  * Global Router represented by this SPFVertex during the route discovery 
@@ -528,6 +545,7 @@ public:
 private:
   VertexType m_vertexType; //!< Vertex type
   Ipv4Address m_vertexId; //!< Vertex ID
+  uint32_t m_vertexIndex; //!< Index of the vertex in the LSDB adjacency arrays
   GlobalRoutingLSA* m_lsa; //!< Link State Advertisement
   uint32_t m_distanceFromRoot; //!< Distance from root node
   int32_t m_rootOif; //!< root Output Interface
@@ -674,6 +692,64 @@ public:
    */
   uint32_t GetNumExtLSAs () const;
 
+  /**
+   * @brief An edge of the graph of the transit vertices (routers and transit
+   * networks) described by the Link State Advertisements.
+   */
+  struct Edge
+  {
+    uint32_t vertex; //!< Index of the vertex at the end of the edge
+    GlobalRoutingLinkRecord *link; //!< Link record of a router vertex (0 from a network vertex)
+  };
+
+  /**
+   * @brief Build the adjacency arrays of the database.
+   *
+   * The router and network LSAs are numbered in the order of their link
+   * state IDs, and the point-to-point and transit links of each router LSA,
+   * as well as the attached routers of each network LSA, are resolved once
+   * into a compact array of edges, in the order of the LSA records.  This
+   * avoids the database look ups during the SPF calculations, which only
+   * read the arrays and can therefore run concurrently.
+   *
+   * Inserting a new LSA invalidates the arrays.
+   */
+  void BuildAdjacencyArrays ();
+
+  /**
+   * @returns True if the adjacency arrays are up to date.
+   */
+  bool HasAdjacencyArrays () const;
+
+  /**
+   * @returns The number of router and network LSAs in the adjacency arrays.
+   */
+  uint32_t GetNVertices () const;
+
+  /**
+   * @param addr The link state ID of an LSA.
+   * @returns The index of the LSA in the adjacency arrays, or -1 if not found.
+   */
+  int32_t GetVertexIndex (Ipv4Address addr) const;
+
+  /**
+   * @param index The index of a vertex.
+   * @returns The LSA of the vertex.
+   */
+  GlobalRoutingLSA* GetVertexLSA (uint32_t index) const;
+
+  /**
+   * @param index The index of a vertex.
+   * @returns The number of edges leaving the vertex.
+   */
+  uint32_t GetNEdges (uint32_t index) const;
+
+  /**
+   * @param index The index of a vertex.
+   * @param i The index of the edge, among the edges leaving the vertex.
+   * @returns The edge.
+   */
+  const Edge& GetEdge (uint32_t index, uint32_t i) const;
 
 private:
   typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
@@ -681,6 +757,13 @@ private:
 
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
+  LSDBMap_t m_linkDataIndex; //!< LSAs by the link data of their transit network link records
+
+  bool m_adjacencyValid; //!< whether the adjacency arrays are up to date
+  std::vector<GlobalRoutingLSA*> m_vertices; //!< LSAs of the vertices, by index
+  std::map<Ipv4Address, uint32_t> m_vertexIndices; //!< indices of the vertices, by link state ID
+  std::vector<uint32_t> m_edgeOffsets; //!< index of the first edge of each vertex, plus the total number of edges
+  std::vector<Edge> m_edges; //!< edges of all the vertices
 
 /**
  * @brief GlobalRouteManagerLSDB copy construction is disallowed.  There's no 
@@ -732,9 +815,24 @@ public:
 /**
  * @brief Compute routes using a Dijkstra SPF computation and populate
  * per-node forwarding tables
+ *
+ * The shortest path trees of the routers are computed by the number of
+ * threads given by the "GlobalRoutingThreads" global value.
  */
   virtual void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and recompute the routes of the
+ * routers affected by the changes of the database.
+ *
+ * The routes of a router are recomputed only if one of the Link State
+ * Advertisements its shortest path tree was built from changed (or if the
+ * AS external LSAs or the addresses of its interfaces changed).  If the
+ * routes were not computed with InitializeRoutes () beforehand, all the
+ * routes are deleted and recomputed.
+ */
+  virtual void UpdateRoutes ();
+
 /**
  * @brief Debugging routine; allow client code to supply a pre-built LSDB
  */
@@ -766,9 +864,145 @@ private:
  */
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
+  /**
+   * \brief A router at the root of an SPF calculation.
+   */
+  struct SPFRoot
+  {
+    Ipv4Address routerId; //!< the router ID
+    Ptr<Ipv4GlobalRouting> routing; //!< the routing protocol to add the routes to (0 if unknown)
+    std::vector<std::vector<Ipv4Address> > interfaces; //!< the local addresses of the router, by interface
+  };
+
+  /**
+   * \brief A route computed by an SPF calculation.
+   */
+  struct SPFRoute
+  {
+    /// The kind of route
+    enum Type
+    {
+      HOST,     //!< host route, from a router LSA
+      NETWORK,  //!< network route, from a stub link or a network LSA
+      EXTERNAL  //!< AS external route
+    };
+    Type type;           //!< the kind of route
+    Ipv4Address dest;    //!< the destination
+    Ipv4Mask mask;       //!< the network mask (network and external routes)
+    Ipv4Address nextHop; //!< the next hop
+    int32_t outIf;       //!< the output interface
+  };
+
+  /**
+   * \brief What the routes of a router were computed from.
+   */
+  struct SPFDependencies
+  {
+    std::vector<Ipv4Address> lsas; //!< link state IDs of the LSAs read by the calculation, sorted
+    std::vector<std::vector<Ipv4Address> > interfaces; //!< the local addresses of the router, by interface
+  };
+
+  /**
+   * \brief The output of the SPF calculation of a router.
+   */
+  struct SPFResult
+  {
+    std::vector<SPFRoute> routes; //!< the routes, in the order they must be added
+    SPFDependencies dependencies; //!< what the routes were computed from
+  };
+
+  /**
+   * \brief The roots assigned to a worker computing SPF trees in its own thread.
+   */
+  struct SPFJob
+  {
+    const std::vector<SPFRoot> *roots; //!< all the roots
+    std::vector<SPFResult> *results;   //!< the results of all the roots
+    uint32_t first;  //!< index of the first root of the worker
+    uint32_t stride; //!< number of workers
+  };
+
   SPFVertex* m_spfroot; //!< the root node
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
 
+  const SPFRoot* m_root; //!< the router at the root of the current SPF calculation
+  bool m_checkStubNodes; //!< whether stub routers get a default route instead of an SPF tree
+  std::vector<GlobalRoutingLSA::SPFStatus> m_status; //!< status of the LSDB vertices in the current SPF calculation
+  SPFResult m_result; //!< output of the current SPF calculation
+  SPFJob m_job; //!< the roots of a worker
+
+  std::map<Ipv4Address, SPFDependencies> m_dependencies; //!< what the routes of each router were computed from
+  bool m_incremental; //!< whether m_dependencies describes the routes in the routing tables
+
+  /**
+   * \brief Get the routers whose routes are computed by this system
+   * \return the routers having LSAs in the routing database
+   */
+  std::vector<SPFRoot> GetRoots (void) const;
+
+  /**
+   * \brief Compute the routes of a set of routers and add them to their
+   * routing tables
+   *
+   * \param roots the routers
+   */
+  void CalculateRoutes (const std::vector<SPFRoot> &roots);
+
+  /**
+   * \brief Calculate the shortest path first (SPF) tree of a router, the
+   * routes being stored in m_result
+   *
+   * Equivalent to quagga ospf_spf_calculate.  Only the LSDB (read-only) and
+   * the state of the current calculation are accessed, hence several
+   * calculations can run in parallel in distinct GlobalRouteManagerImpl
+   * objects sharing the same LSDB.
+   *
+   * \param root the router
+   */
+  void SPFCalculate (const SPFRoot &root);
+
+  /**
+   * \brief Entry point of the worker threads: compute the SPF trees of the
+   * roots described by m_job
+   */
+  void RunJob (void);
+
+  /**
+   * \brief Add the routes computed for a router to its routing table
+   *
+   * \param root the router
+   * \param routes the routes
+   */
+  static void AddRoutes (const SPFRoot &root, const std::vector<SPFRoute> &routes);
+
+  /**
+   * \brief Record a route computed by the current SPF calculation
+   *
+   * \param type the kind of route
+   * \param dest the destination
+   * \param mask the network mask
+   * \param nextHop the next hop
+   * \param outIf the output interface
+   */
+  void AddSPFRoute (SPFRoute::Type type, Ipv4Address dest, Ipv4Mask mask,
+                    Ipv4Address nextHop, int32_t outIf);
+
+  /**
+   * \brief Remove all the routes of a routing protocol
+   *
+   * \param gr the routing protocol
+   */
+  static void DeleteRoutes (Ptr<Ipv4GlobalRouting> gr);
+
+  /**
+   * \brief Compare two Link State Advertisements
+   *
+   * \param a first LSA
+   * \param b second LSA
+   * \return true if both LSAs have the same contents
+   */
+  static bool IsSameLSA (const GlobalRoutingLSA *a, const GlobalRoutingLSA *b);
+
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
    *
@@ -782,9 +1016,9 @@ private:
   bool CheckForStubNode (Ipv4Address root);
 
   /**
-   * \brief Calculate the shortest path first (SPF) tree
+   * \brief Calculate the shortest path first (SPF) tree and add the routes
+   * to the routing table of the root node
    *
-   * Equivalent to quagga ospf_spf_calculate
    * \param root the root node
    */
   void SPFCalculate (Ipv4Address root);
@@ -65,6 +65,12 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and recompute the routes of the
+ * routers affected by the changes since the routes were computed
+ */
+  static void UpdateGlobalRoutes ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
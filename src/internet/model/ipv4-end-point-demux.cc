@@ -23,11 +23,41 @@
 #include "ipv4-interface-address.h"
 #include "ns3/log.h"
 
+#include <algorithm>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
+bool
+Ipv4EndPointDemux::ConnectionKey::operator == (const ConnectionKey &other) const
+{
+  return localAddress == other.localAddress && localPort == other.localPort
+         && peerAddress == other.peerAddress && peerPort == other.peerPort;
+}
+
+size_t
+Ipv4EndPointDemux::ConnectionKeyHash::operator () (const ConnectionKey &key) const
+{
+  uint64_t local = (static_cast<uint64_t> (key.localAddress.Get ()) << 16) | key.localPort;
+  uint64_t peer = (static_cast<uint64_t> (key.peerAddress.Get ()) << 16) | key.peerPort;
+  uint64_t h = (local * 0x9e3779b97f4a7c15ULL) ^ peer;
+  return static_cast<size_t> (h ^ (h >> 32));
+}
+
+bool
+Ipv4EndPointDemux::LocalKey::operator == (const LocalKey &other) const
+{
+  return address == other.address && port == other.port && device == other.device;
+}
+
+size_t
+Ipv4EndPointDemux::LocalKeyHash::operator () (const LocalKey &key) const
+{
+  uint64_t h = ((static_cast<uint64_t> (key.address.Get ()) << 16) | key.port) * 0x9e3779b97f4a7c15ULL;
+  return static_cast<size_t> (h ^ (h >> 32)) ^ std::hash<NetDevice *> () (key.device);
+}
+
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
   : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
 {
@@ -40,39 +70,104 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
 }
 
-bool
-Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv4EndPoint *
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  NS_LOG_FUNCTION (this << endPoint);
+  m_positions[endPoint] = m_endPoints.insert (m_endPoints.end (), endPoint);
+  AddToIndex (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+void
+Ipv4EndPointDemux::AddToIndex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  endPoint->m_demux = this;
+  uint16_t port = endPoint->GetLocalPort ();
+  m_ports[port]++;
+  LocalKey local = {endPoint->GetLocalAddress (), port, PeekPointer (endPoint->GetBoundNetDevice ())};
+  m_locals[local]++;
+  if (endPoint->GetPeerAddress () == Ipv4Address::GetAny () && endPoint->GetPeerPort () == 0)
+    {
+      m_listeners[port].push_back (endPoint);
+    }
+  else
     {
-      if ((*i)->GetLocalPort  () == port) 
+      ConnectionKey key = {endPoint->GetLocalAddress (), port,
+                           endPoint->GetPeerAddress (), endPoint->GetPeerPort ()};
+      m_connections[key].push_back (endPoint);
+    }
+}
+
+void
+Ipv4EndPointDemux::RemoveFromIndex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint16_t port = endPoint->GetLocalPort ();
+  std::unordered_map<uint16_t, uint32_t>::iterator portIt = m_ports.find (port);
+  NS_ASSERT (portIt != m_ports.end ());
+  if (--portIt->second == 0)
+    {
+      m_ports.erase (portIt);
+    }
+  LocalKey local = {endPoint->GetLocalAddress (), port, PeekPointer (endPoint->GetBoundNetDevice ())};
+  std::unordered_map<LocalKey, uint32_t, LocalKeyHash>::iterator localIt = m_locals.find (local);
+  NS_ASSERT (localIt != m_locals.end ());
+  if (--localIt->second == 0)
+    {
+      m_locals.erase (localIt);
+    }
+
+  EndPointVector *endPoints;
+  if (endPoint->GetPeerAddress () == Ipv4Address::GetAny () && endPoint->GetPeerPort () == 0)
+    {
+      endPoints = &m_listeners[port];
+    }
+  else
+    {
+      ConnectionKey key = {endPoint->GetLocalAddress (), port,
+                           endPoint->GetPeerAddress (), endPoint->GetPeerPort ()};
+      endPoints = &m_connections[key];
+    }
+  EndPointVector::iterator it = std::find (endPoints->begin (), endPoints->end (), endPoint);
+  NS_ASSERT (it != endPoints->end ());
+  endPoints->erase (it);
+  if (endPoints->empty ())
+    {
+      if (endPoint->GetPeerAddress () == Ipv4Address::GetAny () && endPoint->GetPeerPort () == 0)
+        {
+          m_listeners.erase (port);
+        }
+      else
         {
-          return true;
+          ConnectionKey key = {endPoint->GetLocalAddress (), port,
+                               endPoint->GetPeerAddress (), endPoint->GetPeerPort ()};
+          m_connections.erase (key);
         }
     }
-  return false;
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr &&
-          (*i)->GetBoundNetDevice () == boundNetDevice)
-        {
-          return true;
-        }
-    }
-  return false;
+  LocalKey local = {addr, port, PeekPointer (boundNetDevice)};
+  return m_locals.find (local) != m_locals.end ();
 }
 
 Ipv4EndPoint *
@@ -85,10 +180,7 @@ Ipv4EndPointDemux::Allocate (void)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (Ipv4Address::GetAny (), port));
 }
 
 Ipv4EndPoint *
@@ -101,10 +193,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -124,10 +213,7 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv4Address address,
       NS_LOG_WARN ("Duplicated endpoint.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -136,39 +222,53 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  const EndPointVector *endPoints = 0;
+  if (peerAddress == Ipv4Address::GetAny () && peerPort == 0)
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress &&
-          ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+      std::unordered_map<uint16_t, EndPointVector>::const_iterator it = m_listeners.find (localPort);
+      if (it != m_listeners.end ())
         {
-          NS_LOG_WARN ("Duplicated endpoint.");
-          return 0;
+          endPoints = &it->second;
+        }
+    }
+  else
+    {
+      ConnectionKey key = {localAddress, localPort, peerAddress, peerPort};
+      std::unordered_map<ConnectionKey, EndPointVector, ConnectionKeyHash>::const_iterator it = m_connections.find (key);
+      if (it != m_connections.end ())
+        {
+          endPoints = &it->second;
+        }
+    }
+  if (endPoints != 0)
+    {
+      for (EndPointVector::const_iterator i = endPoints->begin (); i != endPoints->end (); i++)
+        {
+          if ((*i)->GetLocalAddress () == localAddress &&
+              ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+            {
+              NS_LOG_WARN ("Duplicated endpoint.");
+              return 0;
+            }
         }
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void 
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<Ipv4EndPoint *, EndPointsI>::iterator it = m_positions.find (endPoint);
+  if (it != m_positions.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      RemoveFromIndex (endPoint);
+      endPoint->m_demux = 0;
+      m_endPoints.erase (it->second);
+      m_positions.erase (it);
+      delete endPoint;
     }
 }
 
@@ -208,7 +308,46 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr << ":" << dport);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+
+  // The candidates are the endpoints without peer on the destination port,
+  // and the endpoints whose peer is the source and whose local address
+  // could match the destination: the destination itself, the wildcard, or
+  // a subnet of the incoming interface.
+  EndPointVector candidates;
+  std::unordered_map<uint16_t, EndPointVector>::const_iterator listeners = m_listeners.find (dport);
+  if (listeners != m_listeners.end ())
+    {
+      candidates = listeners->second;
+    }
+  std::vector<Ipv4Address> localAddresses;
+  localAddresses.push_back (daddr);
+  if (daddr != Ipv4Address::GetAny ())
+    {
+      localAddresses.push_back (Ipv4Address::GetAny ());
+    }
+  if (incomingInterface != 0)
+    {
+      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+        {
+          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+          Ipv4Address addrNetpart = addr.GetLocal ().CombineMask (addr.GetMask ());
+          if (std::find (localAddresses.begin (), localAddresses.end (), addrNetpart) == localAddresses.end ())
+            {
+              localAddresses.push_back (addrNetpart);
+            }
+        }
+    }
+  for (std::vector<Ipv4Address>::const_iterator i = localAddresses.begin (); i != localAddresses.end (); i++)
+    {
+      ConnectionKey key = {*i, dport, saddr, sport};
+      std::unordered_map<ConnectionKey, EndPointVector, ConnectionKeyHash>::const_iterator connections = m_connections.find (key);
+      if (connections != m_connections.end ())
+        {
+          candidates.insert (candidates.end (), connections->second.begin (), connections->second.end ());
+        }
+    }
+
+  for (EndPointVector::const_iterator i = candidates.begin (); i != candidates.end (); i++)
     {
       Ipv4EndPoint* endP = *i;
 
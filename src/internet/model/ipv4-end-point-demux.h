@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
+#include <unordered_map>
 #include "ns3/ipv4-address.h"
 #include "ipv4-interface.h"
 
@@ -40,6 +42,12 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are indexed by their four-tuple when they have a peer, and
+ * by their local port otherwise, so that a lookup only looks at the few
+ * endpoints that could match the packet, whatever the number of connections
+ * on the node.  The endpoints notify the demux when their addresses, ports
+ * or bound NetDevice change.
  */
 
 class Ipv4EndPointDemux {
@@ -166,6 +174,88 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief Key of the endpoints having a peer.
+   */
+  struct ConnectionKey
+  {
+    Ipv4Address localAddress; //!< local address
+    uint16_t localPort;       //!< local port
+    Ipv4Address peerAddress;  //!< peer address
+    uint16_t peerPort;        //!< peer port
+
+    /**
+     * \param other the other key
+     * \return true if the keys are equal
+     */
+    bool operator == (const ConnectionKey &other) const;
+  };
+
+  /**
+   * \brief Hash of a ConnectionKey.
+   */
+  struct ConnectionKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator () (const ConnectionKey &key) const;
+  };
+
+  /**
+   * \brief Key of the endpoints by local address, port and bound NetDevice.
+   */
+  struct LocalKey
+  {
+    Ipv4Address address; //!< local address
+    uint16_t port;       //!< local port
+    NetDevice *device;   //!< bound NetDevice (if any)
+
+    /**
+     * \param other the other key
+     * \return true if the keys are equal
+     */
+    bool operator == (const LocalKey &other) const;
+  };
+
+  /**
+   * \brief Hash of a LocalKey.
+   */
+  struct LocalKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator () (const LocalKey &key) const;
+  };
+
+  /**
+   * \brief Container of the endpoints sharing an index key.
+   */
+  typedef std::vector<Ipv4EndPoint *> EndPointVector;
+
+  /**
+   * \brief Add a newly created endpoint to the list and to the indexes.
+   * \param endPoint the endpoint
+   * \return the endpoint
+   */
+  Ipv4EndPoint *Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Add an endpoint to the indexes.
+   * \param endPoint the endpoint
+   */
+  void AddToIndex (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an endpoint from the indexes.
+   * \param endPoint the endpoint
+   */
+  void RemoveFromIndex (Ipv4EndPoint *endPoint);
 
   /**
    * \brief Allocate an ephemeral port.
@@ -192,6 +282,31 @@ private:
    * \brief A list of IPv4 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief Position of each endpoint in the list.
+   */
+  std::unordered_map<Ipv4EndPoint *, EndPointsI> m_positions;
+
+  /**
+   * \brief Endpoints having a peer, by four-tuple.
+   */
+  std::unordered_map<ConnectionKey, EndPointVector, ConnectionKeyHash> m_connections;
+
+  /**
+   * \brief Endpoints without peer, by local port.
+   */
+  std::unordered_map<uint16_t, EndPointVector> m_listeners;
+
+  /**
+   * \brief Number of endpoints by local address, port and bound NetDevice.
+   */
+  std::unordered_map<LocalKey, uint32_t, LocalKeyHash> m_locals;
+
+  /**
+   * \brief Number of endpoints by local port.
+   */
+  std::unordered_map<uint16_t, uint32_t> m_ports;
 };
 
 } // namespace ns3
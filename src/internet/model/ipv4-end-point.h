@@ -31,6 +31,7 @@
 namespace ns3 {
 
 class Header;
+class Ipv4EndPointDemux;
 class Packet;
 
 /**
@@ -227,6 +228,16 @@ private:
    * \brief true if the endpoint can receive packets.
    */
   bool m_rxEnabled;
+
+  /**
+   * \brief The demux indexing this endpoint (if any).
+   *
+   * The demux is notified when the addresses, ports or bound NetDevice
+   * of the endpoint change.
+   */
+  Ipv4EndPointDemux *m_demux;
+
+  friend class Ipv4EndPointDemux;
 };
 
 } // namespace ns3
@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ipv4-queue-disc-item.h"
+#include "ipv4-five-tuple-packet-filter.h"
+#include "tcp-l4-protocol.h"
+#include "udp-l4-protocol.h"
+
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4FiveTuplePacketFilter");
+
+NS_OBJECT_ENSURE_REGISTERED (Ipv4FiveTuplePacketFilter);
+
+TypeId
+Ipv4FiveTuplePacketFilter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Ipv4FiveTuplePacketFilter")
+    .SetParent<Ipv4PacketFilter> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<Ipv4FiveTuplePacketFilter> ()
+  ;
+  return tid;
+}
+
+Ipv4FiveTuplePacketFilter::Ipv4FiveTuplePacketFilter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ipv4FiveTuplePacketFilter::~Ipv4FiveTuplePacketFilter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+Ipv4FiveTuplePacketFilter::AddRule (const TupleSpaceClassifier::Rule &rule)
+{
+  NS_LOG_FUNCTION (this << rule.priority << rule.value);
+  NS_ABORT_MSG_IF (rule.value > static_cast<uint32_t> (std::numeric_limits<int32_t>::max ()),
+                   "Invalid class index " << rule.value);
+  m_classifier.Add (rule);
+}
+
+void
+Ipv4FiveTuplePacketFilter::ClearRules (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_classifier.Clear ();
+}
+
+uint32_t
+Ipv4FiveTuplePacketFilter::GetNRules (void) const
+{
+  return m_classifier.GetNRules ();
+}
+
+int32_t
+Ipv4FiveTuplePacketFilter::DoClassify (Ptr<QueueDiscItem> item) const
+{
+  NS_LOG_FUNCTION (this << item);
+  Ptr<Ipv4QueueDiscItem> ipv4Item = StaticCast<Ipv4QueueDiscItem> (item);
+  const Ipv4Header &header = ipv4Item->GetHeader ();
+
+  TupleSpaceClassifier::Key key;
+  key.SetSource (header.GetSource ());
+  key.SetDestination (header.GetDestination ());
+  key.protocol = header.GetProtocol ();
+  key.tos = header.GetTos ();
+  if ((key.protocol == TcpL4Protocol::PROT_NUMBER || key.protocol == UdpL4Protocol::PROT_NUMBER)
+      && header.GetFragmentOffset () == 0)
+    {
+      // both TCP and UDP headers start with the source and destination ports
+      uint8_t buf[4];
+      if (item->GetPacket ()->CopyData (buf, 4) == 4)
+        {
+          key.sourcePort = (buf[0] << 8) | buf[1];
+          key.destinationPort = (buf[2] << 8) | buf[3];
+        }
+    }
+
+  const TupleSpaceClassifier::Rule *rule = m_classifier.Lookup (key);
+  if (rule == 0)
+    {
+      NS_LOG_LOGIC ("No match");
+      return PacketFilter::PF_NO_MATCH;
+    }
+  NS_LOG_LOGIC ("Match, class " << rule->value);
+  return rule->value;
+}
+
+} // namespace ns3
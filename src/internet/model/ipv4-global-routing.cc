@@ -18,8 +18,10 @@
 
 #include <vector>
 #include <iomanip>
+#include <algorithm>
 #include "ns3/names.h"
 #include "ns3/log.h"
+#include "ns3/unused.h"
 #include "ns3/simulator.h"
 #include "ns3/object.h"
 #include "ns3/packet.h"
@@ -59,7 +61,8 @@ Ipv4GlobalRouting::GetTypeId (void)
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_respondToInterfaceEvents (false),
+    m_routeSequence (0)
 {
   NS_LOG_FUNCTION (this);
 
@@ -80,6 +83,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  IndexRoute (m_hostRouteTrie, route);
 }
 
 void 
@@ -90,6 +94,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  IndexRoute (m_hostRouteTrie, route);
 }
 
 void 
@@ -105,6 +110,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  IndexRoute (m_networkRouteTrie, route);
 }
 
 void 
@@ -118,6 +124,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  IndexRoute (m_networkRouteTrie, route);
 }
 
 void 
@@ -133,6 +140,7 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  IndexRoute (m_externalRouteTrie, route);
 }
 
 
@@ -146,72 +154,68 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
 
+  uint8_t addr[16];
+  RouteTrie::Serialize (dest, addr);
+  RouteTrie::MatchArray matches;
+  std::vector<IndexedRoute> candidates;
+
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  uint32_t nMatches = m_hostRouteTrie.Lookup (addr, matches);
+  if (nMatches > 0)
+    {
+      // host routes are indexed with their /32 prefix only
+      candidates.assign (matches[0]->begin (), matches[0]->end ());
+    }
+  for (std::vector<IndexedRoute>::const_iterator i = candidates.begin (); i != candidates.end (); i++)
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
+      NS_ASSERT (i->route->IsHost ());
+      if (oif != 0)
         {
-          if (oif != 0)
+          if (oif != m_ipv4->GetNetDevice (i->route->GetInterface ()))
             {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
-                {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
-                }
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
+              continue;
             }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
         }
+      allRoutes.push_back (i->route);
+      NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << i->route);
     }
   if (allRoutes.size () == 0) // if no host route is found
     {
       NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      // all the matching network routes are equal-cost candidates,
+      // whatever their prefix length, in the order they were added
+      GetCandidates (m_networkRouteTrie, addr, candidates);
+      for (std::vector<IndexedRoute>::const_iterator j = candidates.begin (); j != candidates.end (); j++)
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          if (oif != 0)
             {
-              if (oif != 0)
+              if (oif != m_ipv4->GetNetDevice (j->route->GetInterface ()))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
+                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  continue;
                 }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
             }
+          allRoutes.push_back (j->route);
+          NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << j->route);
         }
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
+      GetCandidates (m_externalRouteTrie, addr, candidates);
+      for (std::vector<IndexedRoute>::const_iterator k = candidates.begin (); k != candidates.end (); k++)
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
+          NS_LOG_LOGIC ("Found external route" << k->route);
+          if (oif != 0)
             {
-              NS_LOG_LOGIC ("Found external route" << *k);
-              if (oif != 0)
+              if (oif != m_ipv4->GetNetDevice (k->route->GetInterface ()))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
+                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  continue;
                 }
-              allRoutes.push_back (*k);
-              break;
             }
+          allRoutes.push_back (k->route);
+          break;
         }
     }
   if (allRoutes.size () > 0 ) // if route(s) is found
@@ -245,6 +249,67 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 }
 
+void
+Ipv4GlobalRouting::IndexRoute (RouteTrie &trie, Ipv4RoutingTableEntry *route)
+{
+  NS_LOG_FUNCTION (this << route);
+  IndexedRoute indexed;
+  indexed.sequence = m_routeSequence++;
+  indexed.route = route;
+  uint8_t prefix[16];
+  if (route->IsHost ())
+    {
+      RouteTrie::Serialize (route->GetDest (), prefix);
+      trie.Insert (prefix, 32, indexed);
+    }
+  else
+    {
+      RouteTrie::Serialize (route->GetDestNetwork (), prefix);
+      trie.Insert (prefix, route->GetDestNetworkMask ().GetPrefixLength (), indexed);
+    }
+}
+
+void
+Ipv4GlobalRouting::UnindexRoute (RouteTrie &trie, Ipv4RoutingTableEntry *route)
+{
+  NS_LOG_FUNCTION (this << route);
+  IndexedRoute indexed;
+  indexed.sequence = 0;
+  indexed.route = route;
+  uint8_t prefix[16];
+  bool found;
+  if (route->IsHost ())
+    {
+      RouteTrie::Serialize (route->GetDest (), prefix);
+      found = trie.Remove (prefix, 32, indexed);
+    }
+  else
+    {
+      RouteTrie::Serialize (route->GetDestNetwork (), prefix);
+      found = trie.Remove (prefix, route->GetDestNetworkMask ().GetPrefixLength (), indexed);
+    }
+  NS_ASSERT_MSG (found, "Route not indexed");
+  NS_UNUSED (found);
+}
+
+void
+Ipv4GlobalRouting::GetCandidates (const RouteTrie &trie, const uint8_t addr[16],
+                                  std::vector<IndexedRoute> &candidates) const
+{
+  RouteTrie::MatchArray matches;
+  uint32_t nMatches = trie.Lookup (addr, matches);
+  candidates.clear ();
+  for (uint32_t m = 0; m < nMatches; m++)
+    {
+      candidates.insert (candidates.end (), matches[m]->begin (), matches[m]->end ());
+    }
+  if (nMatches > 1)
+    {
+      std::sort (candidates.begin (), candidates.end (),
+                 [] (const IndexedRoute &a, const IndexedRoute &b) { return a.sequence < b.sequence; });
+    }
+}
+
 uint32_t 
 Ipv4GlobalRouting::GetNRoutes (void) const
 {
@@ -319,6 +384,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           if (tmp  == index)
             {
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
+              UnindexRoute (m_hostRouteTrie, *i);
               delete *i;
               m_hostRoutes.erase (i);
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
@@ -336,6 +402,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
+          UnindexRoute (m_networkRouteTrie, *j);
           delete *j;
           m_networkRoutes.erase (j);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -352,6 +419,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
+          UnindexRoute (m_externalRouteTrie, *k);
           delete *k;
           m_ASexternalRoutes.erase (k);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -374,6 +442,9 @@ void
 Ipv4GlobalRouting::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  m_hostRouteTrie.Clear ();
+  m_networkRouteTrie.Clear ();
+  m_externalRouteTrie.Clear ();
   for (HostRoutesI i = m_hostRoutes.begin (); 
        i != m_hostRoutes.end (); 
        i = m_hostRoutes.erase (i)) 
@@ -537,9 +608,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateGlobalRoutes ();
     }
 }
 
@@ -549,9 +618,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateGlobalRoutes ();
     }
 }
 
@@ -561,9 +628,7 @@ Ipv4GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress ad
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateGlobalRoutes ();
     }
 }
 
@@ -573,9 +638,7 @@ Ipv4GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateGlobalRoutes ();
     }
 }
 
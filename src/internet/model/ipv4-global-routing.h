@@ -28,6 +28,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/ip-prefix-trie.h"
 
 namespace ns3 {
 
@@ -268,10 +269,56 @@ private:
    */
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /// A route indexed by destination prefix
+  struct IndexedRoute
+  {
+    uint64_t sequence;             //!< the order in which the route was added
+    Ipv4RoutingTableEntry *route;  //!< the route
+    /**
+     * \param other the indexed route to compare with
+     * \return true if both refer to the same route
+     */
+    bool operator == (const IndexedRoute &other) const
+    {
+      return route == other.route;
+    }
+  };
+
+  /// prefix trie of routes
+  typedef IpPrefixTrie<IndexedRoute> RouteTrie;
+
+  /**
+   * \brief Index a route by its destination prefix.
+   * \param trie the trie
+   * \param route the route
+   */
+  void IndexRoute (RouteTrie &trie, Ipv4RoutingTableEntry *route);
+
+  /**
+   * \brief Remove a route from the index.
+   * \param trie the trie
+   * \param route the route
+   */
+  void UnindexRoute (RouteTrie &trie, Ipv4RoutingTableEntry *route);
+
+  /**
+   * \brief Get the routes whose prefix matches an address.
+   * \param trie the trie
+   * \param addr the address
+   * \param candidates the matching routes, in the order they were added
+   */
+  void GetCandidates (const RouteTrie &trie, const uint8_t addr[16],
+                      std::vector<IndexedRoute> &candidates) const;
+
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  RouteTrie m_hostRouteTrie;     //!< Routes to hosts, by destination
+  RouteTrie m_networkRouteTrie;  //!< Routes to networks, by destination prefix
+  RouteTrie m_externalRouteTrie; //!< External routes, by destination prefix
+  uint64_t m_routeSequence;      //!< Number of routes added so far
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -584,7 +584,10 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
 
   if (ipv4Interface->IsUp ())
     {
-      m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+      if (!m_rxTrace.IsEmpty ())
+        {
+          m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+        }
     }
   else
     {
@@ -740,6 +743,10 @@ void
 Ipv4L3Protocol::CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet,
                                     Ptr<Ipv4> ipv4, uint32_t interface)
 {
+  if (m_txTrace.IsEmpty ())
+    {
+      return;
+    }
   Ptr<Packet> packetCopy = packet->Copy ();
   packetCopy->AddHeader (ipHeader);
   m_txTrace (packetCopy, ipv4, interface);
@@ -25,6 +25,7 @@
 
 #include <iomanip>
 #include "ns3/log.h"
+#include "ns3/unused.h"
 #include "ns3/names.h"
 #include "ns3/packet.h"
 #include "ns3/node.h"
@@ -72,7 +73,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         nextHop,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  InsertNetworkRoute (route, metric);
 }
 
 void 
@@ -86,7 +87,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  InsertNetworkRoute (route, metric);
 }
 
 void 
@@ -143,7 +144,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         outputInterface);
-  m_networkRoutes.push_back (make_pair (route,0));
+  InsertNetworkRoute (route, 0);
 }
 
 uint32_t 
@@ -224,8 +225,6 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION (this << dest << " " << oif);
   Ptr<Ipv4Route> rtentry = 0;
-  uint16_t longest_mask = 0;
-  uint32_t shortest_metric = 0xffffffff;
   /* when sending on local multicast, there have to be interface specified */
   if (dest.IsLocalMulticast ())
     {
@@ -240,18 +239,23 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
-       i++) 
+  // visit the prefixes matching the destination, longest first, and
+  // stop at the first one holding a route on the requested interface
+  uint8_t addr[16];
+  IpPrefixTrie<NetworkRoutesI>::Serialize (dest, addr);
+  IpPrefixTrie<NetworkRoutesI>::MatchArray matches;
+  uint32_t nMatches = m_networkRouteTrie.Lookup (addr, matches);
+  for (uint32_t m = 0; m < nMatches && rtentry == 0; m++)
     {
-      Ipv4RoutingTableEntry *j=i->first;
-      uint32_t metric =i->second;
-      Ipv4Mask mask = (j)->GetDestNetworkMask ();
-      uint16_t masklen = mask.GetPrefixLength ();
-      Ipv4Address entry = (j)->GetDestNetwork ();
-      NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
-      if (mask.IsMatch (dest, entry)) 
+      Ipv4RoutingTableEntry *route = 0;
+      uint32_t shortest_metric = 0xffffffff;
+      for (std::vector<NetworkRoutesI>::const_iterator i = matches[m]->begin ();
+           i != matches[m]->end ();
+           i++)
         {
+          Ipv4RoutingTableEntry *j = (*i)->first;
+          uint32_t metric = (*i)->second;
+          uint16_t masklen = j->GetDestNetworkMask ().GetPrefixLength ();
           NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
           if (oif != 0)
             {
@@ -261,33 +265,26 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
                   continue;
                 }
             }
-          if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-              NS_LOG_LOGIC ("Previous match longer, skipping");
-              continue;
-            }
-          if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-              shortest_metric = 0xffffffff;
-            }
-          longest_mask = masklen;
           if (metric > shortest_metric)
             {
               NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
               continue;
             }
           shortest_metric = metric;
-          Ipv4RoutingTableEntry* route = (j);
+          route = j;
+          if (masklen == 32)
+            {
+              break;
+            }
+        }
+      if (route != 0)
+        {
           uint32_t interfaceIdx = route->GetInterface ();
           rtentry = Create<Ipv4Route> ();
           rtentry->SetDestination (route->GetDest ());
           rtentry->SetSource (m_ipv4->SourceAddressSelection (interfaceIdx, route->GetDest ()));
           rtentry->SetGateway (route->GetGateway ());
           rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-          if (masklen == 32)
-            {
-              break;
-            }
         }
     }
   if (rtentry != 0)
@@ -353,6 +350,29 @@ Ipv4StaticRouting::LookupStatic (
   return mrtentry;
 }
 
+void
+Ipv4StaticRouting::InsertNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  NetworkRoutesI it = m_networkRoutes.insert (m_networkRoutes.end (), std::make_pair (route, metric));
+  uint8_t prefix[16];
+  IpPrefixTrie<NetworkRoutesI>::Serialize (route->GetDestNetwork (), prefix);
+  m_networkRouteTrie.Insert (prefix, route->GetDestNetworkMask ().GetPrefixLength (), it);
+}
+
+Ipv4StaticRouting::NetworkRoutesI
+Ipv4StaticRouting::EraseNetworkRoute (NetworkRoutesI it)
+{
+  NS_LOG_FUNCTION (this << it->first);
+  uint8_t prefix[16];
+  IpPrefixTrie<NetworkRoutesI>::Serialize (it->first->GetDestNetwork (), prefix);
+  bool found = m_networkRouteTrie.Remove (prefix, it->first->GetDestNetworkMask ().GetPrefixLength (), it);
+  NS_ASSERT_MSG (found, "Route not indexed");
+  NS_UNUSED (found);
+  delete it->first;
+  return m_networkRoutes.erase (it);
+}
+
 uint32_t 
 Ipv4StaticRouting::GetNRoutes (void) const
 {
@@ -447,8 +467,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete j->first;
-          m_networkRoutes.erase (j);
+          EraseNetworkRoute (j);
           return;
         }
       tmp++;
@@ -569,6 +588,7 @@ void
 Ipv4StaticRouting::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  m_networkRouteTrie.Clear ();
   for (NetworkRoutesI j = m_networkRoutes.begin (); 
        j != m_networkRoutes.end (); 
        j = m_networkRoutes.erase (j)) 
@@ -613,8 +633,7 @@ Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
     {
       if (it->first->GetInterface () == i)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = EraseNetworkRoute (it);
         }
       else
         {
@@ -660,8 +679,7 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkMask () == networkMask)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = EraseNetworkRoute (it);
         }
       else
         {
@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ip-prefix-trie.h"
 
 namespace ns3 {
 
@@ -413,11 +414,30 @@ private:
   Ptr<Ipv4MulticastRoute> LookupStatic (Ipv4Address origin, Ipv4Address group,
                                         uint32_t interface);
 
+  /**
+   * \brief Append a route to the network routes and index it.
+   * \param route the route
+   * \param metric the metric of the route
+   */
+  void InsertNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric);
+
+  /**
+   * \brief Delete a network route.
+   * \param it the route
+   * \return the route following the deleted one
+   */
+  NetworkRoutesI EraseNetworkRoute (NetworkRoutesI it);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the network routes indexed by destination prefix.
+   */
+  IpPrefixTrie<NetworkRoutesI> m_networkRouteTrie;
+
   /**
    * \brief the forwarding table for multicast.
    */
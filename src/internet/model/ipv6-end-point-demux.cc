@@ -22,10 +22,40 @@
 #include "ipv6-end-point.h"
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv6EndPointDemux");
 
+bool
+Ipv6EndPointDemux::ConnectionKey::operator == (const ConnectionKey &other) const
+{
+  return localAddress == other.localAddress && localPort == other.localPort
+         && peerAddress == other.peerAddress && peerPort == other.peerPort;
+}
+
+size_t
+Ipv6EndPointDemux::ConnectionKeyHash::operator () (const ConnectionKey &key) const
+{
+  Ipv6AddressHash addressHash;
+  size_t h = addressHash (key.localAddress) ^ ((static_cast<size_t> (key.localPort) << 16) | key.peerPort);
+  return h ^ (addressHash (key.peerAddress) + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
+bool
+Ipv6EndPointDemux::LocalKey::operator == (const LocalKey &other) const
+{
+  return address == other.address && port == other.port && device == other.device;
+}
+
+size_t
+Ipv6EndPointDemux::LocalKeyHash::operator () (const LocalKey &key) const
+{
+  size_t h = Ipv6AddressHash () (key.address) ^ key.port;
+  return h ^ (std::hash<NetDevice *> () (key.device) + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
 Ipv6EndPointDemux::Ipv6EndPointDemux ()
   : m_ephemeral (49152),
     m_portFirst (49152),
@@ -40,37 +70,99 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
       Ipv6EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
 }
 
-bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv6EndPoint* Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  NS_LOG_FUNCTION (this << endPoint);
+  m_positions[endPoint] = m_endPoints.insert (m_endPoints.end (), endPoint);
+  AddToIndex (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+void Ipv6EndPointDemux::AddToIndex (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  endPoint->m_demux = this;
+  uint16_t port = endPoint->GetLocalPort ();
+  m_ports[port]++;
+  LocalKey local = {endPoint->GetLocalAddress (), port, PeekPointer (endPoint->GetBoundNetDevice ())};
+  m_locals[local]++;
+  if (endPoint->GetPeerAddress () == Ipv6Address::GetAny () && endPoint->GetPeerPort () == 0)
     {
-      if ((*i)->GetLocalPort  () == port)
-        {
-          return true;
-        }
+      m_listeners[port].push_back (endPoint);
+    }
+  else
+    {
+      ConnectionKey key = {endPoint->GetLocalAddress (), port,
+                           endPoint->GetPeerAddress (), endPoint->GetPeerPort ()};
+      m_connections[key].push_back (endPoint);
     }
-  return false;
 }
 
-bool Ipv6EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
+void Ipv6EndPointDemux::RemoveFromIndex (Ipv6EndPoint *endPoint)
 {
-  NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  NS_LOG_FUNCTION (this << endPoint);
+  uint16_t port = endPoint->GetLocalPort ();
+  std::unordered_map<uint16_t, uint32_t>::iterator portIt = m_ports.find (port);
+  NS_ASSERT (portIt != m_ports.end ());
+  if (--portIt->second == 0)
+    {
+      m_ports.erase (portIt);
+    }
+  LocalKey local = {endPoint->GetLocalAddress (), port, PeekPointer (endPoint->GetBoundNetDevice ())};
+  std::unordered_map<LocalKey, uint32_t, LocalKeyHash>::iterator localIt = m_locals.find (local);
+  NS_ASSERT (localIt != m_locals.end ());
+  if (--localIt->second == 0)
+    {
+      m_locals.erase (localIt);
+    }
+
+  EndPointVector *endPoints;
+  if (endPoint->GetPeerAddress () == Ipv6Address::GetAny () && endPoint->GetPeerPort () == 0)
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr &&
-          (*i)->GetBoundNetDevice () == boundNetDevice)
+      endPoints = &m_listeners[port];
+    }
+  else
+    {
+      ConnectionKey key = {endPoint->GetLocalAddress (), port,
+                           endPoint->GetPeerAddress (), endPoint->GetPeerPort ()};
+      endPoints = &m_connections[key];
+    }
+  EndPointVector::iterator it = std::find (endPoints->begin (), endPoints->end (), endPoint);
+  NS_ASSERT (it != endPoints->end ());
+  endPoints->erase (it);
+  if (endPoints->empty ())
+    {
+      if (endPoint->GetPeerAddress () == Ipv6Address::GetAny () && endPoint->GetPeerPort () == 0)
+        {
+          m_listeners.erase (port);
+        }
+      else
         {
-          return true;
+          ConnectionKey key = {endPoint->GetLocalAddress (), port,
+                               endPoint->GetPeerAddress (), endPoint->GetPeerPort ()};
+          m_connections.erase (key);
         }
     }
-  return false;
+}
+
+bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
+}
+
+bool Ipv6EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
+{
+  NS_LOG_FUNCTION (this << addr << port);
+  LocalKey local = {addr, port, PeekPointer (boundNetDevice)};
+  return m_locals.find (local) != m_locals.end ();
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
@@ -82,10 +174,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (Ipv6Address::GetAny (), port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
@@ -97,10 +186,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, uint16_t port)
@@ -118,10 +204,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv6Ad
       NS_LOG_WARN ("Duplicated endpoint.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
@@ -129,38 +212,52 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  const EndPointVector *endPoints = 0;
+  if (peerAddress == Ipv6Address::GetAny () && peerPort == 0)
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress &&
-          ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+      std::unordered_map<uint16_t, EndPointVector>::const_iterator it = m_listeners.find (localPort);
+      if (it != m_listeners.end ())
         {
-          NS_LOG_WARN ("Duplicated endpoint.");
-          return 0;
+          endPoints = &it->second;
+        }
+    }
+  else
+    {
+      ConnectionKey key = {localAddress, localPort, peerAddress, peerPort};
+      std::unordered_map<ConnectionKey, EndPointVector, ConnectionKeyHash>::const_iterator it = m_connections.find (key);
+      if (it != m_connections.end ())
+        {
+          endPoints = &it->second;
+        }
+    }
+  if (endPoints != 0)
+    {
+      for (EndPointVector::const_iterator i = endPoints->begin (); i != endPoints->end (); i++)
+        {
+          if ((*i)->GetLocalAddress () == localAddress &&
+              ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+            {
+              NS_LOG_WARN ("Duplicated endpoint.");
+              return 0;
+            }
         }
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<Ipv6EndPoint *, EndPointsI>::iterator it = m_positions.find (endPoint);
+  if (it != m_positions.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      RemoveFromIndex (endPoint);
+      endPoint->m_demux = 0;
+      m_endPoints.erase (it->second);
+      m_positions.erase (it);
+      delete endPoint;
     }
 }
 
@@ -181,7 +278,33 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval4; /* Exact match on all 4 */
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+
+  /* The candidates are the endpoints without peer on the destination port,
+     and the endpoints whose peer is the source, bound either to the
+     destination or to the wildcard address */
+  EndPointVector candidates;
+  std::unordered_map<uint16_t, EndPointVector>::const_iterator listeners = m_listeners.find (dport);
+  if (listeners != m_listeners.end ())
+    {
+      candidates = listeners->second;
+    }
+  ConnectionKey key = {daddr, dport, saddr, sport};
+  std::unordered_map<ConnectionKey, EndPointVector, ConnectionKeyHash>::const_iterator connections = m_connections.find (key);
+  if (connections != m_connections.end ())
+    {
+      candidates.insert (candidates.end (), connections->second.begin (), connections->second.end ());
+    }
+  if (daddr != Ipv6Address::GetAny ())
+    {
+      key.localAddress = Ipv6Address::GetAny ();
+      connections = m_connections.find (key);
+      if (connections != m_connections.end ())
+        {
+          candidates.insert (candidates.end (), connections->second.begin (), connections->second.end ());
+        }
+    }
+
+  for (EndPointVector::const_iterator i = candidates.begin (); i != candidates.end (); i++)
     {
       Ipv6EndPoint* endP = *i;
 
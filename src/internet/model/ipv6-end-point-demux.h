@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
+#include <unordered_map>
 #include "ns3/ipv6-address.h"
 #include "ipv6-interface.h"
 
@@ -34,6 +36,11 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The endpoints are indexed by their four-tuple when they have a peer, and
+ * by their local port otherwise, so that a lookup only looks at the few
+ * endpoints that could match the packet.  The endpoints notify the demux
+ * when their addresses, ports or bound NetDevice change.
  */
 class Ipv6EndPointDemux
 {
@@ -153,6 +160,89 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief Key of the endpoints having a peer.
+   */
+  struct ConnectionKey
+  {
+    Ipv6Address localAddress; //!< local address
+    uint16_t localPort;       //!< local port
+    Ipv6Address peerAddress;  //!< peer address
+    uint16_t peerPort;        //!< peer port
+
+    /**
+     * \param other the other key
+     * \return true if the keys are equal
+     */
+    bool operator == (const ConnectionKey &other) const;
+  };
+
+  /**
+   * \brief Hash of a ConnectionKey.
+   */
+  struct ConnectionKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator () (const ConnectionKey &key) const;
+  };
+
+  /**
+   * \brief Key of the endpoints by local address, port and bound NetDevice.
+   */
+  struct LocalKey
+  {
+    Ipv6Address address; //!< local address
+    uint16_t port;       //!< local port
+    NetDevice *device;   //!< bound NetDevice (if any)
+
+    /**
+     * \param other the other key
+     * \return true if the keys are equal
+     */
+    bool operator == (const LocalKey &other) const;
+  };
+
+  /**
+   * \brief Hash of a LocalKey.
+   */
+  struct LocalKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator () (const LocalKey &key) const;
+  };
+
+  /**
+   * \brief Container of the endpoints sharing an index key.
+   */
+  typedef std::vector<Ipv6EndPoint *> EndPointVector;
+
+  /**
+   * \brief Add a newly created endpoint to the list and to the indexes.
+   * \param endPoint the endpoint
+   * \return the endpoint
+   */
+  Ipv6EndPoint *Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add an endpoint to the indexes.
+   * \param endPoint the endpoint
+   */
+  void AddToIndex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an endpoint from the indexes.
+   * \param endPoint the endpoint
+   */
+  void RemoveFromIndex (Ipv6EndPoint *endPoint);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -178,6 +268,31 @@ private:
    * \brief A list of IPv6 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief Position of each endpoint in the list.
+   */
+  std::unordered_map<Ipv6EndPoint *, EndPointsI> m_positions;
+
+  /**
+   * \brief Endpoints having a peer, by four-tuple.
+   */
+  std::unordered_map<ConnectionKey, EndPointVector, ConnectionKeyHash> m_connections;
+
+  /**
+   * \brief Endpoints without peer, by local port.
+   */
+  std::unordered_map<uint16_t, EndPointVector> m_listeners;
+
+  /**
+   * \brief Number of endpoints by local address, port and bound NetDevice.
+   */
+  std::unordered_map<LocalKey, uint32_t, LocalKeyHash> m_locals;
+
+  /**
+   * \brief Number of endpoints by local port.
+   */
+  std::unordered_map<uint16_t, uint32_t> m_ports;
 };
 
 } /* namespace ns3 */
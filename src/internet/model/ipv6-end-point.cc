@@ -23,6 +23,7 @@
 #include "ns3/simulator.h"
 
 #include "ipv6-end-point.h"
+#include "ipv6-end-point-demux.h"
 
 namespace ns3
 {
@@ -34,7 +35,8 @@ Ipv6EndPoint::Ipv6EndPoint (Ipv6Address addr, uint16_t port)
     m_localPort (port),
     m_peerAddr (Ipv6Address::GetAny ()),
     m_peerPort (0),
-    m_rxEnabled (true)
+    m_rxEnabled (true),
+    m_demux (0)
 {
 }
 
@@ -56,7 +58,15 @@ Ipv6Address Ipv6EndPoint::GetLocalAddress ()
 
 void Ipv6EndPoint::SetLocalAddress (Ipv6Address addr)
 {
+  if (m_demux != 0)
+    {
+      m_demux->RemoveFromIndex (this);
+    }
   m_localAddr = addr;
+  if (m_demux != 0)
+    {
+      m_demux->AddToIndex (this);
+    }
 }
 
 uint16_t Ipv6EndPoint::GetLocalPort ()
@@ -66,7 +76,15 @@ uint16_t Ipv6EndPoint::GetLocalPort ()
 
 void Ipv6EndPoint::SetLocalPort (uint16_t port)
 {
+  if (m_demux != 0)
+    {
+      m_demux->RemoveFromIndex (this);
+    }
   m_localPort = port;
+  if (m_demux != 0)
+    {
+      m_demux->AddToIndex (this);
+    }
 }
 
 Ipv6Address Ipv6EndPoint::GetPeerAddress ()
@@ -81,7 +99,15 @@ uint16_t Ipv6EndPoint::GetPeerPort ()
 
 void Ipv6EndPoint::BindToNetDevice (Ptr<NetDevice> netdevice)
 {
+  if (m_demux != 0)
+    {
+      m_demux->RemoveFromIndex (this);
+    }
   m_boundnetdevice = netdevice;
+  if (m_demux != 0)
+    {
+      m_demux->AddToIndex (this);
+    }
   return;
 }
 
@@ -92,8 +118,16 @@ Ptr<NetDevice> Ipv6EndPoint::GetBoundNetDevice (void)
 
 void Ipv6EndPoint::SetPeer (Ipv6Address addr, uint16_t port)
 {
+  if (m_demux != 0)
+    {
+      m_demux->RemoveFromIndex (this);
+    }
   m_peerAddr = addr;
   m_peerPort = port;
+  if (m_demux != 0)
+    {
+      m_demux->AddToIndex (this);
+    }
 }
 
 void Ipv6EndPoint::SetRxCallback (Callback<void, Ptr<Packet>, Ipv6Header, uint16_t, Ptr<Ipv6Interface> > callback)
@@ -33,6 +33,7 @@ namespace ns3
 {
 
 class Header;
+class Ipv6EndPointDemux;
 class Packet;
 
 /**
@@ -236,6 +237,16 @@ private:
    * \brief true if the endpoint can receive packets.
    */
   bool m_rxEnabled;
+
+  /**
+   * \brief The demux indexing this endpoint (if any).
+   *
+   * The demux is notified when the addresses, ports or bound NetDevice
+   * of the endpoint change.
+   */
+  Ipv6EndPointDemux *m_demux;
+
+  friend class Ipv6EndPointDemux;
 };
 
 } /* namespace ns3 */
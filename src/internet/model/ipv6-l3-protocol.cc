@@ -953,7 +953,10 @@ void Ipv6L3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16
 
   if (ipv6Interface->IsUp ())
     {
-      m_rxTrace (packet, m_node->GetObject<Ipv6> (), interface);
+      if (!m_rxTrace.IsEmpty ())
+        {
+          m_rxTrace (packet, m_node->GetObject<Ipv6> (), interface);
+        }
     }
   else
     {
@@ -1097,6 +1100,10 @@ void
 Ipv6L3Protocol::CallTxTrace (const Ipv6Header & ipHeader, Ptr<Packet> packet,
                                     Ptr<Ipv6> ipv6, uint32_t interface)
 {
+  if (m_txTrace.IsEmpty ())
+    {
+      return;
+    }
   Ptr<Packet> packetCopy = packet->Copy ();
   packetCopy->AddHeader (ipHeader);
   m_txTrace (packetCopy, ipv6, interface);
@@ -20,6 +20,7 @@
 
 #include <iomanip>
 #include "ns3/log.h"
+#include "ns3/unused.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
@@ -151,7 +152,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   NS_LOG_FUNCTION (this << network << networkPrefix << nextHop << interface << metric);
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  InsertNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse, uint32_t metric)
@@ -164,7 +165,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
 
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface, prefixToUse);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  InsertNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, uint32_t interface, uint32_t metric)
@@ -172,7 +173,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   NS_LOG_FUNCTION (this << network << networkPrefix << interface);
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, interface);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  InsertNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::SetDefaultRoute (Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse, uint32_t metric)
@@ -196,7 +197,7 @@ void Ipv6StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   Ipv6Address network = Ipv6Address ("ff00::"); /* RFC 3513 */
   Ipv6Prefix networkMask = Ipv6Prefix (8);
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkMask, outputInterface);
-  m_networkRoutes.push_back (std::make_pair (route, 0));
+  InsertNetworkRoute (route, 0);
 }
 
 uint32_t Ipv6StaticRouting::GetNMulticastRoutes () const
@@ -285,8 +286,6 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
 {
   NS_LOG_FUNCTION (this << dst << interface);
   Ptr<Ipv6Route> rtentry = 0;
-  uint16_t longestMask = 0;
-  uint32_t shortestMetric = 0xffffffff;
 
   /* when sending on link-local multicast, there have to be interface specified */
   if (dst.IsLinkLocalMulticast ())
@@ -300,35 +299,27 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
       return rtentry;
     }
 
-  for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+  /* visit the prefixes matching the destination, longest first, and
+     stop at the first one holding a route on the requested interface */
+  uint8_t addr[16];
+  IpPrefixTrie<NetworkRoutesI>::Serialize (dst, addr);
+  IpPrefixTrie<NetworkRoutesI>::MatchArray matches;
+  uint32_t nMatches = m_networkRouteTrie.Lookup (addr, matches);
+  for (uint32_t m = 0; m < nMatches && !rtentry; m++)
     {
-      Ipv6RoutingTableEntry* j = it->first;
-      uint32_t metric = it->second;
-      Ipv6Prefix mask = j->GetDestNetworkPrefix ();
-      uint16_t maskLen = mask.GetPrefixLength ();
-      Ipv6Address entry = j->GetDestNetwork ();
-
-      NS_LOG_LOGIC ("Searching for route to " << dst << ", mask length " << maskLen << ", metric " << metric);
-
-      if (mask.IsMatch (dst, entry))
+      Ipv6RoutingTableEntry* route = 0;
+      uint32_t shortestMetric = 0xffffffff;
+      for (std::vector<NetworkRoutesI>::const_iterator it = matches[m]->begin (); it != matches[m]->end (); it++)
         {
+          Ipv6RoutingTableEntry* j = (*it)->first;
+          uint32_t metric = (*it)->second;
+          uint16_t maskLen = j->GetDestNetworkPrefix ().GetPrefixLength ();
+
           NS_LOG_LOGIC ("Found global network route " << *j << ", mask length " << maskLen << ", metric " << metric);
 
           /* if interface is given, check the route will output on this interface */
           if (!interface || interface == m_ipv6->GetNetDevice (j->GetInterface ()))
             {
-              if (maskLen < longestMask)
-                {
-                  NS_LOG_LOGIC ("Previous match longer, skipping");
-                  continue;
-                }
-
-              if (maskLen > longestMask)
-                {
-                  shortestMetric = 0xffffffff;
-                }
-
-              longestMask = maskLen;
               if (metric > shortestMetric)
                 {
                   NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
@@ -336,32 +327,36 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
                 }
 
               shortestMetric = metric;
-              Ipv6RoutingTableEntry* route = j;
-              uint32_t interfaceIdx = route->GetInterface ();
-              rtentry = Create<Ipv6Route> ();
-
-              if (route->GetGateway ().IsAny ())
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
-                }
-              else if (route->GetDest ().IsAny ()) /* default route */
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
-                }
-              else
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
-                }
-
-              rtentry->SetDestination (route->GetDest ());
-              rtentry->SetGateway (route->GetGateway ());
-              rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
+              route = j;
               if (maskLen == 128)
                 {
                   break;
                 }
             }
         }
+
+      if (route)
+        {
+          uint32_t interfaceIdx = route->GetInterface ();
+          rtentry = Create<Ipv6Route> ();
+
+          if (route->GetGateway ().IsAny ())
+            {
+              rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
+            }
+          else if (route->GetDest ().IsAny ()) /* default route */
+            {
+              rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
+            }
+          else
+            {
+              rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
+            }
+
+          rtentry->SetDestination (route->GetDest ());
+          rtentry->SetGateway (route->GetGateway ());
+          rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
+        }
     }
 
   if (rtentry)
@@ -375,6 +370,7 @@ void Ipv6StaticRouting::DoDispose ()
 {
   NS_LOG_FUNCTION_NOARGS ();
 
+  m_networkRouteTrie.Clear ();
   for (NetworkRoutesI j = m_networkRoutes.begin ();  j != m_networkRoutes.end (); j = m_networkRoutes.erase (j))
     {
       delete j->first;
@@ -440,6 +436,27 @@ Ptr<Ipv6MulticastRoute> Ipv6StaticRouting::LookupStatic (Ipv6Address origin, Ipv
   return mrtentry;
 }
 
+void Ipv6StaticRouting::InsertNetworkRoute (Ipv6RoutingTableEntry* route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  NetworkRoutesI it = m_networkRoutes.insert (m_networkRoutes.end (), std::make_pair (route, metric));
+  uint8_t prefix[16];
+  IpPrefixTrie<NetworkRoutesI>::Serialize (route->GetDestNetwork (), prefix);
+  m_networkRouteTrie.Insert (prefix, route->GetDestNetworkPrefix ().GetPrefixLength (), it);
+}
+
+Ipv6StaticRouting::NetworkRoutesI Ipv6StaticRouting::EraseNetworkRoute (NetworkRoutesI it)
+{
+  NS_LOG_FUNCTION (this << it->first);
+  uint8_t prefix[16];
+  IpPrefixTrie<NetworkRoutesI>::Serialize (it->first->GetDestNetwork (), prefix);
+  bool found = m_networkRouteTrie.Remove (prefix, it->first->GetDestNetworkPrefix ().GetPrefixLength (), it);
+  NS_ASSERT_MSG (found, "Route not indexed");
+  NS_UNUSED (found);
+  delete it->first;
+  return m_networkRoutes.erase (it);
+}
+
 uint32_t Ipv6StaticRouting::GetNRoutes () const
 {
   return m_networkRoutes.size ();
@@ -528,8 +545,7 @@ void Ipv6StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete it->first;
-          m_networkRoutes.erase (it);
+          EraseNetworkRoute (it);
           return;
         }
       tmp++;
@@ -547,8 +563,7 @@ void Ipv6StaticRouting::RemoveRoute (Ipv6Address network, Ipv6Prefix prefix, uin
       if (network == rtentry->GetDest () && rtentry->GetInterface () == ifIndex
           && rtentry->GetPrefixToUse () == prefixToUse)
         {
-          delete it->first;
-          m_networkRoutes.erase (it);
+          EraseNetworkRoute (it);
           return;
         }
     }
@@ -672,8 +687,7 @@ void Ipv6StaticRouting::NotifyInterfaceDown (uint32_t i)
     {
       if (it->first->GetInterface () == i)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = EraseNetworkRoute (it);
         }
       else
         {
@@ -717,8 +731,7 @@ void Ipv6StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv6InterfaceAd
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkPrefix () == networkMask)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = EraseNetworkRoute (it);
         }
       else
         {
@@ -761,8 +774,7 @@ void Ipv6StaticRouting::NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv
 
           if (dst == entry && prefix == mask && rtentry->GetInterface () == interface)
             {
-              delete j->first;
-              j = m_networkRoutes.erase (j);
+              j = EraseNetworkRoute (j);
             }
           else
             {
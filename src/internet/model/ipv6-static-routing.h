@@ -30,6 +30,7 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-routing-protocol.h"
+#include "ns3/ip-prefix-trie.h"
 
 namespace ns3 {
 
@@ -281,11 +282,30 @@ private:
    */
   Ptr<Ipv6MulticastRoute> LookupStatic (Ipv6Address origin, Ipv6Address group, uint32_t ifIndex);
 
+  /**
+   * \brief Append a route to the network routes and index it.
+   * \param route the route
+   * \param metric the metric of the route
+   */
+  void InsertNetworkRoute (Ipv6RoutingTableEntry* route, uint32_t metric);
+
+  /**
+   * \brief Delete a network route.
+   * \param it the route
+   * \return the route following the deleted one
+   */
+  NetworkRoutesI EraseNetworkRoute (NetworkRoutesI it);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the network routes indexed by destination prefix.
+   */
+  IpPrefixTrie<NetworkRoutesI> m_networkRouteTrie;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -69,6 +69,7 @@ void
 TcpRxBuffer::SetNextRxSequence (const SequenceNumber32& s)
 {
   m_nextRxSeq = s;
+  TrimRanges ();
 }
 
 uint32_t
@@ -128,6 +129,7 @@ TcpRxBuffer::SetFinSequence (const SequenceNumber32& s)
   m_gotFin = true;
   m_finSeq = s;
   if (m_nextRxSeq == m_finSeq) ++m_nextRxSeq;
+  TrimRanges ();
 }
 
 bool
@@ -155,29 +157,29 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end () && i->first <= tailSeq)
+  // Remove overlapped bytes from packet, looking at the received blocks
+  // around it rather than at each stored packet
+  RangeIterator r = m_ranges.upper_bound (headSeq);
+  if (r != m_ranges.begin ())
     {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      if (lastByteSeq > headSeq)
-        {
-          if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
-              m_data.erase (i++);
-              continue;
-            }
-          if (i->first <= headSeq)
-            { // Incoming head is overlapped
-              headSeq = lastByteSeq;
-            }
-          if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-              tailSeq = i->first;
-            }
+      RangeIterator prev = r;
+      --prev;
+      if (prev->second > headSeq)
+        { // Incoming head is overlapped
+          headSeq = prev->second;
+        }
+    }
+  while (r != m_ranges.end () && r->first < tailSeq)
+    {
+      if (r->second < tailSeq)
+        { // Rare case: Existing block is embedded fully in the new packet
+          RemoveData (r->first, r->second);
+          m_ranges.erase (r++);
+          continue;
         }
-      ++i;
+      // Incoming tail is overlapped
+      tailSeq = r->first;
+      break;
     }
   // We now know how much we are going to store, trim the packet
   if (headSeq >= tailSeq)
@@ -195,6 +197,7 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   // Insert packet into buffer
   NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
   m_data [ headSeq ] = p;
+  AddRange (headSeq, tailSeq);
 
   if (headSeq > m_nextRxSeq)
     {
@@ -205,28 +208,82 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
   // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (i = m_data.begin (); i != m_data.end (); ++i)
+  r = m_ranges.upper_bound (m_nextRxSeq);
+  if (r != m_ranges.begin ())
     {
-      if (i->first < m_nextRxSeq)
+      --r;
+      if (r->second > m_nextRxSeq)
         {
-          continue;
+          // The block holding RCV.NXT is now in-sequence up to its end
+          m_availBytes += r->second - m_nextRxSeq;
+          m_nextRxSeq = r->second;
+          ClearSackList (m_nextRxSeq);
         }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
-      ClearSackList (m_nextRxSeq);
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
     { // Account for the FIN packet
       ++m_nextRxSeq;
     };
+  TrimRanges ();
   return true;
 }
 
+void
+TcpRxBuffer::AddRange (const SequenceNumber32 &head, const SequenceNumber32 &tail)
+{
+  NS_LOG_FUNCTION (this << head << tail);
+
+  SequenceNumber32 end = tail;
+  RangeIterator next = m_ranges.find (tail);
+  if (next != m_ranges.end ())
+    { // Merge with the following block
+      end = next->second;
+      m_ranges.erase (next);
+    }
+  RangeIterator prev = m_ranges.lower_bound (head);
+  if (prev != m_ranges.begin ())
+    {
+      --prev;
+      if (prev->second == head)
+        { // Merge with the preceding block
+          prev->second = end;
+          return;
+        }
+    }
+  m_ranges[head] = end;
+}
+
+void
+TcpRxBuffer::RemoveData (const SequenceNumber32 &head, const SequenceNumber32 &tail)
+{
+  NS_LOG_FUNCTION (this << head << tail);
+
+  BufIterator i = m_data.lower_bound (head);
+  while (i != m_data.end () && i->first < tail)
+    {
+      m_size -= i->second->GetSize ();
+      m_data.erase (i++);
+    }
+}
+
+void
+TcpRxBuffer::TrimRanges (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  while (!m_ranges.empty () && m_ranges.begin ()->first < m_nextRxSeq)
+    {
+      SequenceNumber32 tail = m_ranges.begin ()->second;
+      m_ranges.erase (m_ranges.begin ());
+      if (tail > m_nextRxSeq)
+        { // The block holds RCV.NXT: keep its part above
+          m_ranges[m_nextRxSeq] = tail;
+          break;
+        }
+    }
+}
+
 uint32_t
 TcpRxBuffer::GetSackListSize () const
 {
@@ -369,14 +426,37 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return nullptr;  // No contiguous block to return
   NS_ASSERT (m_data.size ()); // At least we have something to extract
-  Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
-  BufIterator i;
+  BufIterator i = m_data.begin ();
+  NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
+  uint32_t pktSize = i->second->GetSize ();
+  Ptr<Packet> outPkt;
+  if (pktSize >= extractSize)
+    { // The head packet alone is enough: hand it out without copying data,
+      // a fragment shares the buffer of the stored packet
+      if (pktSize == extractSize)
+        {
+          outPkt = i->second;
+        }
+      else
+        {
+          outPkt = i->second->CreateFragment (0, extractSize);
+          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
+        }
+      m_data.erase (i);
+      m_size -= extractSize;
+      m_availBytes -= extractSize;
+      extractSize = 0;
+    }
+  else
+    {
+      outPkt = Create<Packet> (); // The packet that contains all the data to return
+    }
   while (extractSize)
     { // Check the buffered data for delivery
       i = m_data.begin ();
       NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
       // Check if we send the whole pkt or just a partial
-      uint32_t pktSize = i->second->GetSize ();
+      pktSize = i->second->GetSize ();
       if (pktSize <= extractSize)
         { // Whole packet is extracted
           outPkt->AddAtEnd (i->second);
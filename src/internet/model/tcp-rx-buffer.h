@@ -53,6 +53,12 @@ class Packet;
  * To store data, use Add; for retrieving a certain amount of ordered data, use
  * the method Extract.
  *
+ * Besides the stored packets, the buffer keeps the set of received blocks of
+ * contiguous data: the overlap of an incoming segment and the advance of
+ * RCV.NXT are found from the blocks around the segment, without walking the
+ * stored packets. When the data to extract is held by a single packet, the
+ * application receives that packet (or a fragment sharing its buffer) as is.
+ *
  * SACK list
  * ---------
  *
@@ -215,6 +221,33 @@ private:
    */
   void ClearSackList (const SequenceNumber32 &seq);
 
+  /**
+   * \brief Add a block of data to the set of received blocks
+   *
+   * The block is merged with the blocks it is adjacent to; it must not
+   * overlap any of them.
+   *
+   * \param head first sequence number of the block
+   * \param tail sequence number following the block
+   */
+  void AddRange (const SequenceNumber32 &head, const SequenceNumber32 &tail);
+
+  /**
+   * \brief Remove the stored packets of a block from the buffer
+   *
+   * \param head first sequence number of the block
+   * \param tail sequence number following the block
+   */
+  void RemoveData (const SequenceNumber32 &head, const SequenceNumber32 &tail);
+
+  /**
+   * \brief Forget the received blocks below RCV.NXT
+   *
+   * Must be called whenever RCV.NXT advances, so that the blocks stay within
+   * the receive window, where the sequence numbers are totally ordered.
+   */
+  void TrimRanges (void);
+
   TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
   /// container for data stored in the buffer
@@ -226,6 +259,13 @@ private:
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
   std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+
+  /// container for the received blocks, from their first to their following sequence number
+  typedef std::map<SequenceNumber32, SequenceNumber32>::iterator RangeIterator;
+  /**
+   * Disjoint, non-adjacent blocks of out-of-order data, above RCV.NXT.
+   */
+  std::map<SequenceNumber32, SequenceNumber32> m_ranges;
 };
 
 } //namespace ns3
@@ -58,7 +58,8 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_maxBuffer (32768), m_size (0), m_sentSize (0), m_firstByteSeq (n)
+  : m_maxBuffer (32768), m_size (0), m_sentSize (0), m_firstByteSeq (n),
+    m_retxHint (n), m_lostScanned (n), m_highestLost (n)
 {
 }
 
@@ -161,6 +162,8 @@ TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
   // if you change the head with data already sent, something bad will happen
   NS_ASSERT (m_sentList.size () == 0);
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_highestLost = seq;
+  ResetScoreboardHints ();
 }
 
 bool
@@ -274,7 +277,7 @@ TcpTxBuffer::GetNewSegment (uint32_t numBytes)
   NS_LOG_INFO ("AppList start at " << startOfAppList << ", sentSize = " <<
                m_sentSize << " firstByte: " << m_firstByteSeq);
 
-  TcpTxItem *item = GetPacketFromList (m_appList, startOfAppList,
+  TcpTxItem *item = GetPacketFromList (m_appList, m_appList.begin (), startOfAppList,
                                        numBytes, startOfAppList);
   item->m_startSeq = startOfAppList;
 
@@ -283,7 +286,7 @@ TcpTxBuffer::GetNewSegment (uint32_t numBytes)
   NS_ASSERT (it != m_appList.end ());
 
   m_appList.erase (it);
-  m_sentList.insert (m_sentList.end (), item);
+  m_sentIndex[item->m_startSeq] = m_sentList.insert (m_sentList.end (), item);
   m_sentSize += item->m_packet->GetSize ();
 
   return item;
@@ -297,40 +300,37 @@ TcpTxBuffer::GetTransmittedSegment (uint32_t numBytes, const SequenceNumber32 &s
   NS_ASSERT (numBytes <= m_sentSize);
   NS_ASSERT (m_sentList.size () >= 1);
 
-  auto it = m_sentList.begin ();
-  bool listEdited = false;
   uint32_t s = numBytes;
 
   // Avoid to merge different packet for this retransmission if flags are
   // different.
-  for (; it != m_sentList.end(); ++it)
+  auto found = m_sentIndex.find (seq);
+  if (found != m_sentIndex.end ())
     {
-      if ((*it)->m_startSeq == seq)
+      auto it = found->second;
+      auto next = it;
+      next++;
+      if (next != m_sentList.end ())
         {
-          auto next = it;
-          next++;
-          if (next != m_sentList.end ())
+          // Next is not sacked... there is the possibility to merge
+          if (! (*next)->m_sacked)
             {
-              // Next is not sacked... there is the possibility to merge
-              if (! (*next)->m_sacked)
-                {
-                  s = std::min(s, (*it)->m_packet->GetSize () + (*next)->m_packet->GetSize ());
-                }
-              else
-                {
-                  // Next is sacked... better to retransmit only the first segment
-                  s = std::min(s, (*it)->m_packet->GetSize ());
-                }
+              s = std::min(s, (*it)->m_packet->GetSize () + (*next)->m_packet->GetSize ());
             }
           else
             {
+              // Next is sacked... better to retransmit only the first segment
               s = std::min(s, (*it)->m_packet->GetSize ());
             }
-          break;
+        }
+      else
+        {
+          s = std::min(s, (*it)->m_packet->GetSize ());
         }
     }
 
-  TcpTxItem *item = GetPacketFromList (m_sentList, m_firstByteSeq, s, seq, &listEdited);
+  PacketList::iterator start = FindSentItem (seq);
+  TcpTxItem *item = GetPacketFromList (m_sentList, start, (*start)->m_startSeq, s, seq);
 
   if (! item->m_retrans)
     {
@@ -363,6 +363,36 @@ TcpTxBuffer::FindHighestSacked () const
   return ret;
 }
 
+TcpTxBuffer::PacketList::iterator
+TcpTxBuffer::FindSentItem (const SequenceNumber32 &seq) const
+{
+  NS_LOG_FUNCTION (this << seq);
+  NS_ASSERT (!m_sentIndex.empty ());
+  auto it = m_sentIndex.upper_bound (seq);
+  NS_ASSERT (it != m_sentIndex.begin ());
+  --it;
+  return it->second;
+}
+
+TcpTxBuffer::PacketList::iterator
+TcpTxBuffer::LowerBoundSentItem (const SequenceNumber32 &seq) const
+{
+  NS_LOG_FUNCTION (this << seq);
+  auto it = m_sentIndex.lower_bound (seq);
+  if (it == m_sentIndex.end ())
+    {
+      return const_cast<PacketList &> (m_sentList).end ();
+    }
+  return it->second;
+}
+
+void
+TcpTxBuffer::ResetScoreboardHints () const
+{
+  NS_LOG_FUNCTION (this);
+  m_retxHint = m_firstByteSeq;
+  m_lostScanned = m_firstByteSeq;
+}
 
 void
 TcpTxBuffer::SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size) const
@@ -385,9 +415,9 @@ TcpTxBuffer::SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size) const
 }
 
 TcpTxItem*
-TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listStartFrom,
-                                uint32_t numBytes, const SequenceNumber32 &seq,
-                                bool *listEdited) const
+TcpTxBuffer::GetPacketFromList (PacketList &list, PacketList::iterator it,
+                                const SequenceNumber32 &listStartFrom,
+                                uint32_t numBytes, const SequenceNumber32 &seq)
 {
   NS_LOG_FUNCTION (this << numBytes << seq);
 
@@ -411,162 +441,111 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
    * We can have mixed case (e.g. seq over the boundary while numBytes not).
    *
    * If we discover that we are in (2) or in a mixed case, we split
-   * packets accordingly to the requested bounds and re-run the function.
+   * packets accordingly to the requested bounds.
    *
    * In (1), things are pretty easy, it's just a matter of walking the list and
    * defragment packets, if needed (e.g. seq is the beginning of the first packet
    * while maxBytes is the end of some packet next in the list).
    */
 
-  Ptr<Packet> currentPacket = nullptr;
+  bool indexed = &list == &m_sentList;
   TcpTxItem *currentItem = nullptr;
-  TcpTxItem *outItem = nullptr;
-  PacketList::iterator it = list.begin ();
   SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
-  while (it != list.end ())
+  // The objective of this snippet is to find (or to create) the packet
+  // that begin with the sequence seq
+  while (true)
     {
+      NS_ABORT_MSG_IF (it == list.end (), "seq is beyond the end of the list");
       currentItem = *it;
-      currentPacket = currentItem->m_packet;
-      NS_ASSERT_MSG (list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+      NS_ASSERT_MSG (!indexed || currentItem->m_startSeq >= m_firstByteSeq,
                      "start: " << m_firstByteSeq << " currentItem start: " <<
                      currentItem->m_startSeq);
+      NS_ABORT_MSG_IF (seq < beginOfCurrentPacket,
+                       "seq < beginOfCurrentPacket: our data is before");
 
-      // The objective of this snippet is to find (or to create) the packet
-      // that begin with the sequence seq
-
-      if (seq < beginOfCurrentPacket + currentPacket->GetSize ())
-        {
-          // seq is inside the current packet
-          if (seq == beginOfCurrentPacket)
-            {
-              // seq is the beginning of the current packet. Hurray!
-              outItem = currentItem;
-              NS_LOG_INFO ("Current packet starts at seq " << seq <<
-                           " ends at " << seq + currentPacket->GetSize ());
-            }
-          else if (seq > beginOfCurrentPacket)
-            {
-              // seq is inside the current packet but seq is not the beginning,
-              // it's somewhere in the middle. Just fragment the beginning and
-              // start again.
-              NS_LOG_INFO ("we are at " << beginOfCurrentPacket <<
-                           " searching for " << seq <<
-                           " and now we recurse because packet ends at "
-                                        << beginOfCurrentPacket + currentPacket->GetSize ());
-              TcpTxItem *firstPart = new TcpTxItem ();
-              SplitItems (firstPart, currentItem, seq - beginOfCurrentPacket);
-
-              // insert firstPart before currentItem
-              list.insert (it, firstPart);
-              if (listEdited)
-                {
-                  *listEdited = true;
-                }
-
-              return GetPacketFromList (list, listStartFrom, numBytes, seq, listEdited);
-            }
-          else
-            {
-              NS_FATAL_ERROR ("seq < beginOfCurrentPacket: our data is before");
-            }
-        }
-      else
+      if (seq >= beginOfCurrentPacket + currentItem->m_packet->GetSize ())
         {
           // Walk the list, the current packet does not contain seq
-          beginOfCurrentPacket += currentPacket->GetSize ();
+          beginOfCurrentPacket += currentItem->m_packet->GetSize ();
           it++;
           continue;
         }
 
-      NS_ASSERT (outItem != nullptr);
-
-      // The objective of this snippet is to find (or to create) the packet
-      // that ends after numBytes bytes. We are sure that outPacket starts
-      // at seq.
-
-      if (seq + numBytes <= beginOfCurrentPacket + currentPacket->GetSize ())
+      if (seq > beginOfCurrentPacket)
         {
-          // the end boundary is inside the current packet
-          if (numBytes == currentPacket->GetSize ())
-            {
-              // the end boundary is exactly the end of the current packet. Hurray!
-              if (currentItem->m_packet == outItem->m_packet)
-                {
-                  // A perfect match!
-                  return outItem;
-                }
-              else
-                {
-                  // the end is exactly the end of current packet, but
-                  // current > outPacket in the list. Merge current with the
-                  // previous, and recurse.
-                  NS_ASSERT (it != list.begin ());
-                  TcpTxItem *previous = *(--it);
-
-                  list.erase (it);
-
-                  MergeItems (previous, currentItem);
-                  delete currentItem;
-                  if (listEdited)
-                    {
-                      *listEdited = true;
-                    }
-
-                  return GetPacketFromList (list, listStartFrom, numBytes, seq, listEdited);
-                }
-            }
-          else if (numBytes < currentPacket->GetSize ())
+          // seq is inside the current packet but seq is not the beginning,
+          // it's somewhere in the middle. Just fragment the beginning.
+          NS_LOG_INFO ("we are at " << beginOfCurrentPacket <<
+                       " searching for " << seq <<
+                       " and now we fragment because packet ends at "
+                       << beginOfCurrentPacket + currentItem->m_packet->GetSize ());
+          TcpTxItem *firstPart = new TcpTxItem ();
+          SplitItems (firstPart, currentItem, seq - beginOfCurrentPacket);
+
+          // insert firstPart before currentItem
+          PacketList::iterator firstPartIt = list.insert (it, firstPart);
+          if (indexed)
             {
-              // the end is inside the current packet, but it isn't exactly
-              // the packet end. Just fragment, fix the list, and return.
-              TcpTxItem *firstPart = new TcpTxItem ();
-              SplitItems (firstPart, currentItem, numBytes);
-
-              // insert firstPart before currentItem
-              list.insert (it, firstPart);
-              if (listEdited)
-                {
-                  *listEdited = true;
-                }
-
-              return firstPart;
+              m_sentIndex[firstPart->m_startSeq] = firstPartIt;
+              m_sentIndex[currentItem->m_startSeq] = it;
             }
         }
-      else
-        {
-          // The end isn't inside current packet, but there is an exception for
-          // the merge and recurse strategy...
-          if (++it == list.end ())
-            {
-              // ...current is the last packet we sent. We have not more data;
-              // Go for this one.
-              NS_LOG_WARN ("Cannot reach the end, but this case is covered "
-                           "with conditional statements inside CopyFromSequence."
-                           "Something has gone wrong, report a bug");
-              return outItem;
-            }
-
-          // The current packet does not contain the requested end. Merge current
-          // with the packet that follows, and recurse
-          TcpTxItem *next = (*it); // Please remember we have incremented it
-                                   // in the previous if
+      break;
+    }
 
-          MergeItems (currentItem, next);
-          list.erase (it);
+  NS_LOG_INFO ("Current packet starts at seq " << seq <<
+               " ends at " << seq + currentItem->m_packet->GetSize ());
 
-          delete next;
+  // The objective of this snippet is to find (or to create) the packet
+  // that ends after numBytes bytes. We are sure that currentItem starts
+  // at seq.
+  while (numBytes > currentItem->m_packet->GetSize ())
+    {
+      // The end isn't inside current packet, but there is an exception for
+      // the merge strategy...
+      PacketList::iterator nextIt = it;
+      if (++nextIt == list.end ())
+        {
+          // ...current is the last packet we sent. We have not more data;
+          // Go for this one.
+          NS_LOG_WARN ("Cannot reach the end, but this case is covered "
+                       "with conditional statements inside CopyFromSequence."
+                       "Something has gone wrong, report a bug");
+          return currentItem;
+        }
 
-          if (listEdited)
-            {
-              *listEdited = true;
-            }
+      // The current packet does not contain the requested end. Merge current
+      // with the packet that follows
+      TcpTxItem *next = *nextIt;
+      MergeItems (currentItem, next);
+      if (indexed)
+        {
+          m_sentIndex.erase (next->m_startSeq);
+        }
+      list.erase (nextIt);
+      delete next;
+    }
 
-          return GetPacketFromList (list, listStartFrom, numBytes, seq, listEdited);
+  if (numBytes < currentItem->m_packet->GetSize ())
+    {
+      // the end is inside the current packet, but it isn't exactly
+      // the packet end. Just fragment, fix the list, and return.
+      TcpTxItem *firstPart = new TcpTxItem ();
+      SplitItems (firstPart, currentItem, numBytes);
+
+      // insert firstPart before currentItem
+      PacketList::iterator firstPartIt = list.insert (it, firstPart);
+      if (indexed)
+        {
+          m_sentIndex[firstPart->m_startSeq] = firstPartIt;
+          m_sentIndex[currentItem->m_startSeq] = it;
         }
+      return firstPart;
     }
 
-  NS_FATAL_ERROR ("This point is not reachable");
+  // the end boundary is exactly the end of the current packet. Hurray!
+  return currentItem;
 }
 
 static bool AreEquals (const bool &first, const bool &second)
@@ -591,6 +570,7 @@ TcpTxBuffer::MergeItems (TcpTxItem *t1, TcpTxItem *t2) const
   // be updated in MarkTransmittedSegment.
   if (! AreEquals (t1->m_retrans, t2->m_retrans))
     {
+      ResetScoreboardHints ();
       if (t1->m_retrans)
         {
           TcpTxBuffer *self = const_cast<TcpTxBuffer*> (this);
@@ -683,6 +663,7 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
 
           RemoveFromCounts (item, pktSize);
 
+          m_sentIndex.erase (item->m_startSeq);
           i = m_sentList.erase (i);
           NS_LOG_INFO ("Removed " << *item << " lost: " << m_lostOut <<
                        " retrans: " << m_retrans << " sacked: " << m_sackedOut <<
@@ -702,7 +683,9 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
           NS_LOG_INFO (*item);
           // PacketTags are preserved when fragmenting
           item->m_packet = item->m_packet->CreateFragment (offset, pktSize);
+          m_sentIndex.erase (item->m_startSeq);
           item->m_startSeq += offset;
+          m_sentIndex[item->m_startSeq] = i;
           m_size -= offset;
           m_sentSize -= offset;
           m_firstByteSeq += offset;
@@ -747,6 +730,21 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
       m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
     }
 
+  // Move the hints along with SND.UNA: left behind, they would be more than
+  // 2^31 bytes away after a long lossless flow, and compare the wrong way
+  if (m_retxHint < m_firstByteSeq)
+    {
+      m_retxHint = m_firstByteSeq;
+    }
+  if (m_lostScanned < m_firstByteSeq)
+    {
+      m_lostScanned = m_firstByteSeq;
+    }
+  if (m_highestLost < m_firstByteSeq)
+    {
+      m_highestLost = m_firstByteSeq;
+    }
+
   NS_LOG_DEBUG ("Discarded up to " << seq << " lost: " << m_lostOut <<
                 " retrans: " << m_retrans << " sacked: " << m_sackedOut);
   NS_LOG_LOGIC ("Buffer status after discarding data " << *this);
@@ -766,15 +764,24 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
 
   for (auto option_it = list.begin (); option_it != list.end (); ++option_it)
     {
-      PacketList::iterator item_it = m_sentList.begin ();
-      SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
       if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
           NS_LOG_INFO ("Not updating scoreboard, the option block is outside the sent list");
           return bytesSacked;
         }
 
+      // Items starting before the block cannot be mapped over it
+      PacketList::iterator item_it = m_sentList.begin ();
+      if ((*option_it).first > m_firstByteSeq)
+        {
+          item_it = LowerBoundSentItem ((*option_it).first);
+        }
+      SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq + m_sentSize;
+      if (item_it != m_sentList.end ())
+        {
+          beginOfCurrentPacket = (*item_it)->m_startSeq;
+        }
+
       while (item_it != m_sentList.end ())
         {
           uint32_t pktSize = (*item_it)->m_packet->GetSize ();
@@ -868,12 +875,24 @@ TcpTxBuffer::UpdateLostCount ()
                    ", will start from item " << *(*m_highestSack.first));
     }
 
+  // The items below m_lostScanned are already lost or sacked, and the
+  // threshold is reached again at m_lostScanned: the walk can stop there,
+  // as it would not change any flag.
+  SequenceNumber32 scanned = m_lostScanned;
   for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
     {
       TcpTxItem *item = *it;
+      if (item->m_startSeq < scanned)
+        {
+          break;
+        }
       if (item->m_sacked)
         {
           sacked++;
+          if (sacked == m_dupAckThresh)
+            {
+              m_lostScanned = item->m_startSeq;
+            }
         }
 
       if (sacked >= m_dupAckThresh)
@@ -882,6 +901,10 @@ TcpTxBuffer::UpdateLostCount ()
             {
               item->m_lost = true;
               m_lostOut += item->m_packet->GetSize ();
+              if (m_highestLost < item->m_startSeq + item->m_packet->GetSize ())
+                {
+                  m_highestLost = item->m_startSeq + item->m_packet->GetSize ();
+                }
             }
         }
       beginOfCurrentPacket -= item->m_packet->GetSize ();
@@ -894,6 +917,10 @@ TcpTxBuffer::UpdateLostCount ()
         {
           item->m_lost = true;
           m_lostOut += item->m_packet->GetSize ();
+          if (m_highestLost < item->m_startSeq + item->m_packet->GetSize ())
+            {
+              m_highestLost = item->m_startSeq + item->m_packet->GetSize ();
+            }
         }
     }
   NS_LOG_INFO ("Status after the update: " << *this);
@@ -905,7 +932,6 @@ TcpTxBuffer::IsLost (const SequenceNumber32 &seq) const
 {
   NS_LOG_FUNCTION (this << seq);
 
-  SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
   PacketList::const_iterator it;
 
   if (seq >= m_highestSack.second)
@@ -913,27 +939,25 @@ TcpTxBuffer::IsLost (const SequenceNumber32 &seq) const
       return false;
     }
 
-  // In theory, using a map and hints when inserting elements can improve
-  // performance
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // Start from the first item at or after seq
+  it = m_sentList.begin ();
+  if (seq > m_firstByteSeq)
+    {
+      it = LowerBoundSentItem (seq);
+    }
+  for (; it != m_sentList.end (); ++it)
     {
-      // Search for the right iterator before calling IsLost()
-      if (beginOfCurrentPacket >= seq)
+      if ((*it)->m_lost == true)
         {
-          if ((*it)->m_lost == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
-              return true;
-            }
-
-          if ((*it)->m_sacked == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
-              return false;
-            }
+          NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
+          return true;
         }
 
-      beginOfCurrentPacket += (*it)->m_packet->GetSize ();
+      if ((*it)->m_sacked == true)
+        {
+          NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
+          return false;
+        }
     }
 
   return false;
@@ -961,15 +985,35 @@ TcpTxBuffer::NextSeg (SequenceNumber32 *seq, bool isRecovery) const
   TcpTxItem *item;
   SequenceNumber32 seqPerRule3;
   bool isSeqPerRule3Valid = false;
-  SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
+  bool isFirstCandidate = true;
 
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // The items before m_retxHint are all retransmitted or sacked, and there
+  // is no lost item after m_highestLost: only the items in between can
+  // satisfy rule (1).
+  it = m_sentList.begin ();
+  if (m_retxHint > m_firstByteSeq)
+    {
+      it = LowerBoundSentItem (m_retxHint);
+    }
+  for (; it != m_sentList.end (); ++it)
     {
       item = *it;
+      SequenceNumber32 beginOfCurrentPkt = item->m_startSeq;
+
+      if (beginOfCurrentPkt >= m_highestLost
+          && (!isRecovery || seqPerRule3.GetValue () != 0))
+        {
+          break;
+        }
 
       // Condition 1.a , 1.b , and 1.c
       if (item->m_retrans == false && item->m_sacked == false)
         {
+          if (isFirstCandidate)
+            {
+              m_retxHint = beginOfCurrentPkt;
+              isFirstCandidate = false;
+            }
           if (item->m_lost)
             {
               NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
@@ -983,9 +1027,6 @@ TcpTxBuffer::NextSeg (SequenceNumber32 *seq, bool isRecovery) const
               seqPerRule3 = beginOfCurrentPkt;
             }
         }
-
-      // Nothing found, iterate
-      beginOfCurrentPkt += item->m_packet->GetSize ();
     }
 
   /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1189,6 +1230,7 @@ TcpTxBuffer::ResetRenoSack ()
     }
 
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  ResetScoreboardHints ();
 }
 
 void
@@ -1206,11 +1248,14 @@ TcpTxBuffer::ResetSentList ()
       m_sentList.pop_back ();
     }
 
+  m_sentIndex.clear ();
   m_sentSize = 0;
   m_lostOut = 0;
   m_retrans = 0;
   m_sackedOut = 0;
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_highestLost = m_firstByteSeq;
+  ResetScoreboardHints ();
 }
 
 void
@@ -1221,6 +1266,7 @@ TcpTxBuffer::ResetLastSegmentSent ()
     {
       TcpTxItem *item = m_sentList.back ();
 
+      m_sentIndex.erase (item->m_startSeq);
       m_sentList.pop_back ();
       m_sentSize -= item->m_packet->GetSize ();
       if (item->m_retrans)
@@ -1228,6 +1274,7 @@ TcpTxBuffer::ResetLastSegmentSent ()
           m_retrans -= item->m_packet->GetSize ();
         }
       m_appList.insert (m_appList.begin (), item);
+      ResetScoreboardHints ();
     }
   ConsistencyCheck ();
 }
@@ -1274,6 +1321,11 @@ TcpTxBuffer::SetSentListLost (bool resetSack)
       (*it)->m_retrans = false;
     }
 
+  // Now every item is either lost or sacked
+  m_retxHint = m_firstByteSeq;
+  m_lostScanned = m_firstByteSeq + m_sentSize;
+  m_highestLost = m_firstByteSeq + m_sentSize;
+
   NS_LOG_INFO ("Set sent list lost, status: " << *this);
   NS_ASSERT_MSG (m_sentSize >= m_sackedOut + m_lostOut, *this);
   ConsistencyCheck ();
@@ -1306,6 +1358,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead ()
     {
       m_sentList.front ()->m_retrans = false;
       m_retrans -= m_sentList.front ()->m_packet->GetSize ();
+      ResetScoreboardHints ();
     }
   ConsistencyCheck ();
 }
@@ -1335,6 +1388,13 @@ TcpTxBuffer::MarkHeadAsLost ()
           m_sentList.front()->m_lost = true;
           m_lostOut += m_sentList.front ()->m_packet->GetSize ();
         }
+
+      SequenceNumber32 headEnd = m_firstByteSeq + m_sentList.front ()->m_packet->GetSize ();
+      if (m_highestLost < headEnd)
+        {
+          m_highestLost = headEnd;
+        }
+      ResetScoreboardHints ();
     }
   ConsistencyCheck ();
 }
@@ -1409,6 +1469,15 @@ TcpTxBuffer::ConsistencyCheck () const
                  " stored lost: " << m_lostOut);
   NS_ASSERT_MSG (retrans == m_retrans, " Counted retrans: " << retrans <<
                  " stored retrans: " << m_retrans);
+
+  NS_ASSERT_MSG (m_sentIndex.size () == m_sentList.size (), "Index of " <<
+                 m_sentIndex.size () << " items for " << m_sentList.size () <<
+                 " sent items");
+  for (auto it = m_sentIndex.begin (); it != m_sentIndex.end (); ++it)
+    {
+      NS_ASSERT_MSG ((*it->second)->m_startSeq == it->first, "Item " <<
+                     *(*it->second) << " indexed at " << it->first);
+    }
 }
 
 std::ostream &
@@ -22,6 +22,8 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
+#include <map>
+
 #include "ns3/object.h"
 #include "ns3/traced-value.h"
 #include "ns3/sequence-number.h"
@@ -105,6 +107,18 @@ class Packet;
  * of the methods. To have a look how the calculations are made, please see
  * BytesInFlight method.
  *
+ * Sequence index
+ * --------------
+ *
+ * The items of the SentList are also indexed by their starting sequence
+ * number, so that retransmissions, SACK blocks and loss queries reach the
+ * concerned items in logarithmic time instead of walking the list from its
+ * head. Moreover, the scoreboard keeps a few sequence numbers that only move
+ * forward between two resets: the first item that could be returned by
+ * NextSeg, the highest item that is known to be lost or sacked, and the end
+ * of the highest lost item. Hence, with a large window, each ACK only visits
+ * the items around the newly sacked or lost data.
+ *
  * Lost segments
  * -------------
  *
@@ -526,16 +540,41 @@ private:
    * MSS can change, but it is stable, and retransmissions do not happen for
    * each segment).
    *
+   * The walk starts from an item that begins at or before requestedSeq; the
+   * sequence index of the SentList is kept in sync with the fragments and
+   * merges done on it.
+   *
    * \param list List to extract block from
-   * \param startingSeq Starting sequence of the list
+   * \param it Item of the list from which to start the walk
+   * \param startingSeq Starting sequence of the item it
    * \param numBytes Bytes to extract, starting from requestedSeq
    * \param requestedSeq Requested sequence
-   * \param listEdited output parameter which indicates if the list has been edited
    * \return the item that contains the right packet
    */
-  TcpTxItem* GetPacketFromList (PacketList &list, const SequenceNumber32 &startingSeq,
-                                uint32_t numBytes, const SequenceNumber32 &requestedSeq,
-                                bool *listEdited = nullptr) const;
+  TcpTxItem* GetPacketFromList (PacketList &list, PacketList::iterator it,
+                                const SequenceNumber32 &startingSeq,
+                                uint32_t numBytes, const SequenceNumber32 &requestedSeq);
+
+  /**
+   * \brief Find the sent item that contains a sequence number
+   * \param seq the sequence number, inside the SentList
+   * \return an iterator to the item of the SentList
+   */
+  PacketList::iterator FindSentItem (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Find the first sent item starting at or after a sequence number
+   * \param seq the sequence number
+   * \return an iterator to the item of the SentList, or its end
+   */
+  PacketList::iterator LowerBoundSentItem (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Restart the scoreboard walks from the head of the SentList
+   *
+   * To be called when a flag that the scoreboard hints rely on is cleared.
+   */
+  void ResetScoreboardHints () const;
 
   /**
    * \brief Merge two TcpTxItem
@@ -576,6 +615,7 @@ private:
 
   PacketList m_appList;  //!< Buffer for application data
   PacketList m_sentList; //!< Buffer for sent (but not acked) data
+  std::map<SequenceNumber32, PacketList::iterator> m_sentIndex; //!< Sent items by starting sequence
   uint32_t m_maxBuffer;  //!< Max number of data bytes in buffer (SND.WND)
   uint32_t m_size;       //!< Size of all data in this buffer
   uint32_t m_sentSize;   //!< Size of sent (and not discarded) segments
@@ -587,6 +627,10 @@ private:
   uint32_t m_sackedOut {0}; //!< Number of sacked bytes
   uint32_t m_retrans   {0}; //!< Number of retransmitted bytes
 
+  mutable SequenceNumber32 m_retxHint;   //!< Sent items starting before are retransmitted or sacked
+  mutable SequenceNumber32 m_lostScanned; //!< Sent items starting before are lost or sacked
+  SequenceNumber32 m_highestLost;        //!< No lost byte at or after this sequence
+
   uint32_t m_dupAckThresh {0}; //!< Duplicate Ack threshold from TcpSocketBase
   uint32_t m_segmentSize {0}; //!< Segment size from TcpSocketBase
   bool     m_renoSack {false}; //!< Indicates if AddRenoSack was called
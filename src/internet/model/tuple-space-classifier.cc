@@ -0,0 +1,353 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tuple-space-classifier.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TupleSpaceClassifier");
+
+namespace {
+
+/**
+ * Write an IPv4 mask in network byte order in the first four bytes of
+ * a 16 byte mask, and clear the remaining bytes
+ *
+ * \param mask the mask
+ * \param buf the buffer
+ */
+void
+SerializeMask (Ipv4Mask mask, uint8_t buf[16])
+{
+  uint32_t m = mask.Get ();
+  std::memset (buf, 0, 16);
+  buf[0] = (m >> 24) & 0xff;
+  buf[1] = (m >> 16) & 0xff;
+  buf[2] = (m >> 8) & 0xff;
+  buf[3] = m & 0xff;
+}
+
+/**
+ * Write an IPv4 address in network byte order in the first four bytes
+ * of a 16 byte address, and clear the remaining bytes
+ *
+ * \param addr the address
+ * \param buf the buffer
+ */
+void
+SerializeAddress (Ipv4Address addr, uint8_t buf[16])
+{
+  std::memset (buf, 0, 16);
+  addr.Serialize (buf);
+}
+
+} // anonymous namespace
+
+TupleSpaceClassifier::Key::Key ()
+  : sourcePort (0),
+    destinationPort (0),
+    protocol (0),
+    tos (0)
+{
+  std::memset (source, 0, 16);
+  std::memset (destination, 0, 16);
+}
+
+void
+TupleSpaceClassifier::Key::SetSource (Ipv4Address addr)
+{
+  SerializeAddress (addr, source);
+}
+
+void
+TupleSpaceClassifier::Key::SetSource (Ipv6Address addr)
+{
+  addr.Serialize (source);
+}
+
+void
+TupleSpaceClassifier::Key::SetDestination (Ipv4Address addr)
+{
+  SerializeAddress (addr, destination);
+}
+
+void
+TupleSpaceClassifier::Key::SetDestination (Ipv6Address addr)
+{
+  addr.Serialize (destination);
+}
+
+bool
+TupleSpaceClassifier::Key::operator == (const Key &other) const
+{
+  return sourcePort == other.sourcePort && destinationPort == other.destinationPort
+         && protocol == other.protocol && tos == other.tos
+         && std::memcmp (source, other.source, 16) == 0
+         && std::memcmp (destination, other.destination, 16) == 0;
+}
+
+std::size_t
+TupleSpaceClassifier::KeyHash::operator () (const Key &key) const
+{
+  char buf[38];
+  std::memcpy (buf, key.source, 16);
+  std::memcpy (buf + 16, key.destination, 16);
+  std::memcpy (buf + 32, &key.sourcePort, 2);
+  std::memcpy (buf + 34, &key.destinationPort, 2);
+  buf[36] = key.protocol;
+  buf[37] = key.tos;
+  return Hash32 (buf, sizeof (buf));
+}
+
+TupleSpaceClassifier::Rule::Rule ()
+  : sourcePortStart (0),
+    sourcePortEnd (65535),
+    destinationPortStart (0),
+    destinationPortEnd (65535),
+    protocol (0),
+    protocolMask (0),
+    tos (0),
+    tosMask (0),
+    priority (0),
+    value (0)
+{
+  std::memset (source, 0, 16);
+  std::memset (sourceMask, 0, 16);
+  std::memset (destination, 0, 16);
+  std::memset (destinationMask, 0, 16);
+}
+
+void
+TupleSpaceClassifier::Rule::SetSource (Ipv4Address addr, Ipv4Mask mask)
+{
+  SerializeAddress (addr, source);
+  SerializeMask (mask, sourceMask);
+}
+
+void
+TupleSpaceClassifier::Rule::SetSource (Ipv6Address addr, Ipv6Prefix prefix)
+{
+  addr.Serialize (source);
+  prefix.GetBytes (sourceMask);
+}
+
+void
+TupleSpaceClassifier::Rule::SetDestination (Ipv4Address addr, Ipv4Mask mask)
+{
+  SerializeAddress (addr, destination);
+  SerializeMask (mask, destinationMask);
+}
+
+void
+TupleSpaceClassifier::Rule::SetDestination (Ipv6Address addr, Ipv6Prefix prefix)
+{
+  addr.Serialize (destination);
+  prefix.GetBytes (destinationMask);
+}
+
+TupleSpaceClassifier::TupleSpaceClassifier ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TupleSpaceClassifier::Add (const Rule &rule)
+{
+  NS_LOG_FUNCTION (this << rule.priority << rule.value);
+
+  // store the rule with its fields already masked
+  Rule r = rule;
+  for (uint32_t i = 0; i < 16; ++i)
+    {
+      r.source[i] &= r.sourceMask[i];
+      r.destination[i] &= r.destinationMask[i];
+    }
+  r.protocol &= r.protocolMask;
+  r.tos &= r.tosMask;
+  NS_ABORT_MSG_IF (m_rules.size () == std::numeric_limits<uint32_t>::max (), "Too many rules");
+  uint32_t index = m_rules.size ();
+  m_rules.push_back (r);
+
+  bool exactSourcePort = (r.sourcePortStart == r.sourcePortEnd);
+  bool exactDestinationPort = (r.destinationPortStart == r.destinationPortEnd);
+  std::vector<Tuple>::iterator tuple;
+  for (tuple = m_tuples.begin (); tuple != m_tuples.end (); ++tuple)
+    {
+      if (tuple->protocolMask == r.protocolMask && tuple->tosMask == r.tosMask
+          && tuple->exactSourcePort == exactSourcePort
+          && tuple->exactDestinationPort == exactDestinationPort
+          && std::memcmp (tuple->sourceMask, r.sourceMask, 16) == 0
+          && std::memcmp (tuple->destinationMask, r.destinationMask, 16) == 0)
+        {
+          break;
+        }
+    }
+  if (tuple == m_tuples.end ())
+    {
+      Tuple t;
+      std::memcpy (t.sourceMask, r.sourceMask, 16);
+      std::memcpy (t.destinationMask, r.destinationMask, 16);
+      t.protocolMask = r.protocolMask;
+      t.tosMask = r.tosMask;
+      t.exactSourcePort = exactSourcePort;
+      t.exactDestinationPort = exactDestinationPort;
+      t.bestRank = std::numeric_limits<uint64_t>::max ();
+      m_tuples.push_back (t);
+      tuple = m_tuples.end () - 1;
+      NS_LOG_LOGIC ("new tuple, " << m_tuples.size () << " tuples");
+    }
+
+  Key key;
+  std::memcpy (key.source, r.source, 16);
+  std::memcpy (key.destination, r.destination, 16);
+  key.sourcePort = exactSourcePort ? r.sourcePortStart : 0;
+  key.destinationPort = exactDestinationPort ? r.destinationPortStart : 0;
+  key.protocol = r.protocol;
+  key.tos = r.tos;
+
+  std::vector<uint32_t> &bucket = tuple->buckets[key];
+  uint64_t rank = GetRank (index);
+  std::vector<uint32_t>::iterator pos = bucket.begin ();
+  while (pos != bucket.end () && GetRank (*pos) < rank)
+    {
+      ++pos;
+    }
+  bucket.insert (pos, index);
+  tuple->bestRank = std::min (tuple->bestRank, rank);
+
+  std::stable_sort (m_tuples.begin (), m_tuples.end (),
+                    [] (const Tuple &a, const Tuple &b) { return a.bestRank < b.bestRank; });
+}
+
+void
+TupleSpaceClassifier::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_rules.clear ();
+  m_tuples.clear ();
+}
+
+uint32_t
+TupleSpaceClassifier::GetNRules (void) const
+{
+  return m_rules.size ();
+}
+
+uint32_t
+TupleSpaceClassifier::GetNTuples (void) const
+{
+  return m_tuples.size ();
+}
+
+uint64_t
+TupleSpaceClassifier::GetRank (uint32_t index) const
+{
+  return (static_cast<uint64_t> (m_rules[index].priority) << 32) | index;
+}
+
+TupleSpaceClassifier::Key
+TupleSpaceClassifier::MaskKey (const Tuple &tuple, const Key &key)
+{
+  Key masked;
+  for (uint32_t i = 0; i < 16; ++i)
+    {
+      masked.source[i] = key.source[i] & tuple.sourceMask[i];
+      masked.destination[i] = key.destination[i] & tuple.destinationMask[i];
+    }
+  masked.sourcePort = tuple.exactSourcePort ? key.sourcePort : 0;
+  masked.destinationPort = tuple.exactDestinationPort ? key.destinationPort : 0;
+  masked.protocol = key.protocol & tuple.protocolMask;
+  masked.tos = key.tos & tuple.tosMask;
+  return masked;
+}
+
+const TupleSpaceClassifier::Rule *
+TupleSpaceClassifier::Lookup (const Key &key) const
+{
+  const Rule *best = 0;
+  uint64_t bestRank = std::numeric_limits<uint64_t>::max ();
+  for (std::vector<Tuple>::const_iterator tuple = m_tuples.begin ();
+       tuple != m_tuples.end () && tuple->bestRank < bestRank;
+       ++tuple)
+    {
+      std::unordered_map<Key, std::vector<uint32_t>, KeyHash>::const_iterator bucket =
+        tuple->buckets.find (MaskKey (*tuple, key));
+      if (bucket == tuple->buckets.end ())
+        {
+          continue;
+        }
+      // the masked fields match: only the port ranges are left to check
+      for (std::vector<uint32_t>::const_iterator it = bucket->second.begin ();
+           it != bucket->second.end () && GetRank (*it) < bestRank;
+           ++it)
+        {
+          const Rule &rule = m_rules[*it];
+          if ((tuple->exactSourcePort
+               || (rule.sourcePortStart <= key.sourcePort && key.sourcePort <= rule.sourcePortEnd))
+              && (tuple->exactDestinationPort
+                  || (rule.destinationPortStart <= key.destinationPort
+                      && key.destinationPort <= rule.destinationPortEnd)))
+            {
+              best = &rule;
+              bestRank = GetRank (*it);
+              break;
+            }
+        }
+    }
+  return best;
+}
+
+const TupleSpaceClassifier::Rule *
+TupleSpaceClassifier::LookupLinear (const Key &key) const
+{
+  const Rule *best = 0;
+  uint64_t bestRank = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < m_rules.size (); ++i)
+    {
+      if (GetRank (i) < bestRank && Matches (m_rules[i], key))
+        {
+          best = &m_rules[i];
+          bestRank = GetRank (i);
+        }
+    }
+  return best;
+}
+
+bool
+TupleSpaceClassifier::Matches (const Rule &rule, const Key &key)
+{
+  for (uint32_t i = 0; i < 16; ++i)
+    {
+      if ((key.source[i] & rule.sourceMask[i]) != (rule.source[i] & rule.sourceMask[i])
+          || (key.destination[i] & rule.destinationMask[i]) != (rule.destination[i] & rule.destinationMask[i]))
+        {
+          return false;
+        }
+    }
+  return (key.protocol & rule.protocolMask) == (rule.protocol & rule.protocolMask)
+         && (key.tos & rule.tosMask) == (rule.tos & rule.tosMask)
+         && rule.sourcePortStart <= key.sourcePort && key.sourcePort <= rule.sourcePortEnd
+         && rule.destinationPortStart <= key.destinationPort && key.destinationPort <= rule.destinationPortEnd;
+}
+
+} // namespace ns3
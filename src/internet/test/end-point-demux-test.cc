@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-interface-address.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("EndPointDemuxTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the matching rules and the ephemeral ports of
+ * Ipv4EndPointDemux, while endpoints are allocated, modified and removed
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param demux the demux
+   * \param daddr the destination address
+   * \param dport the destination port
+   * \param saddr the source address
+   * \param sport the source port
+   * \param interface the incoming interface
+   * \return the matching endpoint, or 0
+   */
+  static Ipv4EndPoint * Lookup (Ipv4EndPointDemux &demux,
+                                Ipv4Address daddr, uint16_t dport,
+                                Ipv4Address saddr, uint16_t sport,
+                                Ptr<Ipv4Interface> interface);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("IPv4 end point demux")
+{
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemuxTestCase::Lookup (Ipv4EndPointDemux &demux,
+                                   Ipv4Address daddr, uint16_t dport,
+                                   Ipv4Address saddr, uint16_t sport,
+                                   Ptr<Ipv4Interface> interface)
+{
+  Ipv4EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, interface);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv4Address local ("10.1.1.1");
+  Ipv4Address peer ("10.2.2.2");
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  interface->AddAddress (Ipv4InterfaceAddress (local, Ipv4Mask ("255.255.255.0")));
+
+  Ipv4EndPointDemux demux;
+  Ipv4EndPoint *any = demux.Allocate (0, 80);
+  NS_TEST_ASSERT_MSG_NE (any, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (0, 80), 0, "Duplicated endpoint allowed");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (80), true, "Port not found");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (81), false, "Unused port found");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupLocal (0, Ipv4Address::GetAny (), 80), true, "Endpoint not found");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1000, interface), any, "Wildcard endpoint not matched");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 81, peer, 1000, interface), 0, "Wrong port matched");
+
+  Ipv4EndPoint *bound = demux.Allocate (0, local, 80);
+  NS_TEST_ASSERT_MSG_NE (bound, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1000, interface), bound, "Local address match not preferred");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, Ipv4Address ("10.1.1.2"), 80, peer, 1000, interface), any, "Wildcard endpoint not matched");
+
+  Ipv4EndPoint *subnet = demux.Allocate (0, Ipv4Address ("10.1.1.0"), 53);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, Ipv4Address ("10.1.1.255"), 53, peer, 1000, interface), subnet, "Subnet-directed broadcast not matched");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, Ipv4Address ("10.1.2.255"), 53, peer, 1000, interface), 0, "Other subnet matched");
+
+  Ipv4EndPoint *connection = demux.Allocate (0, local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_NE (connection, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (0, local, 80, peer, 1000), 0, "Duplicated connection allowed");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1000, interface), connection, "Four-tuple match not preferred");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1001, interface), bound, "Wrong connection matched");
+  connection->SetRxEnabled (false);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1000, interface), bound, "Disabled endpoint matched");
+  connection->SetRxEnabled (true);
+  demux.DeAllocate (connection);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1000, interface), bound, "Removed connection matched");
+  demux.DeAllocate (bound);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1000, interface), any, "Removed endpoint matched");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupLocal (0, local, 80), false, "Removed endpoint found");
+
+  // an active open: ephemeral port, then peer, then local address
+  demux.Allocate (0, 49154);
+  Ipv4EndPoint *client = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_EQ (client->GetLocalPort (), 49153, "Wrong ephemeral port");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate ()->GetLocalPort (), 49155, "Used ephemeral port allocated");
+  client->SetPeer (peer, 8080);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 49153, peer, 8080, interface), client, "Connection with wildcard local address not matched");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 49153, peer, 8081, interface), 0, "Wrong connection matched");
+  client->SetLocalAddress (local);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 49153, peer, 8080, interface), client, "Updated connection not matched");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, Ipv4Address ("10.1.1.2"), 49153, peer, 8080, interface), 0, "Wrong local address matched");
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 49153, peer, 8080), client, "Simple lookup failed");
+
+  // many connections to the same listener
+  for (uint16_t port = 1; port <= 1000; port++)
+    {
+      demux.Allocate (0, local, 80, peer, port);
+    }
+  for (uint16_t port = 1; port <= 1000; port += 37)
+    {
+      Ipv4EndPoint *endPoint = Lookup (demux, local, 80, peer, port, interface);
+      NS_TEST_ASSERT_MSG_NE (endPoint, 0, "Connection not found");
+      NS_TEST_ASSERT_MSG_EQ (endPoint->GetPeerPort (), port, "Wrong connection matched");
+    }
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1001, interface), any, "Wildcard endpoint not matched");
+  NS_TEST_ASSERT_MSG_EQ (demux.GetAllEndPoints ().size (), 1005, "Wrong number of endpoints");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the matching rules and the ephemeral ports of
+ * Ipv6EndPointDemux, while endpoints are allocated, modified and removed
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param demux the demux
+   * \param daddr the destination address
+   * \param dport the destination port
+   * \param saddr the source address
+   * \param sport the source port
+   * \return the matching endpoint, or 0
+   */
+  static Ipv6EndPoint * Lookup (Ipv6EndPointDemux &demux,
+                                Ipv6Address daddr, uint16_t dport,
+                                Ipv6Address saddr, uint16_t sport);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("IPv6 end point demux")
+{
+}
+
+Ipv6EndPoint *
+Ipv6EndPointDemuxTestCase::Lookup (Ipv6EndPointDemux &demux,
+                                   Ipv6Address daddr, uint16_t dport,
+                                   Ipv6Address saddr, uint16_t sport)
+{
+  Ipv6EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, 0);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6Address local ("2001:1::1");
+  Ipv6Address peer ("2001:2::2");
+
+  Ipv6EndPointDemux demux;
+  Ipv6EndPoint *any = demux.Allocate (0, 80);
+  NS_TEST_ASSERT_MSG_NE (any, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (0, 80), 0, "Duplicated endpoint allowed");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (80), true, "Port not found");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1000), any, "Wildcard endpoint not matched");
+
+  Ipv6EndPoint *bound = demux.Allocate (0, local, 80);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1000), bound, "Local address match not preferred");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, Ipv6Address ("2001:1::2"), 80, peer, 1000), any, "Wildcard endpoint not matched");
+
+  Ipv6EndPoint *connection = demux.Allocate (0, local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (0, local, 80, peer, 1000), 0, "Duplicated connection allowed");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1000), connection, "Four-tuple match not preferred");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1001), bound, "Wrong connection matched");
+  demux.DeAllocate (connection);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 80, peer, 1000), bound, "Removed connection matched");
+
+  // an active open: ephemeral port, then peer, then local address
+  Ipv6EndPoint *client = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_EQ (client->GetLocalPort (), 49153, "Wrong ephemeral port");
+  client->SetPeer (peer, 8080);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 49153, peer, 8080), client, "Connection with wildcard local address not matched");
+  client->SetLocalAddress (local);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 49153, peer, 8080), client, "Updated connection not matched");
+  client->SetLocalPort (49200);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 49153, peer, 8080), 0, "Old port matched");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (demux, local, 49200, peer, 8080), client, "New port not matched");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (49153), false, "Old port still used");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate ()->GetLocalPort (), 49154, "Wrong ephemeral port");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief End point demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ()
+    : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+  }
+};
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite;
@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ip-prefix-trie.h"
+
+#include <vector>
+#include <cstring>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("IpPrefixTrieTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the IPv4 and IPv6 lookups of IpPrefixTrie against a linear
+ * search, while prefixes are added and removed
+ */
+class IpPrefixTrieTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param ipv6 whether to use IPv6 addresses
+   */
+  IpPrefixTrieTestCase (bool ipv6);
+
+private:
+  virtual void DoRun (void);
+
+  /// A prefix and its value
+  struct Entry
+  {
+    uint8_t prefix[16]; //!< the prefix
+    uint32_t length;    //!< the prefix length
+    uint32_t value;     //!< the value
+  };
+
+  /**
+   * \param entry the entry
+   * \param addr the address
+   * \return true if the prefix of the entry matches the address
+   */
+  static bool IsMatch (const Entry &entry, const uint8_t addr[16]);
+
+  /**
+   * Check the lookup of random addresses
+   * \param trie the trie
+   * \param entries the entries stored in the trie, in insertion order
+   */
+  void CheckLookups (const IpPrefixTrie<uint32_t> &trie, const std::vector<Entry> &entries);
+
+  bool m_ipv6; //!< whether to use IPv6 addresses
+  Ptr<UniformRandomVariable> m_rng; //!< random number generator
+};
+
+IpPrefixTrieTestCase::IpPrefixTrieTestCase (bool ipv6)
+  : TestCase (ipv6 ? "IPv6 prefix trie" : "IPv4 prefix trie"),
+    m_ipv6 (ipv6)
+{
+}
+
+bool
+IpPrefixTrieTestCase::IsMatch (const Entry &entry, const uint8_t addr[16])
+{
+  for (uint32_t bit = 0; bit < entry.length; ++bit)
+    {
+      uint8_t mask = 0x80 >> (bit % 8);
+      if ((entry.prefix[bit / 8] & mask) != (addr[bit / 8] & mask))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+IpPrefixTrieTestCase::CheckLookups (const IpPrefixTrie<uint32_t> &trie, const std::vector<Entry> &entries)
+{
+  uint32_t addressBytes = m_ipv6 ? 16 : 4;
+  for (uint32_t n = 0; n < 2000; ++n)
+    {
+      uint8_t addr[16] = {0};
+      for (uint32_t i = 0; i < addressBytes; ++i)
+        {
+          // a small alphabet, so that prefixes overlap often
+          addr[i] = (i < 3) ? m_rng->GetInteger (0, 3) << 6 : m_rng->GetInteger (0, 255);
+        }
+
+      // expected: values of the matching prefixes, longest first, in insertion order
+      std::vector<std::vector<uint32_t> > byLength (129);
+      for (std::vector<Entry>::const_iterator it = entries.begin (); it != entries.end (); ++it)
+        {
+          if (IsMatch (*it, addr))
+            {
+              byLength[it->length].push_back (it->value);
+            }
+        }
+      std::vector<std::vector<uint32_t> > expected;
+      for (int32_t length = 128; length >= 0; --length)
+        {
+          if (!byLength[length].empty ())
+            {
+              expected.push_back (byLength[length]);
+            }
+        }
+
+      IpPrefixTrie<uint32_t>::MatchArray matches;
+      uint32_t nMatches = trie.Lookup (addr, matches);
+      NS_TEST_ASSERT_MSG_EQ (nMatches, expected.size (), "Wrong number of matching prefixes");
+      for (uint32_t m = 0; m < nMatches; ++m)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((*matches[m] == expected[m]), true, "Wrong values for matching prefix " << m);
+        }
+    }
+}
+
+void
+IpPrefixTrieTestCase::DoRun (void)
+{
+  m_rng = CreateObject<UniformRandomVariable> ();
+  m_rng->SetStream (m_ipv6 ? 2 : 1);
+
+  const uint32_t ipv4Lengths[] = {0, 1, 2, 4, 8, 16, 20, 24, 30, 32};
+  const uint32_t ipv6Lengths[] = {0, 1, 2, 8, 16, 32, 48, 64, 96, 128};
+  uint32_t addressBytes = m_ipv6 ? 16 : 4;
+
+  IpPrefixTrie<uint32_t> trie;
+  std::vector<Entry> entries;
+  for (uint32_t n = 0; n < 500; ++n)
+    {
+      Entry entry;
+      std::memset (entry.prefix, 0, 16);
+      for (uint32_t i = 0; i < addressBytes; ++i)
+        {
+          entry.prefix[i] = (i < 3) ? m_rng->GetInteger (0, 3) << 6 : m_rng->GetInteger (0, 255);
+        }
+      entry.length = m_ipv6 ? ipv6Lengths[m_rng->GetInteger (0, 9)] : ipv4Lengths[m_rng->GetInteger (0, 9)];
+      entry.value = n;
+      trie.Insert (entry.prefix, entry.length, entry.value);
+      entries.push_back (entry);
+    }
+  NS_TEST_ASSERT_MSG_EQ (trie.GetNValues (), entries.size (), "Wrong number of values");
+  CheckLookups (trie, entries);
+
+  // remove two thirds of the entries, in random order
+  for (uint32_t n = 0; n < 333; ++n)
+    {
+      uint32_t index = m_rng->GetInteger (0, entries.size () - 1);
+      bool removed = trie.Remove (entries[index].prefix, entries[index].length, entries[index].value);
+      NS_TEST_ASSERT_MSG_EQ (removed, true, "Entry not found");
+      removed = trie.Remove (entries[index].prefix, entries[index].length, entries[index].value);
+      NS_TEST_ASSERT_MSG_EQ (removed, false, "Entry removed twice");
+      entries.erase (entries.begin () + index);
+    }
+  NS_TEST_ASSERT_MSG_EQ (trie.GetNValues (), entries.size (), "Wrong number of values");
+  CheckLookups (trie, entries);
+
+  trie.Clear ();
+  CheckLookups (trie, std::vector<Entry> ());
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IpPrefixTrie TestSuite
+ */
+class IpPrefixTrieTestSuite : public TestSuite
+{
+public:
+  IpPrefixTrieTestSuite ()
+    : TestSuite ("ip-prefix-trie", UNIT)
+  {
+    AddTestCase (new IpPrefixTrieTestCase (false), TestCase::QUICK);
+    AddTestCase (new IpPrefixTrieTestCase (true), TestCase::QUICK);
+  }
+};
+static IpPrefixTrieTestSuite g_ipPrefixTrieTestSuite;
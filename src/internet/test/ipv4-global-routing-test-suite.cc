@@ -15,6 +15,7 @@
  */
 
 #include <vector>
+#include <sstream>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
 #include "ns3/inet-socket-address.h"
@@ -1244,6 +1245,180 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv4 GlobalRouting parallel and incremental SPF test
+ *
+ * Checks that the routing tables computed with several threads, and the
+ * ones updated after interface events, are identical to the ones computed
+ * from scratch by a single thread.
+ */
+class Ipv4GlobalRoutingSpfTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingSpfTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Connect nodes to a channel.
+   * \param nodes The nodes.
+   * \param pointToPoint Whether the channel is a point-to-point link.
+   * \param metrics The metric of the interface of each node.
+   * \return The interfaces.
+   */
+  Ipv4InterfaceContainer Connect (NodeContainer nodes, bool pointToPoint, std::vector<uint16_t> metrics);
+
+  /**
+   * \brief Get the routing tables of all the nodes.
+   * \return The routes of each node, in order.
+   */
+  std::vector<std::string> GetRoutingTables (void) const;
+
+  NodeContainer m_nodes;   //!< Nodes used in the test.
+  Ipv4AddressHelper m_ipv4; //!< Address allocator.
+  Ipv4InterfaceContainer m_events; //!< Interfaces taken down and up.
+};
+
+Ipv4GlobalRoutingSpfTestCase::Ipv4GlobalRoutingSpfTestCase ()
+  : TestCase ("Global routing with parallel and incremental SPF calculations")
+{
+}
+
+Ipv4InterfaceContainer
+Ipv4GlobalRoutingSpfTestCase::Connect (NodeContainer nodes, bool pointToPoint, std::vector<uint16_t> metrics)
+{
+  Ptr<SimpleChannel> channel = CreateObject <SimpleChannel> ();
+  SimpleNetDeviceHelper simpleHelper;
+  simpleHelper.SetNetDevicePointToPointMode (pointToPoint);
+  NetDeviceContainer net = simpleHelper.Install (nodes, channel);
+  Ipv4InterfaceContainer interfaces = m_ipv4.Assign (net);
+  for (uint32_t i = 0; i < interfaces.GetN (); i++)
+    {
+      interfaces.Get (i).first->SetMetric (interfaces.Get (i).second, metrics[i]);
+    }
+  m_ipv4.NewNetwork ();
+  return interfaces;
+}
+
+void
+Ipv4GlobalRoutingSpfTestCase::DoSetup ()
+{
+  // The topology avoids equal cost paths towards transit networks not
+  // directly connected to the root, that global routing does not support.
+  const uint32_t nRing = 23;
+  m_nodes.Create (nRing + 4);
+
+  InternetStackHelper internet;
+  Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+  internet.SetRoutingHelper (ipv4RoutingHelper);
+  internet.Install (m_nodes);
+
+  m_ipv4.SetBase ("10.0.0.0", "255.255.255.0");
+  std::vector<uint16_t> unit (2, 1);
+  // a ring with an odd number of routers
+  for (uint32_t i = 0; i < nRing; i++)
+    {
+      Ipv4InterfaceContainer interfaces = Connect (NodeContainer (m_nodes.Get (i), m_nodes.Get ((i + 1) % nRing)), true, unit);
+      if (i == 5)
+        {
+          m_events.Add (interfaces.Get (0));
+        }
+    }
+  // a LAN, whose metrics make it a transit network only towards itself
+  std::vector<uint16_t> lanMetrics;
+  lanMetrics.push_back (100);
+  lanMetrics.push_back (1000);
+  lanMetrics.push_back (10000);
+  Ipv4InterfaceContainer lan = Connect (NodeContainer (m_nodes.Get (0), m_nodes.Get (7), m_nodes.Get (14)), false, lanMetrics);
+  m_events.Add (lan.Get (0));
+  // a diamond hanging from the ring, with equal cost paths from the ring
+  // to its bottom router
+  std::vector<uint16_t> asymmetric;
+  asymmetric.push_back (1);
+  asymmetric.push_back (2);
+  Ptr<Node> top = m_nodes.Get (3);
+  Ptr<Node> bottom = m_nodes.Get (nRing + 2);
+  Connect (NodeContainer (top, m_nodes.Get (nRing)), true, unit);
+  Connect (NodeContainer (top, m_nodes.Get (nRing + 1)), true, asymmetric);
+  Ipv4InterfaceContainer left = Connect (NodeContainer (m_nodes.Get (nRing), bottom), true, unit);
+  m_events.Add (left.Get (0));
+  Connect (NodeContainer (m_nodes.Get (nRing + 1), bottom), true, unit);
+  // a stub router
+  Connect (NodeContainer (m_nodes.Get (10), m_nodes.Get (nRing + 3)), true, unit);
+}
+
+void
+Ipv4GlobalRoutingSpfTestCase::DoTeardown ()
+{
+  Config::SetGlobal ("GlobalRoutingThreads", UintegerValue (1));
+  Simulator::Destroy ();
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingSpfTestCase::GetRoutingTables (void) const
+{
+  std::vector<std::string> tables;
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> routing = m_nodes.Get (i)->GetObject<Ipv4> ()->GetRoutingProtocol ()->GetObject<Ipv4GlobalRouting> ();
+      std::ostringstream oss;
+      for (uint32_t j = 0; j < routing->GetNRoutes (); j++)
+        {
+          oss << *routing->GetRoute (j) << std::endl;
+        }
+      tables.push_back (oss.str ());
+    }
+  return tables;
+}
+
+void
+Ipv4GlobalRoutingSpfTestCase::DoRun ()
+{
+  Config::SetGlobal ("GlobalRoutingThreads", UintegerValue (1));
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> expected = GetRoutingTables ();
+  NS_TEST_ASSERT_MSG_NE (expected[1], "", "No routes computed");
+
+  Config::SetGlobal ("GlobalRoutingThreads", UintegerValue (4));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> tables = GetRoutingTables ();
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (tables[i], expected[i], "Wrong routes with 4 threads on node " << i);
+    }
+
+  // take interfaces down and up again, comparing the updated routes with the
+  // routes computed from scratch
+  for (uint32_t e = 0; e < 2 * m_events.GetN (); e++)
+    {
+      std::pair<Ptr<Ipv4>, uint32_t> event = m_events.Get (e % m_events.GetN ());
+      if (e < m_events.GetN ())
+        {
+          event.first->SetDown (event.second);
+        }
+      else
+        {
+          event.first->SetUp (event.second);
+        }
+      Ipv4GlobalRoutingHelper::UpdateRoutingTables ();
+      tables = GetRoutingTables ();
+      Config::SetGlobal ("GlobalRoutingThreads", UintegerValue (1));
+      Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+      expected = GetRoutingTables ();
+      for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (tables[i], expected[i], "Wrong updated routes on node " << i << " after event " << e);
+        }
+      Config::SetGlobal ("GlobalRoutingThreads", UintegerValue (4));
+    }
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -1267,6 +1442,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingSpfTestCase, TestCase::QUICK);
   }
 
 static Ipv4GlobalRoutingTestSuite g_globalRoutingTestSuite; //!< Static variable for test initialization
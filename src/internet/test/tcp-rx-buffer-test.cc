@@ -21,6 +21,8 @@
 
 #include "ns3/tcp-rx-buffer.h"
 
+#include <vector>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("TcpRxBufferTestSuite");
@@ -44,6 +46,24 @@ private:
    * \brief Test the SACK list update.
    */
   void TestUpdateSACKList ();
+
+  /**
+   * \brief Test the reassembly of overlapping, out-of-order segments.
+   */
+  void TestReassembly ();
+
+  /**
+   * \brief Test a stream longer than the sequence space, starting near the wrap.
+   */
+  void TestWrapAround ();
+
+  /**
+   * \brief Create a segment of the test byte stream
+   * \param seq first sequence number of the segment
+   * \param size size of the segment
+   * \return the segment payload
+   */
+  static Ptr<Packet> CreateSegment (uint32_t seq, uint32_t size);
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase ()
@@ -55,6 +75,78 @@ void
 TcpRxBufferTestCase::DoRun ()
 {
   TestUpdateSACKList ();
+  TestReassembly ();
+  TestWrapAround ();
+}
+
+Ptr<Packet>
+TcpRxBufferTestCase::CreateSegment (uint32_t seq, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      data[i] = (seq + i) % 251;
+    }
+  return Create<Packet> (data.data (), size);
+}
+
+void
+TcpRxBufferTestCase::TestReassembly ()
+{
+  TcpRxBuffer rxBuf;
+  rxBuf.SetNextRxSequence (SequenceNumber32 (1));
+  rxBuf.SetMaxBufferSize (10000);
+  TcpHeader h;
+
+  // Segments as [first sequence, size], out of order and overlapping:
+  // duplicates, segments covering several stored blocks, and segments
+  // partially overlapping the head or the tail of a block
+  const uint32_t segments[][2] = {
+    {301, 100}, {601, 100}, {351, 100}, {501, 50}, {201, 600},
+    {601, 100}, {901, 100}, {851, 200}, {1, 100}, {51, 200}, {1051, 100},
+    {751, 150}
+  };
+  const uint32_t nextRx[] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 101, 801, 801, 1151
+  };
+  for (uint32_t n = 0; n < sizeof (nextRx) / sizeof (nextRx[0]); ++n)
+    {
+      h.SetSequenceNumber (SequenceNumber32 (segments[n][0]));
+      rxBuf.Add (CreateSegment (segments[n][0], segments[n][1]), h);
+      NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (nextRx[n]),
+                             "Sequence number differs from expected after segment " << n);
+    }
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 1150, "Buffer occupancy differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 1150, "Available bytes differ from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.GetSackListSize (), 0, "SACK list should be empty");
+
+  // Extract the stream in chunks of various sizes, and check its content
+  uint32_t seq = 1;
+  const uint32_t chunks[] = {100, 30, 500, 1, 519};
+  for (uint32_t n = 0; n < sizeof (chunks) / sizeof (chunks[0]); ++n)
+    {
+      Ptr<Packet> p = rxBuf.Extract (chunks[n]);
+      NS_TEST_ASSERT_MSG_EQ ((p != nullptr), true, "Nothing extracted");
+      NS_TEST_ASSERT_MSG_EQ (p->GetSize (), chunks[n], "Extracted size differs from expected");
+      std::vector<uint8_t> data (chunks[n]);
+      p->CopyData (data.data (), chunks[n]);
+      for (uint32_t i = 0; i < chunks[n]; ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (data[i]), (seq + i) % 251,
+                                 "Wrong byte at sequence " << seq + i);
+        }
+      seq += chunks[n];
+    }
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 0, "Buffer should be empty");
+  NS_TEST_ASSERT_MSG_EQ ((rxBuf.Extract (100) == nullptr), true,
+                         "Extracted data from an empty buffer");
+
+  // In sequence data after the buffer was emptied
+  h.SetSequenceNumber (SequenceNumber32 (1151));
+  rxBuf.Add (CreateSegment (1151, 100), h);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (1251),
+                         "Sequence number differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 100, "Available bytes differ from expected");
 }
 
 void
@@ -338,6 +430,57 @@ TcpRxBufferTestCase::TestUpdateSACKList ()
                          "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestWrapAround ()
+{
+  const uint32_t segSize = 1 << 19;
+  TcpRxBuffer rxBuf;
+  rxBuf.SetMaxBufferSize (4 * segSize);
+  SequenceNumber32 seq (0xffffffff - 1500);
+  rxBuf.SetNextRxSequence (seq);
+  TcpHeader h;
+
+  // Out of order segments across the wrap
+  h.SetSequenceNumber (seq + SequenceNumber32 (1000));
+  rxBuf.Add (Create<Packet> (1000), h);
+  h.SetSequenceNumber (seq);
+  rxBuf.Add (Create<Packet> (1000), h);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), seq + SequenceNumber32 (2000),
+                         "Sequence number differs from expected across the wrap");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Extract (2000)->GetSize (), 2000, "Extracted size differs from expected");
+  seq += 2000;
+
+  // More than 2^32 bytes: in sequence for 3 GiB, and then each pair of
+  // segments received out of order, so that the out of order blocks land
+  // where the stream started
+  uint64_t total = 0;
+  while (total < (uint64_t (5) << 30))
+    {
+      if (total >= (uint64_t (3) << 30))
+        {
+          h.SetSequenceNumber (seq + SequenceNumber32 (segSize));
+          NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (Create<Packet> (segSize), h), true,
+                                 "Out of order segment dropped after " << total << " bytes");
+        }
+      h.SetSequenceNumber (seq);
+      NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (Create<Packet> (segSize), h), true,
+                             "In sequence segment dropped after " << total << " bytes");
+      if (total < (uint64_t (3) << 30))
+        {
+          h.SetSequenceNumber (seq + SequenceNumber32 (segSize));
+          NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (Create<Packet> (segSize), h), true,
+                                 "In sequence segment dropped after " << total << " bytes");
+        }
+      seq += 2 * segSize;
+      NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), seq,
+                             "Sequence number differs from expected after " << total << " bytes");
+      NS_TEST_ASSERT_MSG_EQ (rxBuf.Extract (2 * segSize)->GetSize (), 2 * segSize,
+                             "Extracted size differs from expected after " << total << " bytes");
+      total += 2 * segSize;
+    }
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 0, "Buffer should be empty");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown ()
 {
@@ -49,6 +49,8 @@ private:
   void TestTransmittedBlock ();
   /** \brief Test the generation of the "next" block */
   void TestNextSeg ();
+  /** \brief Test the scoreboard of a long sent list, with many holes */
+  void TestScoreboard ();
 };
 
 TcpTxBufferTestCase::TcpTxBufferTestCase ()
@@ -81,6 +83,8 @@ TcpTxBufferTestCase::DoRun ()
                        &TcpTxBufferTestCase::TestTransmittedBlock, this);
   Simulator::Schedule (Seconds (0.0),
                        &TcpTxBufferTestCase::TestNextSeg, this);
+  Simulator::Schedule (Seconds (0.0),
+                       &TcpTxBufferTestCase::TestScoreboard, this);
 
   Simulator::Run ();
   Simulator::Destroy ();
@@ -267,6 +271,131 @@ TcpTxBufferTestCase::TestNextSeg ()
                          "Data inside the buffer");
 }
 
+void
+TcpTxBufferTestCase::TestScoreboard ()
+{
+  TcpTxBuffer txBuf;
+  SequenceNumber32 head (1);
+  SequenceNumber32 ret;
+  uint32_t segmentSize = 100;
+  uint32_t nSegments = 200;
+  txBuf.SetHeadSequence (head);
+  txBuf.SetSegmentSize (segmentSize);
+  txBuf.SetDupAckThresh (3);
+  txBuf.SetMaxBufferSize (segmentSize * nSegments);
+  Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack> ();
+
+  txBuf.Add (Create<Packet> (segmentSize * nSegments));
+  for (uint32_t i = 0; i < nSegments; ++i)
+    {
+      txBuf.CopyFromSequence (segmentSize, head + (segmentSize * i));
+    }
+
+  // SACK the odd segments up to 99, one at a time, leaving a hole
+  // between each of them
+  for (uint32_t i = 1; i < 100; i += 2)
+    {
+      sack->ClearSackList ();
+      sack->AddSackBlock (TcpOptionSack::SackBlock (head + (segmentSize * i),
+                                                    head + (segmentSize * (i + 1))));
+      txBuf.Update (sack->GetSackList ());
+    }
+
+  // A hole is lost when at least three segments above it are sacked,
+  // hence the holes up to segment 94 are lost
+  for (uint32_t i = 0; i < nSegments; ++i)
+    {
+      bool lost = (i % 2 == 0) && i <= 94;
+      NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head + (segmentSize * i)), lost,
+                             "Wrong lost state for segment " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf.GetLost (), 48 * segmentSize,
+                         "Wrong number of lost bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.GetSacked (), 50 * segmentSize,
+                         "Wrong number of sacked bytes");
+
+  // The lost holes are returned in order, each once
+  for (uint32_t i = 0; i <= 94; i += 2)
+    {
+      NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, true), true,
+                             "No NextSeq with lost segments");
+      NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * i),
+                             "Different NextSeq than the lowest lost segment");
+      txBuf.CopyFromSequence (segmentSize, ret);
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf.GetRetransmitsCount (), 48 * segmentSize,
+                         "Wrong number of retransmitted bytes");
+
+  // No unsent data: rule (3) gives the first hole that is not lost
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, true), true,
+                         "No NextSeq for rule 3");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * 96),
+                         "Different NextSeq than expected for rule 3");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), false,
+                         "NextSeq returned outside recovery");
+
+  // A cumulative ACK in the middle of the holes, then more SACKs
+  head = head + (segmentSize * 50);
+  txBuf.DiscardUpTo (head);
+  for (uint32_t i = 51; i < 100; i += 2)
+    {
+      NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head + (segmentSize * (i - 50))),
+                             false, "Sacked segment marked as lost");
+    }
+  sack->ClearSackList ();
+  sack->AddSackBlock (TcpOptionSack::SackBlock (head + (segmentSize * 60),
+                                                head + (segmentSize * 64)));
+  txBuf.Update (sack->GetSackList ());
+  NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head + (segmentSize * 50)), true,
+                         "Hole below three sacked segments is not lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, true), true,
+                         "No NextSeq with lost segments");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * 46),
+                         "Different NextSeq than the lowest lost segment");
+
+  txBuf.DiscardUpTo (head + (segmentSize * 150));
+  NS_TEST_ASSERT_MSG_EQ (txBuf.Size (), 0, "Data inside the buffer");
+
+  // A lossless flow of more than 2^31 bytes, and then a hole: the hints
+  // must have followed SND.UNA for the hole to be found
+  TcpTxBuffer longTxBuf;
+  segmentSize = 1 << 16;
+  nSegments = 16;
+  head = SequenceNumber32 (1);
+  longTxBuf.SetHeadSequence (head);
+  longTxBuf.SetSegmentSize (segmentSize);
+  longTxBuf.SetDupAckThresh (3);
+  longTxBuf.SetMaxBufferSize (segmentSize * nSegments);
+  for (uint64_t sent = 0; sent <= (uint64_t (1) << 31); sent += segmentSize * nSegments)
+    {
+      longTxBuf.Add (Create<Packet> (segmentSize * nSegments));
+      for (uint32_t i = 0; i < nSegments; ++i)
+        {
+          longTxBuf.CopyFromSequence (segmentSize, head + (segmentSize * i));
+        }
+      NS_TEST_ASSERT_MSG_EQ (longTxBuf.NextSeg (&ret, false), false,
+                             "NextSeq returned without losses");
+      head = head + (segmentSize * nSegments);
+      longTxBuf.DiscardUpTo (head);
+    }
+  longTxBuf.Add (Create<Packet> (segmentSize * 5));
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      longTxBuf.CopyFromSequence (segmentSize, head + (segmentSize * i));
+    }
+  sack->ClearSackList ();
+  sack->AddSackBlock (TcpOptionSack::SackBlock (head + segmentSize,
+                                                head + (segmentSize * 5)));
+  longTxBuf.Update (sack->GetSackList ());
+  NS_TEST_ASSERT_MSG_EQ (longTxBuf.IsLost (head), true,
+                         "Hole below four sacked segments is not lost after 2^31 bytes");
+  NS_TEST_ASSERT_MSG_EQ (longTxBuf.GetLost (), segmentSize,
+                         "Wrong number of lost bytes after 2^31 bytes");
+  NS_TEST_ASSERT_MSG_EQ (longTxBuf.NextSeg (&ret, true), true,
+                         "No NextSeq with a lost segment after 2^31 bytes");
+  NS_TEST_ASSERT_MSG_EQ (ret, head, "Different NextSeq than the lost segment");
+}
+
 void
 TcpTxBufferTestCase::TestNewBlock ()
 {
@@ -0,0 +1,275 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/udp-header.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/tuple-space-classifier.h"
+#include "ns3/ipv4-five-tuple-packet-filter.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TupleSpaceClassifierTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the tuple space search returns the same rule as the
+ * linear search on random rule sets
+ */
+class TupleSpaceClassifierRandomTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param nRules the number of rules
+   * \param ipv6 whether to use IPv6 rules
+   */
+  TupleSpaceClassifierRandomTestCase (uint32_t nRules, bool ipv6);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param prefixLength the prefix length
+   * \param buf the 16 byte mask to fill
+   * \param maxLength the length of the address
+   */
+  static void FillMask (uint32_t prefixLength, uint8_t buf[16], uint32_t maxLength);
+
+  uint32_t m_nRules; ///< the number of rules
+  bool m_ipv6;       ///< whether to use IPv6 rules
+};
+
+TupleSpaceClassifierRandomTestCase::TupleSpaceClassifierRandomTestCase (uint32_t nRules, bool ipv6)
+  : TestCase ("Random rule set: " + std::to_string (nRules) + (ipv6 ? " IPv6" : " IPv4") + " rules"),
+    m_nRules (nRules),
+    m_ipv6 (ipv6)
+{
+}
+
+void
+TupleSpaceClassifierRandomTestCase::FillMask (uint32_t prefixLength, uint8_t buf[16], uint32_t maxLength)
+{
+  for (uint32_t i = 0; i < 16; ++i)
+    {
+      uint32_t bits = 0;
+      if (i * 8 < maxLength && prefixLength > i * 8)
+        {
+          bits = std::min<uint32_t> (8, prefixLength - i * 8);
+        }
+      buf[i] = static_cast<uint8_t> (0xff00 >> bits);
+    }
+}
+
+void
+TupleSpaceClassifierRandomTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1 + m_nRules);
+
+  uint32_t addressLength = m_ipv6 ? 128 : 32;
+  // addresses are drawn from a small space so that rules overlap often
+  uint32_t addressBytes = m_ipv6 ? 16 : 4;
+  const uint32_t prefixLengths[] = {0, 8, 16, 24, addressLength};
+
+  TupleSpaceClassifier classifier;
+  for (uint32_t n = 0; n < m_nRules; ++n)
+    {
+      TupleSpaceClassifier::Rule rule;
+      for (uint32_t i = 0; i < addressBytes; ++i)
+        {
+          rule.source[i] = rng->GetInteger (0, 3);
+          rule.destination[i] = rng->GetInteger (0, 3);
+        }
+      FillMask (prefixLengths[rng->GetInteger (0, 4)], rule.sourceMask, addressLength);
+      FillMask (prefixLengths[rng->GetInteger (0, 4)], rule.destinationMask, addressLength);
+      switch (rng->GetInteger (0, 2))
+        {
+        case 0:
+          break;
+        case 1:
+          rule.sourcePortStart = rule.sourcePortEnd = rng->GetInteger (1000, 1010);
+          break;
+        default:
+          rule.sourcePortStart = rng->GetInteger (1000, 1010);
+          rule.sourcePortEnd = rule.sourcePortStart + rng->GetInteger (0, 5);
+        }
+      switch (rng->GetInteger (0, 2))
+        {
+        case 0:
+          break;
+        case 1:
+          rule.destinationPortStart = rule.destinationPortEnd = rng->GetInteger (2000, 2010);
+          break;
+        default:
+          rule.destinationPortStart = rng->GetInteger (2000, 2010);
+          rule.destinationPortEnd = rule.destinationPortStart + rng->GetInteger (0, 5);
+        }
+      if (rng->GetInteger (0, 1))
+        {
+          rule.protocol = rng->GetInteger (0, 1) ? 6 : 17;
+          rule.protocolMask = 0xff;
+        }
+      if (rng->GetInteger (0, 3) == 0)
+        {
+          rule.tos = rng->GetInteger (0, 3) << 2;
+          rule.tosMask = 0xfc;
+        }
+      rule.priority = rng->GetInteger (0, 10);
+      rule.value = n;
+      classifier.Add (rule);
+    }
+  NS_TEST_ASSERT_MSG_EQ (classifier.GetNRules (), m_nRules, "Wrong number of rules");
+
+  for (uint32_t n = 0; n < 10000; ++n)
+    {
+      TupleSpaceClassifier::Key key;
+      for (uint32_t i = 0; i < addressBytes; ++i)
+        {
+          key.source[i] = rng->GetInteger (0, 3);
+          key.destination[i] = rng->GetInteger (0, 3);
+        }
+      key.sourcePort = rng->GetInteger (998, 1017);
+      key.destinationPort = rng->GetInteger (1998, 2017);
+      key.protocol = rng->GetInteger (0, 1) ? 6 : 17;
+      key.tos = rng->GetInteger (0, 3) << 2;
+
+      const TupleSpaceClassifier::Rule *expected = classifier.LookupLinear (key);
+      const TupleSpaceClassifier::Rule *rule = classifier.Lookup (key);
+      NS_TEST_ASSERT_MSG_EQ (rule, expected, "Lookup and linear search disagree");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the classification of IPv4 packets by Ipv4FiveTuplePacketFilter
+ */
+class Ipv4FiveTuplePacketFilterTestCase : public TestCase
+{
+public:
+  Ipv4FiveTuplePacketFilterTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param src the source address
+   * \param dst the destination address
+   * \param srcPort the source port
+   * \param dstPort the destination port
+   * \param tos the type of service
+   * \return a UDP packet queue disc item
+   */
+  static Ptr<QueueDiscItem> CreateItem (Ipv4Address src, Ipv4Address dst,
+                                        uint16_t srcPort, uint16_t dstPort, uint8_t tos);
+};
+
+Ipv4FiveTuplePacketFilterTestCase::Ipv4FiveTuplePacketFilterTestCase ()
+  : TestCase ("Ipv4FiveTuplePacketFilter classification")
+{
+}
+
+Ptr<QueueDiscItem>
+Ipv4FiveTuplePacketFilterTestCase::CreateItem (Ipv4Address src, Ipv4Address dst,
+                                               uint16_t srcPort, uint16_t dstPort, uint8_t tos)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (srcPort);
+  udpHeader.SetDestinationPort (dstPort);
+  p->AddHeader (udpHeader);
+
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (src);
+  ipHeader.SetDestination (dst);
+  ipHeader.SetProtocol (17);
+  ipHeader.SetTos (tos);
+  ipHeader.SetPayloadSize (p->GetSize ());
+  return Create<Ipv4QueueDiscItem> (p, Address (), 0x0800, ipHeader);
+}
+
+void
+Ipv4FiveTuplePacketFilterTestCase::DoRun (void)
+{
+  Ptr<Ipv4FiveTuplePacketFilter> filter = CreateObject<Ipv4FiveTuplePacketFilter> ();
+
+  TupleSpaceClassifier::Rule voice;
+  voice.SetDestination (Ipv4Address ("10.1.1.0"), Ipv4Mask ("255.255.255.0"));
+  voice.destinationPortStart = 5060;
+  voice.destinationPortEnd = 5061;
+  voice.protocol = 17;
+  voice.protocolMask = 0xff;
+  voice.priority = 1;
+  voice.value = 1;
+  filter->AddRule (voice);
+
+  TupleSpaceClassifier::Rule video;
+  video.tos = 0x88;
+  video.tosMask = 0xfc;
+  video.priority = 2;
+  video.value = 2;
+  filter->AddRule (video);
+
+  TupleSpaceClassifier::Rule host;
+  host.SetSource (Ipv4Address ("10.2.2.2"), Ipv4Mask ("255.255.255.255"));
+  host.priority = 3;
+  host.value = 3;
+  filter->AddRule (host);
+  NS_TEST_ASSERT_MSG_EQ (filter->GetNRules (), 3, "Wrong number of rules");
+
+  NS_TEST_ASSERT_MSG_EQ (filter->Classify (CreateItem ("10.2.2.2", "10.1.1.5", 1000, 5060, 0x88)), 1,
+                         "The voice rule has the highest priority");
+  NS_TEST_ASSERT_MSG_EQ (filter->Classify (CreateItem ("10.2.2.2", "10.1.2.5", 1000, 5060, 0x88)), 2,
+                         "The destination does not match the voice rule");
+  NS_TEST_ASSERT_MSG_EQ (filter->Classify (CreateItem ("10.2.2.2", "10.1.1.5", 1000, 5062, 0)), 3,
+                         "The port does not match the voice rule");
+  NS_TEST_ASSERT_MSG_EQ (filter->Classify (CreateItem ("10.2.2.3", "10.1.1.5", 1000, 80, 0)),
+                         PacketFilter::PF_NO_MATCH, "No rule should match");
+
+  filter->ClearRules ();
+  NS_TEST_ASSERT_MSG_EQ (filter->Classify (CreateItem ("10.2.2.2", "10.1.1.5", 1000, 5060, 0x88)),
+                         PacketFilter::PF_NO_MATCH, "No rule should match after clearing");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TupleSpaceClassifier TestSuite
+ */
+class TupleSpaceClassifierTestSuite : public TestSuite
+{
+public:
+  TupleSpaceClassifierTestSuite ()
+    : TestSuite ("tuple-space-classifier", UNIT)
+  {
+    AddTestCase (new Ipv4FiveTuplePacketFilterTestCase, TestCase::QUICK);
+    AddTestCase (new TupleSpaceClassifierRandomTestCase (10, false), TestCase::QUICK);
+    AddTestCase (new TupleSpaceClassifierRandomTestCase (10, true), TestCase::QUICK);
+    AddTestCase (new TupleSpaceClassifierRandomTestCase (1000, false), TestCase::QUICK);
+    AddTestCase (new TupleSpaceClassifierRandomTestCase (1000, true), TestCase::QUICK);
+    AddTestCase (new TupleSpaceClassifierRandomTestCase (5000, false), TestCase::EXTENSIVE);
+  }
+};
+static TupleSpaceClassifierTestSuite g_tupleSpaceClassifierTestSuite;
@@ -36,6 +36,7 @@
 #include <ns3/lte-enb-phy.h>
 #include <ns3/lte-ue-phy.h>
 #include <ns3/lte-spectrum-phy.h>
+#include <ns3/lte-gain-map.h>
 #include <ns3/lte-chunk-processor.h>
 #include <ns3/multi-model-spectrum-channel.h>
 #include <ns3/friis-spectrum-propagation-loss.h>
@@ -220,6 +221,39 @@ LteHelper::GetDownlinkSpectrumChannel (void) const
   return m_downlinkChannel;
 }
 
+Ptr<LteGainMap>
+LteHelper::InstallDlGainMap (NetDeviceContainer enbDevices, NetDeviceContainer ueDevices)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (!m_usePdschForCqiGeneration, "The gain map requires the PDSCH based DL CQI (UsePdschForCqiGeneration)");
+  Ptr<PropagationLossModel> plm = m_downlinkPathlossModel->GetObject<PropagationLossModel> ();
+  Ptr<SpectrumPropagationLossModel> splm = m_downlinkPathlossModel->GetObject<SpectrumPropagationLossModel> ();
+  Ptr<LteGainMap> gainMap = CreateObject<LteGainMap> ();
+  for (NetDeviceContainer::Iterator enbIt = enbDevices.Begin (); enbIt != enbDevices.End (); ++enbIt)
+    {
+      Ptr<LteEnbNetDevice> enbDev = (*enbIt)->GetObject<LteEnbNetDevice> ();
+      NS_ASSERT_MSG (enbDev != 0, "not an LteEnbNetDevice");
+      Ptr<LteEnbPhy> enbPhy = enbDev->GetPhy ();
+      for (NetDeviceContainer::Iterator ueIt = ueDevices.Begin (); ueIt != ueDevices.End (); ++ueIt)
+        {
+          Ptr<LteUeNetDevice> ueDev = (*ueIt)->GetObject<LteUeNetDevice> ();
+          NS_ASSERT_MSG (ueDev != 0, "not an LteUeNetDevice");
+          gainMap->ComputeGain (enbDev->GetCellId (), ueDev->GetImsi (),
+                                enbPhy->GetDlSpectrumPhy (),
+                                ueDev->GetPhy ()->GetDownlinkSpectrumPhy (),
+                                LteSpectrumValueHelper::GetSpectrumModel (enbDev->GetDlEarfcn (),
+                                                                          enbDev->GetDlBandwidth ()),
+                                plm, splm);
+        }
+      enbPhy->SetGainMap (gainMap);
+    }
+  for (NetDeviceContainer::Iterator ueIt = ueDevices.Begin (); ueIt != ueDevices.End (); ++ueIt)
+    {
+      (*ueIt)->GetObject<LteUeNetDevice> ()->GetPhy ()->SetGainMap (gainMap);
+    }
+  return gainMap;
+}
+
 void
 LteHelper::ChannelModelInitialization (void)
 {
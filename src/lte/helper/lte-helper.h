@@ -52,6 +52,7 @@ class SpectrumChannel;
 class EpcHelper;
 class PropagationLossModel;
 class SpectrumPropagationLossModel;
+class LteGainMap;
 
 /**
  * \ingroup lte
@@ -669,6 +670,24 @@ public:
    */
   Ptr<SpectrumChannel> GetDownlinkSpectrumChannel (void) const;
 
+  /**
+   * Install a DL gain map.
+   *
+   * Precompute the DL channel gain between every eNB and every UE of
+   * the given containers, using the antenna models of the devices and
+   * the pathloss model configured in this helper, and attach the
+   * resulting map to the (primary carrier) PHY of each eNB and UE: the
+   * eNBs report their DL data PSD to the map every subframe, and the
+   * UEs take the interference of their PDSCH based DL CQI from it.
+   * Fading models are not included in the precomputed gains. The DL
+   * signals are still propagated through the SpectrumChannel.
+   *
+   * \param enbDevices the eNB devices
+   * \param ueDevices the UE devices
+   * \return the gain map
+   */
+  Ptr<LteGainMap> InstallDlGainMap (NetDeviceContainer enbDevices, NetDeviceContainer ueDevices);
+
 
 protected:
   // inherited from Object
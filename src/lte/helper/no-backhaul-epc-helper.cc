@@ -32,6 +32,7 @@
 #include "ns3/epc-sgw-application.h"
 #include "ns3/epc-mme-application.h"
 #include "ns3/epc-x2.h"
+#include "ns3/epc-fast-path.h"
 #include "ns3/lte-enb-rrc.h"
 #include "ns3/epc-ue-nas.h"
 #include "ns3/lte-enb-net-device.h"
@@ -54,7 +55,8 @@ NoBackhaulEpcHelper::NoBackhaulEpcHelper ()
     m_gtpcUdpPort (2123),  // fixed by the standard
     m_s5LinkDataRate (DataRate ("10Gb/s")),
     m_s5LinkDelay (Seconds (0)),
-    m_s5LinkMtu (3000)
+    m_s5LinkMtu (3000),
+    m_fastPathEnabled (false)
 {
   NS_LOG_FUNCTION (this);
   // To access the attribute value within the constructor
@@ -176,6 +178,16 @@ NoBackhaulEpcHelper::NoBackhaulEpcHelper ()
   m_sgwApp->AddPgw (pgwS5Address);
   m_pgwApp->AddSgw (sgwS5Address);
 
+  if (m_fastPathEnabled)
+    {
+      // the user plane bypasses S1-U, S5 and the SGW altogether
+      m_fastPath = CreateObject<EpcFastPath> ();
+      m_fastPath->SetAttribute ("Delay", TimeValue (m_fastPathDelay));
+      m_fastPath->SetAttribute ("DataRate", DataRateValue (m_fastPathDataRate));
+      m_fastPath->SetPgw (m_pgwApp);
+      m_pgwApp->SetFastPath (m_fastPath);
+    }
+
 
   // Create S11 link between MME and SGW
   PointToPointHelper s11P2ph;
@@ -281,6 +293,24 @@ NoBackhaulEpcHelper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&NoBackhaulEpcHelper::m_x2LinkEnablePcap),
                    MakeBooleanChecker ())
+    .AddAttribute ("FastPath",
+                   "If true, user plane packets are handed directly between "
+                   "the eNBs and the PGW, without GTP-U tunneling over S1-U "
+                   "and S5 and without going through the SGW",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NoBackhaulEpcHelper::m_fastPathEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FastPathDelay",
+                   "The one-way delay between the eNBs and the PGW when FastPath is true",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&NoBackhaulEpcHelper::m_fastPathDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("FastPathDataRate",
+                   "The data rate of each direction of the link between "
+                   "an eNB and the PGW when FastPath is true",
+                   DataRateValue (DataRate ("10Gb/s")),
+                   MakeDataRateAccessor (&NoBackhaulEpcHelper::m_fastPathDataRate),
+                   MakeDataRateChecker ())
   ;
   return tid;
 }
@@ -297,6 +327,11 @@ NoBackhaulEpcHelper::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_tunDevice->SetSendCallback (MakeNullCallback<bool, Ptr<Packet>, const Address&, const Address&, uint16_t> ());
   m_tunDevice = 0;
+  if (m_fastPath)
+    {
+      m_fastPath->Dispose ();
+      m_fastPath = 0;
+    }
   m_sgwApp = 0;
   m_sgw->Dispose ();
   m_pgwApp = 0;
@@ -353,6 +388,10 @@ NoBackhaulEpcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> lteEnbNetDevice, uint
   NS_ASSERT (enb->GetNApplications () == 1);
   NS_ASSERT_MSG (enb->GetApplication (0)->GetObject<EpcEnbApplication> () != 0, "cannot retrieve EpcEnbApplication");
   NS_LOG_LOGIC ("enb: " << enb << ", enb->GetApplication (0): " << enb->GetApplication (0));
+  if (m_fastPath)
+    {
+      enbApp->SetFastPath (m_fastPath);
+    }
 
   NS_LOG_INFO ("Create EpcX2 entity");
   Ptr<EpcX2> x2 = CreateObject<EpcX2> ();
@@ -540,6 +579,12 @@ NoBackhaulEpcHelper::GetSgwNode () const
   return m_sgw;
 }
 
+Ptr<EpcFastPath>
+NoBackhaulEpcHelper::GetFastPath () const
+{
+  return m_fastPath;
+}
+
 
 void
 NoBackhaulEpcHelper::AddS1Interface (Ptr<Node> enb, Ipv4Address enbAddress, Ipv4Address sgwAddress, uint16_t cellId)
@@ -29,6 +29,7 @@ namespace ns3 {
 class EpcSgwApplication;
 class EpcPgwApplication;
 class EpcMmeApplication;
+class EpcFastPath;
 
 /**
  * \ingroup lte
@@ -78,6 +79,12 @@ public:
   virtual Ipv4Address GetUeDefaultGatewayAddress ();
   virtual Ipv6Address GetUeDefaultGatewayAddress6 ();
 
+  /**
+   * \brief Get the tunnel-less user plane between the eNBs and the PGW
+   * \return the fast path, or a null pointer if the FastPath attribute was false
+   */
+  Ptr<EpcFastPath> GetFastPath () const;
+
 protected:
   /**
    * \brief DoAddX2Interface: Call AddX2Interface on top of the Enb device pointers
@@ -230,6 +237,26 @@ private:
    */
   uint16_t m_x2LinkMtu;
 
+  /**
+   * Whether the user plane bypasses S1-U/S5 and the SGW
+   */
+  bool m_fastPathEnabled;
+
+  /**
+   * The one-way delay of the fast path
+   */
+  Time m_fastPathDelay;
+
+  /**
+   * The data rate of each direction of the fast path
+   */
+  DataRate m_fastPathDataRate;
+
+  /**
+   * Tunnel-less user plane between the eNBs and the PGW, if enabled
+   */
+  Ptr<EpcFastPath> m_fastPath;
+
   /**
    * Enable PCAP generation for X2 link
    */
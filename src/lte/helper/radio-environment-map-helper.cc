@@ -37,9 +37,28 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/component-carrier-enb.h>
+#include <ns3/node-list.h>
+#include <ns3/building-list.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
 
 #include <fstream>
 #include <limits>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 namespace ns3 {
 
@@ -47,7 +66,16 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
+/// Size of the header of the binary raster file.
+static const uint64_t REM_RASTER_HEADER_SIZE = 64;
+
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_maxLossDb (std::numeric_limits<double>::infinity ()),
+    m_numWorkers (1),
+    m_blockStart (0),
+    m_rasterFd (-1),
+    m_raster (0),
+    m_rasterSize (0)
 {
 }
 
@@ -144,6 +172,29 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("ComputeDirectly",
+                   "If true, the SINR of each point is computed directly from the "
+                   "propagation loss model of the channel and from the PSD of the eNBs, "
+                   "instead of deploying RemSpectrumPhy listeners on the channel. "
+                   "Frequency selective (SpectrumPropagationLossModel) losses are not "
+                   "applied, and each eNB is assumed to transmit over its whole bandwidth.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_computeDirectly),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumThreads",
+                   "Number of threads used to compute the map when ComputeDirectly is true. "
+                   "A single thread is used if the scenario contains buildings. With more "
+                   "than one thread the propagation loss model must be deterministic, "
+                   "e.g., it must not use random variables.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1, 1024))
+    .AddAttribute ("RasterFile",
+                   "If not empty, the name of the file to which the map is also saved "
+                   "as a binary raster",
+                   StringValue (""),
+                   MakeStringAccessor (&RadioEnvironmentMapHelper::m_rasterFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -199,7 +250,7 @@ RadioEnvironmentMapHelper::Install ()
       NS_FATAL_ERROR ("Can't open file " << (m_outputFile));
       return;
     }
-  
+
   double startDelay = 0.0026;
 
   if (m_useDataChannel)
@@ -225,6 +276,14 @@ RadioEnvironmentMapHelper::DelayedInstall ()
     {
       m_maxPointsPerIteration = m_xRes * m_yRes;
     }
+
+  OpenRaster ();
+  if (m_computeDirectly)
+    {
+      ComputeDirectly ();
+      Finalize ();
+      return;
+    }
   
   for (uint32_t i = 0; i < m_maxPointsPerIteration; ++i)
     {
@@ -331,11 +390,18 @@ RadioEnvironmentMapHelper::PrintAndReset ()
                     << pos.y << "\t" 
                     << pos.z << "\t" 
                     << it->phy->GetSinr (m_noisePower));
+      double sinr = it->phy->GetSinr (m_noisePower);
       m_outFile << pos.x << "\t" 
                 << pos.y << "\t" 
                 << pos.z << "\t" 
-                << it->phy->GetSinr (m_noisePower)
+                << sinr
                 << std::endl;
+      if (m_raster != 0)
+        {
+          float value = sinr;
+          std::memcpy (m_raster + REM_RASTER_HEADER_SIZE + m_blockStart * sizeof (float), &value, sizeof (float));
+        }
+      ++m_blockStart;
       it->phy->Reset ();
     }
 }
@@ -345,11 +411,264 @@ RadioEnvironmentMapHelper::Finalize ()
 {
   NS_LOG_FUNCTION (this);
   m_outFile.close ();
+  CloseRaster ();
   if (m_stopWhenDone)
     {
       Simulator::Stop ();
     }
 }
 
+void
+RadioEnvironmentMapHelper::OpenRaster ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_rasterFile.empty ())
+    {
+      return;
+    }
+  m_rasterFd = open (m_rasterFile.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (m_rasterFd < 0)
+    {
+      NS_FATAL_ERROR ("Can't open file " << m_rasterFile);
+    }
+  m_rasterSize = REM_RASTER_HEADER_SIZE + (uint64_t) m_xRes * m_yRes * sizeof (float);
+  if (ftruncate (m_rasterFd, m_rasterSize) != 0)
+    {
+      NS_FATAL_ERROR ("Can't resize file " << m_rasterFile << " to " << m_rasterSize << " bytes");
+    }
+  void *map = mmap (0, m_rasterSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_rasterFd, 0);
+  if (map == MAP_FAILED)
+    {
+      NS_FATAL_ERROR ("Can't map file " << m_rasterFile << " in memory");
+    }
+  m_raster = static_cast<uint8_t *> (map);
+
+  uint8_t *header = m_raster;
+  std::memset (header, 0, REM_RASTER_HEADER_SIZE);
+  std::memcpy (header, "LTEREM01", 8);
+  uint32_t res[2] = {m_xRes, m_yRes};
+  std::memcpy (header + 8, res, sizeof (res));
+  double bounds[5] = {m_xMin, m_xMax, m_yMin, m_yMax, m_z};
+  std::memcpy (header + 16, bounds, sizeof (bounds));
+}
+
+void
+RadioEnvironmentMapHelper::CloseRaster ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_raster != 0)
+    {
+      msync (m_raster, m_rasterSize, MS_SYNC);
+      munmap (m_raster, m_rasterSize);
+      m_raster = 0;
+    }
+  if (m_rasterFd >= 0)
+    {
+      close (m_rasterFd);
+      m_rasterFd = -1;
+    }
+}
+
+void
+RadioEnvironmentMapHelper::ComputeDirectly ()
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<const SpectrumModel> remSm = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+  NS_ABORT_MSG_IF (m_rbId >= (int32_t) remSm->GetNumBands (), "RbId " << m_rbId << " out of range");
+
+  // find the eNBs transmitting on the channel
+  m_transmitters.clear ();
+  for (NodeList::Iterator nodeIt = NodeList::Begin (); nodeIt != NodeList::End (); ++nodeIt)
+    {
+      for (uint32_t i = 0; i < (*nodeIt)->GetNDevices (); ++i)
+        {
+          Ptr<LteEnbNetDevice> enbDev = (*nodeIt)->GetDevice (i)->GetObject<LteEnbNetDevice> ();
+          if (enbDev == 0)
+            {
+              continue;
+            }
+          std::map<uint8_t, Ptr<ComponentCarrierBaseStation> > ccMap = enbDev->GetCcMap ();
+          for (std::map<uint8_t, Ptr<ComponentCarrierBaseStation> >::iterator ccIt = ccMap.begin ();
+               ccIt != ccMap.end ();
+               ++ccIt)
+            {
+              Ptr<LteEnbPhy> enbPhy = DynamicCast<ComponentCarrierEnb> (ccIt->second)->GetPhy ();
+              Ptr<LteSpectrumPhy> dlPhy = enbPhy->GetDlSpectrumPhy ();
+              if (dlPhy->GetChannel () != m_channel)
+                {
+                  continue;
+                }
+              std::vector<int> rbs;
+              for (uint8_t rb = 0; rb < ccIt->second->GetDlBandwidth (); ++rb)
+                {
+                  rbs.push_back (rb);
+                }
+              Ptr<SpectrumValue> txPsd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (ccIt->second->GetDlEarfcn (),
+                                                                                              ccIt->second->GetDlBandwidth (),
+                                                                                              enbPhy->GetTxPower (),
+                                                                                              rbs);
+              if (txPsd->GetSpectrumModelUid () != remSm->GetUid ())
+                {
+                  SpectrumConverter converter (txPsd->GetSpectrumModel (), remSm);
+                  txPsd = converter.Convert (txPsd);
+                }
+              RemTransmitter tx;
+              tx.antenna = dlPhy->GetRxAntenna ();
+              tx.position = dlPhy->GetMobility ()->GetPosition ();
+              tx.totalPower = Integral (*txPsd);
+              Bands::const_iterator bandIt = remSm->Begin ();
+              for (uint32_t rb = 0; rb < remSm->GetNumBands (); ++rb, ++bandIt)
+                {
+                  tx.rbPower.push_back ((*txPsd)[rb] * (bandIt->fh - bandIt->fl));
+                }
+              m_transmitters.push_back (tx);
+            }
+        }
+    }
+  NS_LOG_LOGIC ("found " << m_transmitters.size () << " transmitters");
+
+  m_propagationLoss = m_channel->GetPropagationLossModel ();
+  if (m_channel->GetSpectrumPropagationLossModel () != 0)
+    {
+      NS_LOG_WARN ("SpectrumPropagationLossModel of the channel is ignored when computing the REM directly");
+    }
+  DoubleValue maxLossDb;
+  if (m_channel->GetAttributeFailSafe ("MaxLossDb", maxLossDb))
+    {
+      m_maxLossDb = maxLossDb.Get ();
+    }
+
+  // models using buildings access shared objects, hence they can only
+  // be evaluated from the main thread
+  m_numWorkers = m_numThreads;
+  if (BuildingList::GetNBuildings () > 0)
+    {
+      NS_LOG_LOGIC ("buildings found, computing the REM in a single thread");
+      m_numWorkers = 1;
+    }
+#ifndef HAVE_PTHREAD_H
+  m_numWorkers = 1;
+#endif
+
+  // each worker owns private mobility models, so that no reference
+  // count is shared across threads
+  std::vector<RemWorker> workers (m_numWorkers);
+  for (uint32_t w = 0; w < m_numWorkers; ++w)
+    {
+      workers[w].helper = this;
+      workers[w].index = w;
+      workers[w].rxMobility = CreateObject<ConstantPositionMobilityModel> ();
+      workers[w].rxMobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+      for (std::vector<RemTransmitter>::const_iterator txIt = m_transmitters.begin ();
+           txIt != m_transmitters.end ();
+           ++txIt)
+        {
+          Ptr<MobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+          txMobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+          txMobility->SetPosition (txIt->position);
+          BuildingsHelper::MakeConsistent (txMobility);
+          workers[w].txMobility.push_back (txMobility);
+        }
+    }
+  m_rem.clear ();
+
+  uint64_t numPoints = (uint64_t) m_xRes * m_yRes;
+  for (m_blockStart = 0; m_blockStart < numPoints; m_blockStart += m_maxPointsPerIteration)
+    {
+      uint64_t blockSize = std::min<uint64_t> (m_maxPointsPerIteration, numPoints - m_blockStart);
+      m_blockSinr.assign (blockSize, 0.0);
+#ifdef HAVE_PTHREAD_H
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t w = 1; w < m_numWorkers; ++w)
+        {
+          threads.push_back (Create<SystemThread> (MakeCallback (&RemWorker::Run, &workers[w])));
+          threads.back ()->Start ();
+        }
+#endif
+      workers[0].Run ();
+#ifdef HAVE_PTHREAD_H
+      for (std::vector<Ptr<SystemThread> >::iterator it = threads.begin (); it != threads.end (); ++it)
+        {
+          (*it)->Join ();
+        }
+#endif
+
+      for (uint64_t i = 0; i < blockSize; ++i)
+        {
+          uint64_t point = m_blockStart + i;
+          double x = m_xMin + (point / m_yRes) * m_xStep;
+          double y = m_yMin + (point % m_yRes) * m_yStep;
+          m_outFile << x << "\t"
+                    << y << "\t"
+                    << m_z << "\t"
+                    << m_blockSinr[i]
+                    << std::endl;
+          if (m_raster != 0)
+            {
+              float value = m_blockSinr[i];
+              std::memcpy (m_raster + REM_RASTER_HEADER_SIZE + point * sizeof (float), &value, sizeof (float));
+            }
+        }
+    }
+  m_transmitters.clear ();
+  m_propagationLoss = 0;
+}
+
+void
+RadioEnvironmentMapHelper::RemWorker::Run ()
+{
+  helper->ComputeBlock (*this);
+}
+
+void
+RadioEnvironmentMapHelper::ComputeBlock (RemWorker &worker)
+{
+  // this runs outside of the main thread: no logging, and no copy of
+  // any Ptr that is not owned by the worker
+  uint64_t blockSize = m_blockSinr.size ();
+  uint64_t perWorker = (blockSize + m_numWorkers - 1) / m_numWorkers;
+  uint64_t begin = std::min<uint64_t> (blockSize, worker.index * perWorker);
+  uint64_t end = std::min<uint64_t> (blockSize, begin + perWorker);
+  for (uint64_t i = begin; i < end; ++i)
+    {
+      uint64_t point = m_blockStart + i;
+      Vector rxPosition (m_xMin + (point / m_yRes) * m_xStep,
+                         m_yMin + (point % m_yRes) * m_yStep,
+                         m_z);
+      worker.rxMobility->SetPosition (rxPosition);
+      BuildingsHelper::MakeConsistent (worker.rxMobility);
+
+      // same computation as MultiModelSpectrumChannel::StartTx followed
+      // by RemSpectrumPhy::StartRx and RemSpectrumPhy::GetSinr
+      double sumPower = 0;
+      double referenceSignalPower = 0;
+      for (uint32_t t = 0; t < m_transmitters.size (); ++t)
+        {
+          const RemTransmitter &tx = m_transmitters[t];
+          double pathLossDb = 0;
+          if (tx.antenna != 0)
+            {
+              Angles txAngles (rxPosition, tx.position);
+              pathLossDb -= tx.antenna->GetGainDb (txAngles);
+            }
+          if (m_propagationLoss != 0)
+            {
+              pathLossDb -= m_propagationLoss->CalcRxPower (0, worker.txMobility[t], worker.rxMobility);
+            }
+          if (pathLossDb > m_maxLossDb)
+            {
+              continue;
+            }
+          double txPower = (m_rbId >= 0) ? tx.rbPower[m_rbId] : tx.totalPower;
+          double power = txPower * std::pow (10.0, -pathLossDb / 10.0);
+          sumPower += power;
+          if (power > referenceSignalPower)
+            {
+              referenceSignalPower = power;
+            }
+        }
+      m_blockSinr[i] = referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower);
+    }
+}
 
 } // namespace ns3
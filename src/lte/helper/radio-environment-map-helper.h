@@ -24,7 +24,9 @@
 
 
 #include <ns3/object.h>
+#include <ns3/vector.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -35,6 +37,8 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class AntennaModel;
+class PropagationLossModel;
 
 /** 
  * \ingroup lte
@@ -42,6 +46,13 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * If the `RasterFile` attribute is set, the map is also written as a
+ * binary raster: a 64 byte header (the 8 characters "LTEREM01", the
+ * number of points along x and y as uint32_t, then XMin, XMax, YMin,
+ * YMax and Z as double, zero padded) followed by the linear SINR of
+ * each point as float, in the same order as the text output (x major),
+ * all in host byte order.
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -108,6 +119,57 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /**
+   * Generate the whole map in a single event, computing the SINR of
+   * each point directly from the propagation loss model of the channel
+   * and from the PSD of each eNB, without deploying RemSpectrumPhy
+   * listeners. Used when the `ComputeDirectly` attribute is true.
+   */
+  void ComputeDirectly ();
+
+  /// Create the binary raster file and map it in memory.
+  void OpenRaster ();
+
+  /// Flush and unmap the binary raster file.
+  void CloseRaster ();
+
+  /// An eNB transmitting on the channel, as seen by ComputeDirectly ().
+  struct RemTransmitter
+  {
+    /// Antenna of the eNB, or 0 if isotropic.
+    Ptr<AntennaModel> antenna;
+    /// Position of the eNB.
+    Vector position;
+    /// TX power of each RB, in Watts, over the REM spectrum model.
+    std::vector<double> rbPower;
+    /// TX power over the whole bandwidth, in Watts.
+    double totalPower;
+  };
+
+  /// Objects owned by each worker of ComputeDirectly ().
+  struct RemWorker
+  {
+    /// Back pointer to the helper.
+    RadioEnvironmentMapHelper *helper;
+    /// Index of this worker.
+    uint32_t index;
+    /// Position of the point currently computed.
+    Ptr<MobilityModel> rxMobility;
+    /// Private copy of the position of each transmitter.
+    std::vector<Ptr<MobilityModel> > txMobility;
+    /// Entry point of the worker thread.
+    void Run ();
+  };
+
+  /**
+   * Compute the SINR of the points of the current block assigned to a
+   * worker. Only touches objects owned by the worker, so that
+   * several workers can run in parallel.
+   *
+   * \param worker the worker
+   */
+  void ComputeBlock (RemWorker &worker);
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -152,6 +214,27 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_computeDirectly;     ///< The `ComputeDirectly` attribute.
+  uint32_t m_numThreads;      ///< The `NumThreads` attribute.
+  std::string m_rasterFile;   ///< The `RasterFile` attribute.
+
+  /// Transmitters found on the channel by ComputeDirectly ().
+  std::vector<RemTransmitter> m_transmitters;
+  /// Propagation loss model of the channel.
+  Ptr<PropagationLossModel> m_propagationLoss;
+  /// Maximum loss (dB) beyond which signals are ignored by the channel.
+  double m_maxLossDb;
+  /// Number of workers used by ComputeDirectly ().
+  uint32_t m_numWorkers;
+  /// Index of the first point of the block being computed.
+  uint64_t m_blockStart;
+  /// SINR of the points of the block being computed.
+  std::vector<double> m_blockSinr;
+
+  int m_rasterFd;                ///< File descriptor of the raster file.
+  uint8_t *m_raster;             ///< Memory mapping of the raster file.
+  uint64_t m_rasterSize;         ///< Size of the raster file, in bytes.
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
@@ -29,6 +29,7 @@
 
 #include "epc-gtpu-header.h"
 #include "eps-bearer-tag.h"
+#include "epc-fast-path.h"
 
 
 namespace ns3 {
@@ -83,6 +84,7 @@ EpcEnbApplication::DoDispose (void)
   m_lteSocket = 0;
   m_lteSocket6 = 0;
   m_s1uSocket = 0;
+  m_fastPath = 0;
   delete m_s1SapProvider;
   delete m_s1apSapEnb;
 }
@@ -115,6 +117,13 @@ EpcEnbApplication::AddS1Interface (Ptr<Socket> s1uSocket, Ipv4Address enbAddress
   m_sgwS1uAddress = sgwAddress;
 }
 
+void
+EpcEnbApplication::SetFastPath (Ptr<EpcFastPath> fastPath)
+{
+  NS_LOG_FUNCTION (this << fastPath);
+  m_fastPath = fastPath;
+}
+
 
 EpcEnbApplication::~EpcEnbApplication (void)
 {
@@ -182,6 +191,10 @@ EpcEnbApplication::DoPathSwitchRequest (EpcEnbS1SapProvider::PathSwitchRequestPa
       // side effect: create entries if not exist
       m_rbidTeidMap[params.rnti][bit->epsBearerId] = teid;
       m_teidRbidMap[teid] = rbid;
+      if (m_fastPath)
+        {
+          m_fastPath->AddBearer (teid, this);
+        }
 
       EpcS1apSapMme::ErabSwitchedInDownlinkItem erab;
       erab.erabId = bit->epsBearerId;
@@ -206,6 +219,10 @@ EpcEnbApplication::DoUeContextRelease (uint16_t rnti)
         {
           uint32_t teid = bidIt->second;
           m_teidRbidMap.erase (teid);
+          if (m_fastPath)
+            {
+              m_fastPath->RemoveBearer (teid, this);
+            }
           NS_LOG_INFO ("TEID: " << teid << " erased");
         }
       m_rbidTeidMap.erase (rntiIt);
@@ -239,6 +256,10 @@ EpcEnbApplication::DoInitialContextSetupRequest (uint64_t mmeUeS1Id, uint16_t en
       // side effect: create entries if not exist
       m_rbidTeidMap[rnti][erabIt->erabId] = params.gtpTeid;
       m_teidRbidMap[params.gtpTeid] = rbid;
+      if (m_fastPath)
+        {
+          m_fastPath->AddBearer (params.gtpTeid, this);
+        }
     }
 
   // Send Initial Context Setup Request to RRC
@@ -292,7 +313,14 @@ EpcEnbApplication::RecvFromLteSocket (Ptr<Socket> socket)
       NS_ASSERT (bidIt != rntiIt->second.end ());
       uint32_t teid = bidIt->second;
       m_rxLteSocketPktTrace (packet->Copy ());
-      SendToS1uSocket (packet, teid);
+      if (m_fastPath)
+        {
+          m_fastPath->SendUplink (packet, teid, this);
+        }
+      else
+        {
+          SendToS1uSocket (packet, teid);
+        }
     }
 }
 
@@ -317,6 +345,22 @@ EpcEnbApplication::RecvFromS1uSocket (Ptr<Socket> socket)
     }
 }
 
+void
+EpcEnbApplication::RecvFromFastPath (Ptr<Packet> packet, uint32_t teid)
+{
+  NS_LOG_FUNCTION (this << packet << teid);
+  std::map<uint32_t, EpsFlowId_t>::iterator it = m_teidRbidMap.find (teid);
+  if (it == m_teidRbidMap.end ())
+    {
+      NS_LOG_WARN ("UE context at cell id " << m_cellId << " not found, discarding packet");
+    }
+  else
+    {
+      m_rxS1uSocketPktTrace (packet->Copy ());
+      SendToLteSocket (packet, it->second.m_rnti, it->second.m_bid);
+    }
+}
+
 void 
 EpcEnbApplication::SendToLteSocket (Ptr<Packet> packet, uint16_t rnti, uint8_t bid)
 {
@@ -39,6 +39,7 @@
 namespace ns3 {
 class EpcEnbS1SapUser;
 class EpcEnbS1SapProvider;
+class EpcFastPath;
 
 
 /**
@@ -135,6 +136,23 @@ public:
    */
   void RecvFromS1uSocket (Ptr<Socket> socket);
 
+  /**
+   * Use a tunnel-less fast path instead of the S1-U interface for the
+   * user plane. The S1-U socket, if any, is no longer used for data.
+   *
+   * \param fastPath the fast path shared with the PGW
+   */
+  void SetFastPath (Ptr<EpcFastPath> fastPath);
+
+  /**
+   * Method called by the fast path when the eNB receives a data packet
+   * from the PGW that is to be forwarded to the UE.
+   *
+   * \param packet the IP packet
+   * \param teid the Tunnel Endpoint IDentifier
+   */
+  void RecvFromFastPath (Ptr<Packet> packet, uint32_t teid);
+
   /**
    * TracedCallback signature for data Packet reception event.
    *
@@ -270,6 +288,11 @@ private:
    */
   Ptr<Socket> m_s1uSocket;
 
+  /**
+   * tunnel-less user plane replacing the S1-U interface, if enabled
+   */
+  Ptr<EpcFastPath> m_fastPath;
+
   /**
    * address of the eNB for S1-U communications
    */
@@ -0,0 +1,185 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "epc-fast-path.h"
+#include "epc-enb-application.h"
+#include "epc-pgw-application.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/packet.h>
+#include <ns3/node.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EpcFastPath");
+
+NS_OBJECT_ENSURE_REGISTERED (EpcFastPath);
+
+EpcFastPath::BearerStats::BearerStats ()
+  : ulPackets (0),
+    ulBytes (0),
+    dlPackets (0),
+    dlBytes (0)
+{
+}
+
+EpcFastPath::EpcFastPath ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+EpcFastPath::~EpcFastPath ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+EpcFastPath::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EpcFastPath")
+    .SetParent<Object> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<EpcFastPath> ()
+    .AddAttribute ("Delay",
+                   "The one-way delay between each eNB and the PGW",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&EpcFastPath::m_delay),
+                   MakeTimeChecker ())
+    .AddAttribute ("DataRate",
+                   "The serialization rate of each direction of the link "
+                   "between an eNB and the PGW; "
+                   "a rate of zero means no serialization delay",
+                   DataRateValue (DataRate ("10Gb/s")),
+                   MakeDataRateAccessor (&EpcFastPath::m_dataRate),
+                   MakeDataRateChecker ())
+    .AddTraceSource ("UlTx",
+                     "Packet sent from an eNB to the PGW",
+                     MakeTraceSourceAccessor (&EpcFastPath::m_ulTxTrace),
+                     "ns3::EpcFastPath::PacketTracedCallback")
+    .AddTraceSource ("DlTx",
+                     "Packet sent from the PGW to an eNB",
+                     MakeTraceSourceAccessor (&EpcFastPath::m_dlTxTrace),
+                     "ns3::EpcFastPath::PacketTracedCallback")
+    .AddTraceSource ("Drop",
+                     "Downlink packet dropped because its bearer "
+                     "is not bound to any eNB",
+                     MakeTraceSourceAccessor (&EpcFastPath::m_dropTrace),
+                     "ns3::EpcFastPath::PacketTracedCallback")
+  ;
+  return tid;
+}
+
+void
+EpcFastPath::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_pgwApp = 0;
+  m_enbByTeid.clear ();
+  m_links.clear ();
+  Object::DoDispose ();
+}
+
+void
+EpcFastPath::SetPgw (Ptr<EpcPgwApplication> pgwApp)
+{
+  NS_LOG_FUNCTION (this << pgwApp);
+  m_pgwApp = pgwApp;
+}
+
+void
+EpcFastPath::AddBearer (uint32_t teid, Ptr<EpcEnbApplication> enbApp)
+{
+  NS_LOG_FUNCTION (this << teid << enbApp);
+  m_enbByTeid[teid] = enbApp;
+}
+
+void
+EpcFastPath::RemoveBearer (uint32_t teid, Ptr<EpcEnbApplication> enbApp)
+{
+  NS_LOG_FUNCTION (this << teid << enbApp);
+  std::map<uint32_t, Ptr<EpcEnbApplication> >::iterator it = m_enbByTeid.find (teid);
+  // after a handover the bearer is already bound to the target eNB
+  if (it != m_enbByTeid.end () && it->second == enbApp)
+    {
+      m_enbByTeid.erase (it);
+    }
+}
+
+Time
+EpcFastPath::Transmit (Time &busyUntil, uint32_t bytes)
+{
+  Time now = Simulator::Now ();
+  if (m_dataRate.GetBitRate () == 0)
+    {
+      return m_delay;
+    }
+  if (busyUntil < now)
+    {
+      busyUntil = now;
+    }
+  busyUntil += m_dataRate.CalculateBytesTxTime (bytes);
+  return busyUntil - now + m_delay;
+}
+
+void
+EpcFastPath::SendUplink (Ptr<Packet> packet, uint32_t teid, Ptr<EpcEnbApplication> enbApp)
+{
+  NS_LOG_FUNCTION (this << packet << teid << enbApp);
+  NS_ASSERT_MSG (m_pgwApp != 0, "PGW not set");
+  BearerStats &stats = m_stats[teid];
+  ++stats.ulPackets;
+  stats.ulBytes += packet->GetSize ();
+  m_ulTxTrace (packet, teid);
+
+  Time delay = Transmit (m_links[enbApp].ulBusyUntil, packet->GetSize ());
+  Simulator::ScheduleWithContext (m_pgwApp->GetNode ()->GetId (), delay,
+                                  &EpcPgwApplication::RecvFromFastPath, m_pgwApp, packet, teid);
+}
+
+void
+EpcFastPath::SendDownlink (Ptr<Packet> packet, uint32_t teid)
+{
+  NS_LOG_FUNCTION (this << packet << teid);
+  std::map<uint32_t, Ptr<EpcEnbApplication> >::iterator it = m_enbByTeid.find (teid);
+  if (it == m_enbByTeid.end ())
+    {
+      NS_LOG_WARN ("no eNB serving TEID " << teid);
+      m_dropTrace (packet, teid);
+      return;
+    }
+  BearerStats &stats = m_stats[teid];
+  ++stats.dlPackets;
+  stats.dlBytes += packet->GetSize ();
+  m_dlTxTrace (packet, teid);
+
+  Time delay = Transmit (m_links[it->second].dlBusyUntil, packet->GetSize ());
+  Simulator::ScheduleWithContext (it->second->GetNode ()->GetId (), delay,
+                                  &EpcEnbApplication::RecvFromFastPath, it->second, packet, teid);
+}
+
+EpcFastPath::BearerStats
+EpcFastPath::GetBearerStats (uint32_t teid) const
+{
+  std::map<uint32_t, BearerStats>::const_iterator it = m_stats.find (teid);
+  if (it == m_stats.end ())
+    {
+      return BearerStats ();
+    }
+  return it->second;
+}
+
+} // namespace ns3
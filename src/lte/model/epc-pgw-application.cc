@@ -27,9 +27,15 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-l3-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
 #include "ns3/inet-socket-address.h"
+#include "ns3/hash.h"
 #include "ns3/epc-gtpu-header.h"
 #include "ns3/epc-pgw-application.h"
+#include "ns3/epc-fast-path.h"
+
+#include <cstring>
 
 namespace ns3 {
 
@@ -40,6 +46,29 @@ NS_LOG_COMPONENT_DEFINE ("EpcPgwApplication");
 // UeInfo
 /////////////////////////
 
+/// Maximum number of flows cached per UE before the flow table is flushed
+static const std::size_t MAX_FLOWS_PER_UE = 4096;
+
+bool
+EpcPgwApplication::UeInfo::FlowKey::operator == (const FlowKey &other) const
+{
+  return remotePort == other.remotePort && localPort == other.localPort
+         && protocol == other.protocol && tos == other.tos && ipv6 == other.ipv6
+         && std::memcmp (remoteAddr, other.remoteAddr, sizeof (remoteAddr)) == 0;
+}
+
+std::size_t
+EpcPgwApplication::UeInfo::FlowKeyHash::operator () (const FlowKey &key) const
+{
+  char buf[22];
+  std::memcpy (buf, key.remoteAddr, 16);
+  std::memcpy (buf + 16, &key.remotePort, 2);
+  std::memcpy (buf + 18, &key.localPort, 2);
+  buf[20] = key.protocol;
+  buf[21] = key.tos ^ (key.ipv6 ? 0x80 : 0);
+  return Hash32 (buf, sizeof (buf));
+}
+
 EpcPgwApplication::UeInfo::UeInfo ()
 {
   NS_LOG_FUNCTION (this);
@@ -50,6 +79,7 @@ EpcPgwApplication::UeInfo::AddBearer (uint8_t bearerId, uint32_t teid, Ptr<EpcTf
 {
   NS_LOG_FUNCTION (this << (uint16_t) bearerId << teid << tft);
   m_teidByBearerIdMap[bearerId] = teid;
+  m_flowTable.clear ();
   return m_tftClassifier.Add (tft, teid);
 }
 
@@ -60,6 +90,7 @@ EpcPgwApplication::UeInfo::RemoveBearer (uint8_t bearerId)
   std::map<uint8_t, uint32_t >::iterator it = m_teidByBearerIdMap.find (bearerId);
   m_tftClassifier.Delete (it->second); //delete tft
   m_teidByBearerIdMap.erase (bearerId);
+  m_flowTable.clear ();
 }
 
 uint32_t
@@ -72,6 +103,82 @@ EpcPgwApplication::UeInfo::Classify (Ptr<Packet> p, uint16_t protocolNumber)
   return m_tftClassifier.Classify (p, EpcTft::DOWNLINK, protocolNumber);
 }
 
+uint32_t
+EpcPgwApplication::UeInfo::ClassifyFlow (Ptr<Packet> p, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  // parse the raw bytes instead of deserializing the headers
+  uint8_t buf[44];
+  uint32_t size = p->CopyData (buf, sizeof (buf));
+  FlowKey key = FlowKey ();
+  uint32_t l4Offset;
+  bool hasPorts;
+  if (protocolNumber == Ipv4L3Protocol::PROT_NUMBER)
+    {
+      if (size < 20)
+        {
+          return Classify (p, protocolNumber);
+        }
+      uint16_t fragment = (buf[6] << 8) | buf[7];
+      if ((fragment & 0x3fff) != 0)
+        {
+          // more fragments, or not the first one
+          return Classify (p, protocolNumber);
+        }
+      l4Offset = (buf[0] & 0x0f) * 4;
+      uint32_t payloadSize = ((buf[2] << 8) | buf[3]) - l4Offset;
+      key.tos = buf[1];
+      key.protocol = buf[9];
+      std::memcpy (key.remoteAddr, buf + 12, 4);
+      // same conditions as EpcTftClassifier
+      hasPorts = (key.protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
+        || (key.protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20);
+    }
+  else if (protocolNumber == Ipv6L3Protocol::PROT_NUMBER)
+    {
+      if (size < 40)
+        {
+          return Classify (p, protocolNumber);
+        }
+      l4Offset = 40;
+      key.ipv6 = true;
+      key.tos = ((buf[0] & 0x0f) << 4) | (buf[1] >> 4);
+      key.protocol = buf[6];
+      std::memcpy (key.remoteAddr, buf + 8, 16);
+      hasPorts = key.protocol == UdpL4Protocol::PROT_NUMBER
+        || key.protocol == TcpL4Protocol::PROT_NUMBER;
+    }
+  else
+    {
+      return Classify (p, protocolNumber);
+    }
+
+  if (hasPorts)
+    {
+      if (size < l4Offset + 4)
+        {
+          return Classify (p, protocolNumber);
+        }
+      // downlink: the source is the remote end, the destination the UE
+      key.remotePort = (buf[l4Offset] << 8) | buf[l4Offset + 1];
+      key.localPort = (buf[l4Offset + 2] << 8) | buf[l4Offset + 3];
+    }
+
+  std::unordered_map<FlowKey, uint32_t, FlowKeyHash>::const_iterator it = m_flowTable.find (key);
+  if (it != m_flowTable.end ())
+    {
+      return it->second;
+    }
+  uint32_t teid = Classify (p, protocolNumber);
+  if (m_flowTable.size () >= MAX_FLOWS_PER_UE)
+    {
+      m_flowTable.clear ();
+    }
+  m_flowTable[key] = teid;
+  return teid;
+}
+
 Ipv4Address
 EpcPgwApplication::UeInfo::GetSgwAddr ()
 {
@@ -138,6 +245,7 @@ EpcPgwApplication::DoDispose ()
   m_s5uSocket = 0;
   m_s5cSocket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
   m_s5cSocket = 0;
+  m_fastPath = 0;
 }
 
 EpcPgwApplication::EpcPgwApplication (const Ptr<VirtualNetDevice> tunDevice, Ipv4Address s5Addr,
@@ -182,11 +290,16 @@ EpcPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& source,
       else
         {
           Ipv4Address sgwAddr = it->second->GetSgwAddr ();
-          uint32_t teid = it->second->Classify (packet, protocolNumber);
+          uint32_t teid = m_fastPath ? it->second->ClassifyFlow (packet, protocolNumber)
+                                     : it->second->Classify (packet, protocolNumber);
           if (teid == 0)
             {
               NS_LOG_WARN ("no matching bearer for this packet");
             }
+          else if (m_fastPath)
+            {
+              m_fastPath->SendDownlink (packet, teid);
+            }
           else
             {
               SendToS5uSocket (packet, sgwAddr, teid);
@@ -209,11 +322,16 @@ EpcPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& source,
       else
         {
           Ipv4Address sgwAddr = it->second->GetSgwAddr ();
-          uint32_t teid = it->second->Classify (packet, protocolNumber);
+          uint32_t teid = m_fastPath ? it->second->ClassifyFlow (packet, protocolNumber)
+                                     : it->second->Classify (packet, protocolNumber);
           if (teid == 0)
             {
               NS_LOG_WARN ("no matching bearer for this packet");
             }
+          else if (m_fastPath)
+            {
+              m_fastPath->SendDownlink (packet, teid);
+            }
           else
             {
               SendToS5uSocket (packet, sgwAddr, teid);
@@ -247,6 +365,21 @@ EpcPgwApplication::RecvFromS5uSocket (Ptr<Socket> socket)
   SendToTunDevice (packet, teid);
 }
 
+void
+EpcPgwApplication::RecvFromFastPath (Ptr<Packet> packet, uint32_t teid)
+{
+  NS_LOG_FUNCTION (this << packet << teid);
+  m_rxS5PktTrace (packet->Copy ());
+  SendToTunDevice (packet, teid);
+}
+
+void
+EpcPgwApplication::SetFastPath (Ptr<EpcFastPath> fastPath)
+{
+  NS_LOG_FUNCTION (this << fastPath);
+  m_fastPath = fastPath;
+}
+
 void
 EpcPgwApplication::RecvFromS5cSocket (Ptr<Socket> socket)
 {
@@ -28,8 +28,12 @@
 #include "ns3/epc-tft-classifier.h"
 #include "ns3/epc-gtpc-header.h"
 
+#include <unordered_map>
+
 namespace ns3 {
 
+class EpcFastPath;
+
 /**
  * \ingroup lte
  *
@@ -123,6 +127,24 @@ public:
    */
   void SendToS5uSocket (Ptr<Packet> packet, Ipv4Address sgwS5uAddress, uint32_t teid);
 
+  /**
+   * Use a tunnel-less fast path instead of the S5-U interface for the
+   * user plane. Downlink packets are then classified with a per-UE
+   * flow table before falling back to the TFT classifier.
+   *
+   * \param fastPath the fast path shared with the eNBs
+   */
+  void SetFastPath (Ptr<EpcFastPath> fastPath);
+
+  /**
+   * Method called by the fast path when the PGW receives a data packet
+   * from an eNB that is to be forwarded to the internet.
+   *
+   * \param packet the IP packet
+   * \param teid the Tunnel Endpoint IDentifier
+   */
+  void RecvFromFastPath (Ptr<Packet> packet, uint32_t teid);
+
 
   /**
    * Let the PGW be aware of a new SGW
@@ -226,6 +248,20 @@ private:
      */
     uint32_t Classify (Ptr<Packet> p, uint16_t protocolNumber);
 
+    /**
+     * Classify the packet by looking up its 5-tuple (plus TOS) in a
+     * flow table filled with the results of Classify (). Fragments,
+     * whose ports are only known by the TFT classifier, are always
+     * handed to Classify ().
+     *
+     * \param p the IPv4 or IPv6 packet from the internet to be classified
+     * \param protocolNumber identifies the type of packet.
+     *        Only IPv4 and IPv6 packets are allowed.
+     *
+     * \return the same value as Classify ()
+     */
+    uint32_t ClassifyFlow (Ptr<Packet> p, uint16_t protocolNumber);
+
     /**
      * Get the address of the SGW to which the UE is connected
      *
@@ -269,11 +305,39 @@ private:
     void SetUeAddr6 (Ipv6Address addr);
 
   private:
+    /// Header fields a TFT can match on, for a given UE
+    struct FlowKey
+    {
+      uint8_t remoteAddr[16]; ///< remote IPv4 or IPv6 address
+      uint16_t remotePort;    ///< remote port
+      uint16_t localPort;     ///< local port
+      uint8_t protocol;       ///< IP protocol number
+      uint8_t tos;            ///< type of service or traffic class
+      bool ipv6;              ///< whether the addresses are IPv6 ones
+
+      /**
+       * \param other the key to compare with
+       * \return true if the keys are equal
+       */
+      bool operator == (const FlowKey &other) const;
+    };
+
+    /// Hash function of FlowKey
+    struct FlowKeyHash
+    {
+      /**
+       * \param key the key
+       * \return the hash of the key
+       */
+      std::size_t operator () (const FlowKey &key) const;
+    };
+
     Ipv4Address m_ueAddr; ///< UE IPv4 address
     Ipv6Address m_ueAddr6; ///< UE IPv6 address
     Ipv4Address m_sgwAddr; ///< SGW IPv4 address
     EpcTftClassifier m_tftClassifier; ///< TFT classifier
     std::map<uint8_t, uint32_t> m_teidByBearerIdMap; ///< TEID By bearer ID Map
+    std::unordered_map<FlowKey, uint32_t, FlowKeyHash> m_flowTable; ///< TEID by flow, flushed when the bearers change
   };
 
   /**
@@ -297,6 +361,11 @@ private:
    */
   Ptr<VirtualNetDevice> m_tunDevice;
 
+  /**
+   * tunnel-less user plane replacing the S5-U interface, if enabled
+   */
+  Ptr<EpcFastPath> m_fastPath;
+
   /**
    * UeInfo stored by UE IPv4 address
    */
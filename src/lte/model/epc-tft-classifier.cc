@@ -38,6 +38,8 @@
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 
+#include <limits>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
@@ -55,6 +57,8 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
 
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
+
+  Compile ();
 }
 
 void
@@ -62,6 +66,58 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  Compile ();
+}
+
+void
+EpcTftClassifier::Compile (void)
+{
+  NS_LOG_FUNCTION (this);
+  const EpcTft::Direction directions[2] = {EpcTft::DOWNLINK, EpcTft::UPLINK};
+  for (uint32_t d = 0; d < 2; ++d)
+    {
+      m_classifiers[d][0].Clear ();
+      m_classifiers[d][1].Clear ();
+    }
+
+  for (std::map <uint32_t, Ptr<EpcTft> >::const_iterator it = m_tftMap.begin ();
+       it != m_tftMap.end ();
+       ++it)
+    {
+      std::list<EpcTft::PacketFilter> filters = it->second->GetPacketFilters ();
+      for (std::list<EpcTft::PacketFilter>::const_iterator f = filters.begin ();
+           f != filters.end ();
+           ++f)
+        {
+          // the remote end is the source of the packet and the local end
+          // is its destination; the highest TFT id takes precedence, since
+          // the default bearer is expected to be added first
+          TupleSpaceClassifier::Rule rule;
+          rule.sourcePortStart = f->remotePortStart;
+          rule.sourcePortEnd = f->remotePortEnd;
+          rule.destinationPortStart = f->localPortStart;
+          rule.destinationPortEnd = f->localPortEnd;
+          rule.tos = f->typeOfService;
+          rule.tosMask = f->typeOfServiceMask;
+          rule.priority = std::numeric_limits<uint32_t>::max () - it->first;
+          rule.value = it->first;
+
+          TupleSpaceClassifier::Rule ipv6Rule = rule;
+          rule.SetSource (f->remoteAddress, f->remoteMask);
+          rule.SetDestination (f->localAddress, f->localMask);
+          ipv6Rule.SetSource (f->remoteIpv6Address, f->remoteIpv6Prefix);
+          ipv6Rule.SetDestination (f->localIpv6Address, f->localIpv6Prefix);
+
+          for (uint32_t d = 0; d < 2; ++d)
+            {
+              if (f->direction & directions[d])
+                {
+                  m_classifiers[d][0].Add (rule);
+                  m_classifiers[d][1].Add (ipv6Rule);
+                }
+            }
+        }
+    }
 }
 
 uint32_t 
@@ -258,6 +314,11 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
     }
 
 
+  TupleSpaceClassifier::Key key;
+  key.sourcePort = remotePort;
+  key.destinationPort = localPort;
+  key.tos = tos;
+  uint32_t family;
   if (protocolNumber == Ipv4L3Protocol::PROT_NUMBER)
     {
       NS_LOG_INFO ("Classifying packet:"
@@ -266,26 +327,11 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
           << " localPort="  << localPort
           << " remotePort=" << remotePort
           << " tos=0x" << (uint16_t) tos );
-
-      // now it is possible to classify the packet!
-      // we use a reverse iterator since filter priority is not implemented properly.
-      // This way, since the default bearer is expected to be added first, it will be evaluated last.
-      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-      NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
-
-      for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
-        {
-          NS_LOG_LOGIC ("TFT id: " << it->first );
-          NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-          Ptr<EpcTft> tft = it->second;
-          if (tft->Matches (direction, remoteAddressIpv4, localAddressIpv4, remotePort, localPort, tos))
-            {
-              NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-              return it->first; // the id of the matching TFT
-            }
-        }
+      key.SetSource (remoteAddressIpv4);
+      key.SetDestination (localAddressIpv4);
+      family = 0;
     }
-  else if (protocolNumber == Ipv6L3Protocol::PROT_NUMBER)
+  else
     {
       NS_LOG_INFO ("Classifying packet:"
           << " localAddr="  << localAddressIpv6
@@ -293,24 +339,18 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
           << " localPort="  << localPort
           << " remotePort=" << remotePort
           << " tos=0x" << (uint16_t) tos );
+      key.SetSource (remoteAddressIpv6);
+      key.SetDestination (localAddressIpv6);
+      family = 1;
+    }
 
-      // now it is possible to classify the packet!
-      // we use a reverse iterator since filter priority is not implemented properly.
-      // This way, since the default bearer is expected to be added first, it will be evaluated last.
-      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-      NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
-
-      for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
-        {
-          NS_LOG_LOGIC ("TFT id: " << it->first );
-          NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-          Ptr<EpcTft> tft = it->second;
-          if (tft->Matches (direction, remoteAddressIpv6, localAddressIpv6, remotePort, localPort, tos))
-            {
-              NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-              return it->first; // the id of the matching TFT
-            }
-        }
+  // now it is possible to classify the packet!
+  uint32_t d = (direction == EpcTft::UPLINK) ? 1 : 0;
+  const TupleSpaceClassifier::Rule *rule = m_classifiers[d][family].Lookup (key);
+  if (rule != 0)
+    {
+      NS_LOG_LOGIC ("matches with TFT ID = " << rule->value);
+      return rule->value; // the id of the matching TFT
     }
   NS_LOG_LOGIC ("no match");
   return 0;  // no match
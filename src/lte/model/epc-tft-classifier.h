@@ -26,6 +26,7 @@
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 #include "ns3/epc-tft.h"
+#include "ns3/tuple-space-classifier.h"
 
 #include <map>
 
@@ -50,6 +51,12 @@ class Packet;
  *
  * When we cannot cache the port info, the TFT of the default bearer is used. This may happen
  * if there is reordering or losses of IP packets.
+ *
+ * The packet filters of all the TFTs are compiled into a
+ * TupleSpaceClassifier per direction and IP version whenever a TFT is
+ * added or deleted, so that the cost of classifying a packet does not
+ * grow with the number of packet filters. Hence, a TFT must not be
+ * modified after it has been added to the classifier.
  */
 class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
 {
@@ -87,8 +94,17 @@ public:
   
 protected:
   
+  /**
+   * Compile the packet filters of all the TFTs into the tuple space
+   * classifiers
+   */
+  void Compile (void);
+
   std::map <uint32_t, Ptr<EpcTft> > m_tftMap; ///< TFT map
 
+  /// Compiled packet filters, indexed by direction (downlink, uplink) and IP version (4, 6)
+  TupleSpaceClassifier m_classifiers[2][2];
+
   std::map < std::tuple<uint32_t, uint32_t, uint8_t, uint16_t>,
              std::pair<uint32_t, uint32_t> >
       m_classifiedIpv4Fragments; ///< Map with already classified IPv4 Fragments
@@ -256,6 +256,8 @@ LteEnbPhy::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_ueAttached.clear ();
   m_srsUeOffset.clear ();
+  m_gainMap = 0;
+  m_dlDataTxPsd = 0;
   delete m_enbPhySapProvider;
   delete m_enbCphySapProvider;
   LtePhy::DoDispose ();
@@ -753,10 +755,22 @@ LteEnbPhy::StartSubFrame (void)
         }
     }
 
+  // the DL data PSD is built once per subframe, and shared by the PDSCH
+  // and the gain map
+  Ptr<PacketBurst> pb = GetPacketBurst ();
+  m_dlDataTxPsd = 0;
+  if ((pb || m_gainMap) && !m_dlDataRbMap.empty ())
+    {
+      m_dlDataTxPsd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (m_dlEarfcn, m_dlBandwidth, m_txPower, m_dlPowerAllocationMap, m_dlDataRbMap);
+    }
+  if (m_gainMap)
+    {
+      m_gainMap->SetDlTxPsd (m_cellId, m_dlDataTxPsd);
+    }
+
   SendControlChannels (ctrlMsg);
 
   // send data frame
-  Ptr<PacketBurst> pb = GetPacketBurst ();
   if (pb)
     {
       Simulator::Schedule (DL_CTRL_DELAY_FROM_SUBFRAME_START, // ctrl frame fixed to 3 symbols
@@ -798,7 +812,15 @@ void
 LteEnbPhy::SendDataChannels (Ptr<PacketBurst> pb)
 {
   // set the current tx power spectral density
-  SetDownlinkSubChannelsWithPowerAllocation (m_dlDataRbMap);
+  if (m_dlDataTxPsd)
+    {
+      m_listOfDownlinkSubchannel = m_dlDataRbMap;
+      m_downlinkSpectrumPhy->SetTxPowerSpectralDensity (m_dlDataTxPsd);
+    }
+  else
+    {
+      SetDownlinkSubChannelsWithPowerAllocation (m_dlDataRbMap);
+    }
   // send the current burts of packets
   NS_LOG_LOGIC (this << " eNB start TX DATA");
   std::list<Ptr<LteControlMessage> > ctrlMsgList;
@@ -1169,6 +1191,13 @@ LteEnbPhy::SetHarqPhyModule (Ptr<LteHarqPhy> harq)
   m_harqPhyModule = harq;
 }
 
+void
+LteEnbPhy::SetGainMap (Ptr<LteGainMap> gainMap)
+{
+  NS_LOG_FUNCTION (this << gainMap);
+  m_gainMap = gainMap;
+}
+
 
 void
 LteEnbPhy::ReceiveLteUlHarqFeedback (UlInfoListElement_s mes)
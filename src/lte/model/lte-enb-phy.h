@@ -28,6 +28,7 @@
 #include <ns3/lte-enb-cphy-sap.h>
 #include <ns3/lte-phy.h>
 #include <ns3/lte-harq-phy.h>
+#include <ns3/lte-gain-map.h>
 
 #include <map>
 #include <set>
@@ -298,6 +299,17 @@ public:
    */
   void SetHarqPhyModule (Ptr<LteHarqPhy> harq);
 
+  /**
+   * \brief Set the DL gain map
+   *
+   * When set, the DL data PSD of every subframe is reported to the
+   * gain map, from which the UEs sharing the map compute the
+   * interference of their DL CQI.
+   *
+   * \param gainMap the gain map
+   */
+  void SetGainMap (Ptr<LteGainMap> gainMap);
+
   /**
    * TracedCallback signature for the linear average of SRS SINRs.
    *
@@ -440,6 +452,7 @@ private:
   std::vector <int> m_listOfDownlinkSubchannel;
 
   std::vector <int> m_dlDataRbMap; ///< DL data RB map
+  Ptr<SpectrumValue> m_dlDataTxPsd; ///< DL data PSD of the current subframe, if any
 
   /// For storing info on future receptions.
   std::vector< std::list<UlDciLteControlMessage> > m_ulDciQueue;
@@ -482,6 +495,8 @@ private:
 
   Ptr<LteHarqPhy> m_harqPhyModule; ///< HARQ Phy module
 
+  Ptr<LteGainMap> m_gainMap; ///< DL gain map, if any
+
   /**
    * The `ReportUeSinr` trace source. Reporting the linear average of SRS SINR.
    * Exporting cell ID, RNTI, SINR in linear unit and ComponentCarrierId
@@ -0,0 +1,202 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-gain-map.h"
+#include "lte-spectrum-phy.h"
+
+#include <ns3/log.h>
+#include <ns3/mobility-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteGainMap");
+
+NS_OBJECT_ENSURE_REGISTERED (LteGainMap);
+
+LteGainMap::LteGainMap ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteGainMap::~LteGainMap ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+LteGainMap::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteGainMap")
+    .SetParent<Object> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LteGainMap> ()
+  ;
+  return tid;
+}
+
+void
+LteGainMap::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_gainMap.clear ();
+  m_dlTxPsd.clear ();
+  Object::DoDispose ();
+}
+
+void
+LteGainMap::ComputeGain (uint16_t cellId, uint64_t imsi,
+                         Ptr<LteSpectrumPhy> enbPhy, Ptr<LteSpectrumPhy> uePhy,
+                         Ptr<const SpectrumModel> model,
+                         Ptr<PropagationLossModel> plm,
+                         Ptr<SpectrumPropagationLossModel> splm)
+{
+  NS_LOG_FUNCTION (this << cellId << imsi);
+  Ptr<MobilityModel> txMobility = enbPhy->GetMobility ();
+  Ptr<MobilityModel> rxMobility = uePhy->GetMobility ();
+  NS_ASSERT_MSG (txMobility && rxMobility, "eNB and UE must have a MobilityModel");
+
+  // same sequence of operations as MultiModelSpectrumChannel::StartTx
+  double pathLossDb = 0;
+  Ptr<AntennaModel> txAntenna = enbPhy->GetRxAntenna ();
+  if (txAntenna != 0)
+    {
+      Angles txAngles (rxMobility->GetPosition (), txMobility->GetPosition ());
+      pathLossDb -= txAntenna->GetGainDb (txAngles);
+    }
+  Ptr<AntennaModel> rxAntenna = uePhy->GetRxAntenna ();
+  if (rxAntenna != 0)
+    {
+      Angles rxAngles (txMobility->GetPosition (), rxMobility->GetPosition ());
+      pathLossDb -= rxAntenna->GetGainDb (rxAngles);
+    }
+  if (plm != 0)
+    {
+      pathLossDb -= plm->CalcRxPower (0, txMobility, rxMobility);
+    }
+  NS_LOG_LOGIC ("cellId " << cellId << " imsi " << imsi << " pathLoss " << pathLossDb << " dB");
+
+  // the RX spectrum model of the UE is not known until it has synchronized
+  // to a cell, hence the model of the DL carrier of the eNB is used
+  Ptr<SpectrumValue> gain = Create<SpectrumValue> (model);
+  (*gain) = std::pow (10.0, -pathLossDb / 10.0);
+  if (splm != 0)
+    {
+      gain = splm->CalcRxPowerSpectralDensity (gain, txMobility, rxMobility);
+    }
+  m_gainMap[cellId][imsi] = gain;
+}
+
+void
+LteGainMap::SetGain (uint16_t cellId, uint64_t imsi, const SpectrumValue &gain)
+{
+  NS_LOG_FUNCTION (this << cellId << imsi);
+  m_gainMap[cellId][imsi] = Create<SpectrumValue> (gain);
+}
+
+Ptr<const SpectrumValue>
+LteGainMap::GetGain (uint16_t cellId, uint64_t imsi) const
+{
+  std::map<uint16_t, std::map<uint64_t, Ptr<SpectrumValue> > >::const_iterator cellIt = m_gainMap.find (cellId);
+  if (cellIt == m_gainMap.end ())
+    {
+      return 0;
+    }
+  std::map<uint64_t, Ptr<SpectrumValue> >::const_iterator ueIt = cellIt->second.find (imsi);
+  if (ueIt == cellIt->second.end ())
+    {
+      return 0;
+    }
+  return ueIt->second;
+}
+
+double
+LteGainMap::GetWidebandGainDb (uint16_t cellId, uint64_t imsi) const
+{
+  Ptr<const SpectrumValue> gain = GetGain (cellId, imsi);
+  if (gain == 0 || gain->GetSpectrumModel ()->GetNumBands () == 0)
+    {
+      return -std::numeric_limits<double>::infinity ();
+    }
+  double avg = Sum (*gain) / gain->GetSpectrumModel ()->GetNumBands ();
+  return 10 * std::log10 (avg);
+}
+
+void
+LteGainMap::SetDlTxPsd (uint16_t cellId, Ptr<const SpectrumValue> txPsd)
+{
+  NS_LOG_FUNCTION (this << cellId);
+  if (txPsd == 0)
+    {
+      m_dlTxPsd.erase (cellId);
+    }
+  else
+    {
+      m_dlTxPsd[cellId] = txPsd;
+    }
+}
+
+SpectrumValue
+LteGainMap::CalculateDlRxPsd (uint16_t cellId, uint64_t imsi) const
+{
+  Ptr<const SpectrumValue> gain = GetGain (cellId, imsi);
+  NS_ASSERT_MSG (gain != 0, "no gain for cellId " << cellId << " imsi " << imsi);
+  std::map<uint16_t, Ptr<const SpectrumValue> >::const_iterator it = m_dlTxPsd.find (cellId);
+  if (it == m_dlTxPsd.end ())
+    {
+      return SpectrumValue (gain->GetSpectrumModel ());
+    }
+  return (*it->second) * (*gain);
+}
+
+SpectrumValue
+LteGainMap::CalculateDlSinr (uint16_t cellId, uint64_t imsi,
+                             const SpectrumValue &noisePsd) const
+{
+  NS_LOG_FUNCTION (this << cellId << imsi);
+  return CalculateDlRxPsd (cellId, imsi) / CalculateDlInterference (cellId, imsi, noisePsd);
+}
+
+SpectrumValue
+LteGainMap::CalculateDlInterference (uint16_t cellId, uint64_t imsi,
+                                     const SpectrumValue &noisePsd) const
+{
+  NS_LOG_FUNCTION (this << cellId << imsi);
+  SpectrumValue interference = noisePsd;
+  for (std::map<uint16_t, Ptr<const SpectrumValue> >::const_iterator it = m_dlTxPsd.begin ();
+       it != m_dlTxPsd.end ();
+       ++it)
+    {
+      if (it->first == cellId)
+        {
+          continue;
+        }
+      Ptr<const SpectrumValue> gain = GetGain (it->first, imsi);
+      if (gain != 0)
+        {
+          interference += (*it->second) * (*gain);
+        }
+    }
+  return interference;
+}
+
+} // namespace ns3
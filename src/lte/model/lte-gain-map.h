@@ -0,0 +1,163 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_GAIN_MAP_H
+#define LTE_GAIN_MAP_H
+
+#include <ns3/object.h>
+#include <ns3/ptr.h>
+#include <ns3/spectrum-value.h>
+#include <map>
+
+namespace ns3 {
+
+class LteSpectrumPhy;
+class PropagationLossModel;
+class SpectrumPropagationLossModel;
+
+/**
+ * \ingroup lte
+ *
+ * Precomputed downlink channel gain map.
+ *
+ * For every (cell, UE) pair the map stores the per-RB linear channel
+ * gain, including antenna gains, the (wideband) PropagationLossModel
+ * and the (frequency selective) SpectrumPropagationLossModel, exactly
+ * as MultiModelSpectrumChannel would apply them to a transmitted PSD.
+ * Unlike LteGlobalPathlossDatabase, which only records what the
+ * channel traces report, the gains are computed up front, so that the
+ * per-RB DL SINR of a UE can be evaluated from the gains and the DL
+ * data PSD that each eNB reports for the current TTI.
+ *
+ * The map does not replace the SpectrumChannel: the data and control
+ * signals are still propagated through it and received by
+ * LteSpectrumPhy. The UE PHYs sharing the map only take the
+ * interference of their PDSCH based DL CQI from it.
+ *
+ * Gains are static once computed; time-varying models (fast fading,
+ * mobility) are not tracked unless the map is recomputed by the user.
+ */
+class LteGainMap : public Object
+{
+public:
+  LteGainMap ();
+  virtual ~LteGainMap ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * Compute and store the gain between an eNB and a UE.
+   *
+   * \param cellId the id of the cell
+   * \param imsi the IMSI of the UE
+   * \param enbPhy the DL LteSpectrumPhy of the eNB
+   * \param uePhy the DL LteSpectrumPhy of the UE
+   * \param model the spectrum model of the DL carrier of the eNB
+   * \param plm the wideband propagation loss model (may be null)
+   * \param splm the frequency selective propagation loss model (may be null)
+   */
+  void ComputeGain (uint16_t cellId, uint64_t imsi,
+                    Ptr<LteSpectrumPhy> enbPhy, Ptr<LteSpectrumPhy> uePhy,
+                    Ptr<const SpectrumModel> model,
+                    Ptr<PropagationLossModel> plm,
+                    Ptr<SpectrumPropagationLossModel> splm);
+
+  /**
+   * Set the per-RB linear gain between an eNB and a UE, overriding
+   * any previously computed value.
+   *
+   * \param cellId the id of the cell
+   * \param imsi the IMSI of the UE
+   * \param gain the linear gain of each RB
+   */
+  void SetGain (uint16_t cellId, uint64_t imsi, const SpectrumValue &gain);
+
+  /**
+   * \param cellId the id of the cell
+   * \param imsi the IMSI of the UE
+   * \return the per-RB linear gain, or 0 if the pair is unknown
+   */
+  Ptr<const SpectrumValue> GetGain (uint16_t cellId, uint64_t imsi) const;
+
+  /**
+   * \param cellId the id of the cell
+   * \param imsi the IMSI of the UE
+   * \return the wideband (RB averaged) gain in dB, or -infinity if the
+   * pair is unknown
+   */
+  double GetWidebandGainDb (uint16_t cellId, uint64_t imsi) const;
+
+  /**
+   * Record the DL data PSD transmitted by a cell in the current TTI.
+   * RBs that are not allocated must have zero power. Passing a null
+   * pointer marks the cell as silent.
+   *
+   * \param cellId the id of the cell
+   * \param txPsd the transmitted PSD
+   */
+  void SetDlTxPsd (uint16_t cellId, Ptr<const SpectrumValue> txPsd);
+
+  /**
+   * Compute the per-RB DL SINR of a UE served by the given cell, using
+   * the PSDs of all cells that transmit in the current TTI as
+   * interferers.
+   *
+   * \param cellId the id of the serving cell
+   * \param imsi the IMSI of the UE
+   * \param noisePsd the noise PSD of the UE receiver
+   * \return the linear SINR of each RB
+   */
+  SpectrumValue CalculateDlSinr (uint16_t cellId, uint64_t imsi,
+                                 const SpectrumValue &noisePsd) const;
+
+  /**
+   * Compute the DL interference plus noise of a UE served by the given
+   * cell, i.e., the sum of the noise and of the PSDs received from all
+   * the other cells that transmit in the current TTI.
+   *
+   * \param cellId the id of the serving cell
+   * \param imsi the IMSI of the UE
+   * \param noisePsd the noise PSD of the UE receiver
+   * \return the interference plus noise PSD
+   */
+  SpectrumValue CalculateDlInterference (uint16_t cellId, uint64_t imsi,
+                                         const SpectrumValue &noisePsd) const;
+
+  /**
+   * \param cellId the id of the cell
+   * \param imsi the IMSI of the UE
+   * \return the received PSD from the given cell in the current TTI
+   */
+  SpectrumValue CalculateDlRxPsd (uint16_t cellId, uint64_t imsi) const;
+
+protected:
+  // inherited from Object
+  virtual void DoDispose (void);
+
+private:
+  /// per-RB linear gain by (CELL ID, (IMSI, GAIN))
+  std::map<uint16_t, std::map<uint64_t, Ptr<SpectrumValue> > > m_gainMap;
+  /// DL data PSD transmitted by each active cell in the current TTI
+  std::map<uint16_t, Ptr<const SpectrumValue> > m_dlTxPsd;
+};
+
+} // namespace ns3
+
+#endif /* LTE_GAIN_MAP_H */
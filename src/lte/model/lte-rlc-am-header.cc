@@ -218,13 +218,14 @@ LteRlcAmHeader::OneMoreNackWouldFitIn (uint16_t bytes)
   NS_LOG_FUNCTION (this << bytes);
   NS_ASSERT_MSG (m_dataControlBit == CONTROL_PDU && m_controlPduType == LteRlcAmHeader::STATUS_PDU,
                  "method allowed only for STATUS PDUs");
+  // see PushNack: an odd NACK_SN takes 2 more bytes, an even one 1 more
   if (m_nackSnList.size () % 2 == 0)
     {
-      return (m_headerLength < bytes);
+      return (m_headerLength + 2 <= bytes);
     }
   else
     {
-      return (m_headerLength < (bytes - 1));
+      return (m_headerLength + 1 <= bytes);
     }
 }
 
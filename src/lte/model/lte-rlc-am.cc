@@ -27,6 +27,8 @@
 #include "ns3/lte-rlc-sdu-status-tag.h"
 #include "ns3/lte-rlc-tag.h"
 
+#include <algorithm>
+
 
 namespace ns3 {
 
@@ -45,6 +47,7 @@ LteRlcAm::LteRlcAm ()
   m_retxBufferSize = 0;
   m_txedBuffer.resize (1024);
   m_txedBufferSize = 0;
+  m_rxonBuffer.resize (1024);
 
   m_statusPduRequested = false;
   m_statusPduBufferSize = 0;
@@ -197,7 +200,11 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
 
   if ( m_statusPduRequested && ! m_statusProhibitTimer.IsRunning () )
     {
-      if (txOpParams.bytes < m_statusPduBufferSize)
+      // The whole STATUS PDU (m_statusPduBufferSize) is reported to the
+      // MAC, but a smaller grant is still valid as long as it can carry
+      // ACK_SN and one NACK_SN: the NACKs which do not fit are left out
+      // and ACK_SN is set to the first SN not reported as missing.
+      if (txOpParams.bytes < 4)
         {
           // Stingy MAC: We need more bytes for the STATUS PDU
           NS_LOG_LOGIC ("TxOpportunity (size = " << txOpParams.bytes << ") too small for the STATUS PDU (size = " << m_statusPduBufferSize << ")");
@@ -215,7 +222,6 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
       NS_LOG_LOGIC ("Check for SNs to NACK from " << m_vrR.GetValue() << " to " << m_vrMs.GetValue());
       SequenceNumber10 sn;
       sn.SetModulusBase (m_vrR);
-      std::map<uint16_t, PduBuffer>::iterator pduIt;
       for (sn = m_vrR; sn < m_vrMs; sn++) 
         {
           NS_LOG_LOGIC ("SN = " << sn);          
@@ -224,8 +230,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
               NS_LOG_LOGIC ("Can't fit more NACKs in STATUS PDU");
               break;
             }          
-          pduIt = m_rxonBuffer.find (sn.GetValue ());
-          if (pduIt == m_rxonBuffer.end () || (!(pduIt->second.m_pduComplete)))
+          if (!m_rxonBuffer[sn.GetValue ()].m_pduComplete)
             {
               NS_LOG_LOGIC ("adding NACK_SN " << sn.GetValue ());
               rlcAmHeader.PushNack (sn.GetValue ());              
@@ -235,13 +240,11 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
       // 3GPP TS 36.322 section 6.2.2.1.4 ACK SN
       // find the  SN of the next not received RLC Data PDU 
       // which is not reported as missing in the STATUS PDU. 
-      pduIt = m_rxonBuffer.find (sn.GetValue ());
-      while ((sn < m_vrMs) && (pduIt != m_rxonBuffer.end ()) && (pduIt->second.m_pduComplete))            
+      while ((sn < m_vrMs) && m_rxonBuffer[sn.GetValue ()].m_pduComplete)
         {
           NS_LOG_LOGIC ("SN = " << sn << " < " << m_vrMs << " = " << (sn < m_vrMs));
           sn++;
           NS_LOG_LOGIC ("SN = " << sn);
-          pduIt = m_rxonBuffer.find (sn.GetValue ());
         }
       
       NS_ASSERT_MSG (sn <= m_vrMs, "first SN not reported as missing = " << sn << ", VR(MS) = " << m_vrMs);      
@@ -363,7 +366,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
                     }
 
                   NS_LOG_INFO ("Move SN = " << seqNumberValue << " back to txedBuffer");
-                  m_txedBuffer.at (seqNumberValue).m_pdu = m_retxBuffer.at (seqNumberValue).m_pdu->Copy ();
+                  m_txedBuffer.at (seqNumberValue).m_pdu = m_retxBuffer.at (seqNumberValue).m_pdu;
                   m_txedBuffer.at (seqNumberValue).m_retxCount = m_retxBuffer.at (seqNumberValue).m_retxCount;
                   m_txedBuffer.at (seqNumberValue).m_waitingSince = m_retxBuffer.at (seqNumberValue).m_waitingSince;
                   m_txedBufferSize += m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
@@ -846,7 +849,6 @@ LteRlcAm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
       if ( rlcAmHeader.GetPollingBit () == LteRlcAmHeader::STATUS_REPORT_IS_REQUESTED )
         {
           m_statusPduRequested = true;
-          m_statusPduBufferSize = 4;
 
           if (! m_statusProhibitTimer.IsRunning ())
             {
@@ -885,18 +887,17 @@ LteRlcAm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
           //         - discard the duplicate byte segments.
           // note: re-segmentation of AMD PDU is currently not supported, 
           // so we just check that the segment was not received before
-          std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (seqNumber.GetValue ());
-          if (it != m_rxonBuffer.end () )
+          PduBuffer &pduBuffer = m_rxonBuffer[seqNumber.GetValue ()];
+          if (pduBuffer.m_pdu != 0)
             {
-              NS_ASSERT (it->second.m_byteSegments.size () > 0);
-              NS_ASSERT_MSG (it->second.m_byteSegments.size () == 1, "re-segmentation not supported");
+              NS_ASSERT_MSG (pduBuffer.m_pduComplete, "re-segmentation not supported");
               NS_LOG_LOGIC ("PDU segment already received, discarded");
             }
           else
             {
               NS_LOG_LOGIC ("Place PDU in the reception buffer ( SN = " << seqNumber << " )");
-              m_rxonBuffer[ seqNumber.GetValue () ].m_byteSegments.push_back (rxPduParams.p);
-              m_rxonBuffer[ seqNumber.GetValue () ].m_pduComplete = true;
+              pduBuffer.m_pdu = rxPduParams.p;
+              pduBuffer.m_pduComplete = true;
             }
 
 
@@ -919,16 +920,12 @@ LteRlcAm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
       //     - update VR(MS) to the SN of the first AMD PDU with SN > current VR(MS) for
       //       which not all byte segments have been received;
 
-      std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (m_vrMs.GetValue ());
-      if ( it != m_rxonBuffer.end () &&
-           it->second.m_pduComplete )
+      if ( m_rxonBuffer[m_vrMs.GetValue ()].m_pduComplete )
         {
           int firstVrMs = m_vrMs.GetValue ();
-          while ( it != m_rxonBuffer.end () &&
-                  it->second.m_pduComplete )
+          while ( m_rxonBuffer[m_vrMs.GetValue ()].m_pduComplete )
             {
               m_vrMs++;
-              it = m_rxonBuffer.find (m_vrMs.GetValue ());
               NS_LOG_LOGIC ("Incr VR(MS) = " << m_vrMs);
 
               NS_ASSERT_MSG (firstVrMs != m_vrMs.GetValue (), "Infinite loop in RxonBuffer");
@@ -944,27 +941,23 @@ LteRlcAm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
 
       if ( seqNumber == m_vrR )
         {
-          std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (seqNumber.GetValue ());
-          if ( it != m_rxonBuffer.end () &&
-               it->second.m_pduComplete )
+          if ( m_rxonBuffer[seqNumber.GetValue ()].m_pduComplete )
             {
-              it = m_rxonBuffer.find (m_vrR.GetValue ());
               int firstVrR = m_vrR.GetValue ();
-              while ( it != m_rxonBuffer.end () &&
-                      it->second.m_pduComplete )
+              while ( m_rxonBuffer[m_vrR.GetValue ()].m_pduComplete )
                 {
                   NS_LOG_LOGIC ("Reassemble and Deliver ( SN = " << m_vrR << " )");
-                  NS_ASSERT_MSG (it->second.m_byteSegments.size () == 1,
-                                "Too many segments. PDU Reassembly process didn't work");
-                  ReassembleAndDeliver (it->second.m_byteSegments.front ());
-                  m_rxonBuffer.erase (m_vrR.GetValue ());
+                  PduBuffer &pduBuffer = m_rxonBuffer[m_vrR.GetValue ()];
+                  Ptr<Packet> pdu = pduBuffer.m_pdu;
+                  pduBuffer.m_pdu = 0;
+                  pduBuffer.m_pduComplete = false;
+                  ReassembleAndDeliver (pdu);
 
                   m_vrR++;
                   m_vrR.SetModulusBase (m_vrR);
                   m_vrX.SetModulusBase (m_vrR);
                   m_vrMs.SetModulusBase (m_vrR);
                   m_vrH.SetModulusBase (m_vrR);
-                  it = m_rxonBuffer.find (m_vrR.GetValue ());
 
                   NS_ASSERT_MSG (firstVrR != m_vrR.GetValue (), "Infinite loop in RxonBuffer");
                 }
@@ -1054,7 +1047,7 @@ LteRlcAm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
               if (m_txedBuffer.at (seqNumberValue).m_pdu != 0)
                 {
                   NS_LOG_INFO ("Move SN = " << seqNumberValue << " to retxBuffer");
-                  m_retxBuffer.at (seqNumberValue).m_pdu = m_txedBuffer.at (seqNumberValue).m_pdu->Copy ();
+                  m_retxBuffer.at (seqNumberValue).m_pdu = m_txedBuffer.at (seqNumberValue).m_pdu;
                   m_retxBuffer.at (seqNumberValue).m_retxCount = m_txedBuffer.at (seqNumberValue).m_retxCount;
                   m_retxBuffer.at (seqNumberValue).m_waitingSince = m_txedBuffer.at (seqNumberValue).m_waitingSince;
                   m_retxBufferSize += m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
@@ -1620,6 +1613,7 @@ LteRlcAm::DoReportBufferStatus (void)
 
   if ( m_statusPduRequested && ! m_statusProhibitTimer.IsRunning () )
     {
+      m_statusPduBufferSize = GetStatusPduSize ();
       r.statusPduSize = m_statusPduBufferSize;
     }
   else
@@ -1640,6 +1634,30 @@ LteRlcAm::DoReportBufferStatus (void)
     }
 }
 
+uint32_t
+LteRlcAm::GetStatusPduSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  // One NACK_SN for each AMD PDU not completely received below VR(MS),
+  // so that a single STATUS PDU reports every hole of the receiving
+  // window instead of one hole per t-StatusProhibit period.
+  uint32_t nacks = 0;
+  SequenceNumber10 sn;
+  sn.SetModulusBase (m_vrR);
+  for (sn = m_vrR; sn < m_vrMs; sn++)
+    {
+      if (!m_rxonBuffer[sn.GetValue ()].m_pduComplete)
+        {
+          nacks++;
+        }
+    }
+
+  // D/C + CPT + ACK_SN + E1 take 2 bytes, and each NACK_SN + E1 + E2
+  // takes 12 bits (see LteRlcAmHeader::PushNack). A STATUS PDU without
+  // NACKs is still reported with room for one, as before.
+  return 2 + (3 * std::max (nacks, 1u) + 1) / 2;
+}
 
 void
 LteRlcAm::ExpireReorderingTimer (void)
@@ -1657,12 +1675,9 @@ LteRlcAm::ExpireReorderingTimer (void)
 
   m_vrMs = m_vrX;
   int firstVrMs = m_vrMs.GetValue ();
-  std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (m_vrMs.GetValue ());
-  while ( it != m_rxonBuffer.end () &&
-          it->second.m_pduComplete )
+  while ( m_rxonBuffer[m_vrMs.GetValue ()].m_pduComplete )
     {
       m_vrMs++;
-      it = m_rxonBuffer.find (m_vrMs.GetValue ());
 
       NS_ASSERT_MSG (firstVrMs != m_vrMs.GetValue (), "Infinite loop in ExpireReorderingTimer");
     }
@@ -1711,7 +1726,7 @@ LteRlcAm::ExpirePollRetransmitTimer (void)
              {
                uint16_t snValue = sn.GetValue ();
                NS_LOG_INFO ("Move PDU " << sn << " from txedBuffer to retxBuffer");
-               m_retxBuffer.at (snValue).m_pdu = m_txedBuffer.at (snValue).m_pdu->Copy ();
+               m_retxBuffer.at (snValue).m_pdu = m_txedBuffer.at (snValue).m_pdu;
                m_retxBuffer.at (snValue).m_retxCount = m_txedBuffer.at (snValue).m_retxCount;
                m_retxBuffer.at (snValue).m_waitingSince = m_txedBuffer.at (snValue).m_waitingSince;
                m_retxBufferSize += m_retxBuffer.at (snValue).m_pdu->GetSize ();
@@ -26,8 +26,11 @@
 #include <ns3/lte-rlc.h>
 
 #include <vector>
+#include <deque>
 #include <map>
 
+class LteRlcAmReceiverTestCase;
+
 namespace ns3 {
 
 /**
@@ -35,6 +38,9 @@ namespace ns3 {
  */
 class LteRlcAm : public LteRlc
 {
+  /// allow LteRlcAmReceiverTestCase class friend access
+  friend class ::LteRlcAmReceiverTestCase;
+
 public:
   LteRlcAm ();
   virtual ~LteRlcAm ();
@@ -106,6 +112,14 @@ private:
    */
   void DoReportBufferStatus ();
 
+  /**
+   * Compute the size of a STATUS PDU carrying a NACK_SN for every AMD PDU
+   * not completely received between VR(R) and VR(MS)
+   *
+   * \returns the STATUS PDU size in bytes
+   */
+  uint32_t GetStatusPduSize (void) const;
+
 private:
   /**
    * \brief Store an incoming (from layer above us) PDU, waiting to transmit it
@@ -128,7 +142,7 @@ private:
     Time        m_waitingSince;  ///< Layer arrival time
   };
 
-  std::vector < TxPdu > m_txonBuffer; ///< Transmission buffer
+  std::deque < TxPdu > m_txonBuffer; ///< Transmission buffer
 
   /// RetxPdu structure
   struct RetxPdu
@@ -153,13 +167,16 @@ private:
     /// PduBuffer structure
     struct PduBuffer
     {
-      SequenceNumber10  m_seqNumber; ///< sequence number
-      std::list < Ptr<Packet> >  m_byteSegments; ///< byte segments
+      PduBuffer () : m_pduComplete (false) { }
 
+      /// the received PDU; re-segmentation of AMD PDUs is not
+      /// supported, hence there is at most one segment per SN
+      Ptr<Packet> m_pdu;
       bool      m_pduComplete; ///< PDU complete?
     };
 
-    std::map <uint16_t, PduBuffer > m_rxonBuffer; ///< Reception buffer
+    /// Reception buffer, indexed by SN like the transmission buffers
+    std::vector <PduBuffer> m_rxonBuffer;
 
     Ptr<Packet> m_controlPduBuffer;               ///< Control PDU buffer (just one PDU)
 
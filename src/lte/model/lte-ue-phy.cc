@@ -44,6 +44,7 @@
 #include <ns3/pointer.h>
 #include <ns3/boolean.h>
 #include <ns3/lte-ue-power-control.h>
+#include <ns3/lte-gain-map.h>
 
 namespace ns3 {
 
@@ -194,6 +195,7 @@ LteUePhy::DoDispose ()
   NS_LOG_FUNCTION (this);
   delete m_uePhySapProvider;
   delete m_ueCphySapProvider;
+  m_gainMap = 0;
   LtePhy::DoDispose ();
 }
 
@@ -748,7 +750,15 @@ LteUePhy::GenerateMixedCqiReport (const SpectrumValue& sinr)
   m_ctrlSinrForRlf = sinr;
 
   SpectrumValue mixedSinr = (m_rsReceivedPower * m_paLinear);
-  if (m_dataInterferencePowerUpdated)
+  if (m_gainMap && m_gainMap->GetGain (m_cellId, m_imsi))
+    {
+      // gain map: interference of the data scheduled in this
+      // subframe by the other cells, as seen through the gain map
+      mixedSinr /= m_gainMap->CalculateDlInterference (m_cellId, m_imsi, *m_noisePsd);
+      m_dataInterferencePowerUpdated = false;
+      NS_LOG_LOGIC ("data interf from the gain map, SINR = " << mixedSinr);
+    }
+  else if (m_dataInterferencePowerUpdated)
     {
       // we have a measurement of interf + noise for the denominator
       // of SINR = S/(I+N)
@@ -1747,6 +1757,13 @@ LteUePhy::SetHarqPhyModule (Ptr<LteHarqPhy> harq)
   m_harqPhyModule = harq;
 }
 
+void
+LteUePhy::SetGainMap (Ptr<LteGainMap> gainMap)
+{
+  NS_LOG_FUNCTION (this << gainMap);
+  m_gainMap = gainMap;
+}
+
 
 LteUePhy::State
 LteUePhy::GetState () const
@@ -44,6 +44,7 @@ namespace ns3 {
 class PacketBurst;
 class LteEnbPhy;
 class LteHarqPhy;
+class LteGainMap;
 
 
 /**
@@ -292,6 +293,18 @@ public:
    */
   void SetHarqPhyModule (Ptr<LteHarqPhy> harq);
 
+  /**
+   * \brief Set the DL gain map
+   *
+   * When set, the PDSCH based DL CQI (see the UsePdschForCqiGeneration
+   * attribute of LteHelper) takes the interference from the gain map,
+   * i.e., from the data PSDs reported by the eNBs for the current
+   * subframe, instead of the interference measured by LteInterference.
+   *
+   * \param gainMap the gain map
+   */
+  void SetGainMap (Ptr<LteGainMap> gainMap);
+
   /**
    * \brief Get state of the UE physical layer
    *
@@ -808,6 +821,7 @@ private:
   double m_sinrDbFrame; ///< the average SINR per radio frame
   SpectrumValue m_ctrlSinrForRlf; ///< the CTRL SINR used for RLF detection
   uint64_t m_imsi; ///< the IMSI of the UE
+  Ptr<LteGainMap> m_gainMap; ///< DL gain map, if any
   bool m_enableRlfDetection; ///< Flag to enable/disable RLF detection
 
 }; // end of `class LteUePhy`
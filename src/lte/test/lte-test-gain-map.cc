@@ -0,0 +1,272 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/test.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+
+#include "ns3/lte-ue-phy.h"
+#include "ns3/lte-ue-net-device.h"
+#include "ns3/lte-enb-net-device.h"
+#include "ns3/lte-gain-map.h"
+#include "ns3/lte-spectrum-value-helper.h"
+#include "ns3/lte-global-pathloss-database.h"
+
+#include <ns3/lte-chunk-processor.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteGainMapTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check the per-RB SINR computed by LteGainMap from manually
+ * configured gains and DL allocations against the analytical value.
+ */
+class LteGainMapSinrTestCase : public TestCase
+{
+public:
+  LteGainMapSinrTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteGainMapSinrTestCase::LteGainMapSinrTestCase ()
+  : TestCase ("SINR from manually configured gains")
+{
+}
+
+void
+LteGainMapSinrTestCase::DoRun (void)
+{
+  const uint32_t earfcn = 100;
+  const uint8_t bw = 6;
+  Ptr<SpectrumModel> sm = LteSpectrumValueHelper::GetSpectrumModel (earfcn, bw);
+
+  Ptr<LteGainMap> gainMap = CreateObject<LteGainMap> ();
+  SpectrumValue g1 (sm);
+  SpectrumValue g2 (sm);
+  for (uint32_t i = 0; i < bw; ++i)
+    {
+      g1[i] = 1e-9 * (i + 1);
+      g2[i] = 1e-10;
+    }
+  gainMap->SetGain (1, 7, g1);
+  gainMap->SetGain (2, 7, g2);
+  NS_TEST_ASSERT_MSG_EQ_TOL (gainMap->GetWidebandGainDb (2, 7), -100.0, 1e-9, "wrong wideband gain");
+  NS_TEST_ASSERT_MSG_EQ (gainMap->GetGain (3, 7), 0, "unexpected gain for unknown cell");
+
+  // cell 1 transmits on RBs 0-3, cell 2 on RBs 2-5
+  std::vector<int> rbs1;
+  std::vector<int> rbs2;
+  for (int i = 0; i < 4; ++i)
+    {
+      rbs1.push_back (i);
+      rbs2.push_back (i + 2);
+    }
+  Ptr<SpectrumValue> psd1 = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (earfcn, bw, 30, rbs1);
+  Ptr<SpectrumValue> psd2 = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (earfcn, bw, 30, rbs2);
+  gainMap->SetDlTxPsd (1, psd1);
+  gainMap->SetDlTxPsd (2, psd2);
+
+  Ptr<SpectrumValue> noise = LteSpectrumValueHelper::CreateNoisePowerSpectralDensity (earfcn, bw, 9);
+  SpectrumValue sinr = gainMap->CalculateDlSinr (1, 7, *noise);
+  for (uint32_t i = 0; i < bw; ++i)
+    {
+      double s = (*psd1)[i] * g1[i];
+      double n = (*noise)[i] + (*psd2)[i] * g2[i];
+      NS_TEST_ASSERT_MSG_EQ_TOL (sinr[i], s / n, s / n * 1e-9, "wrong SINR on RB " << i);
+    }
+
+  // once the interferer is silent only the noise remains
+  gainMap->SetDlTxPsd (2, 0);
+  sinr = gainMap->CalculateDlSinr (1, 7, *noise);
+  for (uint32_t i = 0; i < bw; ++i)
+    {
+      double snr = (*psd1)[i] * g1[i] / (*noise)[i];
+      NS_TEST_ASSERT_MSG_EQ_TOL (sinr[i], snr, snr * 1e-9, "wrong SNR on RB " << i);
+    }
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check that the gains precomputed by LteHelper::InstallDlGainMap
+ * match the pathloss applied by the SpectrumChannel and that the SINR
+ * computed from the map, with the data PSDs reported by the eNBs, matches
+ * the data SINR measured by the full PHY model.
+ */
+class LteGainMapChannelTestCase : public TestCase
+{
+public:
+  LteGainMapChannelTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record the SINR of the gain map for the current subframe
+   * \param gainMap the gain map
+   * \param imsi the IMSI of the UE
+   * \param noisePsd the noise PSD of the UE
+   */
+  void SampleGainMap (Ptr<LteGainMap> gainMap, uint64_t imsi, Ptr<SpectrumValue> noisePsd);
+  /**
+   * Record the data SINR measured by the UE PHY
+   * \param sinr the SINR
+   */
+  void ReportChannelSinr (const SpectrumValue &sinr);
+
+  std::map<int64_t, SpectrumValue> m_mapSinr; ///< SINR of the gain map, by subframe
+  uint32_t m_interferedSubframes; ///< number of subframes with interference in the gain map
+  std::vector<std::pair<Time, SpectrumValue> > m_channelSinr; ///< data SINR measured by the UE PHY
+};
+
+LteGainMapChannelTestCase::LteGainMapChannelTestCase ()
+  : TestCase ("Gain map vs. full channel model"),
+    m_interferedSubframes (0)
+{
+}
+
+void
+LteGainMapChannelTestCase::SampleGainMap (Ptr<LteGainMap> gainMap, uint64_t imsi, Ptr<SpectrumValue> noisePsd)
+{
+  // the subframes start every millisecond, the samples are taken in the middle
+  int64_t subframe = Simulator::Now ().GetMicroSeconds () / 1000;
+  m_mapSinr.insert (std::make_pair (subframe, gainMap->CalculateDlSinr (1, imsi, *noisePsd)));
+  if (Sum (gainMap->CalculateDlInterference (1, imsi, *noisePsd)) > 1.01 * Sum (*noisePsd))
+    {
+      m_interferedSubframes++;
+    }
+  Simulator::Schedule (MilliSeconds (1), &LteGainMapChannelTestCase::SampleGainMap, this, gainMap, imsi, noisePsd);
+}
+
+void
+LteGainMapChannelTestCase::ReportChannelSinr (const SpectrumValue &sinr)
+{
+  m_channelSinr.push_back (std::make_pair (Simulator::Now (), sinr));
+}
+
+void
+LteGainMapChannelTestCase::DoRun (void)
+{
+  Config::Reset ();
+  Config::SetDefault ("ns3::LteSpectrumPhy::CtrlErrorModelEnabled", BooleanValue (false));
+  Config::SetDefault ("ns3::LteSpectrumPhy::DataErrorModelEnabled", BooleanValue (false));
+
+  // the RRC messages are the DL data of both cells
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("UseIdealRrc", BooleanValue (false));
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (2);
+  ueNodes.Create (2);
+  NodeContainer allNodes = NodeContainer (enbNodes, ueNodes);
+
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (500.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (100.0, 50.0, 0.0));
+  positionAlloc->Add (Vector (400.0, -50.0, 0.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (allNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->Attach (ueDevs.Get (0), enbDevs.Get (0));
+  lteHelper->Attach (ueDevs.Get (1), enbDevs.Get (1));
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  Ptr<LteGainMap> gainMap = lteHelper->InstallDlGainMap (enbDevs, ueDevs);
+
+  Ptr<LteUeNetDevice> ueDev = ueDevs.Get (0)->GetObject<LteUeNetDevice> ();
+  Ptr<LteChunkProcessor> testDlSinr = Create<LteChunkProcessor> ();
+  testDlSinr->AddCallback (MakeCallback (&LteGainMapChannelTestCase::ReportChannelSinr, this));
+  ueDev->GetPhy ()->GetDownlinkSpectrumPhy ()->AddDataSinrChunkProcessor (testDlSinr);
+
+  Ptr<LteEnbNetDevice> enbDev = enbDevs.Get (0)->GetObject<LteEnbNetDevice> ();
+  Ptr<SpectrumValue> noisePsd =
+    LteSpectrumValueHelper::CreateNoisePowerSpectralDensity (enbDev->GetDlEarfcn (), enbDev->GetDlBandwidth (),
+                                                             ueDev->GetPhy ()->GetNoiseFigure ());
+  Simulator::Schedule (MicroSeconds (500), &LteGainMapChannelTestCase::SampleGainMap,
+                       this, gainMap, ueDev->GetImsi (), noisePsd);
+
+  DownlinkLteGlobalPathlossDatabase dlPathlossDb;
+  Config::Connect ("/ChannelList/0/PathLoss",
+                   MakeCallback (&DownlinkLteGlobalPathlossDatabase::UpdatePathloss, &dlPathlossDb));
+
+  Simulator::Stop (Seconds (0.2));
+  Simulator::Run ();
+
+  for (uint16_t cellId = 1; cellId <= 2; ++cellId)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (gainMap->GetWidebandGainDb (cellId, ueDev->GetImsi ()),
+                                 -dlPathlossDb.GetPathloss (cellId, ueDev->GetImsi ()),
+                                 1e-6, "gain map does not match channel pathloss for cell " << cellId);
+    }
+
+  NS_TEST_ASSERT_MSG_GT (m_channelSinr.size (), 0, "no DL data SINR measured by the UE");
+  NS_TEST_ASSERT_MSG_GT (m_interferedSubframes, 0, "the other cell never interfered");
+  for (uint32_t n = 0; n < m_channelSinr.size (); ++n)
+    {
+      // the data of a subframe is received at its end
+      int64_t subframe = (m_channelSinr[n].first.GetMicroSeconds () - 500) / 1000;
+      std::map<int64_t, SpectrumValue>::const_iterator it = m_mapSinr.find (subframe);
+      NS_TEST_ASSERT_MSG_EQ ((it != m_mapSinr.end ()), true, "no gain map sample for subframe " << subframe);
+      const SpectrumValue &channel = m_channelSinr[n].second;
+      for (uint32_t i = 0; i < channel.GetSpectrumModel ()->GetNumBands (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL (it->second[i], channel[i], channel[i] * 0.002,
+                                     "wrong SINR from gain map on RB " << i << " in subframe " << subframe);
+        }
+    }
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief LteGainMap test suite
+ */
+class LteGainMapTestSuite : public TestSuite
+{
+public:
+  LteGainMapTestSuite ();
+};
+
+LteGainMapTestSuite::LteGainMapTestSuite ()
+  : TestSuite ("lte-gain-map", UNIT)
+{
+  AddTestCase (new LteGainMapSinrTestCase (), TestCase::QUICK);
+  AddTestCase (new LteGainMapChannelTestCase (), TestCase::QUICK);
+}
+
+static LteGainMapTestSuite lteGainMapTestSuite;
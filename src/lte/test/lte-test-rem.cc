@@ -0,0 +1,175 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/test.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/radio-environment-map-helper.h"
+
+#include <fstream>
+#include <cstring>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRemTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Compare the REM computed directly (with one or more threads)
+ * against the REM generated by RemSpectrumPhy listeners, and check the
+ * content of the binary raster file.
+ */
+class LteRemDirectTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param numThreads the number of threads used by the direct computation
+   */
+  LteRemDirectTestCase (uint32_t numThreads);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Generate a REM
+   *
+   * \param direct whether to compute the REM directly
+   * \param outputFile the name of the ASCII output
+   * \param rasterFile the name of the binary output
+   * \return the SINR values of the REM
+   */
+  std::vector<double> GenerateRem (bool direct, std::string outputFile, std::string rasterFile);
+
+  uint32_t m_numThreads; ///< number of threads of the direct computation
+};
+
+LteRemDirectTestCase::LteRemDirectTestCase (uint32_t numThreads)
+  : TestCase ("Direct REM computation with " + std::to_string (numThreads) + " thread(s)"),
+    m_numThreads (numThreads)
+{
+}
+
+std::vector<double>
+LteRemDirectTestCase::GenerateRem (bool direct, std::string outputFile, std::string rasterFile)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (400.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (200.0, 300.0, 30.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  lteHelper->InstallEnbDevice (enbNodes);
+
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue ("/ChannelList/0"));
+  remHelper->SetAttribute ("OutputFile", StringValue (outputFile));
+  remHelper->SetAttribute ("RasterFile", StringValue (rasterFile));
+  remHelper->SetAttribute ("XMin", DoubleValue (-100.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (500.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (7));
+  remHelper->SetAttribute ("YMin", DoubleValue (-100.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (400.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (6));
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (10));
+  remHelper->SetAttribute ("ComputeDirectly", BooleanValue (direct));
+  remHelper->SetAttribute ("NumThreads", UintegerValue (m_numThreads));
+  remHelper->Install ();
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::vector<double> sinr;
+  std::ifstream in (outputFile.c_str ());
+  double x, y, z, value;
+  while (in >> x >> y >> z >> value)
+    {
+      sinr.push_back (value);
+    }
+  return sinr;
+}
+
+void
+LteRemDirectTestCase::DoRun (void)
+{
+  Config::Reset ();
+  std::string remFile = CreateTempDirFilename ("rem.out");
+  std::vector<double> expected = GenerateRem (false, remFile, "");
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 42, "wrong number of REM points");
+
+  std::string directFile = CreateTempDirFilename ("rem-direct.out");
+  std::string rasterFile = CreateTempDirFilename ("rem-direct.bin");
+  std::vector<double> actual = GenerateRem (true, directFile, rasterFile);
+  NS_TEST_ASSERT_MSG_EQ (actual.size (), expected.size (), "wrong number of REM points");
+  for (uint32_t i = 0; i < actual.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (10 * std::log10 (actual[i]), 10 * std::log10 (expected[i]), 0.001,
+                                 "wrong SINR at point " << i);
+    }
+
+  std::ifstream raster (rasterFile.c_str (), std::ios::binary);
+  char header[64];
+  raster.read (header, sizeof (header));
+  NS_TEST_ASSERT_MSG_EQ (std::string (header, 8), "LTEREM01", "wrong raster magic");
+  uint32_t res[2];
+  std::memcpy (res, header + 8, sizeof (res));
+  NS_TEST_ASSERT_MSG_EQ (res[0], 7, "wrong X resolution");
+  NS_TEST_ASSERT_MSG_EQ (res[1], 6, "wrong Y resolution");
+  for (uint32_t i = 0; i < actual.size (); ++i)
+    {
+      float value;
+      raster.read (reinterpret_cast<char *> (&value), sizeof (value));
+      NS_TEST_ASSERT_MSG_EQ_TOL (value, actual[i], actual[i] * 1e-5, "wrong raster value at point " << i);
+    }
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Radio Environment Map test suite
+ */
+class LteRemTestSuite : public TestSuite
+{
+public:
+  LteRemTestSuite ();
+};
+
+LteRemTestSuite::LteRemTestSuite ()
+  : TestSuite ("lte-rem", SYSTEM)
+{
+  AddTestCase (new LteRemDirectTestCase (1), TestCase::QUICK);
+  AddTestCase (new LteRemDirectTestCase (4), TestCase::QUICK);
+}
+
+static LteRemTestSuite lteRemTestSuite;
@@ -0,0 +1,286 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+#include "ns3/lte-rlc-am-header.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-tag.h"
+
+#include "lte-test-rlc-am-receiver.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRlcAmReceiverTest");
+
+namespace ns3 {
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief MAC SAP provider recording the PDUs and the buffer status
+ * reported by the RLC AM entity under test
+ */
+class LteRlcAmReceiverTestMac : public LteMacSapProvider
+{
+public:
+  LteRlcAmReceiverTestMac ()
+    : m_statusPduSize (0)
+  {
+  }
+  virtual void TransmitPdu (TransmitPduParameters params)
+  {
+    m_pdus.push_back (params.pdu);
+  }
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+  {
+    m_statusPduSize = params.statusPduSize;
+  }
+
+  std::vector<Ptr<Packet> > m_pdus; ///< PDUs sent by the RLC
+  uint16_t m_statusPduSize; ///< last reported STATUS PDU size
+};
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief RLC SAP user counting the SDUs delivered by the RLC AM entity
+ * under test
+ */
+class LteRlcAmReceiverTestPdcp : public LteRlcSapUser
+{
+public:
+  LteRlcAmReceiverTestPdcp ()
+    : m_sdus (0)
+  {
+  }
+  virtual void ReceivePdcpPdu (Ptr<Packet> p)
+  {
+    m_sdus++;
+  }
+
+  uint32_t m_sdus; ///< number of SDUs delivered
+};
+
+} // namespace ns3
+
+
+/**
+ * TestSuite RLC AM: Only receiver
+ */
+
+LteRlcAmReceiverTestSuite::LteRlcAmReceiverTestSuite ()
+  : TestSuite ("lte-rlc-am-receiver", UNIT)
+{
+  AddTestCase (new LteRlcAmReceiverTestCase ("Reception buffer wraparound",
+                                             LteRlcAmReceiverTestCase::RING_WRAPAROUND),
+               TestCase::QUICK);
+  AddTestCase (new LteRlcAmReceiverTestCase ("STATUS PDU with all the NACKs",
+                                             LteRlcAmReceiverTestCase::STATUS_FULL),
+               TestCase::QUICK);
+  AddTestCase (new LteRlcAmReceiverTestCase ("STATUS PDU truncated by the grant",
+                                             LteRlcAmReceiverTestCase::STATUS_TRUNCATED),
+               TestCase::QUICK);
+}
+
+static LteRlcAmReceiverTestSuite lteRlcAmReceiverTestSuite;
+
+
+LteRlcAmReceiverTestCase::LteRlcAmReceiverTestCase (std::string name, Scenario scenario)
+  : TestCase (name),
+    m_scenario (scenario),
+    m_mac (0),
+    m_pdcp (0)
+{
+}
+
+LteRlcAmReceiverTestCase::~LteRlcAmReceiverTestCase ()
+{
+}
+
+void
+LteRlcAmReceiverTestCase::DoRun (void)
+{
+  m_mac = new LteRlcAmReceiverTestMac ();
+  m_pdcp = new LteRlcAmReceiverTestPdcp ();
+  m_rlc = CreateObject<LteRlcAm> ();
+  m_rlc->SetRnti (1);
+  m_rlc->SetLcId (1);
+  m_rlc->SetLteMacSapProvider (m_mac);
+  m_rlc->SetLteRlcSapUser (m_pdcp);
+
+  if (m_scenario == RING_WRAPAROUND)
+    {
+      RunRingWraparound ();
+    }
+  else
+    {
+      RunStatus ();
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_rlc->Dispose ();
+  m_rlc = 0;
+  delete m_mac;
+  delete m_pdcp;
+}
+
+void
+LteRlcAmReceiverTestCase::ReceivePdu (uint16_t sn, bool poll)
+{
+  Ptr<Packet> p = Create<Packet> (10);
+
+  LteRlcAmHeader rlcAmHeader;
+  rlcAmHeader.SetDataPdu ();
+  rlcAmHeader.SetSequenceNumber (SequenceNumber10 (sn % 1024));
+  rlcAmHeader.SetResegmentationFlag (LteRlcAmHeader::PDU);
+  rlcAmHeader.SetPollingBit (poll ? LteRlcAmHeader::STATUS_REPORT_IS_REQUESTED
+                                  : LteRlcAmHeader::STATUS_REPORT_NOT_REQUESTED);
+  rlcAmHeader.SetFramingInfo (LteRlcAmHeader::FIRST_BYTE | LteRlcAmHeader::LAST_BYTE);
+  rlcAmHeader.SetLastSegmentFlag (LteRlcAmHeader::LAST_PDU_SEGMENT);
+  rlcAmHeader.SetSegmentOffset (0);
+  rlcAmHeader.PushExtensionBit (LteRlcAmHeader::DATA_FIELD_FOLLOWS);
+  p->AddHeader (rlcAmHeader);
+
+  RlcTag rlcTag (Simulator::Now ());
+  p->AddByteTag (rlcTag, 1, rlcAmHeader.GetSerializedSize ());
+
+  LteMacSapUser::ReceivePduParameters params;
+  params.p = p;
+  params.rnti = 1;
+  params.lcid = 1;
+  m_rlc->GetLteMacSapUser ()->ReceivePdu (params);
+}
+
+void
+LteRlcAmReceiverTestCase::CheckState (uint16_t vrR, uint16_t vrMs, uint16_t vrH, std::string msg)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_rlc->m_vrR.GetValue (), vrR, "wrong VR(R) " << msg);
+  NS_TEST_ASSERT_MSG_EQ (m_rlc->m_vrMs.GetValue (), vrMs, "wrong VR(MS) " << msg);
+  NS_TEST_ASSERT_MSG_EQ (m_rlc->m_vrH.GetValue (), vrH, "wrong VR(H) " << msg);
+}
+
+void
+LteRlcAmReceiverTestCase::CheckStatusPdu (uint32_t bytes, uint16_t ackSn, std::vector<uint16_t> nacks)
+{
+  // every hole below VR(MS) is reported to the MAC in one go
+  m_rlc->DoReportBufferStatus ();
+  NS_TEST_ASSERT_MSG_EQ (m_mac->m_statusPduSize, 8, "wrong STATUS PDU size reported");
+
+  LteMacSapUser::TxOpportunityParameters params;
+  params.bytes = bytes;
+  params.layer = 0;
+  params.harqId = 0;
+  params.componentCarrierId = 0;
+  params.rnti = 1;
+  params.lcid = 1;
+  m_rlc->GetLteMacSapUser ()->NotifyTxOpportunity (params);
+
+  NS_TEST_ASSERT_MSG_EQ (m_mac->m_pdus.size (), 1, "no STATUS PDU sent");
+  Ptr<Packet> pdu = m_mac->m_pdus.back ();
+  NS_TEST_ASSERT_MSG_EQ (pdu->GetSize (), std::min<uint32_t> (bytes, 8), "wrong STATUS PDU size");
+
+  LteRlcAmHeader rlcAmHeader;
+  pdu->RemoveHeader (rlcAmHeader);
+  NS_TEST_ASSERT_MSG_EQ (rlcAmHeader.IsControlPdu (), true, "not a STATUS PDU");
+  NS_TEST_ASSERT_MSG_EQ (rlcAmHeader.GetAckSn ().GetValue (), ackSn, "wrong ACK_SN");
+  for (std::vector<uint16_t>::const_iterator it = nacks.begin (); it != nacks.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (rlcAmHeader.PopNack (), *it, "wrong NACK_SN");
+    }
+  NS_TEST_ASSERT_MSG_EQ (rlcAmHeader.PopNack (), -1, "unexpected NACK_SN");
+}
+
+void
+LteRlcAmReceiverTestCase::RunRingWraparound (void)
+{
+  for (uint16_t sn = 0; sn < 1022; sn++)
+    {
+      ReceivePdu (sn, false);
+    }
+  CheckState (1022, 1022, 1022, "after in-sequence PDUs");
+  NS_TEST_ASSERT_MSG_EQ (m_pdcp->m_sdus, 1022, "SDUs not delivered in sequence");
+
+  // SN 1023 and 1024 (= 0) arrive before SN 1022
+  ReceivePdu (1023, false);
+  CheckState (1022, 1022, 0, "after SN 1023");
+  ReceivePdu (1024, false);
+  CheckState (1022, 1022, 1, "after SN 0");
+  NS_TEST_ASSERT_MSG_EQ (m_pdcp->m_sdus, 1022, "SDUs delivered across a hole");
+
+  ReceivePdu (1022, false);
+  CheckState (1, 1, 1, "after the hole is filled");
+  NS_TEST_ASSERT_MSG_EQ (m_pdcp->m_sdus, 1025, "SDUs not delivered across the wraparound");
+
+  for (uint16_t sn = 1025; sn < 1524; sn++)
+    {
+      ReceivePdu (sn, false);
+    }
+  CheckState (500, 500, 500, "after the second lap");
+  NS_TEST_ASSERT_MSG_EQ (m_pdcp->m_sdus, 1524, "SDUs not delivered in the second lap");
+
+  uint32_t buffered = 0;
+  for (uint16_t i = 0; i < m_rlc->m_rxonBuffer.size (); i++)
+    {
+      if (m_rlc->m_rxonBuffer[i].m_pdu != 0 || m_rlc->m_rxonBuffer[i].m_pduComplete)
+        {
+          buffered++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffered, 0, "delivered PDUs left in the reception buffer");
+}
+
+void
+LteRlcAmReceiverTestCase::RunStatus (void)
+{
+  ReceivePdu (0, false);
+  ReceivePdu (1, false);
+  CheckState (2, 2, 2, "after in-sequence PDUs");
+  ReceivePdu (3, false);
+  CheckState (2, 2, 4, "after SN 3");
+  ReceivePdu (5, false);
+  ReceivePdu (6, false);
+  ReceivePdu (9, true);
+  CheckState (2, 2, 10, "after SN 9");
+  NS_TEST_ASSERT_MSG_EQ (m_pdcp->m_sdus, 2, "SDUs delivered across a hole");
+
+  // t-Reordering expires twice (VR(MS) = 4, then VR(MS) = 10) before the
+  // STATUS PDU is sent
+  Simulator::Schedule (MilliSeconds (50), &LteRlcAmReceiverTestCase::CheckState, this,
+                       2, 10, 10, "after t-Reordering");
+
+  std::vector<uint16_t> nacks;
+  nacks.push_back (2);
+  nacks.push_back (4);
+  if (m_scenario == STATUS_FULL)
+    {
+      nacks.push_back (7);
+      nacks.push_back (8);
+      Simulator::Schedule (MilliSeconds (50), &LteRlcAmReceiverTestCase::CheckStatusPdu, this,
+                           100, 10, nacks);
+    }
+  else
+    {
+      // only two NACKs fit in 5 bytes: ACK_SN is the first SN not reported
+      Simulator::Schedule (MilliSeconds (50), &LteRlcAmReceiverTestCase::CheckStatusPdu, this,
+                           5, 7, nacks);
+    }
+}
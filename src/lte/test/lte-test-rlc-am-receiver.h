@@ -0,0 +1,119 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_TEST_RLC_AM_RECEIVER_H
+#define LTE_TEST_RLC_AM_RECEIVER_H
+
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+
+#include <vector>
+
+
+namespace ns3 {
+
+class Packet;
+class LteRlcAm;
+class LteRlcAmReceiverTestMac;
+class LteRlcAmReceiverTestPdcp;
+
+}
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief TestSuite RLC AM: Only receiver functionality.
+ */
+class LteRlcAmReceiverTestSuite : public TestSuite
+{
+  public:
+    LteRlcAmReceiverTestSuite ();
+};
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Feed AMD PDUs straight into the MAC SAP of an RLC AM entity and
+ * check its reception buffer, the receiver state variables and the
+ * STATUS PDUs it sends back.
+ */
+class LteRlcAmReceiverTestCase : public TestCase
+{
+  public:
+    /// Scenario enumeration
+    enum Scenario
+    {
+      RING_WRAPAROUND,   ///< in-sequence PDUs and a hole across SN 1023 -> 0
+      STATUS_FULL,       ///< one STATUS PDU reports every hole
+      STATUS_TRUNCATED   ///< the grant only fits part of the NACKs
+    };
+
+    /**
+     * Constructor
+     *
+     * \param name the reference name
+     * \param scenario the scenario to run
+     */
+    LteRlcAmReceiverTestCase (std::string name, Scenario scenario);
+    virtual ~LteRlcAmReceiverTestCase ();
+
+  private:
+    virtual void DoRun (void);
+
+    /**
+     * Receive an AMD PDU carrying one whole SDU
+     *
+     * \param sn the SN of the AMD PDU
+     * \param poll whether the polling bit is set
+     */
+    void ReceivePdu (uint16_t sn, bool poll);
+
+    /**
+     * Check VR(R), VR(MS) and VR(H)
+     *
+     * \param vrR expected VR(R)
+     * \param vrMs expected VR(MS)
+     * \param vrH expected VR(H)
+     * \param msg the assert message
+     */
+    void CheckState (uint16_t vrR, uint16_t vrMs, uint16_t vrH, std::string msg);
+
+    /**
+     * Give a transmission opportunity to the RLC entity and check the
+     * STATUS PDU it sends
+     *
+     * \param bytes the size of the transmission opportunity
+     * \param ackSn expected ACK_SN
+     * \param nacks expected NACK_SNs
+     */
+    void CheckStatusPdu (uint32_t bytes, uint16_t ackSn, std::vector<uint16_t> nacks);
+
+    /// Run the RING_WRAPAROUND scenario
+    void RunRingWraparound (void);
+    /// Run the STATUS_FULL and STATUS_TRUNCATED scenarios
+    void RunStatus (void);
+
+    Scenario m_scenario; ///< the scenario
+    Ptr<LteRlcAm> m_rlc; ///< the RLC AM entity under test
+    LteRlcAmReceiverTestMac *m_mac; ///< the MAC below the RLC
+    LteRlcAmReceiverTestPdcp *m_pdcp; ///< the PDCP above the RLC
+};
+
+#endif // LTE_TEST_RLC_AM_RECEIVER_H
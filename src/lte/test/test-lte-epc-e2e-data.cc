@@ -40,6 +40,7 @@
 #include "ns3/double.h"
 #include "ns3/abort.h"
 #include "ns3/mobility-helper.h"
+#include "ns3/epc-fast-path.h"
 
 
 
@@ -113,19 +114,32 @@ public:
    *
    * \param name the reference name
    * \param v the ENB test data
+   * \param fastPath whether the user plane uses the EPC fast path
    */
-  LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v);
+  LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v, bool fastPath = false);
   virtual ~LteEpcE2eDataTestCase ();
 
 private:
   virtual void DoRun (void);
+  /**
+   * Count the packets sent through the fast path
+   *
+   * \param packet the packet
+   * \param teid the TEID of the bearer
+   */
+  void FastPathTx (Ptr<const Packet> packet, uint32_t teid);
+
   std::vector<EnbTestData> m_enbTestData; ///< the ENB test data
+  bool m_fastPath; ///< whether the user plane uses the EPC fast path
+  uint32_t m_fastPathTxPkts; ///< number of packets sent through the fast path
 };
 
 
-LteEpcE2eDataTestCase::LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v)
+LteEpcE2eDataTestCase::LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v, bool fastPath)
   : TestCase (name),
-    m_enbTestData (v)
+    m_enbTestData (v),
+    m_fastPath (fastPath),
+    m_fastPathTxPkts (0)
 {
   NS_LOG_FUNCTION (this << name);
 }
@@ -134,6 +148,12 @@ LteEpcE2eDataTestCase::~LteEpcE2eDataTestCase ()
 {
 }
 
+void
+LteEpcE2eDataTestCase::FastPathTx (Ptr<const Packet> packet, uint32_t teid)
+{
+  ++m_fastPathTxPkts;
+}
+
 void 
 LteEpcE2eDataTestCase::DoRun ()
 {
@@ -142,10 +162,20 @@ LteEpcE2eDataTestCase::DoRun ()
   Config::SetDefault ("ns3::LteSpectrumPhy::CtrlErrorModelEnabled", BooleanValue (false));
   Config::SetDefault ("ns3::LteSpectrumPhy::DataErrorModelEnabled", BooleanValue (false));  
   Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+  Config::SetDefault ("ns3::NoBackhaulEpcHelper::FastPath", BooleanValue (m_fastPath));
   Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
   Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
   lteHelper->SetEpcHelper (epcHelper);
 
+  m_fastPathTxPkts = 0;
+  if (m_fastPath)
+    {
+      Ptr<EpcFastPath> fastPath = epcHelper->GetFastPath ();
+      NS_ABORT_MSG_IF (fastPath == 0, "fast path not created");
+      fastPath->TraceConnectWithoutContext ("UlTx", MakeCallback (&LteEpcE2eDataTestCase::FastPathTx, this));
+      fastPath->TraceConnectWithoutContext ("DlTx", MakeCallback (&LteEpcE2eDataTestCase::FastPathTx, this));
+    }
+
   lteHelper->SetAttribute("PathlossModel",
                           StringValue("ns3::FriisPropagationLossModel"));
 
@@ -312,6 +342,7 @@ LteEpcE2eDataTestCase::DoRun ()
   Simulator::Run ();
 
   uint64_t imsiCounter = 0;
+  uint32_t totalPkts = 0;
 
   for (std::vector<EnbTestData>::iterator enbit = m_enbTestData.begin ();
        enbit < m_enbTestData.end ();
@@ -328,6 +359,7 @@ LteEpcE2eDataTestCase::DoRun ()
               // LCID 3 is (at the moment) the Default EPS bearer, and is unused in this test program
               uint8_t lcid = b+4;
               uint32_t expectedPkts = ueit->bearers.at (b).numPkts;
+              totalPkts += 2 * expectedPkts;
               uint32_t expectedBytes = (ueit->bearers.at (b).numPkts) * (ueit->bearers.at (b).pktSize);
               uint32_t txPktsPdcpDl = lteHelper->GetPdcpStats ()->GetDlTxPackets (imsi, lcid);
               uint32_t rxPktsPdcpDl = lteHelper->GetPdcpStats ()->GetDlRxPackets (imsi, lcid);
@@ -360,6 +392,11 @@ LteEpcE2eDataTestCase::DoRun ()
             }
         }      
     }
+
+  if (m_fastPath)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_fastPathTxPkts, totalPkts, "wrong number of packets through the fast path");
+    }
   
   Simulator::Destroy ();
 }
@@ -392,6 +429,7 @@ LteEpcE2eDataTestSuite::LteEpcE2eDataTestSuite ()
   e1.ues.push_back (u1);
   v1.push_back (e1);
   AddTestCase (new LteEpcE2eDataTestCase ("1 eNB, 1UE", v1), TestCase::QUICK);
+  AddTestCase (new LteEpcE2eDataTestCase ("1 eNB, 1UE, fast path", v1, true), TestCase::QUICK);
 
   std::vector<EnbTestData> v2;  
   EnbTestData e2;
@@ -459,6 +497,7 @@ LteEpcE2eDataTestSuite::LteEpcE2eDataTestSuite ()
   std::vector<EnbTestData> v7;
   v7.push_back (e7);
   AddTestCase (new LteEpcE2eDataTestCase ("1 eNB, 1UE with 2 bearers", v7), TestCase::EXTENSIVE);
+  AddTestCase (new LteEpcE2eDataTestCase ("1 eNB, 1UE with 2 bearers, fast path", v7, true), TestCase::EXTENSIVE);
 
   EnbTestData e8;
   UeTestData u8;
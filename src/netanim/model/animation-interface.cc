@@ -33,6 +33,7 @@
 #include <string>
 #include <iomanip>
 #include <map>
+#include <cstring>
 
 // ns3 includes
 #include "ns3/animation-interface.h"
@@ -58,6 +59,7 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/energy-source-container.h"
+#include "ns3/async-stream-buffer.h"
 #include "animation-interface.h"
 
 namespace ns3 {
@@ -68,10 +70,208 @@ NS_LOG_COMPONENT_DEFINE ("AnimationInterface");
 
 static bool initialized = false; //!< Initialization flag
 
+namespace {
+
+const char BINARY_MAGIC[8] = "NS3ANIM"; //!< the magic string of binary traces, with its terminating null
+const uint8_t BINARY_VERSION = 1;        //!< the version of the binary format
+const uint32_t BINARY_BLOCK_SIZE = 1 << 16; //!< the size of the blocks handed to the writer thread
+const uint32_t BINARY_MAX_BLOCKS = 16;   //!< the maximum number of blocks of a binary trace
+
+/// The records of a binary trace
+enum BinaryRecordType
+{
+  BINARY_TEXT = 0,     //!< XML written as is: the length then the characters
+  BINARY_PREF,         //!< pr element: uid, fId, fbTx, meta-info
+  BINARY_PRX,          //!< reception of a wireless packet: uid, type, tId, fbRx, lbRx
+  BINARY_P,            //!< wired packet: type, fId, fbTx, lbTx, tId, fbRx, lbRx, meta-info
+  BINARY_POSITION,     //!< nu element of a position: t, id, x, y
+  BINARY_COUNTER       //!< nc element: c, i, t, v
+};
+
+/**
+ * \brief Append an integer as a variable-length integer, 7 bits per byte
+ * \param buffer the buffer
+ * \param value the integer
+ */
+void
+PutVarint (std::vector<uint8_t> &buffer, uint64_t value)
+{
+  while (value >= 0x80)
+    {
+      buffer.push_back (static_cast<uint8_t> (value | 0x80));
+      value >>= 7;
+    }
+  buffer.push_back (static_cast<uint8_t> (value));
+}
+
+/**
+ * \brief Append the difference between two packet identifiers, small
+ * differences of both signs giving short integers
+ * \param buffer the buffer
+ * \param uid the identifier
+ * \param last the previous identifier, updated
+ */
+void
+PutUid (std::vector<uint8_t> &buffer, uint64_t uid, uint64_t &last)
+{
+  int64_t delta = static_cast<int64_t> (uid - last);
+  PutVarint (buffer, (static_cast<uint64_t> (delta) << 1) ^ static_cast<uint64_t> (delta >> 63));
+  last = uid;
+}
+
+/**
+ * \brief Append a double, bit for bit in little-endian order, so that
+ * the XML converted from the record is the one written directly
+ * \param buffer the buffer
+ * \param value the double
+ */
+void
+PutDouble (std::vector<uint8_t> &buffer, double value)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      buffer.push_back (static_cast<uint8_t> (bits >> (8 * i)));
+    }
+}
+
+/**
+ * \brief Append a string: its length then its characters
+ * \param buffer the buffer
+ * \param value the string
+ */
+void
+PutString (std::vector<uint8_t> &buffer, const std::string &value)
+{
+  PutVarint (buffer, value.size ());
+  buffer.insert (buffer.end (), value.begin (), value.end ());
+}
+
+/// A cursor over the records of a binary trace being converted
+class BinaryReader
+{
+public:
+  /**
+   * Constructor
+   * \param in the binary trace
+   */
+  BinaryReader (std::istream &in)
+    : m_in (in.rdbuf ()),
+      m_uid (0),
+      m_fail (in.rdbuf () == 0)
+  {
+  }
+
+  /**
+   * \param byte the next byte
+   * \return false at the end of the trace
+   */
+  bool GetByte (uint8_t &byte)
+  {
+    if (m_fail)
+      {
+        return false;
+      }
+    std::streambuf::int_type c = m_in->sbumpc ();
+    if (std::streambuf::traits_type::eq_int_type (c, std::streambuf::traits_type::eof ()))
+      {
+        return false;
+      }
+    byte = static_cast<uint8_t> (c);
+    return true;
+  }
+
+  /**
+   * \return the next variable-length integer
+   */
+  uint64_t GetVarint (void)
+  {
+    uint64_t value = 0;
+    uint8_t byte;
+    for (uint32_t shift = 0; shift < 64 && GetByte (byte); shift += 7)
+      {
+        value |= static_cast<uint64_t> (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+          {
+            return value;
+          }
+      }
+    m_fail = true;
+    return 0;
+  }
+
+  /**
+   * \return the next packet identifier
+   */
+  uint64_t GetUid (void)
+  {
+    uint64_t value = GetVarint ();
+    m_uid += static_cast<uint64_t> (static_cast<int64_t> (value >> 1) ^ -static_cast<int64_t> (value & 1));
+    return m_uid;
+  }
+
+  /**
+   * \return the next double
+   */
+  double GetDouble (void)
+  {
+    uint64_t bits = 0;
+    uint8_t byte;
+    for (uint32_t i = 0; i < 8; i++)
+      {
+        if (!GetByte (byte))
+          {
+            m_fail = true;
+            return 0;
+          }
+        bits |= static_cast<uint64_t> (byte) << (8 * i);
+      }
+    double value;
+    std::memcpy (&value, &bits, sizeof (value));
+    return value;
+  }
+
+  /**
+   * \return the next string
+   */
+  std::string GetString (void)
+  {
+    uint64_t size = GetVarint ();
+    std::string value;
+    uint8_t byte;
+    for (uint64_t i = 0; i < size; i++)
+      {
+        if (!GetByte (byte))
+          {
+            m_fail = true;
+            return "";
+          }
+        value += static_cast<char> (byte);
+      }
+    return value;
+  }
+
+  /**
+   * \return true if reading past the end was attempted
+   */
+  bool Fail (void) const
+  {
+    return m_fail;
+  }
+
+private:
+  std::streambuf *m_in; //!< the binary trace
+  uint64_t m_uid;       //!< the last packet identifier read
+  bool m_fail;          //!< whether reading past the end was attempted
+};
+
+} // anonymous namespace
+
 
 // Public methods
 
-AnimationInterface::AnimationInterface (const std::string fn)
+AnimationInterface::AnimationInterface (const std::string fn, OutputFormat format)
   : m_f (0),
     m_routingF (0),
     m_mobilityPollInterval (Seconds (0.25)), 
@@ -87,7 +287,13 @@ AnimationInterface::AnimationInterface (const std::string fn)
     m_routingStopTime (Seconds (0)), 
     m_routingFileName (""),
     m_routingPollInterval (Seconds (5)), 
-    m_trackPackets (true)
+    m_trackPackets (true),
+    m_format (format),
+    m_binaryBuffer (0),
+    m_binaryUid (0),
+    m_positionQuantum (1),
+    m_packetSampling (1),
+    m_sampledPackets (0)
 {
   initialized = true;
   StartAnimation ();
@@ -291,6 +497,124 @@ AnimationInterface::SetMobilityPollInterval (Time t)
   m_mobilityPollInterval = t;
 }
 
+void
+AnimationInterface::SetPositionQuantum (double quantum)
+{
+  NS_ASSERT_MSG (quantum > 0, "The position quantum must be positive");
+  m_positionQuantum = quantum;
+}
+
+void
+AnimationInterface::SetPacketSampling (uint32_t n)
+{
+  NS_ASSERT_MSG (n > 0, "The packet sampling period must be positive");
+  m_packetSampling = n;
+  m_sampledPackets = 0;
+}
+
+void
+AnimationInterface::SetNodeFilter (NodeContainer nodes)
+{
+  m_nodeFilter.clear ();
+  for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+    {
+      m_nodeFilter.insert ((*i)->GetId ());
+    }
+}
+
+bool
+AnimationInterface::ConvertBinaryToXml (std::istream &in, std::ostream &out)
+{
+  BinaryReader reader (in);
+  uint8_t byte;
+  for (uint32_t i = 0; i < sizeof (BINARY_MAGIC); i++)
+    {
+      if (!reader.GetByte (byte) || byte != static_cast<uint8_t> (BINARY_MAGIC[i]))
+        {
+          NS_LOG_WARN ("Not a binary animation trace");
+          return false;
+        }
+    }
+  if (!reader.GetByte (byte) || byte != BINARY_VERSION)
+    {
+      NS_LOG_WARN ("Unsupported version of the binary animation trace");
+      return false;
+    }
+
+  uint8_t type;
+  while (reader.GetByte (type))
+    {
+      switch (type)
+        {
+        case BINARY_TEXT:
+          {
+            std::string text = reader.GetString ();
+            out << text;
+            break;
+          }
+        case BINARY_PREF:
+          {
+            uint64_t uid = reader.GetUid ();
+            uint32_t fId = reader.GetVarint ();
+            double fbTx = reader.GetDouble ();
+            std::string metaInfo = reader.GetString ();
+            out << GetXmlPRef (uid, fId, fbTx, metaInfo);
+            break;
+          }
+        case BINARY_PRX:
+          {
+            uint64_t uid = reader.GetUid ();
+            std::string pktType = reader.GetString ();
+            uint32_t tId = reader.GetVarint ();
+            double fbRx = reader.GetDouble ();
+            double lbRx = reader.GetDouble ();
+            out << GetXmlP (uid, pktType, tId, fbRx, lbRx);
+            break;
+          }
+        case BINARY_P:
+          {
+            std::string pktType = reader.GetString ();
+            uint32_t fId = reader.GetVarint ();
+            double fbTx = reader.GetDouble ();
+            double lbTx = reader.GetDouble ();
+            uint32_t tId = reader.GetVarint ();
+            double fbRx = reader.GetDouble ();
+            double lbRx = reader.GetDouble ();
+            std::string metaInfo = reader.GetString ();
+            out << GetXmlP (pktType, fId, fbTx, lbTx, tId, fbRx, lbRx, metaInfo);
+            break;
+          }
+        case BINARY_POSITION:
+          {
+            double t = reader.GetDouble ();
+            uint32_t id = reader.GetVarint ();
+            double x = reader.GetDouble ();
+            double y = reader.GetDouble ();
+            out << GetXmlUpdateNodePosition (t, id, x, y);
+            break;
+          }
+        case BINARY_COUNTER:
+          {
+            uint32_t c = reader.GetVarint ();
+            uint32_t i = reader.GetVarint ();
+            double t = reader.GetDouble ();
+            double v = reader.GetDouble ();
+            out << GetXmlUpdateNodeCounter (c, i, t, v);
+            break;
+          }
+        default:
+          NS_LOG_WARN ("Unknown record " << (uint32_t) type << " in the binary animation trace");
+          return false;
+        }
+      if (reader.Fail ())
+        {
+          NS_LOG_WARN ("Truncated binary animation trace");
+          return false;
+        }
+    }
+  return out.good ();
+}
+
 
 void 
 AnimationInterface::SetConstantPosition (Ptr <Node> n, double x, double y, double z)
@@ -326,6 +650,10 @@ AnimationInterface::UpdateNodeCounter (uint32_t nodeCounterId, uint32_t nodeId,
     {
       NS_FATAL_ERROR ("NodeCounter Id:" << nodeCounterId << " not found. Did you use AddNodeCounter?");
     }
+  if (!IsNodeTraced (nodeId))
+    {
+      return;
+    }
   WriteXmlUpdateNodeCounter (nodeCounterId, nodeId, counter);
 }
 
@@ -420,16 +748,21 @@ AnimationInterface::MobilityCourseChangeTrace (Ptr <const MobilityModel> mobilit
       v = mobility->GetPosition ();
     }
   UpdatePosition (n, v);
-  WriteXmlUpdateNodePosition (n->GetId (), v.x, v.y);
+  m_polledNodeLocation[n->GetId ()] = v;
+  if (IsNodeTraced (n->GetId ()))
+    {
+      WriteXmlUpdateNodePosition (n->GetId (), v.x, v.y);
+    }
 }
 
 bool 
 AnimationInterface::NodeHasMoved (Ptr <Node> n, Vector newLocation)
 {
-  Vector oldLocation = GetPosition (n);
+  std::map <uint32_t, Vector>::const_iterator polled = m_polledNodeLocation.find (n->GetId ());
+  Vector oldLocation = polled != m_polledNodeLocation.end () ? polled->second : GetPosition (n);
   bool moved = true;
-  if ((ceil (oldLocation.x) == ceil (newLocation.x)) &&
-    (ceil (oldLocation.y) == ceil (newLocation.y)))
+  if ((ceil (oldLocation.x / m_positionQuantum) == ceil (newLocation.x / m_positionQuantum)) &&
+    (ceil (oldLocation.y / m_positionQuantum) == ceil (newLocation.y / m_positionQuantum)))
     {
       moved = false;
     }
@@ -449,6 +782,10 @@ AnimationInterface::MobilityAutoCheck ()
     {
       Ptr <Node> n = MovedNodes [i];
       NS_ASSERT (n);
+      if (!IsNodeTraced (n->GetId ()))
+        {
+          continue;
+        }
       Vector v = GetPosition (n);
       WriteXmlUpdateNodePosition (n->GetId () , v.x, v.y);
     }
@@ -489,6 +826,7 @@ AnimationInterface::GetMovedNodes ()
       else
         {
           UpdatePosition (n, newLocation);
+          m_polledNodeLocation[n->GetId ()] = newLocation;
           movedNodes.push_back (n);
         }
     }
@@ -509,6 +847,46 @@ AnimationInterface::WriteN (const std::string& st, FILE * f)
   return WriteN (st.c_str (), st.length (), f);
 }
 
+int
+AnimationInterface::WriteN (const std::string& st)
+{
+  if (!m_binaryBuffer)
+    {
+      return WriteN (st, m_f);
+    }
+  if (m_writeCallback)
+    {
+      m_writeCallback (st.c_str ());
+    }
+  m_record.clear ();
+  m_record.push_back (BINARY_TEXT);
+  PutString (m_record, st);
+  return WriteRecord ();
+}
+
+int
+AnimationInterface::WriteRecord ()
+{
+  NS_ASSERT (m_binaryBuffer);
+  return m_binaryBuffer->sputn (reinterpret_cast<const char *> (&m_record[0]), m_record.size ());
+}
+
+bool
+AnimationInterface::IsNodeTraced (uint32_t nodeId) const
+{
+  return m_nodeFilter.empty () || m_nodeFilter.find (nodeId) != m_nodeFilter.end ();
+}
+
+bool
+AnimationInterface::IsPacketSampled (uint32_t nodeId)
+{
+  if (!IsNodeTraced (nodeId))
+    {
+      return false;
+    }
+  return m_sampledPackets++ % m_packetSampling == 0;
+}
+
 int 
 AnimationInterface::WriteN (const char* data, uint32_t count, FILE * f)
 { 
@@ -791,6 +1169,10 @@ AnimationInterface::DevTxTrace (std::string context,
   double lbTx = (now + txTime).GetSeconds ();
   double fbRx = (now + rxTime - txTime).GetSeconds ();
   double lbRx = (now + rxTime).GetSeconds ();
+  if (!IsPacketSampled (tx->GetNode ()->GetId ()))
+    {
+      return;
+    }
   CheckMaxPktsPerTraceFile ();
   WriteXmlP ("p", 
              tx->GetNode ()->GetId (), 
@@ -810,6 +1192,12 @@ AnimationInterface::GenericWirelessTxTrace (std::string context, Ptr<const Packe
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
   UpdatePosition (ndev);
+  if (!IsPacketSampled (ndev->GetNode ()->GetId ()))
+    {
+      // hide the UID of a previous hop from the receivers
+      AddByteTag (0, p);
+      return;
+    }
 
   ++gAnimUid;
   NS_LOG_INFO (ProtocolTypeToString (protocolType).c_str () << " GenericWirelessTxTrace for packet:" << gAnimUid);
@@ -882,6 +1270,11 @@ AnimationInterface::WifiPhyRxBeginTrace (std::string context, Ptr<const Packet>
   NS_ASSERT (ndev);
   UpdatePosition (ndev);
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (IsPacketUnsampled (animUid, AnimationInterface::WIFI))
+    {
+      // the transmission was not sampled
+      return;
+    }
   NS_LOG_INFO ("Wifi RxBeginTrace for packet: " << animUid);
   if (!IsPacketPending (animUid, AnimationInterface::WIFI))
     {
@@ -952,6 +1345,12 @@ AnimationInterface::LrWpanPhyTxBeginTrace (std::string context,
   m_macToNodeIdMap[oss.str ()] = n->GetId ();
   NS_LOG_INFO ("Added Mac" << oss.str () << " node:" <<m_macToNodeIdMap[oss.str ()]);
 
+  if (!IsPacketSampled (n->GetId ()))
+    {
+      // hide the UID of a previous hop from the receivers
+      AddByteTag (0, p);
+      return;
+    }
   ++gAnimUid;
   NS_LOG_INFO ("LrWpan TxBeginTrace for packet:" << gAnimUid);
   AddByteTag (gAnimUid, p);
@@ -980,6 +1379,11 @@ AnimationInterface::LrWpanPhyRxBeginTrace (std::string context,
     }
 
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (IsPacketUnsampled (animUid, AnimationInterface::LRWPAN))
+    {
+      // the transmission was not sampled
+      return;
+    }
   NS_LOG_INFO ("LrWpan RxBeginTrace for packet:" << animUid);
   if (!IsPacketPending (animUid, AnimationInterface::LRWPAN))
     {
@@ -1007,6 +1411,11 @@ AnimationInterface::WavePhyRxBeginTrace (std::string context, Ptr<const Packet>
   NS_ASSERT (ndev);
   UpdatePosition (ndev);
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (IsPacketUnsampled (animUid, AnimationInterface::WAVE))
+    {
+      // the transmission was not sampled
+      return;
+    }
   NS_LOG_INFO ("Wave RxBeginTrace for packet:" << animUid);
   if (!IsPacketPending (animUid, AnimationInterface::WAVE))
     {
@@ -1086,6 +1495,12 @@ AnimationInterface::LteSpectrumPhyTxStart (std::string context, Ptr<const Packet
        ++i)
     {
       Ptr <Packet> p = *i;
+      if (!IsPacketSampled (ndev->GetNode ()->GetId ()))
+        {
+          // hide the UID of a previous hop from the receivers
+          AddByteTag (0, p);
+          continue;
+        }
       ++gAnimUid;
       NS_LOG_INFO ("LteSpectrumPhyTxTrace for packet:" << gAnimUid);
       AnimPacketInfo pktInfo (ndev, Simulator::Now ());
@@ -1121,7 +1536,7 @@ AnimationInterface::LteSpectrumPhyRxStart (std::string context, Ptr<const Packet
       if (!IsPacketPending (animUid, AnimationInterface::LTE))
         {
           NS_LOG_WARN ("LteSpectrumPhyRxTrace: unknown Uid");
-          return;
+          continue;
         }
       AnimPacketInfo& pktInfo = m_pendingLtePackets[animUid];
       pktInfo.ProcessRxBegin (ndev, Simulator::Now ().GetSeconds ());
@@ -1137,6 +1552,12 @@ AnimationInterface::CsmaPhyTxBeginTrace (std::string context, Ptr<const Packet>
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
   UpdatePosition (ndev);
+  if (!IsPacketSampled (ndev->GetNode ()->GetId ()))
+    {
+      // hide the UID of a previous hop from the receivers
+      AddByteTag (0, p);
+      return;
+    }
   ++gAnimUid;
   NS_LOG_INFO ("CsmaPhyTxBeginTrace for packet:" << gAnimUid);
   AddByteTag (gAnimUid, p);
@@ -1156,6 +1577,11 @@ AnimationInterface::CsmaPhyTxEndTrace (std::string context, Ptr<const Packet> p)
   NS_ASSERT (ndev);
   UpdatePosition (ndev);
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (IsPacketUnsampled (animUid, AnimationInterface::CSMA))
+    {
+      // the transmission was not sampled
+      return;
+    }
   NS_LOG_INFO ("CsmaPhyTxEndTrace for packet:" << animUid);
   if (!IsPacketPending (animUid, AnimationInterface::CSMA))
     {
@@ -1270,6 +1696,16 @@ AnimationInterface::IsPacketPending (uint64_t animUid, AnimationInterface::Proto
   return (pendingPackets->find (animUid) != pendingPackets->end ());
 }
 
+bool
+AnimationInterface::IsPacketUnsampled (uint64_t animUid, AnimationInterface::ProtocolType protocolType)
+{
+  if (m_packetSampling == 1 && m_nodeFilter.empty ())
+    {
+      return false;
+    }
+  return animUid == 0 || !IsPacketPending (animUid, protocolType);
+}
+
 void 
 AnimationInterface::PurgePendingPackets (AnimationInterface::ProtocolType protocolType)
 {
@@ -1442,6 +1878,17 @@ AnimationInterface::StopAnimation (bool onlyAnimation)
       std::fclose (m_f);
       m_f = 0;
     }
+  if (m_binaryBuffer)
+    {
+      WriteXmlClose ("anim");
+      if (!m_binaryBuffer->Flush ())
+        {
+          NS_LOG_WARN ("Unable to write the binary trace file " << m_outputFileName);
+        }
+      delete m_binaryBuffer;
+      m_binaryBuffer = 0;
+      m_binaryFile.close ();
+    }
   if (onlyAnimation)
     {
       return;
@@ -2060,7 +2507,7 @@ AnimationInterface::IsInTimeWindow ()
 void 
 AnimationInterface::SetOutputFile (const std::string& fn, bool routing)
 {
-  if (!routing && m_f)
+  if (!routing && (m_f || m_binaryBuffer))
     {
       return;
     }
@@ -2071,6 +2518,19 @@ AnimationInterface::SetOutputFile (const std::string& fn, bool routing)
     }
 
   NS_LOG_INFO ("Creating new trace file:" << fn.c_str ());
+  if (!routing && m_format == BINARY_FORMAT)
+    {
+      if (!m_binaryFile.open (fn.c_str (), std::ios::out | std::ios::binary | std::ios::trunc))
+        {
+          NS_FATAL_ERROR ("Unable to open output file:" << fn.c_str ());
+        }
+      m_binaryBuffer = new AsyncStreamBuffer (&m_binaryFile, BINARY_BLOCK_SIZE, BINARY_MAX_BLOCKS);
+      m_binaryBuffer->sputn (BINARY_MAGIC, sizeof (BINARY_MAGIC));
+      m_binaryBuffer->sputc (static_cast<char> (BINARY_VERSION));
+      m_binaryUid = 0;
+      m_outputFileName = fn;
+      return;
+    }
   FILE * f = 0;
   f = std::fopen (fn.c_str (), "w");
   if (!f)
@@ -2388,17 +2848,16 @@ AnimationInterface::WriteXmlAnim (bool routing)
 {
   AnimXmlElement element ("anim");
   element.AddAttribute ("ver", GetNetAnimVersion ());
-  FILE * f = m_f;
   if (!routing)
     {
       element.AddAttribute ("filetype", "animation");
+      WriteN (element.ToString (false) + ">\n");
     }
   else
     {
       element.AddAttribute ("filetype", "routing");
-      f = m_routingF;
+      WriteN (element.ToString (false) + ">\n", m_routingF);
     }
-  WriteN (element.ToString (false) + ">\n", f);
 }
 
 void 
@@ -2407,7 +2866,7 @@ AnimationInterface::WriteXmlClose (std::string name, bool routing)
   std::string closeString = "</" + name + ">\n"; 
   if (!routing)
     {
-      WriteN (closeString, m_f);
+      WriteN (closeString);
     }
   else
     {
@@ -2423,7 +2882,7 @@ AnimationInterface::WriteXmlNode (uint32_t id, uint32_t sysId, double locX, doub
   element.AddAttribute ("sysId", sysId);
   element.AddAttribute ("locX", locX);
   element.AddAttribute ("locY", locY);
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 void 
@@ -2434,7 +2893,7 @@ AnimationInterface::WriteXmlUpdateLink (uint32_t fromId, uint32_t toId, std::str
   element.AddAttribute ("fromId", fromId);
   element.AddAttribute ("toId", toId);
   element.AddAttribute ("ld", linkDescription, true);
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 void 
@@ -2463,7 +2922,7 @@ AnimationInterface::WriteXmlLink (uint32_t fromId, uint32_t toLp, uint32_t toId)
   element.AddAttribute ("fd", lprop.fromNodeDescription, true); 
   element.AddAttribute ("td", lprop.toNodeDescription, true); 
   element.AddAttribute ("ld", lprop.linkDescription, true); 
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 void
@@ -2479,7 +2938,7 @@ AnimationInterface::WriteXmlIpv4Addresses (uint32_t nodeId, std::vector<std::str
       valueElement.SetText (*i);
       element.AppendChild(valueElement);
     }
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 void
@@ -2495,7 +2954,7 @@ AnimationInterface::WriteXmlIpv6Addresses (uint32_t nodeId, std::vector<std::str
       valueElement.SetText (*i);
       element.AppendChild (valueElement);
     }
-  WriteN(element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 void 
@@ -2533,6 +2992,27 @@ AnimationInterface::WriteXmlRp (uint32_t nodeId, std::string destination, Ipv4Ro
 
 void 
 AnimationInterface::WriteXmlPRef (uint64_t animUid, uint32_t fId, double fbTx, std::string metaInfo)
+{
+  if (!m_binaryBuffer)
+    {
+      WriteN (GetXmlPRef (animUid, fId, fbTx, metaInfo));
+      return;
+    }
+  if (m_writeCallback)
+    {
+      m_writeCallback (GetXmlPRef (animUid, fId, fbTx, metaInfo).c_str ());
+    }
+  m_record.clear ();
+  m_record.push_back (BINARY_PREF);
+  PutUid (m_record, animUid, m_binaryUid);
+  PutVarint (m_record, fId);
+  PutDouble (m_record, fbTx);
+  PutString (m_record, metaInfo);
+  WriteRecord ();
+}
+
+std::string
+AnimationInterface::GetXmlPRef (uint64_t animUid, uint32_t fId, double fbTx, std::string metaInfo)
 {
   AnimXmlElement element ("pr");
   element.AddAttribute ("uId", animUid);
@@ -2542,23 +3022,71 @@ AnimationInterface::WriteXmlPRef (uint64_t animUid, uint32_t fId, double fbTx, s
     {
       element.AddAttribute ("meta-info", metaInfo.c_str (), true);
     }
-  WriteN (element.ToString (),  m_f);
+  return element.ToString ();
 }
 
 void 
 AnimationInterface::WriteXmlP (uint64_t animUid, std::string pktType, uint32_t tId, double fbRx, double lbRx)
+{
+  if (!m_binaryBuffer)
+    {
+      WriteN (GetXmlP (animUid, pktType, tId, fbRx, lbRx));
+      return;
+    }
+  if (m_writeCallback)
+    {
+      m_writeCallback (GetXmlP (animUid, pktType, tId, fbRx, lbRx).c_str ());
+    }
+  m_record.clear ();
+  m_record.push_back (BINARY_PRX);
+  PutUid (m_record, animUid, m_binaryUid);
+  PutString (m_record, pktType);
+  PutVarint (m_record, tId);
+  PutDouble (m_record, fbRx);
+  PutDouble (m_record, lbRx);
+  WriteRecord ();
+}
+
+std::string
+AnimationInterface::GetXmlP (uint64_t animUid, std::string pktType, uint32_t tId, double fbRx, double lbRx)
 {
   AnimXmlElement element (pktType);
   element.AddAttribute ("uId", animUid);
   element.AddAttribute ("tId", tId);
   element.AddAttribute ("fbRx", fbRx);
   element.AddAttribute ("lbRx", lbRx);
-  WriteN (element.ToString (),  m_f);
+  return element.ToString ();
 }
 
 void 
 AnimationInterface::WriteXmlP (std::string pktType, uint32_t fId, double fbTx, double lbTx, 
                                                    uint32_t tId, double fbRx, double lbRx, std::string metaInfo)
+{
+  if (!m_binaryBuffer)
+    {
+      WriteN (GetXmlP (pktType, fId, fbTx, lbTx, tId, fbRx, lbRx, metaInfo));
+      return;
+    }
+  if (m_writeCallback)
+    {
+      m_writeCallback (GetXmlP (pktType, fId, fbTx, lbTx, tId, fbRx, lbRx, metaInfo).c_str ());
+    }
+  m_record.clear ();
+  m_record.push_back (BINARY_P);
+  PutString (m_record, pktType);
+  PutVarint (m_record, fId);
+  PutDouble (m_record, fbTx);
+  PutDouble (m_record, lbTx);
+  PutVarint (m_record, tId);
+  PutDouble (m_record, fbRx);
+  PutDouble (m_record, lbRx);
+  PutString (m_record, metaInfo);
+  WriteRecord ();
+}
+
+std::string
+AnimationInterface::GetXmlP (std::string pktType, uint32_t fId, double fbTx, double lbTx,
+                             uint32_t tId, double fbRx, double lbRx, std::string metaInfo)
 {
   AnimXmlElement element (pktType);
   element.AddAttribute ("fId", fId);
@@ -2571,7 +3099,7 @@ AnimationInterface::WriteXmlP (std::string pktType, uint32_t fId, double fbTx, d
   element.AddAttribute ("tId", tId);
   element.AddAttribute ("fbRx", fbRx);
   element.AddAttribute ("lbRx", lbRx);
-  WriteN (element.ToString (),  m_f);
+  return element.ToString ();
 }
 
 void 
@@ -2581,7 +3109,7 @@ AnimationInterface::WriteXmlAddNodeCounter (uint32_t nodeCounterId, std::string
   element.AddAttribute ("ncId", nodeCounterId);
   element.AddAttribute ("n", counterName);
   element.AddAttribute ("t", CounterTypeToString (counterType));
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 void 
@@ -2590,7 +3118,7 @@ AnimationInterface::WriteXmlAddResource (uint32_t resourceId, std::string resour
   AnimXmlElement element ("res");
   element.AddAttribute ("rid", resourceId);
   element.AddAttribute ("p", resourcePath);
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 void 
@@ -2601,7 +3129,7 @@ AnimationInterface::WriteXmlUpdateNodeImage (uint32_t nodeId, uint32_t resourceI
   element.AddAttribute ("t", Simulator::Now ().GetSeconds ());
   element.AddAttribute ("id", nodeId);
   element.AddAttribute ("rid", resourceId);
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 void 
@@ -2613,19 +3141,41 @@ AnimationInterface::WriteXmlUpdateNodeSize (uint32_t nodeId, double width, doubl
   element.AddAttribute ("id", nodeId);
   element.AddAttribute ("w", width);
   element.AddAttribute ("h", height);
-  WriteN (element.ToString (),  m_f);
+  WriteN (element.ToString ());
 }
 
 void 
 AnimationInterface::WriteXmlUpdateNodePosition (uint32_t nodeId, double x, double y)
+{
+  double t = Simulator::Now ().GetSeconds ();
+  if (!m_binaryBuffer)
+    {
+      WriteN (GetXmlUpdateNodePosition (t, nodeId, x, y));
+      return;
+    }
+  if (m_writeCallback)
+    {
+      m_writeCallback (GetXmlUpdateNodePosition (t, nodeId, x, y).c_str ());
+    }
+  m_record.clear ();
+  m_record.push_back (BINARY_POSITION);
+  PutDouble (m_record, t);
+  PutVarint (m_record, nodeId);
+  PutDouble (m_record, x);
+  PutDouble (m_record, y);
+  WriteRecord ();
+}
+
+std::string
+AnimationInterface::GetXmlUpdateNodePosition (double t, uint32_t nodeId, double x, double y)
 {
   AnimXmlElement element ("nu");
   element.AddAttribute ("p", "p");
-  element.AddAttribute ("t", Simulator::Now ().GetSeconds ());
+  element.AddAttribute ("t", t);
   element.AddAttribute ("id", nodeId);
   element.AddAttribute ("x", x);
   element.AddAttribute ("y", y);
-  WriteN (element.ToString (), m_f);
+  return element.ToString ();
 }
 
 void 
@@ -2638,7 +3188,7 @@ AnimationInterface::WriteXmlUpdateNodeColor (uint32_t nodeId, uint8_t r, uint8_t
   element.AddAttribute ("r", (uint32_t) r);
   element.AddAttribute ("g", (uint32_t) g);
   element.AddAttribute ("b", (uint32_t) b);
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 void 
@@ -2652,19 +3202,41 @@ AnimationInterface::WriteXmlUpdateNodeDescription (uint32_t nodeId)
     {
       element.AddAttribute ("descr", m_nodeDescriptions[nodeId], true); 
     }
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 
 void 
 AnimationInterface::WriteXmlUpdateNodeCounter (uint32_t nodeCounterId, uint32_t nodeId, double counterValue)
+{
+  double t = Simulator::Now ().GetSeconds ();
+  if (!m_binaryBuffer)
+    {
+      WriteN (GetXmlUpdateNodeCounter (nodeCounterId, nodeId, t, counterValue));
+      return;
+    }
+  if (m_writeCallback)
+    {
+      m_writeCallback (GetXmlUpdateNodeCounter (nodeCounterId, nodeId, t, counterValue).c_str ());
+    }
+  m_record.clear ();
+  m_record.push_back (BINARY_COUNTER);
+  PutVarint (m_record, nodeCounterId);
+  PutVarint (m_record, nodeId);
+  PutDouble (m_record, t);
+  PutDouble (m_record, counterValue);
+  WriteRecord ();
+}
+
+std::string
+AnimationInterface::GetXmlUpdateNodeCounter (uint32_t nodeCounterId, uint32_t nodeId, double t, double counterValue)
 {
   AnimXmlElement element ("nc");
   element.AddAttribute ("c", nodeCounterId);
   element.AddAttribute ("i", nodeId);
-  element.AddAttribute ("t", Simulator::Now ().GetSeconds ());
+  element.AddAttribute ("t", t);
   element.AddAttribute ("v", counterValue);
-  WriteN (element.ToString (), m_f);
+  return element.ToString ();
 }
 
 void 
@@ -2677,7 +3249,7 @@ AnimationInterface::WriteXmlUpdateBackground (std::string fileName, double x, do
   element.AddAttribute ("sx", scaleX);
   element.AddAttribute ("sy", scaleY);
   element.AddAttribute ("o", opacity);
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 void 
@@ -2687,7 +3259,7 @@ AnimationInterface::WriteXmlNonP2pLinkProperties (uint32_t id, std::string ipAdd
   element.AddAttribute ("id", id);
   element.AddAttribute ("ipAddress", ipAddress);
   element.AddAttribute ("channelType", channelType);
-  WriteN (element.ToString (), m_f);
+  WriteN (element.ToString ());
 }
 
 
@@ -26,6 +26,11 @@
 #include <string>
 #include <cstdio>
 #include <map>
+#include <set>
+#include <vector>
+#include <fstream>
+#include <istream>
+#include <ostream>
 
 #include "ns3/ptr.h"
 #include "ns3/net-device.h"
@@ -55,6 +60,7 @@ namespace ns3 {
 
 
 struct NodeSize;
+class AsyncStreamBuffer;
 
 /**
  * \defgroup netanim Network Animation
@@ -74,12 +80,22 @@ class AnimationInterface
 {
 public:
 
+  /**
+   * Output Formats
+   */
+  typedef enum
+    {
+      XML_FORMAT,   ///< the XML read by NetAnim
+      BINARY_FORMAT ///< compact records written by a background thread, see ConvertBinaryToXml
+    } OutputFormat;
+
   /**
    * \brief Constructor
    * \param filename The Filename for the trace file used by the Animator
+   * \param format The format of the trace file
    *
    */
-  AnimationInterface (const std::string filename);
+  AnimationInterface (const std::string filename, OutputFormat format = XML_FORMAT);
 
   /**
    * Counter Types 
@@ -222,6 +238,50 @@ public:
    */
   void SetMobilityPollInterval (Time t);
 
+  /**
+   * \brief Set the position quantum: the position of a node is written by the
+   * periodic mobility poll only if it moved to another square of this side
+   *
+   * \param quantum the side of the squares, in meters. Default: 1
+   *
+   * \returns none
+   */
+  void SetPositionQuantum (double quantum);
+
+  /**
+   * \brief Trace only one packet out of n. The packets which are not
+   * sampled are not written at all, which reduces the trace file size
+   * and the time spent writing it in large scenarios
+   *
+   * \param n the sampling period. Default: 1, i.e., every packet is traced
+   *
+   * \returns none
+   */
+  void SetPacketSampling (uint32_t n);
+
+  /**
+   * \brief Trace only the packets transmitted by, the position updates
+   * and the counters of some nodes. All the nodes are still described
+   * at the start of the animation
+   *
+   * \param nodes the nodes to trace
+   *
+   * \returns none
+   */
+  void SetNodeFilter (NodeContainer nodes);
+
+  /**
+   * \brief Convert a trace file written in BINARY_FORMAT to the XML read by NetAnim
+   *
+   * The XML is exactly the one AnimationInterface would have written in XML_FORMAT.
+   *
+   * \param in the binary trace
+   * \param out the stream the XML is written to
+   *
+   * \returns false if the binary trace is not valid or truncated
+   */
+  static bool ConvertBinaryToXml (std::istream &in, std::ostream &out);
+
   /**
    * \brief Set a callback function to listen to AnimationInterface write events
    *
@@ -634,6 +694,15 @@ private:
   Time m_wifiPhyCountersPollInterval; ///< wifi Phy counters poll interval
   static Rectangle * userBoundary; ///< user boundary
   bool m_trackPackets; ///< track packets
+  OutputFormat m_format; ///< format of the trace file
+  std::filebuf m_binaryFile; ///< trace file in binary format
+  AsyncStreamBuffer * m_binaryBuffer; ///< buffer of the trace file in binary format (0 if none)
+  std::vector<uint8_t> m_record; ///< binary record being encoded
+  uint64_t m_binaryUid; ///< last packet unique identifier written to the binary trace
+  double m_positionQuantum; ///< position quantum
+  uint32_t m_packetSampling; ///< one packet out of m_packetSampling is traced
+  uint64_t m_sampledPackets; ///< number of packets considered for sampling
+  std::set<uint32_t> m_nodeFilter; ///< IDs of the traced nodes (all if empty)
 
   // Counter ID
   uint32_t m_remainingEnergyCounterId; ///< remaining energy counter ID
@@ -663,6 +732,7 @@ private:
   AnimUidPacketInfoMap m_pendingWavePackets; ///< pending WAVE packets
 
   std::map <uint32_t, Vector> m_nodeLocation; ///< node location
+  std::map <uint32_t, Vector> m_polledNodeLocation; ///< node location at the last reported move
   std::map <std::string, uint32_t> m_macToNodeIdMap; ///< MAC to node ID map
   std::map <std::string, uint32_t> m_ipv4ToNodeIdMap; ///< IPv4 to node ID map
   std::map <std::string, uint32_t> m_ipv6ToNodeIdMap; ///< IPv6 to node ID map
@@ -769,6 +839,29 @@ private:
    * \returns the number of bytes written
    */
   int WriteN (const std::string& st, FILE * f);
+  /**
+   * WriteN function, writing to the trace file in any format
+   * \param st the XML to output
+   * \returns the number of bytes written
+   */
+  int WriteN (const std::string& st);
+  /**
+   * Write the binary record in m_record to the trace file
+   * \returns the number of bytes written
+   */
+  int WriteRecord ();
+  /**
+   * Is packet sampled function, counting the packet for sampling
+   * \param nodeId the ID of the transmitting node
+   * \returns true if the packet must be traced
+   */
+  bool IsPacketSampled (uint32_t nodeId);
+  /**
+   * Is node traced function
+   * \param nodeId the node ID
+   * \returns true if the node passes the node filter
+   */
+  bool IsNodeTraced (uint32_t nodeId) const;
   /**
    * Get MAC address function
    * \param nd the device
@@ -814,6 +907,15 @@ private:
    * \returns true if a packet is pending
    */
   bool IsPacketPending (uint64_t animUid, ProtocolType protocolType);
+  /**
+   * Is packet unsampled function, for the receptions when packets are
+   * sampled or filtered: the transmissions which were not traced tag
+   * the packet with the UID 0, and the traced ones are purged after a while
+   * \param animUid the UID
+   * \param protocolType the protocol type
+   * \returns true if the reception must be ignored
+   */
+  bool IsPacketUnsampled (uint64_t animUid, ProtocolType protocolType);
   /**
    * Purge pending packets function
    * \param protocolType the protocol type
@@ -1247,7 +1349,9 @@ private:
    */
   Vector UpdatePosition (Ptr <NetDevice> ndev);
   /**
-   * Node has moved function
+   * Node has moved function, by at least the position quantum since
+   * its last reported move (the packet traces refresh the node location
+   * without reporting it)
    * \param n the node
    * \param newLocation the new location vector
    * \returns true if the node has moved
@@ -1325,6 +1429,15 @@ private:
    * \param y the Y position
    */
   void WriteXmlUpdateNodePosition (uint32_t nodeId, double x, double y);
+  /**
+   * Get XML update node position function
+   * \param t the time
+   * \param nodeId the node ID
+   * \param x the X position
+   * \param y the Y position
+   * \returns the XML element
+   */
+  static std::string GetXmlUpdateNodePosition (double t, uint32_t nodeId, double x, double y);
   /**
    * Write XML update node color function
    * \param nodeId the node ID
@@ -1371,6 +1484,15 @@ private:
    * \param value the node counter value
    */
   void WriteXmlUpdateNodeCounter (uint32_t counterId, uint32_t nodeId, double value);
+  /**
+   * Get XML update node counter function
+   * \param counterId the counter ID
+   * \param nodeId the node ID
+   * \param t the time
+   * \param value the node counter value
+   * \returns the XML element
+   */
+  static std::string GetXmlUpdateNodeCounter (uint32_t counterId, uint32_t nodeId, double t, double value);
   /**
    * Write XML node function
    * \param id the ID
@@ -1421,6 +1543,30 @@ private:
    * \param lbTx the LB transmit
    */
   void WriteXmlP (uint64_t animUid, std::string pktType, uint32_t fId, double fbTx, double lbTx);
+  /**
+   * Get XMLP function
+   * \param pktType the packet type
+   * \param fId the FID
+   * \param fbTx the FB transmit
+   * \param lbTx the LB transmit
+   * \param tId the TID
+   * \param fbRx the FB receive
+   * \param lbRx the LB receive
+   * \param metaInfo the meta info
+   * \returns the XML element
+   */
+  static std::string GetXmlP (std::string pktType, uint32_t fId, double fbTx, double lbTx,
+                              uint32_t tId, double fbRx, double lbRx, std::string metaInfo);
+  /**
+   * Get XMLP function
+   * \param animUid the UID
+   * \param pktType the packet type
+   * \param tId the TID
+   * \param fbRx the FB receive
+   * \param lbRx the LB receive
+   * \returns the XML element
+   */
+  static std::string GetXmlP (uint64_t animUid, std::string pktType, uint32_t tId, double fbRx, double lbRx);
   /**
    * Write XMLP Ref function
    * \param animUid the UID
@@ -1429,6 +1575,15 @@ private:
    * \param metaInfo the meta info
    */
   void WriteXmlPRef (uint64_t animUid, uint32_t fId, double fbTx, std::string metaInfo = "");
+  /**
+   * Get XMLP Ref function
+   * \param animUid the UID
+   * \param fId the FID
+   * \param fbTx the FB transmit
+   * \param metaInfo the meta info
+   * \returns the XML element
+   */
+  static std::string GetXmlPRef (uint64_t animUid, uint32_t fId, double fbTx, std::string metaInfo);
   /**
    * Write XML close function
    * \param name the name
@@ -18,6 +18,8 @@
  */
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include "unistd.h"
 
 #include "ns3/core-module.h"
@@ -27,6 +29,8 @@
 #include "ns3/netanim-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/point-to-point-layout-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
 #include "ns3/basic-energy-source.h"
 #include "ns3/simple-device-energy-model.h"
 
@@ -253,6 +257,331 @@ AnimationRemainingEnergyTestCase::CheckLogic (void)
                             "Wrong remaining energy value was traced");
 }
 
+/**
+ * \ingroup netanim-test
+ * \ingroup tests
+ *
+ * \brief Check that the binary traces convert to the XML traces, and the packet sampling
+ */
+class AnimationBinaryFormatTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   */
+  AnimationBinaryFormatTestCase ();
+
+private:
+  virtual void
+  DoRun (void);
+
+  /**
+   * \brief Animate a point-to-point echo
+   * \param format the format of the trace file
+   * \param sampling the packet sampling period
+   * \param packets the number of packets traced
+   * \returns the XML trace, converted if needed
+   */
+  std::string
+  Animate (AnimationInterface::OutputFormat format, uint32_t sampling, uint64_t &packets);
+
+  /**
+   * \brief Animate an echo over a line of four wifi nodes, where each node
+   * only reaches its neighbors; the end nodes slowly move away
+   * \param sampling the packet sampling period
+   * \param filter whether to trace only the nodes 0 and 1
+   * \param quantum the position quantum
+   * \returns the XML trace
+   */
+  std::string
+  AnimateMultiHop (uint32_t sampling, bool filter, double quantum);
+
+  /**
+   * \brief Check the wireless packets of a multi-hop trace
+   *
+   * Each reception must refer to a traced transmission of a neighbor.
+   *
+   * \param xml the XML trace
+   * \param filter whether only the nodes 0 and 1 were traced
+   * \returns the number of receptions
+   */
+  uint32_t
+  CheckMultiHop (const std::string &xml, bool filter);
+
+  /**
+   * \brief Count the position updates of a node
+   * \param xml the XML trace
+   * \param nodeId the node
+   * \returns the number of position updates
+   */
+  static uint32_t
+  CountPositionUpdates (const std::string &xml, uint32_t nodeId);
+
+  /**
+   * \brief Get the value of an attribute of an XML element
+   * \param element the XML element
+   * \param name the attribute
+   * \returns the value of the attribute
+   */
+  static std::string
+  GetAttribute (const std::string &element, const std::string &name);
+};
+
+AnimationBinaryFormatTestCase::AnimationBinaryFormatTestCase () :
+  TestCase ("Verify the binary format and the packet sampling")
+{
+}
+
+std::string
+AnimationBinaryFormatTestCase::Animate (AnimationInterface::OutputFormat format, uint32_t sampling, uint64_t &packets)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  AnimationInterface::SetConstantPosition (nodes.Get (0), 0 , 10);
+  AnimationInterface::SetConstantPosition (nodes.Get (1), 1.5 , 10);
+
+  PointToPointHelper pointToPoint;
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+  // the same addresses in every run
+  devices.Get (0)->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+  devices.Get (1)->SetAddress (Mac48Address ("00:00:00:00:00:02"));
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  UdpEchoServerHelper echoServer (9);
+  ApplicationContainer serverApps = echoServer.Install (nodes.Get (1));
+  serverApps.Start (Seconds (1.0));
+  UdpEchoClientHelper echoClient (interfaces.GetAddress (1), 9);
+  echoClient.SetAttribute ("MaxPackets", UintegerValue (10));
+  echoClient.SetAttribute ("Interval", TimeValue (Seconds (0.3)));
+  ApplicationContainer clientApps = echoClient.Install (nodes.Get (0));
+  clientApps.Start (Seconds (2.0));
+  Simulator::Stop (Seconds (6));
+
+  std::string fileName = CreateTempDirFilename ("netanim-test.anim");
+  AnimationInterface *anim = new AnimationInterface (fileName, format);
+  anim->SetPacketSampling (sampling);
+  anim->UpdateNodeDescription (nodes.Get (0), "client & <source>");
+  uint32_t counterId = anim->AddNodeCounter ("Counter", AnimationInterface::DOUBLE_COUNTER);
+  anim->UpdateNodeCounter (counterId, 1, 1.0 / 3);
+  Simulator::Run ();
+  packets = anim->GetTracePktCount ();
+  delete anim;
+  Simulator::Destroy ();
+
+  std::ifstream in (fileName.c_str (), std::ios::binary);
+  std::ostringstream xml;
+  if (format == AnimationInterface::BINARY_FORMAT)
+    {
+      NS_TEST_EXPECT_MSG_EQ (AnimationInterface::ConvertBinaryToXml (in, xml), true, "Unable to convert " << fileName);
+    }
+  else
+    {
+      xml << in.rdbuf ();
+    }
+  in.close ();
+  unlink (fileName.c_str ());
+  return xml.str ();
+}
+
+std::string
+AnimationBinaryFormatTestCase::AnimateMultiHop (uint32_t sampling, bool filter, double quantum)
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+
+  YansWifiChannelHelper channel;
+  channel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  channel.AddPropagationLoss ("ns3::RangePropagationLossModel", "MaxRange", DoubleValue (60));
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211b);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("DsssRate1Mbps"),
+                                "ControlMode", StringValue ("DsssRate1Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+
+  // 50 m apart; the end nodes move away at 0.5 m/s, staying in range
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> model = nodes.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      model->SetPosition (Vector (50.0 * i, 0, 0));
+      if (i == 0 || i == nodes.GetN () - 1)
+        {
+          model->SetVelocity (Vector (i == 0 ? -0.5 : 0.5, 0, 0));
+        }
+    }
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  Ipv4StaticRoutingHelper staticRouting;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4StaticRouting> routing = staticRouting.GetStaticRouting (nodes.Get (i)->GetObject<Ipv4> ());
+      if (i + 1 < nodes.GetN ())
+        {
+          routing->AddHostRouteTo (interfaces.GetAddress (nodes.GetN () - 1), interfaces.GetAddress (i + 1), 1);
+        }
+      if (i > 0)
+        {
+          routing->AddHostRouteTo (interfaces.GetAddress (0), interfaces.GetAddress (i - 1), 1);
+        }
+    }
+
+  UdpEchoServerHelper echoServer (9);
+  ApplicationContainer serverApps = echoServer.Install (nodes.Get (nodes.GetN () - 1));
+  serverApps.Start (Seconds (1.0));
+  UdpEchoClientHelper echoClient (interfaces.GetAddress (nodes.GetN () - 1), 9);
+  echoClient.SetAttribute ("MaxPackets", UintegerValue (40));
+  echoClient.SetAttribute ("Interval", TimeValue (Seconds (0.25)));
+  ApplicationContainer clientApps = echoClient.Install (nodes.Get (0));
+  clientApps.Start (Seconds (2.0));
+  Simulator::Stop (Seconds (14));
+
+  std::string fileName = CreateTempDirFilename ("netanim-multihop-test.anim");
+  AnimationInterface *anim = new AnimationInterface (fileName);
+  anim->SetPacketSampling (sampling);
+  anim->SetPositionQuantum (quantum);
+  if (filter)
+    {
+      NodeContainer traced;
+      traced.Add (nodes.Get (0));
+      traced.Add (nodes.Get (1));
+      anim->SetNodeFilter (traced);
+    }
+  Simulator::Run ();
+  delete anim;
+  Simulator::Destroy ();
+
+  std::ifstream in (fileName.c_str ());
+  std::ostringstream xml;
+  xml << in.rdbuf ();
+  in.close ();
+  unlink (fileName.c_str ());
+  return xml.str ();
+}
+
+std::string
+AnimationBinaryFormatTestCase::GetAttribute (const std::string &element, const std::string &name)
+{
+  std::string key = " " + name + "=\"";
+  std::string::size_type start = element.find (key);
+  if (start == std::string::npos)
+    {
+      return "";
+    }
+  start += key.size ();
+  return element.substr (start, element.find ('"', start) - start);
+}
+
+uint32_t
+AnimationBinaryFormatTestCase::CountPositionUpdates (const std::string &xml, uint32_t nodeId)
+{
+  std::ostringstream id;
+  id << nodeId;
+  uint32_t updates = 0;
+  for (std::string::size_type pos = xml.find ("<nu p=\"p\""); pos != std::string::npos;
+       pos = xml.find ("<nu p=\"p\"", pos + 1))
+    {
+      if (GetAttribute (xml.substr (pos, xml.find ('>', pos) - pos), "id") == id.str ())
+        {
+          updates++;
+        }
+    }
+  return updates;
+}
+
+uint32_t
+AnimationBinaryFormatTestCase::CheckMultiHop (const std::string &xml, bool filter)
+{
+  std::map<std::string, uint32_t> senders;
+  uint32_t receptions = 0;
+  std::istringstream lines (xml);
+  std::string line;
+  while (std::getline (lines, line))
+    {
+      std::string::size_type pos = line.find ("<pr ");
+      if (pos != std::string::npos)
+        {
+          uint32_t fId = std::atoi (GetAttribute (line.substr (pos), "fId").c_str ());
+          senders[GetAttribute (line.substr (pos), "uId")] = fId;
+          if (filter)
+            {
+              NS_TEST_EXPECT_MSG_LT_OR_EQ (fId, 1, "Transmission of a filtered node traced");
+            }
+        }
+      pos = line.find ("<wpr ");
+      if (pos != std::string::npos)
+        {
+          std::string uId = GetAttribute (line.substr (pos), "uId");
+          uint32_t tId = std::atoi (GetAttribute (line.substr (pos), "tId").c_str ());
+          std::map<std::string, uint32_t>::const_iterator sender = senders.find (uId);
+          NS_TEST_EXPECT_MSG_EQ ((sender != senders.end ()), true, "Reception of an unknown packet " << uId);
+          if (sender != senders.end ())
+            {
+              // the nodes only reach their neighbors
+              NS_TEST_EXPECT_MSG_EQ ((tId + 1 == sender->second || sender->second + 1 == tId), true,
+                                     "Node " << tId << " cannot receive packet " << uId << " from node " << sender->second);
+            }
+          receptions++;
+        }
+    }
+  return receptions;
+}
+
+void
+AnimationBinaryFormatTestCase::DoRun (void)
+{
+  uint64_t xmlPackets;
+  uint64_t binaryPackets;
+  std::string xml = Animate (AnimationInterface::XML_FORMAT, 1, xmlPackets);
+  std::string converted = Animate (AnimationInterface::BINARY_FORMAT, 1, binaryPackets);
+  NS_TEST_EXPECT_MSG_EQ (binaryPackets, xmlPackets, "The format must not change the packets traced");
+  NS_TEST_EXPECT_MSG_NE (xml.find ("<p "), std::string::npos, "No packet traced");
+  NS_TEST_EXPECT_MSG_NE (xml.find ("</anim>"), std::string::npos, "The anim element is not closed");
+  NS_TEST_EXPECT_MSG_EQ (converted, xml, "The converted binary trace differs from the XML trace");
+
+  uint64_t sampledPackets;
+  Animate (AnimationInterface::XML_FORMAT, 2, sampledPackets);
+  NS_TEST_EXPECT_MSG_EQ (sampledPackets, xmlPackets / 2, "One packet out of two must be traced");
+
+  // a sampled packet forwarded by a node whose transmission is not
+  // sampled must not be reported as received from the first hop
+  std::string multiHop = AnimateMultiHop (1, false, 1);
+  uint32_t receptions = CheckMultiHop (multiHop, false);
+  NS_TEST_EXPECT_MSG_GT (receptions, 0, "No wireless reception traced");
+  uint32_t sampledReceptions = CheckMultiHop (AnimateMultiHop (3, false, 1), false);
+  NS_TEST_EXPECT_MSG_GT (sampledReceptions, 0, "No sampled wireless reception traced");
+  NS_TEST_EXPECT_MSG_LT (sampledReceptions, receptions, "The receptions must be sampled");
+  // the end nodes move by 6 m
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (CountPositionUpdates (multiHop, 0), 6, "Position updates missing");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (CountPositionUpdates (multiHop, 3), 6, "Position updates missing");
+
+  // only the nodes 0 and 1 are traced, and their position updates are coarser
+  std::string filtered = AnimateMultiHop (1, true, 3);
+  NS_TEST_EXPECT_MSG_GT (CheckMultiHop (filtered, true), 0, "No filtered wireless reception traced");
+  NS_TEST_EXPECT_MSG_EQ (CountPositionUpdates (filtered, 3), 0, "Position of a filtered node traced");
+  uint32_t coarseUpdates = CountPositionUpdates (filtered, 0);
+  NS_TEST_EXPECT_MSG_GT (coarseUpdates, 0, "Position updates missing");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (coarseUpdates, 3, "Position updates finer than the quantum");
+
+  std::istringstream invalid ("<anim>");
+  std::ostringstream out;
+  NS_TEST_EXPECT_MSG_EQ (AnimationInterface::ConvertBinaryToXml (invalid, out), false, "An XML trace must not be converted");
+}
+
 /**
  * \ingroup netanim-test
  * \ingroup tests
@@ -267,5 +596,6 @@ public:
   {
     AddTestCase (new AnimationInterfaceTestCase (), TestCase::QUICK);
     AddTestCase (new AnimationRemainingEnergyTestCase (), TestCase::QUICK);
+    AddTestCase (new AnimationBinaryFormatTestCase (), TestCase::QUICK);
   }
 } g_animationInterfaceTestSuite; ///< the test suite
@@ -28,6 +28,9 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +38,42 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+/**
+ * \ingroup network
+ * Size of the blocks buffering the trace files, zero to write through.
+ */
+static GlobalValue g_traceWriteBufferSize = GlobalValue ("TraceWriteBufferSize",
+                                                         "The size of the blocks buffering the pcap and ascii trace "
+                                                         "files created by the helpers, written to the files by a "
+                                                         "background thread (0 to write the traces directly)",
+                                                         UintegerValue (0),
+                                                         MakeUintegerChecker<uint32_t> ());
+
+/**
+ * \ingroup network
+ * Maximum number of blocks buffering a trace file.
+ */
+static GlobalValue g_traceWriteBufferCount = GlobalValue ("TraceWriteBufferCount",
+                                                          "The maximum number of blocks buffering a trace file, "
+                                                          "beyond which tracing waits for a block to be written",
+                                                          UintegerValue (4),
+                                                          MakeUintegerChecker<uint32_t> (1));
+
+/**
+ * \brief Get the buffering of the trace files
+ * \param [out] blockSize the size of the blocks, zero to write through
+ * \param [out] maxBlocks the maximum number of blocks
+ */
+static void
+GetTraceWriteBuffer (uint32_t &blockSize, uint32_t &maxBlocks)
+{
+  UintegerValue value;
+  g_traceWriteBufferSize.GetValue (value);
+  blockSize = value.Get ();
+  g_traceWriteBufferCount.GetValue (value);
+  maxBlocks = value.Get ();
+}
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -62,6 +101,14 @@ PcapHelper::CreateFile (
   file->Init (dataLinkType, snapLen, tzCorrection);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Init " << filename);
 
+  uint32_t blockSize;
+  uint32_t maxBlocks;
+  GetTraceWriteBuffer (blockSize, maxBlocks);
+  if (blockSize > 0)
+    {
+      file->SetWriteBuffer (blockSize, maxBlocks);
+    }
+
   //
   // Note that the pcap helper promptly forgets all about the pcap file.  We
   // rely on the reference count of the file object which will soon be owned
@@ -194,6 +241,14 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
 
   Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper> (filename, filemode);
 
+  uint32_t blockSize;
+  uint32_t maxBlocks;
+  GetTraceWriteBuffer (blockSize, maxBlocks);
+  if (blockSize > 0)
+    {
+      StreamWrapper->SetWriteBuffer (blockSize, maxBlocks);
+    }
+
   //
   // Note that the ascii trace helper promptly forgets all about the trace file.
   // We rely on the reference count of the file object which will soon be owned
@@ -397,6 +452,135 @@ AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
+BinaryTraceHelper::BinaryTraceHelper ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+BinaryTraceHelper::~BinaryTraceHelper ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+Ptr<BinaryTraceFile>
+BinaryTraceHelper::CreateFile (std::string filename, bool compress)
+{
+  NS_LOG_FUNCTION (filename << compress);
+
+  Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> ();
+  file->Create (filename, compress);
+  NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for writing");
+  return file;
+}
+
+/**
+ * \brief Check that an object has a trace source passing a packet only
+ * \param object the object
+ * \param name the name of the trace source
+ * \return true if the trace source can be hooked to the binary trace sinks
+ */
+static bool
+HasPacketTraceSource (Ptr<Object> object, std::string name)
+{
+  struct TypeId::TraceSourceInformation info;
+  return object->GetInstanceTypeId ().LookupTraceSourceByName (name, &info) != 0
+         && info.callback == "ns3::Packet::TracedCallback";
+}
+
+void
+BinaryTraceHelper::EnableDevice (Ptr<BinaryTraceFile> file, Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (file << device);
+
+  uint32_t nodeId = device->GetNode ()->GetId ();
+  uint32_t deviceId = device->GetIfIndex ();
+
+  if (HasPacketTraceSource (device, "MacRx"))
+    {
+      HookDefaultReceiveSink (device, "MacRx", file, nodeId, deviceId);
+    }
+  if (HasPacketTraceSource (device, "MacTxDrop"))
+    {
+      HookDefaultDropSink (device, "MacTxDrop", file, nodeId, deviceId);
+    }
+  if (HasPacketTraceSource (device, "PhyRxDrop"))
+    {
+      HookDefaultDropSink (device, "PhyRxDrop", file, nodeId, deviceId);
+    }
+
+  struct TypeId::AttributeInformation info;
+  if (device->GetInstanceTypeId ().LookupAttributeByName ("TxQueue", &info))
+    {
+      PointerValue ptr;
+      device->GetAttribute ("TxQueue", ptr);
+      Ptr<Object> queue = ptr.Get<Object> ();
+      if (queue != 0)
+        {
+          if (HasPacketTraceSource (queue, "Enqueue"))
+            {
+              HookDefaultEnqueueSink (queue, "Enqueue", file, nodeId, deviceId);
+            }
+          if (HasPacketTraceSource (queue, "Dequeue"))
+            {
+              HookDefaultDequeueSink (queue, "Dequeue", file, nodeId, deviceId);
+            }
+          if (HasPacketTraceSource (queue, "Drop"))
+            {
+              HookDefaultDropSink (queue, "Drop", file, nodeId, deviceId);
+            }
+        }
+    }
+}
+
+/**
+ * \brief Record an event of a packet in a binary trace file
+ * \param file the binary trace file
+ * \param type the type of the event
+ * \param node the id of the node
+ * \param device the index of the device
+ * \param p the packet
+ */
+static inline void
+RecordBinaryTraceEvent (Ptr<BinaryTraceFile> file, uint8_t type, uint32_t node, uint32_t device, Ptr<const Packet> p)
+{
+  BinaryTraceEvent event;
+  event.time = Simulator::Now ().GetTimeStep ();
+  event.uid = p->GetUid ();
+  event.node = node;
+  event.device = device;
+  event.size = p->GetSize ();
+  event.type = type;
+  file->Write (event);
+}
+
+void
+BinaryTraceHelper::DefaultEnqueueSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (file << node << device << p);
+  RecordBinaryTraceEvent (file, BinaryTraceEvent::ENQUEUE, node, device, p);
+}
+
+void
+BinaryTraceHelper::DefaultDropSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (file << node << device << p);
+  RecordBinaryTraceEvent (file, BinaryTraceEvent::DROP, node, device, p);
+}
+
+void
+BinaryTraceHelper::DefaultDequeueSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (file << node << device << p);
+  RecordBinaryTraceEvent (file, BinaryTraceEvent::DEQUEUE, node, device, p);
+}
+
+void
+BinaryTraceHelper::DefaultReceiveSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (file << node << device << p);
+  RecordBinaryTraceEvent (file, BinaryTraceEvent::RECEIVE, node, device, p);
+}
+
 void 
 PcapHelperForDevice::EnablePcap (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
@@ -25,6 +25,7 @@
 #include "ns3/simulator.h"
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/output-stream-wrapper.h"
+#include "ns3/binary-trace-file.h"
 
 namespace ns3 {
 
@@ -545,6 +546,191 @@ AsciiTraceHelper::HookDefaultReceiveSinkWithContext (
                  << tracename << "\"");
 }
 
+/**
+ * \brief Manage binary trace files for device models
+ *
+ * This helper records the same enqueue, dequeue, drop and receive events
+ * as the default ascii trace sinks, in a BinaryTraceFile.  Rather than
+ * the trace context and the printed packet, an event records the node
+ * and device ids bound to the trace sink, the time, the packet uid and
+ * the packet size, so that tracing costs a copy of a fixed-size event.
+ * The binary-trace-convert program converts the files to text or CSV
+ * after the simulation.
+ */
+class BinaryTraceHelper
+{
+public:
+  /**
+   * @brief Create a binary trace helper.
+   */
+  BinaryTraceHelper ();
+
+  /**
+   * @brief Destroy a binary trace helper.
+   */
+  ~BinaryTraceHelper ();
+
+  /**
+   * @brief Create a binary trace file.
+   *
+   * The file is closed, and its pending events written, when the last
+   * reference to it is released, hence when the trace sinks it is bound
+   * to are destroyed, or upon Close.
+   *
+   * @param filename file name
+   * @param compress whether to compress the blocks of events
+   * @returns a smart pointer to the binary trace file
+   */
+  Ptr<BinaryTraceFile> CreateFile (std::string filename, bool compress = true);
+
+  /**
+   * @brief Hook the trace sources of a device, and of its transmit queue,
+   * which are traced by the ascii trace helpers of the devices.
+   *
+   * The "MacRx" source of the device is traced as receive events, its
+   * "MacTxDrop" and "PhyRxDrop" sources as drop events and the "Enqueue",
+   * "Dequeue" and "Drop" sources of the queue held by its "TxQueue"
+   * attribute as enqueue, dequeue and drop events.  The sources the device
+   * does not have, or which do not pass a packet only, are ignored.
+   *
+   * @param file the binary trace file
+   * @param device the device
+   */
+  void EnableDevice (Ptr<BinaryTraceFile> file, Ptr<NetDevice> device);
+
+  /**
+   * @brief Hook a trace source to the default enqueue operation trace sink.
+   *
+   * @param object object
+   * @param traceName trace source name
+   * @param file binary trace file
+   * @param node the id of the node recorded in the events
+   * @param device the index of the device recorded in the events
+   */
+  template <typename T>
+  void HookDefaultEnqueueSink (Ptr<T> object, std::string traceName, Ptr<BinaryTraceFile> file,
+                               uint32_t node, uint32_t device);
+
+  /**
+   * @brief Hook a trace source to the default drop operation trace sink.
+   *
+   * @param object object
+   * @param traceName trace source name
+   * @param file binary trace file
+   * @param node the id of the node recorded in the events
+   * @param device the index of the device recorded in the events
+   */
+  template <typename T>
+  void HookDefaultDropSink (Ptr<T> object, std::string traceName, Ptr<BinaryTraceFile> file,
+                            uint32_t node, uint32_t device);
+
+  /**
+   * @brief Hook a trace source to the default dequeue operation trace sink.
+   *
+   * @param object object
+   * @param traceName trace source name
+   * @param file binary trace file
+   * @param node the id of the node recorded in the events
+   * @param device the index of the device recorded in the events
+   */
+  template <typename T>
+  void HookDefaultDequeueSink (Ptr<T> object, std::string traceName, Ptr<BinaryTraceFile> file,
+                               uint32_t node, uint32_t device);
+
+  /**
+   * @brief Hook a trace source to the default receive operation trace sink.
+   *
+   * @param object object
+   * @param traceName trace source name
+   * @param file binary trace file
+   * @param node the id of the node recorded in the events
+   * @param device the index of the device recorded in the events
+   */
+  template <typename T>
+  void HookDefaultReceiveSink (Ptr<T> object, std::string traceName, Ptr<BinaryTraceFile> file,
+                               uint32_t node, uint32_t device);
+
+  /**
+   * @brief Basic Enqueue default trace sink, recording a '+' event.
+   *
+   * @param file the binary trace file
+   * @param node the id of the node
+   * @param device the index of the device
+   * @param p the packet
+   */
+  static void DefaultEnqueueSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device, Ptr<const Packet> p);
+
+  /**
+   * @brief Basic Drop default trace sink, recording a 'd' event.
+   *
+   * @param file the binary trace file
+   * @param node the id of the node
+   * @param device the index of the device
+   * @param p the packet
+   */
+  static void DefaultDropSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device, Ptr<const Packet> p);
+
+  /**
+   * @brief Basic Dequeue default trace sink, recording a '-' event.
+   *
+   * @param file the binary trace file
+   * @param node the id of the node
+   * @param device the index of the device
+   * @param p the packet
+   */
+  static void DefaultDequeueSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device, Ptr<const Packet> p);
+
+  /**
+   * @brief Basic Receive default trace sink, recording an 'r' event.
+   *
+   * @param file the binary trace file
+   * @param node the id of the node
+   * @param device the index of the device
+   * @param p the packet
+   */
+  static void DefaultReceiveSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device, Ptr<const Packet> p);
+};
+
+template <typename T> void
+BinaryTraceHelper::HookDefaultEnqueueSink (Ptr<T> object, std::string tracename, Ptr<BinaryTraceFile> file,
+                                           uint32_t node, uint32_t device)
+{
+  bool result =
+    object->TraceConnectWithoutContext (tracename, MakeBoundCallback (&DefaultEnqueueSink, file, node, device));
+  NS_ASSERT_MSG (result == true, "BinaryTraceHelper::HookDefaultEnqueueSink():  Unable to hook \""
+                 << tracename << "\"");
+}
+
+template <typename T> void
+BinaryTraceHelper::HookDefaultDropSink (Ptr<T> object, std::string tracename, Ptr<BinaryTraceFile> file,
+                                        uint32_t node, uint32_t device)
+{
+  bool result =
+    object->TraceConnectWithoutContext (tracename, MakeBoundCallback (&DefaultDropSink, file, node, device));
+  NS_ASSERT_MSG (result == true, "BinaryTraceHelper::HookDefaultDropSink():  Unable to hook \""
+                 << tracename << "\"");
+}
+
+template <typename T> void
+BinaryTraceHelper::HookDefaultDequeueSink (Ptr<T> object, std::string tracename, Ptr<BinaryTraceFile> file,
+                                           uint32_t node, uint32_t device)
+{
+  bool result =
+    object->TraceConnectWithoutContext (tracename, MakeBoundCallback (&DefaultDequeueSink, file, node, device));
+  NS_ASSERT_MSG (result == true, "BinaryTraceHelper::HookDefaultDequeueSink():  Unable to hook \""
+                 << tracename << "\"");
+}
+
+template <typename T> void
+BinaryTraceHelper::HookDefaultReceiveSink (Ptr<T> object, std::string tracename, Ptr<BinaryTraceFile> file,
+                                           uint32_t node, uint32_t device)
+{
+  bool result =
+    object->TraceConnectWithoutContext (tracename, MakeBoundCallback (&DefaultReceiveSink, file, node, device));
+  NS_ASSERT_MSG (result == true, "BinaryTraceHelper::HookDefaultReceiveSink():  Unable to hook \""
+                 << tracename << "\"");
+}
+
 /**
  * \brief Base class providing common user-level pcap operations for helpers
  * representing net devices.
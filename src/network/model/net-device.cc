@@ -19,6 +19,7 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/queue-item.h"
 #include "net-device.h"
 
 namespace ns3 {
@@ -41,4 +42,25 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+bool
+NetDevice::SupportsSendBatch (void) const
+{
+  return false;
+}
+
+uint32_t
+NetDevice::SendBatch (const std::vector<Ptr<QueueDiscItem> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+  uint32_t nSent = 0;
+  for (const auto &item : items)
+    {
+      if (Send (item->GetPacket (), item->GetAddress (), item->GetProtocol ()))
+        {
+          nSent++;
+        }
+    }
+  return nSent;
+}
+
 } // namespace ns3
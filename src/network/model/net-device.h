@@ -22,6 +22,7 @@
 #define NET_DEVICE_H
 
 #include <stdint.h>
+#include <vector>
 #include "ns3/callback.h"
 #include "ns3/object.h"
 #include "ns3/ptr.h"
@@ -34,6 +35,7 @@ namespace ns3 {
 
 class Node;
 class Channel;
+class QueueDiscItem;
 
 /**
  * \ingroup network
@@ -359,6 +361,27 @@ public:
    */
   virtual bool SupportsSendFrom (void) const = 0;
 
+  /**
+   * \return true if this interface supports sending a batch of packets
+   *         with a single call to SendBatch, false otherwise.
+   *
+   * Devices returning true are handed the packets dequeued by a queue disc
+   * in batches (modelled after the xmit_more hint of Linux), which allows
+   * them to start a transmission once per batch instead of once per packet.
+   */
+  virtual bool SupportsSendBatch (void) const;
+
+  /**
+   * \param items the packets to send, along with their destination address
+   *        and protocol number, in transmission order
+   *
+   * Called from higher layer to send a batch of packets into the Network
+   * Device. The default implementation calls Send for each packet.
+   *
+   * \return the number of packets accepted by the device
+   */
+  virtual uint32_t SendBatch (const std::vector<Ptr<QueueDiscItem> > &items);
+
 };
 
 } // namespace ns3
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/nstime.h"
+#include "ns3/binary-trace-file.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the events written to a binary trace file are read back
+ */
+class BinaryTraceFileRoundTripTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param compress whether to compress the blocks
+   */
+  BinaryTraceFileRoundTripTestCase (bool compress);
+
+private:
+  virtual void DoRun (void);
+
+  bool m_compress; //!< whether to compress the blocks
+};
+
+BinaryTraceFileRoundTripTestCase::BinaryTraceFileRoundTripTestCase (bool compress)
+  : TestCase (compress ? "Check the round trip of compressed binary trace files"
+              : "Check the round trip of raw binary trace files"),
+    m_compress (compress)
+{
+}
+
+void
+BinaryTraceFileRoundTripTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace.btr");
+
+  // several blocks, the last one partial, and fields going back and forth
+  std::vector<BinaryTraceEvent> events;
+  for (uint32_t i = 0; i < 250; i++)
+    {
+      BinaryTraceEvent event;
+      event.time = 1000000 * static_cast<int64_t> (i) - (i % 3 == 0 ? 7 : 0);
+      event.uid = (i % 5 == 0) ? 0xffffffffffULL - i : i / 2;
+      event.node = i % 7;
+      event.device = (i % 11 == 0) ? 0xffffffff : i % 3;
+      event.size = 40 + i * 13;
+      event.type = "+-dr"[i % 4];
+      events.push_back (event);
+    }
+
+  BinaryTraceFile out;
+  NS_TEST_ASSERT_MSG_EQ (out.Create (filename, m_compress, 64), true, "Unable to create " << filename);
+  for (uint32_t i = 0; i < events.size (); i++)
+    {
+      out.Write (events[i]);
+    }
+  out.Close ();
+  NS_TEST_ASSERT_MSG_EQ (out.Fail (), false, "Unable to write " << filename);
+
+  BinaryTraceFile in;
+  NS_TEST_ASSERT_MSG_EQ (in.Open (filename), true, "Unable to open " << filename);
+  NS_TEST_EXPECT_MSG_EQ (in.GetResolution (), Time::GetResolution (), "Unexpected time resolution");
+  BinaryTraceEvent event;
+  uint32_t n = 0;
+  while (in.Read (event))
+    {
+      NS_TEST_ASSERT_MSG_LT (n, events.size (), "Too many events read");
+      NS_TEST_EXPECT_MSG_EQ (event.time, events[n].time, "Unexpected time of event " << n);
+      NS_TEST_EXPECT_MSG_EQ (event.uid, events[n].uid, "Unexpected uid of event " << n);
+      NS_TEST_EXPECT_MSG_EQ (event.node, events[n].node, "Unexpected node of event " << n);
+      NS_TEST_EXPECT_MSG_EQ (event.device, events[n].device, "Unexpected device of event " << n);
+      NS_TEST_EXPECT_MSG_EQ (event.size, events[n].size, "Unexpected size of event " << n);
+      NS_TEST_EXPECT_MSG_EQ (event.type, events[n].type, "Unexpected type of event " << n);
+      n++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, events.size (), "Events missing");
+  NS_TEST_EXPECT_MSG_EQ (in.Fail (), false, "The end of the file must not be a failure");
+  in.Close ();
+
+  // a truncated file is detected
+  std::ifstream full (filename.c_str (), std::ios::binary);
+  std::vector<char> bytes ((std::istreambuf_iterator<char> (full)), std::istreambuf_iterator<char> ());
+  full.close ();
+  std::ofstream truncated (filename.c_str (), std::ios::binary | std::ios::trunc);
+  truncated.write (&bytes[0], bytes.size () - 3);
+  truncated.close ();
+
+  NS_TEST_ASSERT_MSG_EQ (in.Open (filename), true, "Unable to open " << filename);
+  n = 0;
+  while (in.Read (event))
+    {
+      n++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, 192, "The complete blocks must be read");
+  NS_TEST_EXPECT_MSG_EQ (in.Fail (), true, "The truncated block must be a failure");
+  in.Close ();
+
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that compression shrinks the blocks of typical events
+ */
+class BinaryTraceFileCompressionTestCase : public TestCase
+{
+public:
+  BinaryTraceFileCompressionTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Write typical events to a binary trace file
+   * \param filename the file name
+   * \param compress whether to compress the blocks
+   * \return the size of the file
+   */
+  long WriteFile (std::string filename, bool compress);
+};
+
+BinaryTraceFileCompressionTestCase::BinaryTraceFileCompressionTestCase ()
+  : TestCase ("Check the compression of binary trace files")
+{
+}
+
+long
+BinaryTraceFileCompressionTestCase::WriteFile (std::string filename, bool compress)
+{
+  BinaryTraceFile file;
+  file.Create (filename, compress);
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      BinaryTraceEvent event;
+      event.time = 1200000 * static_cast<int64_t> (i / 4);
+      event.uid = i / 4;
+      event.node = (i / 2) % 2;
+      event.device = 1;
+      event.size = 1052;
+      event.type = "+-dr"[i % 4];
+      file.Write (event);
+    }
+  file.Close ();
+  std::ifstream in (filename.c_str (), std::ios::binary | std::ios::ate);
+  long size = in.tellg ();
+  std::remove (filename.c_str ());
+  return size;
+}
+
+void
+BinaryTraceFileCompressionTestCase::DoRun (void)
+{
+  long raw = WriteFile (CreateTempDirFilename ("raw.btr"), false);
+  long compressed = WriteFile (CreateTempDirFilename ("compressed.btr"), true);
+  NS_TEST_EXPECT_MSG_GT (raw, 29 * 10000, "Unexpected size of the raw file");
+  NS_TEST_EXPECT_MSG_LT (compressed * 3, raw, "The compressed file must be at least three times smaller");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Binary trace file TestSuite
+ */
+class BinaryTraceFileTestSuite : public TestSuite
+{
+public:
+  BinaryTraceFileTestSuite ();
+};
+
+BinaryTraceFileTestSuite::BinaryTraceFileTestSuite ()
+  : TestSuite ("binary-trace-file", UNIT)
+{
+  AddTestCase (new BinaryTraceFileRoundTripTestCase (false), TestCase::QUICK);
+  AddTestCase (new BinaryTraceFileRoundTripTestCase (true), TestCase::QUICK);
+  AddTestCase (new BinaryTraceFileCompressionTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceFileTestSuite binaryTraceFileTestSuite; //!< Static variable for test initialization
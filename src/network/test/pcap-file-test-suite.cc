@@ -25,6 +25,7 @@
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/simulator.h"
 
 using namespace ns3;
 
@@ -1144,6 +1145,99 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the records buffered by
+ * PcapFile::SetWriteBuffer reach the file unchanged.
+ */
+class WriteBufferTestCase : public TestCase
+{
+public:
+  WriteBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Write the known packets to a file
+   * \param f the file
+   * \param rounds the number of times the known packets are written
+   */
+  void WritePackets (PcapFile &f, uint32_t rounds);
+
+  /**
+   * \param filename the file name
+   * \return the content of the file
+   */
+  std::string ReadFile (std::string const &filename);
+};
+
+WriteBufferTestCase::WriteBufferTestCase ()
+  : TestCase ("Check that the buffered records are written unchanged")
+{
+}
+
+void
+WriteBufferTestCase::WritePackets (PcapFile &f, uint32_t rounds)
+{
+  for (uint32_t round = 0; round < rounds; ++round)
+    {
+      for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+        {
+          PacketEntry const & p = knownPackets[i];
+          f.Write (p.tsSec + round, p.tsUsec, (uint8_t const *)p.data, p.origLen);
+        }
+    }
+}
+
+std::string
+WriteBufferTestCase::ReadFile (std::string const &filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::binary);
+  std::stringstream content;
+  content << file.rdbuf ();
+  return content.str ();
+}
+
+void
+WriteBufferTestCase::DoRun (void)
+{
+  std::string direct = CreateTempDirFilename ("direct.pcap");
+  std::string buffered = CreateTempDirFilename ("buffered.pcap");
+
+  PcapFile f;
+  f.Open (direct, std::ios::out);
+  f.Init (1, N_PACKET_BYTES);
+  WritePackets (f, 10);
+  WritePackets (f, 10);
+  f.Close ();
+
+  // small blocks, so that the records span blocks and the writing
+  // waits for the writer thread
+  PcapFile g;
+  g.Open (buffered, std::ios::out);
+  g.Init (1, N_PACKET_BYTES);
+  g.SetWriteBuffer (100, 2);
+  WritePackets (g, 10);
+  g.Flush ();
+  NS_TEST_EXPECT_MSG_EQ (g.Fail (), false, "Flush must not fail");
+  WritePackets (g, 10);
+
+  // the records are written upon Simulator::Destroy, before the file is closed
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (g.Fail (), false, "Write must not fail");
+  NS_TEST_EXPECT_MSG_EQ ((ReadFile (buffered) == ReadFile (direct)), true,
+                         "Buffered file differs from the file written directly");
+  g.Close ();
+  NS_TEST_EXPECT_MSG_EQ ((ReadFile (buffered) == ReadFile (direct)), true,
+                         "Closing the buffered file changed it");
+
+  remove (direct.c_str ());
+  remove (buffered.c_str ());
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1167,6 +1261,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new WriteBufferTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
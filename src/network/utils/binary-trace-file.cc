@@ -0,0 +1,463 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace-file.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/nstime.h"
+
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+namespace {
+
+const char MAGIC[8] = "NS3BTRC";   //!< the magic string, with its terminating null
+const uint16_t VERSION = 1;        //!< the version of the format
+const uint32_t HEADER_SIZE = 12;   //!< the size of the file header
+const uint32_t BLOCK_HEADER_SIZE = 12; //!< the size of a block header
+const uint32_t RAW_EVENT_SIZE = 29; //!< the size of the columns of an event, without compression
+const uint32_t MAX_BLOCK_EVENTS = 1 << 24; //!< the maximum number of events in a block read
+
+/**
+ * \brief Append an integer in little-endian order
+ * \param buffer the buffer
+ * \param value the integer
+ * \param size the number of bytes of the integer
+ */
+void
+PutFixed (std::vector<uint8_t> &buffer, uint64_t value, uint32_t size)
+{
+  for (uint32_t i = 0; i < size; i++)
+    {
+      buffer.push_back (static_cast<uint8_t> (value >> (8 * i)));
+    }
+}
+
+/**
+ * \brief Append an integer as a variable-length integer, 7 bits per byte
+ * \param buffer the buffer
+ * \param value the integer
+ */
+void
+PutVarint (std::vector<uint8_t> &buffer, uint64_t value)
+{
+  while (value >= 0x80)
+    {
+      buffer.push_back (static_cast<uint8_t> (value | 0x80));
+      value >>= 7;
+    }
+  buffer.push_back (static_cast<uint8_t> (value));
+}
+
+/**
+ * \brief Map a signed difference to an unsigned integer, small
+ * differences of both signs giving small integers
+ * \param delta the difference
+ * \return the unsigned integer
+ */
+uint64_t
+ZigZag (int64_t delta)
+{
+  return (static_cast<uint64_t> (delta) << 1) ^ static_cast<uint64_t> (delta >> 63);
+}
+
+/**
+ * \brief Reverse ZigZag
+ * \param value the unsigned integer
+ * \return the difference
+ */
+int64_t
+UnZigZag (uint64_t value)
+{
+  return static_cast<int64_t> (value >> 1) ^ -static_cast<int64_t> (value & 1);
+}
+
+/// A cursor over the columns of a block being decoded
+class Reader
+{
+public:
+  /**
+   * Constructor
+   * \param buffer the columns of the block
+   */
+  Reader (const std::vector<uint8_t> &buffer)
+    : m_data (buffer.empty () ? 0 : &buffer[0]),
+      m_end (m_data + buffer.size ()),
+      m_fail (false)
+  {
+  }
+
+  /**
+   * \param size the number of bytes of the integer
+   * \return the next little-endian integer
+   */
+  uint64_t GetFixed (uint32_t size)
+  {
+    if (m_end - m_data < static_cast<std::ptrdiff_t> (size))
+      {
+        m_fail = true;
+        return 0;
+      }
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < size; i++)
+      {
+        value |= static_cast<uint64_t> (*m_data++) << (8 * i);
+      }
+    return value;
+  }
+
+  /**
+   * \return the next variable-length integer
+   */
+  uint64_t GetVarint (void)
+  {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+      {
+        if (m_data == m_end)
+          {
+            break;
+          }
+        uint8_t byte = *m_data++;
+        value |= static_cast<uint64_t> (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+          {
+            return value;
+          }
+      }
+    m_fail = true;
+    return 0;
+  }
+
+  /**
+   * \return true if the columns were entirely and correctly read
+   */
+  bool Done (void) const
+  {
+    return !m_fail && m_data == m_end;
+  }
+
+private:
+  const uint8_t *m_data; //!< the next byte
+  const uint8_t *m_end;  //!< the end of the columns
+  bool m_fail;           //!< whether reading past the end was attempted
+};
+
+} // anonymous namespace
+
+BinaryTraceFile::BinaryTraceFile ()
+  : m_compress (true),
+    m_blockEvents (0),
+    m_resolution (Time::GetResolution ()),
+    m_next (0),
+    m_writing (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceFile::~BinaryTraceFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+BinaryTraceFile::Create (std::string const &filename, bool compress, uint32_t blockEvents)
+{
+  NS_LOG_FUNCTION (this << filename << compress << blockEvents);
+  NS_ASSERT_MSG (blockEvents > 0, "A block must hold at least one event");
+  Close ();
+
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  m_compress = compress;
+  m_blockEvents = blockEvents;
+  m_resolution = Time::GetResolution ();
+  m_writing = true;
+  m_events.reserve (blockEvents);
+
+  m_buffer.assign (MAGIC, MAGIC + sizeof (MAGIC));
+  PutFixed (m_buffer, VERSION, 2);
+  PutFixed (m_buffer, static_cast<uint16_t> (m_resolution), 2);
+  m_file.write (reinterpret_cast<const char *> (&m_buffer[0]), m_buffer.size ());
+  return !Fail ();
+}
+
+bool
+BinaryTraceFile::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  m_writing = false;
+  m_next = 0;
+
+  m_buffer.resize (HEADER_SIZE);
+  m_file.read (reinterpret_cast<char *> (&m_buffer[0]), HEADER_SIZE);
+  if (Fail () || std::memcmp (&m_buffer[0], MAGIC, sizeof (MAGIC)) != 0)
+    {
+      NS_LOG_WARN ("Not a binary trace file: " << filename);
+      m_file.setstate (std::ios::failbit);
+      return false;
+    }
+  Reader reader (m_buffer);
+  reader.GetFixed (sizeof (MAGIC));
+  uint16_t version = static_cast<uint16_t> (reader.GetFixed (2));
+  m_resolution = static_cast<int> (reader.GetFixed (2));
+  if (version != VERSION)
+    {
+      NS_LOG_WARN ("Unsupported version " << version << " of binary trace file: " << filename);
+      m_file.setstate (std::ios::failbit);
+      return false;
+    }
+  return true;
+}
+
+void
+BinaryTraceFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+  if (m_writing && !m_events.empty ())
+    {
+      WriteBlock ();
+    }
+  m_file.close ();
+  m_events.clear ();
+  m_next = 0;
+}
+
+bool
+BinaryTraceFile::Read (BinaryTraceEvent &event)
+{
+  NS_ASSERT_MSG (!m_writing, "The file was not opened for reading");
+  while (m_next == m_events.size ())
+    {
+      if (!ReadBlock ())
+        {
+          return false;
+        }
+    }
+  event = m_events[m_next++];
+  return true;
+}
+
+int
+BinaryTraceFile::GetResolution (void) const
+{
+  return m_resolution;
+}
+
+bool
+BinaryTraceFile::Fail (void) const
+{
+  return m_file.fail ();
+}
+
+void
+BinaryTraceFile::WriteBlock (void)
+{
+  NS_LOG_FUNCTION (this << m_events.size ());
+  NS_ASSERT (m_writing);
+  uint32_t n = m_events.size ();
+
+  // leave room for the block header, filled once the size of the columns is known
+  m_buffer.assign (BLOCK_HEADER_SIZE, 0);
+  if (m_compress)
+    {
+      m_buffer.reserve (BLOCK_HEADER_SIZE + 8 * n);
+      int64_t time = 0;
+      uint64_t uid = 0;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          PutVarint (m_buffer, ZigZag (m_events[i].time - time));
+          time = m_events[i].time;
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          PutVarint (m_buffer, ZigZag (static_cast<int64_t> (m_events[i].uid - uid)));
+          uid = m_events[i].uid;
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          PutVarint (m_buffer, m_events[i].node);
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          PutVarint (m_buffer, m_events[i].device);
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          PutVarint (m_buffer, m_events[i].size);
+        }
+    }
+  else
+    {
+      m_buffer.reserve (BLOCK_HEADER_SIZE + RAW_EVENT_SIZE * n);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          PutFixed (m_buffer, m_events[i].time, 8);
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          PutFixed (m_buffer, m_events[i].uid, 8);
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          PutFixed (m_buffer, m_events[i].node, 4);
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          PutFixed (m_buffer, m_events[i].device, 4);
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          PutFixed (m_buffer, m_events[i].size, 4);
+        }
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_buffer.push_back (m_events[i].type);
+    }
+
+  std::vector<uint8_t> header;
+  PutFixed (header, n, 4);
+  PutFixed (header, m_compress ? VARINT : RAW, 4);
+  PutFixed (header, m_buffer.size () - BLOCK_HEADER_SIZE, 4);
+  std::copy (header.begin (), header.end (), m_buffer.begin ());
+
+  m_file.write (reinterpret_cast<const char *> (&m_buffer[0]), m_buffer.size ());
+  m_events.clear ();
+}
+
+bool
+BinaryTraceFile::ReadBlock (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_events.clear ();
+  m_next = 0;
+
+  m_buffer.resize (BLOCK_HEADER_SIZE);
+  m_file.read (reinterpret_cast<char *> (&m_buffer[0]), BLOCK_HEADER_SIZE);
+  if (m_file.gcount () == 0 && m_file.eof ())
+    {
+      // end of the file, which is not a failure
+      m_file.clear (std::ios::eofbit);
+      return false;
+    }
+  if (Fail ())
+    {
+      NS_LOG_WARN ("Truncated block header");
+      return false;
+    }
+  Reader header (m_buffer);
+  uint32_t n = static_cast<uint32_t> (header.GetFixed (4));
+  uint32_t encoding = static_cast<uint32_t> (header.GetFixed (4));
+  uint32_t size = static_cast<uint32_t> (header.GetFixed (4));
+  if (n > MAX_BLOCK_EVENTS || (encoding != RAW && encoding != VARINT)
+      || size < n || (encoding == RAW && size != RAW_EVENT_SIZE * n)
+      || (encoding == VARINT && size > 31 * n))
+    {
+      NS_LOG_WARN ("Corrupted block header");
+      m_file.setstate (std::ios::failbit);
+      return false;
+    }
+
+  m_buffer.resize (size);
+  if (size > 0)
+    {
+      m_file.read (reinterpret_cast<char *> (&m_buffer[0]), size);
+      if (Fail ())
+        {
+          NS_LOG_WARN ("Truncated block");
+          return false;
+        }
+    }
+
+  Reader reader (m_buffer);
+  m_events.resize (n);
+  if (encoding == VARINT)
+    {
+      int64_t time = 0;
+      uint64_t uid = 0;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          time += UnZigZag (reader.GetVarint ());
+          m_events[i].time = time;
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          uid += static_cast<uint64_t> (UnZigZag (reader.GetVarint ()));
+          m_events[i].uid = uid;
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          m_events[i].node = static_cast<uint32_t> (reader.GetVarint ());
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          m_events[i].device = static_cast<uint32_t> (reader.GetVarint ());
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          m_events[i].size = static_cast<uint32_t> (reader.GetVarint ());
+        }
+    }
+  else
+    {
+      for (uint32_t i = 0; i < n; i++)
+        {
+          m_events[i].time = static_cast<int64_t> (reader.GetFixed (8));
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          m_events[i].uid = reader.GetFixed (8);
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          m_events[i].node = static_cast<uint32_t> (reader.GetFixed (4));
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          m_events[i].device = static_cast<uint32_t> (reader.GetFixed (4));
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          m_events[i].size = static_cast<uint32_t> (reader.GetFixed (4));
+        }
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_events[i].type = static_cast<uint8_t> (reader.GetFixed (1));
+    }
+
+  if (!reader.Done ())
+    {
+      NS_LOG_WARN ("Corrupted block");
+      m_events.clear ();
+      m_file.setstate (std::ios::failbit);
+      return false;
+    }
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief An event recorded in a binary trace file
+ */
+struct BinaryTraceEvent
+{
+  /// The type of the events, named after the ascii trace events
+  enum Type
+  {
+    ENQUEUE = '+', //!< Packet enqueued in a transmit queue
+    DEQUEUE = '-', //!< Packet dequeued from a transmit queue
+    DROP = 'd',    //!< Packet dropped
+    RECEIVE = 'r'  //!< Packet received
+  };
+
+  int64_t time;    //!< Time of the event, in time steps
+  uint64_t uid;    //!< Uid of the packet
+  uint32_t node;   //!< Id of the node
+  uint32_t device; //!< Index of the device in the node
+  uint32_t size;   //!< Size of the packet, in bytes
+  uint8_t type;    //!< Type of the event
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief A file of trace events stored in a compact binary form.
+ *
+ * Recording an event copies a fixed-size BinaryTraceEvent into the
+ * current block, hence tracing to this file involves no formatting.
+ * Blocks of events are written column by column: the times of all the
+ * events of the block, then their packet uids, and so on.  The columns
+ * are stored either as little-endian fixed-size integers or, when
+ * compression is enabled, as variable-length integers of the differences
+ * between successive times and uids and of the other fields, which
+ * typically shrinks them several times.
+ *
+ * The file starts with the "NS3BTRC" magic string, followed by the
+ * version and the time resolution of the writer, and each block starts
+ * with its number of events, its encoding and the size of its columns.
+ *
+ * This class uses a basic ns-3 reference counting base class, so that
+ * it can be bound to trace sinks as OutputStreamWrapper.
+ */
+class BinaryTraceFile : public SimpleRefCount<BinaryTraceFile>
+{
+public:
+  /// Encoding of the columns of a block
+  enum Encoding
+  {
+    RAW = 0,   //!< Fixed-size integers
+    VARINT = 1 //!< Variable-length integers, deltas of times and uids
+  };
+
+  BinaryTraceFile ();
+  ~BinaryTraceFile ();
+
+  /**
+   * \brief Create a trace file and write its header
+   * \param filename the file name
+   * \param compress whether to compress the blocks
+   * \param blockEvents the number of events per block
+   * \return false if the file cannot be created
+   */
+  bool Create (std::string const &filename, bool compress = true, uint32_t blockEvents = 4096);
+
+  /**
+   * \brief Open an existing trace file and read its header
+   * \param filename the file name
+   * \return false if the file cannot be opened or is not a trace file
+   */
+  bool Open (std::string const &filename);
+
+  /**
+   * \brief Write the pending events, if the file was created, and
+   * close the file
+   */
+  void Close (void);
+
+  /**
+   * \brief Record an event in a file created by Create
+   * \param event the event
+   */
+  void Write (const BinaryTraceEvent &event)
+  {
+    m_events.push_back (event);
+    if (m_events.size () == m_blockEvents)
+      {
+        WriteBlock ();
+      }
+  }
+
+  /**
+   * \brief Read the next event of a file opened by Open
+   * \param [out] event the event
+   * \return false at the end of the file or if the file is corrupted
+   */
+  bool Read (BinaryTraceEvent &event);
+
+  /**
+   * \return the time resolution of the file, as a Time::Unit
+   */
+  int GetResolution (void) const;
+
+  /**
+   * \return true if an operation on the file failed
+   */
+  bool Fail (void) const;
+
+private:
+  /// Disable copy
+  BinaryTraceFile (const BinaryTraceFile &);
+  /// Disable assignment
+  BinaryTraceFile & operator = (const BinaryTraceFile &);
+
+  /**
+   * \brief Encode the pending events and write them as a block
+   */
+  void WriteBlock (void);
+
+  /**
+   * \brief Read and decode the next block
+   * \return false at the end of the file or if the block is corrupted
+   */
+  bool ReadBlock (void);
+
+  std::fstream m_file;                   //!< the file
+  bool m_compress;                       //!< whether the blocks are compressed
+  uint32_t m_blockEvents;                //!< the number of events per block
+  int m_resolution;                      //!< the time resolution of the file
+  std::vector<BinaryTraceEvent> m_events; //!< the events of the current block
+  std::vector<uint8_t> m_buffer;         //!< the encoded columns of a block
+  uint32_t m_next;                       //!< the next event to read in m_events
+  bool m_writing;                        //!< whether the file was created
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
@@ -24,6 +24,7 @@
 #include "ns3/simulator.h"
 #include "ns3/uinteger.h"
 #include "ns3/queue-item.h"
+#include <limits>
 
 namespace ns3 {
 
@@ -135,6 +136,32 @@ NetDeviceQueue::NotifyTransmittedBytes (uint32_t bytes)
     }
 }
 
+uint32_t
+NetDeviceQueue::GetAvailablePackets (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (IsStopped ())
+    {
+      return 0;
+    }
+  if (!m_availablePackets)
+    {
+      return std::numeric_limits<uint32_t>::max ();
+    }
+  return m_availablePackets ();
+}
+
+int32_t
+NetDeviceQueue::GetAvailableBytes (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_queueLimits)
+    {
+      return std::numeric_limits<int32_t>::max ();
+    }
+  return m_queueLimits->Available ();
+}
+
 void
 NetDeviceQueue::ResetQueueLimits ()
 {
@@ -27,6 +27,7 @@
 #include "ns3/ptr.h"
 #include "ns3/log.h"
 #include "ns3/net-device.h"
+#include "ns3/queue-size.h"
 
 namespace ns3 {
 
@@ -124,6 +125,30 @@ public:
    */
   void NotifyTransmittedBytes (uint32_t bytes);
 
+  /**
+   * \brief Get the number of packets the device transmission queue can
+   *        accept before being stopped
+   * \return the number of packets that can be sent to the device
+   *
+   * Called by queue discs to determine how many packets can be handed to the
+   * device in a batch. The returned value is zero if the queue is stopped,
+   * exact if the device queue (connected through ConnectQueueTraces) holds
+   * packets, and one if it holds bytes (since the size of the packets the
+   * device adds its headers to is not known in advance).
+   */
+  uint32_t GetAvailablePackets (void) const;
+
+  /**
+   * \brief Get the number of bytes the queue limits object allows to send
+   * \return the number of bytes available, or the largest int32_t value if
+   *         no queue limits object is set
+   *
+   * As in the Linux function qdisc_avail_bulklimit, a batch of packets is
+   * built as long as this budget is positive, so that the queue limits are
+   * exceeded by at most one packet.
+   */
+  int32_t GetAvailableBytes (void) const;
+
   /**
    * \brief Reset queue limits state
    */
@@ -201,6 +226,7 @@ private:
   bool m_stoppedByQueueLimits;    //!< True if the queue has been stopped by a queue limits object
   Ptr<QueueLimits> m_queueLimits; //!< Queue limits object
   WakeCallback m_wakeCallback;    //!< Wake callback
+  std::function<uint32_t (void)> m_availablePackets; //!< Room in the device queue, in packets
   Ptr<NetDevice> m_device;        //!< the netdevice aggregated to the NetDeviceQueueInterface
 
   NS_LOG_TEMPLATE_DECLARE;        //!< redefinition of the log component
@@ -317,6 +343,18 @@ NetDeviceQueue::ConnectQueueTraces (Ptr<QueueType> queue)
   queue->TraceConnectWithoutContext ("DropBeforeEnqueue",
                                      MakeCallback (&NetDeviceQueue::PacketDiscarded<QueueType>, this)
                                      .Bind (PeekPointer (queue)));
+
+  QueueType* q = PeekPointer (queue);
+  m_availablePackets = [q] ()
+    {
+      QueueSize max = q->GetMaxSize ();
+      QueueSize current = q->GetCurrentSize ();
+      if (max.GetUnit () != QueueSizeUnit::PACKETS)
+        {
+          return 1u;
+        }
+      return (current.GetValue () < max.GetValue ()) ? max.GetValue () - current.GetValue () : 0u;
+    };
 }
 
 template <typename QueueType>
@@ -20,6 +20,7 @@
 #include "ns3/log.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/abort.h"
+#include "ns3/async-stream-buffer.h"
 #include <fstream>
 
 namespace ns3 {
@@ -27,7 +28,9 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("OutputStreamWrapper");
 
 OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmode filemode)
-  : m_destroyable (true)
+  : m_destroyable (true),
+    m_writeBuffer (0),
+    m_writeStream (0)
 {
   NS_LOG_FUNCTION (this << filename << filemode);
   std::ofstream* os = new std::ofstream ();
@@ -39,7 +42,7 @@ OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmo
 }
 
 OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
-  : m_ostream (os), m_destroyable (false)
+  : m_ostream (os), m_destroyable (false), m_writeBuffer (0), m_writeStream (0)
 {
   NS_LOG_FUNCTION (this << os);
   FatalImpl::RegisterStream (m_ostream);
@@ -50,6 +53,12 @@ OutputStreamWrapper::~OutputStreamWrapper ()
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::UnregisterStream (m_ostream);
+  if (m_writeBuffer)
+    {
+      // write the buffered data before closing the file
+      delete m_writeStream;
+      delete m_writeBuffer;
+    }
   if (m_destroyable) delete m_ostream;
   m_ostream = 0;
 }
@@ -58,7 +67,27 @@ std::ostream *
 OutputStreamWrapper::GetStream (void)
 {
   NS_LOG_FUNCTION (this);
-  return m_ostream;
+  return m_writeStream ? m_writeStream : m_ostream;
+}
+
+void
+OutputStreamWrapper::SetWriteBuffer (uint32_t blockSize, uint32_t maxBlocks)
+{
+  NS_LOG_FUNCTION (this << blockSize << maxBlocks);
+  NS_ABORT_MSG_UNLESS (m_destroyable, "Only the streams of the files opened by the wrapper can be buffered");
+  NS_ABORT_MSG_IF (m_writeBuffer, "The stream is already buffered");
+  m_writeBuffer = new AsyncStreamBuffer (m_ostream->rdbuf (), blockSize, maxBlocks);
+  m_writeStream = new std::ostream (m_writeBuffer);
+}
+
+void
+OutputStreamWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writeBuffer && !m_writeBuffer->Flush ())
+    {
+      m_ostream->setstate (std::ios::badbit);
+    }
 }
 
 } // namespace ns3
@@ -26,6 +26,8 @@
 
 namespace ns3 {
 
+class AsyncStreamBuffer;
+
 /**
  * @brief A class encapsulating an output stream.
  *
@@ -92,9 +94,31 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * Buffer the data written to the file in large blocks, written to the
+   * file by a background thread.  The stream returned by GetStream is
+   * replaced, hence this method must be called before GetStream.  The
+   * buffered data reaches the file upon destruction of the wrapper,
+   * upon Flush and upon Simulator::Destroy; flushing the stream itself
+   * does not wait for the data to be written.
+   *
+   * Only the wrappers opening a file can be buffered.
+   *
+   * \param blockSize the size of the blocks, in bytes
+   * \param maxBlocks the maximum number of blocks
+   */
+  void SetWriteBuffer (uint32_t blockSize, uint32_t maxBlocks);
+
+  /**
+   * Write the buffered data to the file, if any.
+   */
+  void Flush (void);
+
 private:
   std::ostream *m_ostream; //!< The output stream
   bool m_destroyable; //!< Can be destroyed
+  AsyncStreamBuffer *m_writeBuffer; //!< The buffer of the data, if any
+  std::ostream *m_writeStream; //!< The stream writing to the buffer, if any
 };
 
 } // namespace ns3
@@ -115,6 +115,20 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
     } 
 }
 
+void
+PcapFileWrapper::SetWriteBuffer (uint32_t blockSize, uint32_t maxBlocks)
+{
+  NS_LOG_FUNCTION (this << blockSize << maxBlocks);
+  m_file.SetWriteBuffer (blockSize, maxBlocks);
+}
+
+void
+PcapFileWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_file.Flush ();
+}
+
 void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
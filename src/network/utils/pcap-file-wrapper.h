@@ -109,6 +109,22 @@ public:
              uint32_t snapLen = std::numeric_limits<uint32_t>::max (), 
              int32_t tzCorrection = PcapFile::ZONE_DEFAULT);
 
+  /**
+   * \brief Buffer the records written to the file in large blocks,
+   * written to the file by a background thread.
+   *
+   * \param blockSize the size of the blocks, in bytes
+   * \param maxBlocks the maximum number of blocks
+   *
+   * \see PcapFile::SetWriteBuffer
+   */
+  void SetWriteBuffer (uint32_t blockSize, uint32_t maxBlocks);
+
+  /**
+   * \brief Write the buffered records to the file, if any
+   */
+  void Flush (void);
+
   /**
    * \brief Write the next packet to file
    * 
@@ -29,6 +29,7 @@
 #include "pcap-file.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
+#include "ns3/async-stream-buffer.h"
 //
 // This file is used as part of the ns-3 test framework, so please refrain from 
 // adding any ns-3 specific constructs such as Packet to this file.
@@ -49,6 +50,8 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 
 PcapFile::PcapFile ()
   : m_file (),
+    m_writeBuffer (0),
+    m_writeStream (&m_file),
     m_swapMode (false),
     m_nanosecMode (false)
 {
@@ -68,7 +71,7 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_file.fail ();
+  return m_file.fail () || (m_writeBuffer != 0 && m_writeBuffer->IsFailed ());
 }
 bool 
 PcapFile::Eof (void) const
@@ -88,9 +91,36 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_writeBuffer != 0)
+    {
+      // write the buffered records before closing the file
+      delete m_writeStream;
+      delete m_writeBuffer;
+      m_writeBuffer = 0;
+      m_writeStream = &m_file;
+    }
   m_file.close ();
 }
 
+void
+PcapFile::SetWriteBuffer (uint32_t blockSize, uint32_t maxBlocks)
+{
+  NS_LOG_FUNCTION (this << blockSize << maxBlocks);
+  NS_ASSERT (m_writeBuffer == 0);
+  m_writeBuffer = new AsyncStreamBuffer (m_file.rdbuf (), blockSize, maxBlocks);
+  m_writeStream = new std::ostream (m_writeBuffer);
+}
+
+void
+PcapFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writeBuffer != 0 && !m_writeBuffer->Flush ())
+    {
+      m_file.setstate (std::ios::badbit);
+    }
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -206,6 +236,7 @@ PcapFile::WriteFileHeader (void)
   // If we're initializing the file, we need to write the pcap file header
   // at the start of the file.
   //
+  Flush ();
   m_file.seekp (0, std::ios::beg);
  
   //
@@ -419,14 +450,15 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
     }
 
   //
-  // Watch out for memory alignment differences between machines, so write
-  // them all individually.
+  // Watch out for memory alignment differences between machines, so copy
+  // the fields individually, then write them all at once.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
-  NS_BUILD_DEBUG(m_file.flush());
+  char buf[16];
+  std::memcpy (buf, &header.m_tsSec, 4);
+  std::memcpy (buf + 4, &header.m_tsUsec, 4);
+  std::memcpy (buf + 8, &header.m_inclLen, 4);
+  std::memcpy (buf + 12, &header.m_origLen, 4);
+  m_writeStream->write (buf, sizeof (buf));
   return inclLen;
 }
 
@@ -435,8 +467,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  m_writeStream->write ((const char *)data, inclLen);
+  NS_BUILD_DEBUG (if (m_writeBuffer == 0) m_file.flush ());
 }
 
 void 
@@ -444,8 +476,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
-  p->CopyData (&m_file, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  p->CopyData (m_writeStream, inclLen);
+  NS_BUILD_DEBUG (if (m_writeBuffer == 0) m_file.flush ());
 }
 
 void 
@@ -460,9 +492,9 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
-  headerBuffer.CopyData (&m_file, toCopy);
+  headerBuffer.CopyData (m_writeStream, toCopy);
   inclLen -= toCopy;
-  p->CopyData (&m_file, inclLen);
+  p->CopyData (m_writeStream, inclLen);
 }
 
 void
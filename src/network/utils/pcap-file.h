@@ -30,6 +30,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class AsyncStreamBuffer;
 
 
 /**
@@ -122,6 +123,24 @@ public:
              bool swapMode = false,
              bool nanosecMode = false);
 
+  /**
+   * \brief Buffer the records written to the file in large blocks,
+   * written to the file by a background thread
+   *
+   * The file must have been opened with write permissions. The buffered
+   * records reach the file upon Close, upon Flush and upon
+   * Simulator::Destroy.
+   *
+   * \param blockSize the size of the blocks, in bytes
+   * \param maxBlocks the maximum number of blocks
+   */
+  void SetWriteBuffer (uint32_t blockSize, uint32_t maxBlocks);
+
+  /**
+   * \brief Write the buffered records to the file, if any
+   */
+  void Flush (void);
+
   /**
    * \brief Write next packet to file
    * 
@@ -368,6 +387,8 @@ private:
 
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
+  AsyncStreamBuffer *m_writeBuffer; //!< buffer of the records, if any
+  std::ostream  *m_writeStream; //!< stream the records are written to
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
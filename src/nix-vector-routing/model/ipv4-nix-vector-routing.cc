@@ -19,7 +19,9 @@
  */
 
 #include <queue>
+#include <set>
 #include <iomanip>
+#include <limits>
 
 #include "ns3/log.h"
 #include "ns3/abort.h"
@@ -34,7 +36,21 @@ NS_LOG_COMPONENT_DEFINE ("Ipv4NixVectorRouting");
 
 NS_OBJECT_ENSURE_REGISTERED (Ipv4NixVectorRouting);
 
-bool Ipv4NixVectorRouting::g_isCacheDirty = false;
+Ipv4NixVectorRouting::NixTopology Ipv4NixVectorRouting::g_topology;
+
+/// Parent of the nodes not reached by the BFS
+static const uint32_t NIX_NO_PARENT = std::numeric_limits<uint32_t>::max ();
+
+/// Number of parent entries, summed over the cached shortest path
+/// trees, above which trees are evicted (64 MiB of parents)
+static const uint64_t NIX_MAX_TREE_ENTRIES = 1 << 24;
+
+Ipv4NixVectorRouting::NixTopology::NixTopology ()
+  : epoch (0),
+    adjacencyDirty (true),
+    addressesDirty (true)
+{
+}
 
 TypeId 
 Ipv4NixVectorRouting::GetTypeId (void)
@@ -48,7 +64,7 @@ Ipv4NixVectorRouting::GetTypeId (void)
 }
 
 Ipv4NixVectorRouting::Ipv4NixVectorRouting ()
-  : m_totalNeighbors (0)
+  : m_epoch (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -76,6 +92,11 @@ Ipv4NixVectorRouting::DoDispose ()
   m_node = 0;
   m_ipv4 = 0;
 
+  // release the shared state, the nodes are being disposed of as well
+  uint64_t epoch = g_topology.epoch;
+  g_topology = NixTopology ();
+  g_topology.epoch = epoch + 1;
+
   Ipv4RoutingProtocol::DoDispose ();
 }
 
@@ -92,21 +113,237 @@ void
 Ipv4NixVectorRouting::FlushGlobalNixRoutingCache (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+  InvalidateTopology ();
+}
+
+void
+Ipv4NixVectorRouting::InvalidateTopology (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  // every node flushes its caches upon its next lookup
+  g_topology.epoch++;
+  g_topology.adjacencyDirty = true;
+  g_topology.addressesDirty = true;
+  g_topology.trees.clear ();
+  g_topology.paths.clear ();
+  g_topology.freePaths.clear ();
+  g_topology.pathsFrom.clear ();
+  g_topology.pathsThrough.clear ();
+}
+
+void
+Ipv4NixVectorRouting::UpdateTopology (void) const
+{
+  uint32_t numberOfNodes = NodeList::GetNNodes ();
+  if (g_topology.nodeOffset.size () != numberOfNodes + 1 && !g_topology.adjacencyDirty)
+    {
+      NS_LOG_LOGIC ("Nodes were added, the shared topology is stale");
+      InvalidateTopology ();
+    }
+
+  if (g_topology.adjacencyDirty)
     {
-      Ptr<Node> node = *i;
-      Ptr<Ipv4NixVectorRouting> rp = node->GetObject<Ipv4NixVectorRouting> ();
+      NS_LOG_LOGIC ("Building the shared adjacency of " << numberOfNodes << " nodes");
+      g_topology.nodeOffset.assign (1, 0);
+      g_topology.linkDevice.clear ();
+      g_topology.linkBridge.clear ();
+      g_topology.neighborOffset.assign (1, 0);
+      g_topology.neighborNode.clear ();
+      g_topology.neighborDevice.clear ();
+
+      for (uint32_t n = 0; n < numberOfNodes; n++)
+        {
+          Ptr<Node> node = NodeList::GetNode (n);
+          for (uint32_t i = 0; i < node->GetNDevices (); i++)
+            {
+              Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+              Ptr<Channel> channel = localNetDevice->GetChannel ();
+              if (channel == 0)
+                {
+                  continue;
+                }
+
+              NetDeviceContainer netDeviceContainer;
+              GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+
+              g_topology.linkDevice.push_back (i);
+              g_topology.linkBridge.push_back (localNetDevice->IsBridge ());
+              for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+                {
+                  g_topology.neighborNode.push_back ((*iter)->GetNode ()->GetId ());
+                  g_topology.neighborDevice.push_back ((*iter)->GetIfIndex ());
+                }
+              g_topology.neighborOffset.push_back (g_topology.neighborNode.size ());
+            }
+          g_topology.nodeOffset.push_back (g_topology.linkDevice.size ());
+        }
+      g_topology.pathsFrom.resize (numberOfNodes);
+      g_topology.pathsThrough.resize (numberOfNodes);
+      g_topology.adjacencyDirty = false;
+    }
+
+  if (g_topology.addressesDirty)
+    {
+      NS_LOG_LOGIC ("Building the shared address map");
+      g_topology.nodeByIp.clear ();
+      for (uint32_t n = 0; n < numberOfNodes; n++)
+        {
+          Ptr<Ipv4> ipv4 = NodeList::GetNode (n)->GetObject<Ipv4> ();
+          if (!ipv4)
+            {
+              continue;
+            }
+          for (uint32_t j = 0; j < ipv4->GetNInterfaces (); j++)
+            {
+              for (uint32_t k = 0; k < ipv4->GetNAddresses (j); k++)
+                {
+                  // the first node owning an address wins
+                  g_topology.nodeByIp.insert (std::make_pair (ipv4->GetAddress (j, k).GetLocal (), n));
+                }
+            }
+        }
+      g_topology.addressesDirty = false;
+    }
+}
+
+void
+Ipv4NixVectorRouting::RegisterPath (const std::vector<uint32_t> & parentVector, uint32_t source, uint32_t dest)
+{
+  // a source caches one nix-vector per destination address, possibly
+  // several per destination node, and output interfaces may give them
+  // different paths: they all share the slot of the destination node
+  std::unordered_map<uint32_t, uint32_t> &pathsFrom = g_topology.pathsFrom.at (source);
+  std::unordered_map<uint32_t, uint32_t>::iterator it = pathsFrom.find (dest);
+  uint32_t id;
+  if (it != pathsFrom.end ())
+    {
+      id = it->second;
+    }
+  else if (!g_topology.freePaths.empty ())
+    {
+      id = g_topology.freePaths.back ();
+      g_topology.freePaths.pop_back ();
+      pathsFrom[dest] = id;
+    }
+  else
+    {
+      id = g_topology.paths.size ();
+      g_topology.paths.push_back (std::vector<uint32_t> ());
+      pathsFrom[dest] = id;
+    }
+
+  std::vector<uint32_t> &path = g_topology.paths[id];
+  for (uint32_t node = dest; ; node = parentVector.at (node))
+    {
+      if (g_topology.pathsThrough.at (node).insert (id).second)
+        {
+          path.push_back (node);
+        }
+      if (node == source)
+        {
+          break;
+        }
+    }
+}
+
+void
+Ipv4NixVectorRouting::ReleasePaths (uint32_t source)
+{
+  NS_LOG_FUNCTION (source);
+  if (source >= g_topology.pathsFrom.size ())
+    {
+      return;
+    }
+
+  std::unordered_map<uint32_t, uint32_t> &pathsFrom = g_topology.pathsFrom[source];
+  for (std::unordered_map<uint32_t, uint32_t>::const_iterator it = pathsFrom.begin (); it != pathsFrom.end (); it++)
+    {
+      std::vector<uint32_t> &path = g_topology.paths[it->second];
+      for (std::vector<uint32_t>::const_iterator n = path.begin (); n != path.end (); n++)
+        {
+          g_topology.pathsThrough[*n].erase (it->second);
+        }
+      path.clear ();
+      g_topology.freePaths.push_back (it->second);
+    }
+  pathsFrom.clear ();
+}
+
+void
+Ipv4NixVectorRouting::InvalidatePathsThrough (uint32_t node)
+{
+  NS_LOG_FUNCTION (node);
+  if (node >= g_topology.pathsThrough.size ())
+    {
+      return;
+    }
+
+  // the sources and the transit nodes of the paths through the node
+  std::set<uint32_t> affected;
+  const std::unordered_set<uint32_t> &ids = g_topology.pathsThrough[node];
+  for (std::unordered_set<uint32_t>::const_iterator id = ids.begin (); id != ids.end (); id++)
+    {
+      const std::vector<uint32_t> &path = g_topology.paths[*id];
+      affected.insert (path.begin (), path.end ());
+    }
+
+  // their caches are flushed as a whole, so all their paths are released
+  for (std::set<uint32_t>::const_iterator n = affected.begin (); n != affected.end (); n++)
+    {
+      ReleasePaths (*n);
+      Ptr<Ipv4NixVectorRouting> rp = NodeList::GetNode (*n)->GetObject<Ipv4NixVectorRouting> ();
       if (!rp)
         {
           continue;
         }
-      NS_LOG_LOGIC ("Flushing Nix caches.");
+      NS_LOG_LOGIC ("Flushing Nix caches of node " << *n);
       rp->FlushNixCache ();
       rp->FlushIpv4RouteCache ();
     }
 }
 
+void
+Ipv4NixVectorRouting::InvalidateTrees (uint32_t node, uint32_t ifIndex)
+{
+  NS_LOG_FUNCTION (node << ifIndex);
+  if (g_topology.adjacencyDirty || node + 1 >= g_topology.nodeOffset.size ())
+    {
+      g_topology.trees.clear ();
+      return;
+    }
+
+  for (uint32_t l = g_topology.nodeOffset[node]; l < g_topology.nodeOffset[node + 1]; l++)
+    {
+      if (g_topology.linkDevice[l] != ifIndex)
+        {
+          continue;
+        }
+      // a tree is affected if it reaches a neighbor through this node
+      std::unordered_map<uint32_t, std::vector<uint32_t> >::iterator it = g_topology.trees.begin ();
+      while (it != g_topology.trees.end ())
+        {
+          bool usesLink = false;
+          for (uint32_t k = g_topology.neighborOffset[l]; k < g_topology.neighborOffset[l + 1]; k++)
+            {
+              if (it->second[g_topology.neighborNode[k]] == node)
+                {
+                  usesLink = true;
+                  break;
+                }
+            }
+          if (usesLink)
+            {
+              NS_LOG_LOGIC ("Dropping the shortest path tree of node " << it->first);
+              it = g_topology.trees.erase (it);
+            }
+          else
+            {
+              it++;
+            }
+        }
+    }
+}
+
 void
 Ipv4NixVectorRouting::FlushNixCache (void) const
 {
@@ -149,13 +386,26 @@ Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetD
   else
     {
       // otherwise proceed as normal 
-      // and build the nix vector
-      std::vector< Ptr<Node> > parentVector;
-
-      BFS (NodeList::GetNNodes (), source, destNode, parentVector, oif);
+      // and build the nix vector, from the shared
+      // shortest path tree of the source unless a
+      // specific output interface is to be used
+      uint32_t sourceId = source->GetId ();
+      uint32_t destId = destNode->GetId ();
+      std::vector<uint32_t> oifParentVector;
+      const std::vector<uint32_t> *parentVector;
+      if (oif)
+        {
+          BFS (sourceId, oifParentVector, oif);
+          parentVector = &oifParentVector;
+        }
+      else
+        {
+          parentVector = &GetShortestPathTree (sourceId);
+        }
 
-      if (BuildNixVector (parentVector, source->GetId (), destNode->GetId (), nixVector))
+      if (BuildNixVector (*parentVector, sourceId, destId, nixVector))
         {
+          RegisterPath (*parentVector, sourceId, destId);
           return nixVector;
         }
       else
@@ -230,7 +480,7 @@ Ipv4NixVectorRouting::BuildNixVectorLocal (Ptr<NixVector> nixVector)
 }
 
 bool
-Ipv4NixVectorRouting::BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector)
+Ipv4NixVectorRouting::BuildNixVector (const std::vector<uint32_t> & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
@@ -239,71 +489,50 @@ Ipv4NixVectorRouting::BuildNixVector (const std::vector< Ptr<Node> > & parentVec
       return true;
     }
 
-  if (parentVector.at (dest) == 0)
+  if (parentVector.at (dest) == NIX_NO_PARENT)
     {
       return false;
     }
 
-  Ptr<Node> parentNode = parentVector.at (dest);
-
-  uint32_t numberOfDevices = parentNode->GetNDevices ();
-  uint32_t destId = 0;
-  uint32_t totalNeighbors = 0;
-
-  // scan through the net devices on the parent node
-  // and then look at the nodes adjacent to them
-  for (uint32_t i = 0; i < numberOfDevices; i++)
+  // walk the parent vector, grabbing the path
+  // and building the nix vector
+  for (uint32_t node = dest; node != source; node = parentVector.at (node))
     {
-      // Get a net device from the node
-      // as well as the channel, and figure
-      // out the adjacent net devices
-      Ptr<NetDevice> localNetDevice = parentNode->GetDevice (i);
-      if (localNetDevice->IsBridge ())
-        {
-          continue;
-        }
-      Ptr<Channel> channel = localNetDevice->GetChannel ();
-      if (channel == 0)
-        {
-          continue;
-        }
-
-      // this function takes in the local net dev, and channel, and
-      // writes to the netDeviceContainer the adjacent net devs
-      NetDeviceContainer netDeviceContainer;
-      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-      // Finally we can get the adjacent nodes
-      // and scan through them.  If we find the 
-      // node that matches "dest" then we can add 
-      // the index  to the nix vector.
+      uint32_t parentNode = parentVector.at (node);
+      uint32_t destId = 0;
+      uint32_t totalNeighbors = 0;
+
+      // scan through the links of the parent node, but
+      // the bridges, and the nodes adjacent to them.  If
+      // we find the node that matches "node" then we can
+      // add the index to the nix vector.
       // the index corresponds to the neighbor index
-      uint32_t offset = 0;
-      for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+      for (uint32_t l = g_topology.nodeOffset[parentNode]; l < g_topology.nodeOffset[parentNode + 1]; l++)
         {
-          Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-          if (remoteNode->GetId () == dest)
+          if (g_topology.linkBridge[l])
+            {
+              continue;
+            }
+          uint32_t first = g_topology.neighborOffset[l];
+          uint32_t last = g_topology.neighborOffset[l + 1];
+          for (uint32_t k = first; k < last; k++)
             {
-              destId = totalNeighbors + offset;
+              if (g_topology.neighborNode[k] == node)
+                {
+                  destId = totalNeighbors + k - first;
+                }
             }
-          offset += 1;
+          totalNeighbors += last - first;
         }
-
-      totalNeighbors += netDeviceContainer.GetN ();
+      NS_LOG_LOGIC ("Adding Nix: " << destId << " with " 
+                                   << nixVector->BitCount (totalNeighbors) << " bits, for node " << parentNode);
+      nixVector->AddNeighborIndex (destId, nixVector->BitCount (totalNeighbors));
     }
-  NS_LOG_LOGIC ("Adding Nix: " << destId << " with " 
-                               << nixVector->BitCount (totalNeighbors) << " bits, for node " << parentNode->GetId ());
-  nixVector->AddNeighborIndex (destId, nixVector->BitCount (totalNeighbors));
-
-  // recurse through parent vector, grabbing the path 
-  // and building the nix vector
-  BuildNixVector (parentVector, source, (parentVector.at (dest))->GetId (), nixVector);
   return true;
 }
 
 void
-Ipv4NixVectorRouting::GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer)
+Ipv4NixVectorRouting::GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer) const
 {
   NS_LOG_FUNCTION_NOARGS ();
 
@@ -347,58 +576,47 @@ Ipv4NixVectorRouting::GetNodeByIp (Ipv4Address dest)
 { 
   NS_LOG_FUNCTION_NOARGS ();
 
-  NodeContainer allNodes = NodeContainer::GetGlobal ();
-  Ptr<Node> destNode;
-
-  for (NodeContainer::Iterator i = allNodes.Begin (); i != allNodes.End (); ++i)
-    {
-      Ptr<Node> node = *i;
-      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-      if (ipv4->GetInterfaceForAddress (dest) != -1)
-        {
-          destNode = node;
-          break;
-        }
-    }
-
-  if (!destNode)
+  std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash>::const_iterator it = g_topology.nodeByIp.find (dest);
+  if (it == g_topology.nodeByIp.end ())
     {
       NS_LOG_ERROR ("Couldn't find dest node given the IP" << dest);
       return 0;
     }
 
-  return destNode;
+  return NodeList::GetNode (it->second);
 }
 
-uint32_t
-Ipv4NixVectorRouting::FindTotalNeighbors (void)
+const std::vector<uint32_t> &
+Ipv4NixVectorRouting::GetShortestPathTree (uint32_t source)
 {
-  uint32_t numberOfDevices = m_node->GetNDevices ();
-  uint32_t totalNeighbors = 0;
+  NS_LOG_FUNCTION (source);
 
-  // scan through the net devices on the parent node
-  // and then look at the nodes adjacent to them
-  for (uint32_t i = 0; i < numberOfDevices; i++)
+  std::unordered_map<uint32_t, std::vector<uint32_t> >::iterator it = g_topology.trees.find (source);
+  if (it == g_topology.trees.end ())
     {
-      // Get a net device from the node
-      // as well as the channel, and figure
-      // out the adjacent net devices
-      Ptr<NetDevice> localNetDevice = m_node->GetDevice (i);
-      Ptr<Channel> channel = localNetDevice->GetChannel ();
-      if (channel == 0)
+      NS_LOG_LOGIC ("Shortest path tree of node " << source << " not in cache, build: ");
+
+      // each tree holds one parent per node: keep the cache bounded
+      uint64_t numberOfNodes = g_topology.nodeOffset.size () - 1;
+      while (!g_topology.trees.empty ()
+             && (g_topology.trees.size () + 1) * numberOfNodes > NIX_MAX_TREE_ENTRIES)
         {
-          continue;
+          NS_LOG_LOGIC ("Evicting the shortest path tree of node " << g_topology.trees.begin ()->first);
+          g_topology.trees.erase (g_topology.trees.begin ());
         }
 
-      // this function takes in the local net dev, and channel, and
-      // writes to the netDeviceContainer the adjacent net devs
-      NetDeviceContainer netDeviceContainer;
-      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-      totalNeighbors += netDeviceContainer.GetN ();
+      it = g_topology.trees.insert (std::make_pair (source, std::vector<uint32_t> ())).first;
+      BFS (source, it->second, 0);
     }
+  return it->second;
+}
 
-  return totalNeighbors;
+uint32_t
+Ipv4NixVectorRouting::FindTotalNeighbors (void)
+{
+  uint32_t id = m_node->GetId ();
+  return g_topology.neighborOffset[g_topology.nodeOffset[id + 1]]
+         - g_topology.neighborOffset[g_topology.nodeOffset[id]];
 }
 
 Ptr<BridgeNetDevice>
@@ -444,36 +662,25 @@ Ipv4NixVectorRouting::NetDeviceIsBridged (Ptr<NetDevice> nd) const
 uint32_t
 Ipv4NixVectorRouting::FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv4Address & gatewayIp)
 {
-  uint32_t numberOfDevices = m_node->GetNDevices ();
+  uint32_t id = m_node->GetId ();
   uint32_t index = 0;
   uint32_t totalNeighbors = 0;
 
-  // scan through the net devices on the parent node
+  // scan through the links of the node
   // and then look at the nodes adjacent to them
-  for (uint32_t i = 0; i < numberOfDevices; i++)
+  for (uint32_t l = g_topology.nodeOffset[id]; l < g_topology.nodeOffset[id + 1]; l++)
     {
-      // Get a net device from the node
-      // as well as the channel, and figure
-      // out the adjacent net devices
-      Ptr<NetDevice> localNetDevice = m_node->GetDevice (i);
-      Ptr<Channel> channel = localNetDevice->GetChannel ();
-      if (channel == 0)
-        {
-          continue;
-        }
-
-      // this function takes in the local net dev, and channel, and
-      // writes to the netDeviceContainer the adjacent net devs
-      NetDeviceContainer netDeviceContainer;
-      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+      uint32_t first = g_topology.neighborOffset[l];
+      uint32_t neighbors = g_topology.neighborOffset[l + 1] - first;
 
       // check how many neighbors we have
-      if (nodeIndex < (totalNeighbors + netDeviceContainer.GetN ()))
+      if (nodeIndex < (totalNeighbors + neighbors))
         {
           // found the proper net device
-          index = i;
-          Ptr<NetDevice> gatewayDevice = netDeviceContainer.Get (nodeIndex-totalNeighbors);
-          Ptr<Node> gatewayNode = gatewayDevice->GetNode ();
+          index = g_topology.linkDevice[l];
+          uint32_t k = first + nodeIndex - totalNeighbors;
+          Ptr<Node> gatewayNode = NodeList::GetNode (g_topology.neighborNode[k]);
+          Ptr<NetDevice> gatewayDevice = gatewayNode->GetDevice (g_topology.neighborDevice[k]);
           Ptr<Ipv4> ipv4 = gatewayNode->GetObject<Ipv4> ();
 
           uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (gatewayDevice);
@@ -481,7 +688,7 @@ Ipv4NixVectorRouting::FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv4Address
           gatewayIp = ifAddr.GetLocal ();
           break;
         }
-      totalNeighbors += netDeviceContainer.GetN ();
+      totalNeighbors += neighbors;
     }
 
   return index;
@@ -525,14 +732,7 @@ Ipv4NixVectorRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<
 
       // Get the interface number that we go out of, by extracting
       // from the nix-vector
-      if (m_totalNeighbors == 0)
-        {
-          m_totalNeighbors = FindTotalNeighbors ();
-        }
-
-      // Get the interface number that we go out of, by extracting
-      // from the nix-vector
-      uint32_t numberOfBits = nixVectorForPacket->BitCount (m_totalNeighbors);
+      uint32_t numberOfBits = nixVectorForPacket->BitCount (FindTotalNeighbors ());
       uint32_t nodeIndex = nixVectorForPacket->ExtractNeighborIndex (numberOfBits);
 
       // Search here in a cache for this node index 
@@ -654,11 +854,7 @@ Ipv4NixVectorRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
 
   // Get the interface number that we go out of, by extracting
   // from the nix-vector
-  if (m_totalNeighbors == 0)
-    {
-      m_totalNeighbors = FindTotalNeighbors ();
-    }
-  uint32_t numberOfBits = nixVector->BitCount (m_totalNeighbors);
+  uint32_t numberOfBits = nixVector->BitCount (FindTotalNeighbors ());
   uint32_t nodeIndex = nixVector->ExtractNeighborIndex (numberOfBits);
 
   rtentry = GetIpv4RouteInCache (header.GetDestination ());
@@ -749,180 +945,122 @@ Ipv4NixVectorRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::
 }
 
 // virtual functions from Ipv4RoutingProtocol 
+// A new link or address may shorten any path, hence all the caches
+// are flushed, while a link or address going away only affects the
+// paths through the node.
 void
 Ipv4NixVectorRouting::NotifyInterfaceUp (uint32_t i)
 {
-  g_isCacheDirty = true;
+  InvalidateTopology ();
 }
 void
 Ipv4NixVectorRouting::NotifyInterfaceDown (uint32_t i)
 {
-  g_isCacheDirty = true;
+  uint32_t node = m_ipv4->GetObject<Node> ()->GetId ();
+  InvalidateTrees (node, m_ipv4->GetNetDevice (i)->GetIfIndex ());
+  InvalidatePathsThrough (node);
 }
 void
 Ipv4NixVectorRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
-  g_isCacheDirty = true;
+  InvalidateTopology ();
 }
 void
 Ipv4NixVectorRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
-  g_isCacheDirty = true;
+  g_topology.addressesDirty = true;
+  InvalidatePathsThrough (m_ipv4->GetObject<Node> ()->GetId ());
 }
 
-bool
-Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source, 
-                           Ptr<Node> dest, std::vector< Ptr<Node> > & parentVector,
+void
+Ipv4NixVectorRouting::BFS (uint32_t source, std::vector<uint32_t> & parentVector,
                            Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  NS_LOG_LOGIC ("Going from Node " << source->GetId () << " to Node " << dest->GetId ());
-  std::queue< Ptr<Node> > greyNodeList;  // discovered nodes with unexplored children
+  NS_LOG_LOGIC ("Building the shortest path tree of Node " << source);
+  std::queue<uint32_t> greyNodeList;  // discovered nodes with unexplored children
 
   // reset the parent vector
-  parentVector.assign (numberOfNodes, 0); // initialize to 0
+  parentVector.assign (g_topology.nodeOffset.size () - 1, NIX_NO_PARENT);
 
   // Add the source node to the queue, set its parent to itself 
   greyNodeList.push (source);
-  parentVector.at (source->GetId ()) = source;
+  parentVector.at (source) = source;
 
   // BFS loop
   while (greyNodeList.size () != 0)
     {
-      Ptr<Node> currNode = greyNodeList.front ();
-      Ptr<Ipv4> ipv4 = currNode->GetObject<Ipv4> ();
- 
-      if (currNode == dest) 
-        {
-          NS_LOG_LOGIC ("Made it to Node " << currNode->GetId ());
-          return true;
-        }
+      uint32_t currNode = greyNodeList.front ();
+      Ptr<Node> node = NodeList::GetNode (currNode);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
 
-      // if this is the first iteration of the loop and a 
-      // specific output interface was given, make sure 
-      // we go this way
-      if (currNode == source && oif)
+      // Iterate over the current node's links
+      // and push the adjacent vertices into the queue
+      for (uint32_t l = g_topology.nodeOffset[currNode]; l < g_topology.nodeOffset[currNode + 1]; l++)
         {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (g_topology.linkDevice[l]);
+
+          // if this is the source node and a 
+          // specific output interface was given, make sure 
+          // we go this way
+          if (currNode == source && oif && localNetDevice != oif)
+            {
+              continue;
+            }
+
           // make sure that we can go this way
           if (ipv4)
             {
-              uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (oif);
-              if (!(ipv4->IsUp (interfaceIndex)))
+              int32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (localNetDevice);
+              if (interfaceIndex == -1 || !(ipv4->IsUp (interfaceIndex)))
                 {
                   NS_LOG_LOGIC ("Ipv4Interface is down");
-                  return false;
+                  continue;
                 }
             }
-          if (!(oif->IsLinkUp ()))
+          if (!(localNetDevice->IsLinkUp ()))
             {
               NS_LOG_LOGIC ("Link is down.");
-              return false;
+              continue;
             }
-          Ptr<Channel> channel = oif->GetChannel ();
-          if (channel == 0)
-            { 
-              return false;
-            }
-
-          // this function takes in the local net dev, and channel, and
-          // writes to the netDeviceContainer the adjacent net devs
-          NetDeviceContainer netDeviceContainer;
-          GetAdjacentNetDevices (oif, channel, netDeviceContainer);
 
           // Finally we can get the adjacent nodes
           // and scan through them.  We push them
           // to the greyNode queue, if they aren't 
           // already there.
-          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+          for (uint32_t k = g_topology.neighborOffset[l]; k < g_topology.neighborOffset[l + 1]; k++)
             {
-              Ptr<Node> remoteNode = (*iter)->GetNode ();
+              uint32_t remoteNode = g_topology.neighborNode[k];
 
               // check to see if this node has been pushed before
               // by checking to see if it has a parent
-              // if it doesn't (null or 0), then set its parent and 
+              // if it doesn't, then set its parent and 
               // push to the queue
-              if (parentVector.at (remoteNode->GetId ()) == 0)
+              if (parentVector[remoteNode] == NIX_NO_PARENT)
                 {
-                  parentVector.at (remoteNode->GetId ()) = currNode;
+                  parentVector[remoteNode] = currNode;
                   greyNodeList.push (remoteNode);
                 }
             }
         }
-      else
-        {
-          // Iterate over the current node's adjacent vertices
-          // and push them into the queue
-          for (uint32_t i = 0; i < (currNode->GetNDevices ()); i++)
-            {
-              // Get a net device from the node
-              // as well as the channel, and figure
-              // out the adjacent net device
-              Ptr<NetDevice> localNetDevice = currNode->GetDevice (i);
-
-              // make sure that we can go this way
-              if (ipv4)
-                {
-                  uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (currNode->GetDevice (i));
-                  if (!(ipv4->IsUp (interfaceIndex)))
-                    {
-                      NS_LOG_LOGIC ("Ipv4Interface is down");
-                      continue;
-                    }
-                }
-              if (!(localNetDevice->IsLinkUp ()))
-                {
-                  NS_LOG_LOGIC ("Link is down.");
-                  continue;
-                }
-              Ptr<Channel> channel = localNetDevice->GetChannel ();
-              if (channel == 0)
-                { 
-                  continue;
-                }
-
-              // this function takes in the local net dev, and channel, and
-              // writes to the netDeviceContainer the adjacent net devs
-              NetDeviceContainer netDeviceContainer;
-              GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-              // Finally we can get the adjacent nodes
-              // and scan through them.  We push them
-              // to the greyNode queue, if they aren't 
-              // already there.
-              for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-                {
-                  Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-                  // check to see if this node has been pushed before
-                  // by checking to see if it has a parent
-                  // if it doesn't (null or 0), then set its parent and 
-                  // push to the queue
-                  if (parentVector.at (remoteNode->GetId ()) == 0)
-                    {
-                      parentVector.at (remoteNode->GetId ()) = currNode;
-                      greyNodeList.push (remoteNode);
-                    }
-                }
-            }
-        }
 
       // Pop off the head grey node.  We have all its children.
       // It is now black.
       greyNodeList.pop ();
     }
-
-  // Didn't find the dest...
-  return false;
 }
 
 void 
 Ipv4NixVectorRouting::CheckCacheStateAndFlush (void) const
 {
-  if (g_isCacheDirty)
+  UpdateTopology ();
+  if (m_epoch != g_topology.epoch)
     {
-      FlushGlobalNixRoutingCache ();
-      g_isCacheDirty = false;
+      NS_LOG_LOGIC ("Flushing Nix caches.");
+      FlushNixCache ();
+      FlushIpv4RouteCache ();
+      m_epoch = g_topology.epoch;
     }
 }
 
@@ -22,6 +22,9 @@
 #define IPV4_NIX_VECTOR_ROUTING_H
 
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "ns3/channel.h"
 #include "ns3/node-container.h"
@@ -33,6 +36,8 @@
 #include "ns3/bridge-net-device.h"
 #include "ns3/nstime.h"
 
+class NixVectorRoutingPathTestCase;
+
 namespace ns3 {
 
 /**
@@ -59,6 +64,9 @@ typedef std::map<Ipv4Address, Ptr<Ipv4Route> > Ipv4RouteMap_t;
  */
 class Ipv4NixVectorRouting : public Ipv4RoutingProtocol
 {
+  /// allow NixVectorRoutingPathTestCase class friend access
+  friend class ::NixVectorRoutingPathTestCase;
+
 public:
   Ipv4NixVectorRouting ();
   ~Ipv4NixVectorRouting ();
@@ -78,8 +86,9 @@ public:
 
   /**
    * @brief Called when run-time link topology change occurs
-   * which iterates through the node list and flushes any
-   * nix vector caches
+   * which invalidates the shared topology and the nix vector
+   * caches of all the nodes.  The caches are flushed lazily,
+   * by each node upon its next route lookup.
    *
    * \internal
    * \c const is used here due to need to potentially flush the cache
@@ -102,13 +111,6 @@ private:
    */
   void FlushIpv4RouteCache (void) const;
 
-  /**
-   * Upon a run-time topology change caches are
-   * flushed and the total number of neighbors is
-   * reset to zero
-   */
-  void ResetTotalNeighbors (void);
-
   /**
    * Takes in the source node and dest IP and calls GetNodeByIp,
    * BFS, accounting for any output interface specified, and finally
@@ -142,25 +144,26 @@ private:
    * \param [in] channel the channel to check
    * \param [out] netDeviceContainer the NetDeviceContainer of the NetDevices in the channel.
    */
-  void GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer);
+  void GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer) const;
 
   /**
-   * Iterates through the node list and finds the one
-   * corresponding to the given Ipv4Address
+   * Looks up the node corresponding to the given Ipv4Address
+   * in the shared address map
    * \param dest destination node IP
    * \return The node with the specified IP.
    */
   Ptr<Node> GetNodeByIp (Ipv4Address dest);
 
   /**
-   * Recurses the parent vector, created by BFS and actually builds the nixvector
+   * Walks the parent vector, created by BFS, from the destination
+   * back to the source and actually builds the nixvector
    * \param [in] parentVector Parent vector for retracing routes
    * \param [in] source Source Node index
    * \param [in] dest Destination Node index
    * \param [out] nixVector the NixVector to be used for routing
    * \returns true on success, false otherwise.
    */
-  bool BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
+  bool BuildNixVector (const std::vector<uint32_t> & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
 
   /**
    * Special variation of BuildNixVector for when a node is sending to itself
@@ -170,8 +173,8 @@ private:
   bool BuildNixVectorLocal (Ptr<NixVector> nixVector);
 
   /**
-   * Simple iterates through the nodes net-devices and determines
-   * how many neighbors it has
+   * Determines from the shared adjacency how many neighbors
+   * the node has
    * \returns the number of neighbors.
    */
   uint32_t FindTotalNeighbors (void);
@@ -194,20 +197,71 @@ private:
   uint32_t FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv4Address & gatewayIp);
 
   /**
-   * \brief Breadth first search algorithm.
-   * \param [in] numberOfNodes total number of nodes
-   * \param [in] source Source Node
-   * \param [in] dest Destination Node
+   * \brief Breadth first search algorithm over the shared adjacency.
+   *
+   * The search is not stopped when the destination is found, so that
+   * the parent vector holds the whole shortest path tree of the source.
+   *
+   * \param [in] source Source Node index
    * \param [out] parentVector Parent vector for retracing routes
    * \param [in] oif specific output interface to use from source node, if not null
-   * \returns false if dest not found, true o.w.
    */
-  bool BFS (uint32_t numberOfNodes,
-            Ptr<Node> source,
-            Ptr<Node> dest,
-            std::vector< Ptr<Node> > & parentVector,
+  void BFS (uint32_t source,
+            std::vector<uint32_t> & parentVector,
             Ptr<NetDevice> oif);
 
+  /**
+   * Returns the shortest path tree of a source node, running
+   * the BFS only if the tree is not already in the shared cache
+   * \param source Source Node index
+   * \returns the parent vector of the tree.
+   */
+  const std::vector<uint32_t> & GetShortestPathTree (uint32_t source);
+
+  /**
+   * Records the nodes along a path, so that their caches are
+   * flushed if any of them changes.  A path already recorded
+   * between the same nodes is extended rather than duplicated.
+   * \param parentVector Parent vector of the path
+   * \param source Source Node index
+   * \param dest Destination Node index
+   */
+  static void RegisterPath (const std::vector<uint32_t> & parentVector, uint32_t source, uint32_t dest);
+
+  /**
+   * Releases the slots of the recorded paths of a source, whose
+   * caches have just been flushed
+   * \param source Source Node index
+   */
+  static void ReleasePaths (uint32_t source);
+
+  /**
+   * Flushes the caches of the nodes on the recorded paths
+   * going through a node
+   * \param node index of the node that changed
+   */
+  static void InvalidatePathsThrough (uint32_t node);
+
+  /**
+   * Drops the cached shortest path trees that use the links
+   * through a device of a node
+   * \param node index of the node
+   * \param ifIndex index of the device in the node
+   */
+  static void InvalidateTrees (uint32_t node, uint32_t ifIndex);
+
+  /**
+   * Marks the shared topology as changed, so that it is rebuilt
+   * and the caches of all the nodes are flushed upon the next
+   * route lookup
+   */
+  static void InvalidateTopology (void);
+
+  /**
+   * Rebuilds the shared adjacency and address map, if needed
+   */
+  void UpdateTopology (void) const;
+
   void DoDispose (void);
 
   /* From Ipv4RoutingProtocol */
@@ -228,10 +282,45 @@ private:
   void CheckCacheStateAndFlush (void) const;
 
   /**
-   * Flag to mark when caches are dirty and need to be flushed.  
-   * Used for lazy cleanup of caches when there are many topology changes.
+   * \brief Topology-wide state shared by the nix-vector routing
+   * instances of all the nodes.
+   *
+   * The adjacency is stored in compressed sparse row form: the links
+   * (devices attached to a channel) of node n are numbered from
+   * nodeOffset[n] to nodeOffset[n+1]-1, and the neighbors reached
+   * through link l are numbered from neighborOffset[l] to
+   * neighborOffset[l+1]-1, in neighbor index order.
    */
-  static bool g_isCacheDirty;
+  struct NixTopology
+  {
+    NixTopology ();
+
+    uint64_t epoch;                      //!< Incremented whenever all the caches must be flushed
+    bool adjacencyDirty;                 //!< Whether the adjacency must be rebuilt
+    bool addressesDirty;                 //!< Whether the address map must be rebuilt
+    std::vector<uint32_t> nodeOffset;    //!< First link of each node
+    std::vector<uint32_t> linkDevice;    //!< Index of the device of each link in its node
+    std::vector<bool> linkBridge;        //!< Whether the device of each link is a bridge
+    std::vector<uint32_t> neighborOffset; //!< First neighbor of each link
+    std::vector<uint32_t> neighborNode;  //!< Node of each neighbor
+    std::vector<uint32_t> neighborDevice; //!< Index of the device of each neighbor in its node
+    /** Map of the interface addresses to the node index */
+    std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash> nodeByIp;
+    /** Shortest path trees of the sources, computed on demand */
+    std::unordered_map<uint32_t, std::vector<uint32_t> > trees;
+    std::vector<std::vector<uint32_t> > paths;        //!< Nodes of the recorded paths, by path slot
+    std::vector<uint32_t> freePaths;                  //!< Released path slots
+    /** Path slot of each destination, for each source */
+    std::vector<std::unordered_map<uint32_t, uint32_t> > pathsFrom;
+    /** Path slots of the recorded paths going through each node */
+    std::vector<std::unordered_set<uint32_t> > pathsThrough;
+  };
+
+  /** The state shared by all the nodes */
+  static NixTopology g_topology;
+
+  /** Epoch of the shared topology the caches were built for */
+  mutable uint64_t m_epoch;
 
   /** Cache stores nix-vectors based on destination ip */
   mutable NixMap_t m_nixCache;
@@ -241,9 +330,6 @@ private:
 
   Ptr<Ipv4> m_ipv4; //!< IPv4 object
   Ptr<Node> m_node; //!< Node object
-
-  /** Total neighbors used for nix-vector to determine number of bits */
-  uint32_t m_totalNeighbors;
 };
 } // namespace ns3
 
@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/ipv4-nix-vector-helper.h"
+#include "ns3/ipv4-nix-vector-routing.h"
+
+#include <algorithm>
+
+using namespace ns3;
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Nix-vector routes and path bookkeeping across topology changes.
+ *
+ * Two paths join n0 and n2: n0-n1-n2 and n0-n3-n4-n2.  The route from
+ * n0 to n2 must follow the short one, then move to the long one when an
+ * interface of n1 goes down, and back when it goes up again.  A removed
+ * address must not be routed to any more.  In between, the recorded
+ * paths must only hold live slots, and must not grow when the caches are
+ * flushed and refilled.
+ */
+class NixVectorRoutingPathTestCase : public TestCase
+{
+public:
+  NixVectorRoutingPathTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Look up the route from a node to an address
+   * \param node the source node
+   * \param dest the destination address
+   * \returns the route, or null if there is none
+   */
+  Ptr<Ipv4Route> Route (Ptr<Node> node, Ipv4Address dest);
+
+  /**
+   * Check the gateway of the route from a node to an address
+   * \param node the source node
+   * \param dest the destination address
+   * \param gateway the expected gateway
+   * \param msg the assert message
+   */
+  void CheckGateway (Ptr<Node> node, Ipv4Address dest, Ipv4Address gateway, std::string msg);
+
+  /**
+   * Look up the routes from every node to every address
+   */
+  void RouteAll (void);
+
+  /**
+   * Check the nodes of the recorded path between two nodes
+   * \param source the source node index
+   * \param dest the destination node index
+   * \param nodes the expected nodes, from the destination to the source
+   * \param msg the assert message
+   */
+  void CheckPath (uint32_t source, uint32_t dest, std::vector<uint32_t> nodes, std::string msg);
+
+  /**
+   * Check that the recorded paths and the path slots are consistent
+   * \param msg the assert message
+   */
+  void CheckPaths (std::string msg);
+
+  NodeContainer m_nodes; //!< The nodes
+  std::vector<Ipv4Address> m_addresses; //!< The addresses of all the nodes
+};
+
+NixVectorRoutingPathTestCase::NixVectorRoutingPathTestCase ()
+  : TestCase ("Nix-vector routes and recorded paths across topology changes")
+{
+}
+
+Ptr<Ipv4Route>
+NixVectorRoutingPathTestCase::Route (Ptr<Node> node, Ipv4Address dest)
+{
+  Ptr<Ipv4RoutingProtocol> routing = node->GetObject<Ipv4> ()->GetRoutingProtocol ();
+  Ptr<Packet> p = Create<Packet> ();
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno sockerr;
+  return routing->RouteOutput (p, header, 0, sockerr);
+}
+
+void
+NixVectorRoutingPathTestCase::CheckGateway (Ptr<Node> node, Ipv4Address dest, Ipv4Address gateway, std::string msg)
+{
+  Ptr<Ipv4Route> route = Route (node, dest);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "no route " << msg);
+  NS_TEST_ASSERT_MSG_EQ (route->GetGateway (), gateway, "wrong gateway " << msg);
+}
+
+void
+NixVectorRoutingPathTestCase::RouteAll (void)
+{
+  for (uint32_t n = 0; n < m_nodes.GetN (); n++)
+    {
+      for (std::vector<Ipv4Address>::const_iterator a = m_addresses.begin (); a != m_addresses.end (); a++)
+        {
+          Route (m_nodes.Get (n), *a);
+        }
+    }
+}
+
+void
+NixVectorRoutingPathTestCase::CheckPath (uint32_t source, uint32_t dest, std::vector<uint32_t> nodes, std::string msg)
+{
+  Ipv4NixVectorRouting::NixTopology &topology = Ipv4NixVectorRouting::g_topology;
+  std::unordered_map<uint32_t, uint32_t>::const_iterator it = topology.pathsFrom.at (source).find (dest);
+  NS_TEST_ASSERT_MSG_EQ ((it != topology.pathsFrom[source].end ()), true, "path not recorded " << msg);
+  NS_TEST_ASSERT_MSG_EQ ((topology.paths[it->second] == nodes), true, "wrong recorded path " << msg);
+}
+
+void
+NixVectorRoutingPathTestCase::CheckPaths (std::string msg)
+{
+  Ipv4NixVectorRouting::NixTopology &topology = Ipv4NixVectorRouting::g_topology;
+
+  uint32_t live = 0;
+  for (uint32_t source = 0; source < topology.pathsFrom.size (); source++)
+    {
+      live += topology.pathsFrom[source].size ();
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (topology.pathsFrom[source].size (), m_nodes.GetN (),
+                                   "more paths than destinations " << msg);
+    }
+  NS_TEST_ASSERT_MSG_EQ (topology.paths.size (), live + topology.freePaths.size (),
+                         "leaked path slots " << msg);
+
+  for (uint32_t node = 0; node < topology.pathsThrough.size (); node++)
+    {
+      for (std::unordered_set<uint32_t>::const_iterator id = topology.pathsThrough[node].begin ();
+           id != topology.pathsThrough[node].end (); id++)
+        {
+          const std::vector<uint32_t> &path = topology.paths.at (*id);
+          NS_TEST_ASSERT_MSG_EQ ((std::find (path.begin (), path.end (), node) != path.end ()), true,
+                                 "stale path " << *id << " through node " << node << " " << msg);
+        }
+    }
+}
+
+void
+NixVectorRoutingPathTestCase::DoRun (void)
+{
+  m_nodes.Create (5);
+
+  SimpleNetDeviceHelper simple;
+  InternetStackHelper stack;
+  Ipv4NixVectorHelper nixRouting;
+  stack.SetRoutingHelper (nixRouting);
+  stack.Install (m_nodes);
+
+  // n0-n1, n1-n2, n0-n3, n3-n4, n4-n2
+  uint32_t links[5][2] = { { 0, 1 }, { 1, 2 }, { 0, 3 }, { 3, 4 }, { 4, 2 } };
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  std::vector<Ipv4InterfaceContainer> interfaces;
+  for (uint32_t l = 0; l < 5; l++)
+    {
+      NetDeviceContainer devices = simple.Install (NodeContainer (m_nodes.Get (links[l][0]), m_nodes.Get (links[l][1])));
+      interfaces.push_back (address.Assign (devices));
+      address.NewNetwork ();
+      m_addresses.push_back (interfaces.back ().GetAddress (0));
+      m_addresses.push_back (interfaces.back ().GetAddress (1));
+    }
+
+  Ptr<Node> n0 = m_nodes.Get (0);
+  Ptr<Ipv4> n1Ipv4 = m_nodes.Get (1)->GetObject<Ipv4> ();
+  Ptr<Ipv4> n2Ipv4 = m_nodes.Get (2)->GetObject<Ipv4> ();
+  Ipv4Address n2ViaN1 = interfaces[1].GetAddress (1);
+  Ipv4Address n2ViaN4 = interfaces[4].GetAddress (1);
+  Ipv4Address n1Gateway = interfaces[0].GetAddress (1);
+  Ipv4Address n3Gateway = interfaces[2].GetAddress (1);
+
+  std::vector<uint32_t> shortPath;
+  shortPath.push_back (2);
+  shortPath.push_back (1);
+  shortPath.push_back (0);
+  std::vector<uint32_t> longPath;
+  longPath.push_back (2);
+  longPath.push_back (4);
+  longPath.push_back (3);
+  longPath.push_back (0);
+
+  CheckGateway (n0, n2ViaN1, n1Gateway, "over the short path");
+  CheckPath (0, 2, shortPath, "over the short path");
+  RouteAll ();
+  CheckPaths ("after the first lookups");
+
+  // the interface of n1 towards n2
+  uint32_t n1Interface = interfaces[1].Get (0).second;
+  n1Ipv4->SetDown (n1Interface);
+  CheckPaths ("after the interface went down");
+  CheckGateway (n0, n2ViaN1, n3Gateway, "with the short path down");
+  CheckPath (0, 2, longPath, "with the short path down");
+  RouteAll ();
+  CheckPaths ("after the lookups with the interface down");
+
+  n1Ipv4->SetUp (n1Interface);
+  CheckGateway (n0, n2ViaN1, n1Gateway, "with the short path up again");
+  CheckPath (0, 2, shortPath, "with the short path up again");
+  RouteAll ();
+  CheckPaths ("after the lookups with the interface up");
+
+  // flushing and refilling the caches recycles the path slots
+  uint32_t slots = Ipv4NixVectorRouting::g_topology.paths.size ();
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      for (uint32_t n = 0; n < m_nodes.GetN (); n++)
+        {
+          Ipv4NixVectorRouting::InvalidatePathsThrough (n);
+          RouteAll ();
+        }
+    }
+  CheckPaths ("after the caches were flushed");
+  NS_TEST_ASSERT_MSG_EQ (Ipv4NixVectorRouting::g_topology.paths.size (), slots, "path slots not recycled");
+
+  // remove the address of n2 on the n1-n2 link
+  uint32_t n2Interface = interfaces[1].Get (1).second;
+  n2Ipv4->RemoveAddress (n2Interface, n2ViaN1);
+  CheckPaths ("after the address was removed");
+  NS_TEST_ASSERT_MSG_EQ (Route (n0, n2ViaN1), 0, "route to a removed address");
+  CheckGateway (n0, n2ViaN4, n1Gateway, "to the remaining address");
+  CheckPaths ("after the lookups with the address removed");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Nix-vector routing TestSuite
+ */
+class NixVectorRoutingTestSuite : public TestSuite
+{
+public:
+  NixVectorRoutingTestSuite ()
+    : TestSuite ("nix-vector-routing", UNIT)
+  {
+    AddTestCase (new NixVectorRoutingPathTestCase (), TestCase::QUICK);
+  }
+};
+
+/// Static variable for test initialization
+static NixVectorRoutingTestSuite g_nixVectorRoutingTestSuite;
@@ -25,6 +25,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/queue-item.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -55,13 +56,20 @@ PointToPointNetDevice::GetTypeId (void)
     .AddAttribute ("DataRate", 
                    "The default data rate for point to point links",
                    DataRateValue (DataRate ("32768b/s")),
-                   MakeDataRateAccessor (&PointToPointNetDevice::m_bps),
+                   MakeDataRateAccessor (&PointToPointNetDevice::SetDataRate,
+                                         &PointToPointNetDevice::GetDataRate),
                    MakeDataRateChecker ())
     .AddAttribute ("ReceiveErrorModel", 
                    "The receiver error model used to simulate packet loss",
                    PointerValue (),
                    MakePointerAccessor (&PointToPointNetDevice::m_receiveErrorModel),
                    MakePointerChecker<ErrorModel> ())
+    .AddAttribute ("FluidBufferSize",
+                   "The size (in bytes) of the buffer shared by the fluid background "
+                   "flows and the packets sent by this device",
+                   UintegerValue (100000),
+                   MakeUintegerAccessor (&PointToPointNetDevice::m_fluidBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("InterframeGap", 
                    "The time to wait between packet (frame) transmissions",
                    TimeValue (Seconds (0.0)),
@@ -177,7 +185,12 @@ PointToPointNetDevice::PointToPointNetDevice ()
     m_txMachineState (READY),
     m_channel (0),
     m_linkUp (false),
-    m_currentPkt (0)
+    m_currentPkt (0),
+    m_nextFluidFlowId (0),
+    m_fluidRate (0),
+    m_fluidBacklog (0),
+    m_fluidLossCredit (0),
+    m_fluidOverflowBytes (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -215,6 +228,7 @@ PointToPointNetDevice::DoDispose ()
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
   m_queue = 0;
+  m_fluidFlows.clear ();
   NetDevice::DoDispose ();
 }
 
@@ -222,9 +236,122 @@ void
 PointToPointNetDevice::SetDataRate (DataRate bps)
 {
   NS_LOG_FUNCTION (this);
+  // the fluid buffer filled or drained at the old rate until now
+  if (m_fluidRate > 0 || m_fluidBacklog > 0)
+    {
+      UpdateFluidBacklog ();
+    }
   m_bps = bps;
 }
 
+DataRate
+PointToPointNetDevice::GetDataRate (void) const
+{
+  return m_bps;
+}
+
+uint32_t
+PointToPointNetDevice::AddFluidFlow (DataRate rate)
+{
+  NS_LOG_FUNCTION (this << rate);
+  UpdateFluidBacklog ();
+  uint32_t flowId = m_nextFluidFlowId++;
+  m_fluidFlows[flowId] = rate.GetBitRate ();
+  m_fluidRate += rate.GetBitRate ();
+  return flowId;
+}
+
+void
+PointToPointNetDevice::SetFluidFlowRate (uint32_t flowId, DataRate rate)
+{
+  NS_LOG_FUNCTION (this << flowId << rate);
+  auto it = m_fluidFlows.find (flowId);
+  NS_ASSERT_MSG (it != m_fluidFlows.end (), "Unknown fluid flow " << flowId);
+  UpdateFluidBacklog ();
+  m_fluidRate = m_fluidRate - it->second + rate.GetBitRate ();
+  it->second = rate.GetBitRate ();
+}
+
+void
+PointToPointNetDevice::RemoveFluidFlow (uint32_t flowId)
+{
+  NS_LOG_FUNCTION (this << flowId);
+  auto it = m_fluidFlows.find (flowId);
+  NS_ASSERT_MSG (it != m_fluidFlows.end (), "Unknown fluid flow " << flowId);
+  UpdateFluidBacklog ();
+  m_fluidRate -= it->second;
+  m_fluidFlows.erase (it);
+}
+
+DataRate
+PointToPointNetDevice::GetFluidRate (void) const
+{
+  return DataRate (m_fluidRate);
+}
+
+uint32_t
+PointToPointNetDevice::GetFluidBacklog (void)
+{
+  UpdateFluidBacklog ();
+  return static_cast<uint32_t> (m_fluidBacklog);
+}
+
+uint64_t
+PointToPointNetDevice::GetFluidOverflowBytes (void)
+{
+  UpdateFluidBacklog ();
+  return static_cast<uint64_t> (m_fluidOverflowBytes);
+}
+
+void
+PointToPointNetDevice::UpdateFluidBacklog (void)
+{
+  Time now = Simulator::Now ();
+  double elapsed = (now - m_fluidLastUpdate).GetSeconds ();
+  m_fluidLastUpdate = now;
+  if (m_fluidRate == 0 && m_fluidBacklog == 0)
+    {
+      return;
+    }
+
+  // the rates are constant since the last update, hence the occupancy
+  // changes monotonically and is clamped at most once
+  double backlog = m_fluidBacklog
+    + (static_cast<double> (m_fluidRate) - static_cast<double> (m_bps.GetBitRate ())) * elapsed / 8;
+  if (backlog < 0)
+    {
+      backlog = 0;
+    }
+  else if (backlog > m_fluidBufferSize)
+    {
+      m_fluidOverflowBytes += backlog - m_fluidBufferSize;
+      backlog = m_fluidBufferSize;
+    }
+  m_fluidBacklog = backlog;
+}
+
+bool
+PointToPointNetDevice::FluidDropsPacket (void)
+{
+  if (m_fluidRate == 0 && m_fluidBacklog == 0)
+    {
+      return false;
+    }
+  UpdateFluidBacklog ();
+  if (m_fluidBacklog < m_fluidBufferSize || m_fluidRate <= m_bps.GetBitRate ())
+    {
+      return false;
+    }
+  m_fluidLossCredit += 1 - static_cast<double> (m_bps.GetBitRate ()) / m_fluidRate;
+  if (m_fluidLossCredit >= 1)
+    {
+      NS_LOG_LOGIC ("Packet dropped by the full fluid buffer");
+      m_fluidLossCredit -= 1;
+      return true;
+    }
+  return false;
+}
+
 void
 PointToPointNetDevice::SetInterframeGap (Time t)
 {
@@ -254,7 +381,28 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
   Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
 
-  bool result = m_channel->TransmitStart (p, this, txTime);
+  //
+  // The packet waits for the fluid ahead of it in the fluid buffer to be
+  // transmitted. Such a wait delays the reception of the packet but does not
+  // keep the transmitter busy, because the other packets queued in the device
+  // wait for the same fluid. The packet then occupies the buffer as well.
+  //
+  Time fluidDelay;
+  if (m_fluidRate > 0 || m_fluidBacklog > 0)
+    {
+      UpdateFluidBacklog ();
+      fluidDelay = m_bps.CalculateBytesTxTime (static_cast<uint32_t> (m_fluidBacklog));
+      m_fluidBacklog += p->GetSize ();
+      if (m_fluidBacklog > m_fluidBufferSize)
+        {
+          // the packet was admitted (see FluidDropsPacket) and is sent: it
+          // takes the room of the fluid, which overflows the buffer instead
+          m_fluidOverflowBytes += m_fluidBacklog - m_fluidBufferSize;
+          m_fluidBacklog = m_fluidBufferSize;
+        }
+    }
+
+  bool result = m_channel->TransmitStart (p, this, txTime + fluidDelay);
   if (result == false)
     {
       m_phyTxDropTrace (p);
@@ -531,6 +679,15 @@ PointToPointNetDevice::Send (
 
   m_macTxTrace (packet);
 
+  //
+  // The packet may be dropped by the buffer shared with the fluid flows
+  //
+  if (FluidDropsPacket ())
+    {
+      m_macTxDropTrace (packet);
+      return false;
+    }
+
   //
   // We should enqueue and dequeue the packet to hit the tracing hooks.
   //
@@ -556,6 +713,57 @@ PointToPointNetDevice::Send (
   return false;
 }
 
+bool
+PointToPointNetDevice::SupportsSendBatch (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return true;
+}
+
+uint32_t
+PointToPointNetDevice::SendBatch (const std::vector<Ptr<QueueDiscItem> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  uint32_t nSent = 0;
+  for (const auto &item : items)
+    {
+      Ptr<Packet> packet = item->GetPacket ();
+      NS_LOG_LOGIC ("UID is " << packet->GetUid ());
+
+      if (IsLinkUp () == false)
+        {
+          m_macTxDropTrace (packet);
+          continue;
+        }
+
+      AddHeader (packet, item->GetProtocol ());
+      m_macTxTrace (packet);
+
+      if (!FluidDropsPacket () && m_queue->Enqueue (packet))
+        {
+          nSent++;
+        }
+      else
+        {
+          m_macTxDropTrace (packet);
+        }
+    }
+
+  //
+  // If the channel is ready for transition we send the first packet right now,
+  // the others are sent by TransmitComplete
+  //
+  if (m_txMachineState == READY && !m_queue->IsEmpty ())
+    {
+      Ptr<Packet> packet = m_queue->Dequeue ();
+      m_snifferTrace (packet);
+      m_promiscSnifferTrace (packet);
+      TransmitStart (packet);
+    }
+  return nSent;
+}
+
 bool
 PointToPointNetDevice::SendFrom (Ptr<Packet> packet, 
                                  const Address &source, 
@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_NET_DEVICE_H
 
 #include <cstring>
+#include <map>
 #include "ns3/address.h"
 #include "ns3/node.h"
 #include "ns3/net-device.h"
@@ -94,6 +95,11 @@ public:
    */
   void SetDataRate (DataRate bps);
 
+  /**
+   * \return the data rate used for transmission of packets
+   */
+  DataRate GetDataRate (void) const;
+
   /**
    * Set the interframe gap used to separate packets.  The interframe gap
    * defines the minimum space required between packets sent by this device.
@@ -137,6 +143,55 @@ public:
    */
   void SetReceiveErrorModel (Ptr<ErrorModel> em);
 
+  /**
+   * \brief Add a fluid background flow transmitted by this device
+   *
+   * Fluid flows model aggregate background traffic without generating any
+   * event: they only feed an analytic fluid buffer, whose occupancy
+   * determines the queueing delay and the drops experienced by the (discrete)
+   * packets sent by this device.
+   *
+   * \param rate the rate of the flow
+   * \return the identifier of the flow
+   */
+  uint32_t AddFluidFlow (DataRate rate);
+
+  /**
+   * \brief Change the rate of a fluid background flow
+   * \param flowId the identifier of the flow
+   * \param rate the new rate of the flow
+   */
+  void SetFluidFlowRate (uint32_t flowId, DataRate rate);
+
+  /**
+   * \brief Remove a fluid background flow
+   * \param flowId the identifier of the flow
+   */
+  void RemoveFluidFlow (uint32_t flowId);
+
+  /**
+   * \return the aggregate rate of the fluid background flows
+   */
+  DataRate GetFluidRate (void) const;
+
+  /**
+   * \return the current occupancy of the fluid buffer, in bytes
+   */
+  uint32_t GetFluidBacklog (void);
+
+  /**
+   * Get the number of bytes by which the fluid buffer overflowed.
+   *
+   * The buffer overflows when the fluid arrives faster than the data rate
+   * while the buffer is full, and when a packet being transmitted takes the
+   * last room in the buffer.  In both cases the overflow is fluid which is
+   * lost; packets are not counted here, they are only dropped (and traced)
+   * when they are sent while the buffer is full (see FluidDropsPacket).
+   *
+   * \return the number of bytes of fluid lost to buffer overflows
+   */
+  uint64_t GetFluidOverflowBytes (void);
+
   /**
    * Receive a packet from a connected PointToPointChannel.
    *
@@ -190,6 +245,17 @@ public:
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
 
+  virtual bool SupportsSendBatch (void) const;
+
+  /**
+   * Enqueue a batch of packets and start the transmission of the first one,
+   * if the device is idle, only once all the packets have been enqueued.
+   *
+   * \param items the packets to send
+   * \return the number of packets accepted by the device
+   */
+  virtual uint32_t SendBatch (const std::vector<Ptr<QueueDiscItem> > &items);
+
 protected:
   /**
    * \brief Handler for MPI receive event
@@ -224,6 +290,25 @@ private:
    */
   virtual void DoDispose (void);
 
+  /**
+   * \brief Bring the occupancy of the fluid buffer up to date
+   *
+   * Between two updates, the fluid buffer fills (or drains) linearly at the
+   * difference between the aggregate fluid rate and the data rate.
+   */
+  void UpdateFluidBacklog (void);
+
+  /**
+   * \brief Determine whether a packet is dropped by the fluid buffer
+   *
+   * While the fluid buffer is full, a fraction 1 - C/R (C being the data
+   * rate and R the aggregate fluid rate) of the incoming traffic is lost.
+   * Packets are dropped deterministically in that proportion.
+   *
+   * \return true if the packet must be dropped
+   */
+  bool FluidDropsPacket (void);
+
 private:
 
   /**
@@ -457,6 +542,15 @@ private:
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
 
+  std::map<uint32_t, uint64_t> m_fluidFlows; //!< Rate (bps) of the fluid flows, by identifier
+  uint32_t m_nextFluidFlowId;  //!< Identifier of the next fluid flow
+  uint64_t m_fluidRate;        //!< Aggregate rate (bps) of the fluid flows
+  double m_fluidBacklog;       //!< Occupancy of the fluid buffer, in bytes
+  uint32_t m_fluidBufferSize;  //!< Size of the fluid buffer, in bytes
+  Time m_fluidLastUpdate;      //!< Time of the last update of the fluid buffer
+  double m_fluidLossCredit;    //!< Accumulated fraction of packets to drop
+  double m_fluidOverflowBytes; //!< Bytes of fluid lost to buffer overflows
+
   /**
    * \brief PPP to Ethernet protocol number mapping
    * \param protocol A PPP protocol number
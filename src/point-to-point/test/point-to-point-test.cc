@@ -24,6 +24,8 @@
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/uinteger.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -94,6 +96,158 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test the fluid background flows of the PointToPointNetDevice
+ *
+ * A 2 Mbps fluid flow is carried by a 1 Mbps link, hence the fluid buffer
+ * fills at 125000 B/s. Packets are delayed by the time needed to transmit
+ * the fluid ahead of them, half of the packets are dropped while the fluid
+ * buffer is full and packets are no longer delayed once it has drained.
+ */
+class PointToPointFluidTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointFluidTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send packets to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param nPackets the number of packets
+   */
+  void SendPackets (Ptr<PointToPointNetDevice> device, uint32_t nPackets);
+
+  /**
+   * \brief Receive callback
+   *
+   * \param device the receiving device
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param sender the sender address
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &sender);
+
+  /**
+   * \brief Check the occupancy of the fluid buffer
+   *
+   * \param device the device
+   * \param backlog the expected occupancy, in bytes
+   */
+  void CheckBacklog (Ptr<PointToPointNetDevice> device, double backlog);
+
+  /**
+   * \brief Change the DataRate attribute of a device
+   *
+   * \param device the device
+   * \param rate the new data rate
+   */
+  void SetDataRateAttribute (Ptr<PointToPointNetDevice> device, DataRate rate);
+
+  std::vector<Time> m_rxTimes; //!< the reception times
+};
+
+PointToPointFluidTest::PointToPointFluidTest ()
+  : TestCase ("PointToPoint fluid background flows")
+{
+}
+
+void
+PointToPointFluidTest::SendPackets (Ptr<PointToPointNetDevice> device, uint32_t nPackets)
+{
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      // 1000 bytes with the PPP header
+      device->Send (Create<Packet> (998), device->GetBroadcast (), 0x800);
+    }
+}
+
+bool
+PointToPointFluidTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                                const Address &sender)
+{
+  m_rxTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointFluidTest::CheckBacklog (Ptr<PointToPointNetDevice> device, double backlog)
+{
+  NS_TEST_EXPECT_MSG_EQ_TOL (device->GetFluidBacklog (), backlog, 1, "Unexpected fluid backlog");
+}
+
+void
+PointToPointFluidTest::SetDataRateAttribute (Ptr<PointToPointNetDevice> device, DataRate rate)
+{
+  device->SetAttribute ("DataRate", DataRateValue (rate));
+}
+
+void
+PointToPointFluidTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devA->SetDataRate (DataRate ("1Mbps"));
+  devA->SetAttribute ("FluidBufferSize", UintegerValue (50000));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devB->SetReceiveCallback (MakeCallback (&PointToPointFluidTest::Receive, this));
+
+  uint32_t flowId = devA->AddFluidFlow (DataRate ("2Mbps"));
+
+  // the packet waits for 25000 bytes of fluid (200ms) and is transmitted in 8ms
+  Simulator::Schedule (Seconds (0.2), &PointToPointFluidTest::CheckBacklog, this, devA, 25000);
+  Simulator::Schedule (Seconds (0.2), &PointToPointFluidTest::SendPackets, this, devA, 1);
+  // the buffer is full after 400ms; half of the packets are then dropped
+  Simulator::Schedule (Seconds (1), &PointToPointFluidTest::CheckBacklog, this, devA, 50000);
+  Simulator::Schedule (Seconds (1), &PointToPointFluidTest::SendPackets, this, devA, 30);
+  // the buffer drains in 400ms once the fluid flow stops
+  Simulator::Schedule (Seconds (2), &PointToPointNetDevice::SetFluidFlowRate, devA, flowId, DataRate (0));
+  Simulator::Schedule (Seconds (2.2), &PointToPointFluidTest::CheckBacklog, this, devA, 25000);
+  Simulator::Schedule (Seconds (3), &PointToPointFluidTest::CheckBacklog, this, devA, 0);
+  Simulator::Schedule (Seconds (3), &PointToPointFluidTest::SendPackets, this, devA, 1);
+  // the buffer fills at 1Mbps until the DataRate attribute is set to the
+  // fluid rate, then holds 25000 bytes
+  Simulator::Schedule (Seconds (4), &PointToPointNetDevice::SetFluidFlowRate, devA, flowId, DataRate ("2Mbps"));
+  Simulator::Schedule (Seconds (4.1), &PointToPointFluidTest::CheckBacklog, this, devA, 12500);
+  Simulator::Schedule (Seconds (4.2), &PointToPointFluidTest::SetDataRateAttribute, this, devA, DataRate ("2Mbps"));
+  Simulator::Schedule (Seconds (4.4), &PointToPointFluidTest::CheckBacklog, this, devA, 25000);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes.size (), 17, "Unexpected number of received packets");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_rxTimes.front ().GetSeconds (), 0.408, 1e-6, "Unexpected fluid delay");
+  // the first packet sent at 1s waits for a full buffer (400ms)
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_rxTimes[1].GetSeconds (), 1.408, 1e-6, "Unexpected fluid delay");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_rxTimes.back ().GetSeconds (), 3.008, 1e-6, "Unexpected delay");
+  NS_TEST_EXPECT_MSG_GT (devA->GetFluidOverflowBytes (), 0, "The fluid buffer must have overflowed");
+  DataRateValue rate;
+  devA->GetAttribute ("DataRate", rate);
+  NS_TEST_EXPECT_MSG_EQ (rate.Get (), DataRate ("2Mbps"), "Unexpected DataRate attribute");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -110,6 +264,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointFluidTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -149,5 +149,12 @@ SpectrumChannel::GetSpectrumPropagationLossModel (void)
   return m_spectrumPropagationLoss;
 }
 
+Ptr<PropagationLossModel>
+SpectrumChannel::GetPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_propagationLoss;
+}
+
 
 } // namespace
@@ -95,6 +95,12 @@ public:
    */
   Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
 
+  /**
+   * Get the single-frequency propagation loss model.
+   * \returns a pointer to the propagation loss model.
+   */
+  Ptr<PropagationLossModel> GetPropagationLossModel (void);
+
 
 
   /**
@@ -57,6 +57,14 @@ public:
    * Reinitializes all variables of MinMaxAvgTotalCalculator
    */
   void Reset ();
+  /**
+   * Adds the values of another MinMaxAvgTotalCalculator, as if they
+   * had been passed to Update.  The values can thus be accumulated
+   * in several calculators, e.g., one per thread or per replication,
+   * and combined afterwards.
+   * \param other the calculator whose values to add
+   */
+  void Merge (const MinMaxAvgTotalCalculator<T> &other);
 
   /**
    * Outputs the data based on the provided callback
@@ -248,6 +256,43 @@ MinMaxAvgTotalCalculator<T>::Reset ()
   // end MinMaxAvgTotalCalculator::Reset
 }
 
+template <typename T>
+void
+MinMaxAvgTotalCalculator<T>::Merge (const MinMaxAvgTotalCalculator<T> &other)
+{
+  if (other.m_count == 0)
+    {
+      return;
+    }
+  if (m_count == 0)
+    {
+      m_min = other.m_min;
+      m_max = other.m_max;
+      m_meanCurr = other.m_meanCurr;
+      m_sCurr = other.m_sCurr;
+    }
+  else
+    {
+      m_min = (other.m_min < m_min) ? other.m_min : m_min;
+      m_max = (other.m_max > m_max) ? other.m_max : m_max;
+
+      // Combine the means and the sums of squared differences from the
+      // means as described in "Updating Formulae and a Pairwise Algorithm
+      // for Computing Sample Variances", Chan, Golub and LeVeque, 1979.
+      double count = m_count + other.m_count;
+      double delta = other.m_meanCurr - m_meanCurr;
+      m_meanCurr = m_meanCurr + delta * other.m_count / count;
+      m_sCurr = m_sCurr + other.m_sCurr + delta * delta * m_count * other.m_count / count;
+    }
+  m_count       += other.m_count;
+  m_total       += other.m_total;
+  m_squareTotal += other.m_squareTotal;
+  m_varianceCurr = (m_count > 1) ? m_sCurr / (m_count - 1) : 0;
+  m_meanPrev     = NaN;
+  m_sPrev        = NaN;
+  // end MinMaxAvgTotalCalculator::Merge
+}
+
 template <typename T>
 void
 MinMaxAvgTotalCalculator<T>::Output (DataOutputCallback &callback) const
@@ -286,6 +331,12 @@ public:
    */
   void Update (const T i);
 
+  /**
+   * Adds the count of another CounterCalculator
+   * \param other the calculator whose count to add
+   */
+  void Merge (const CounterCalculator<T> &other);
+
   /**
    * Returns the count of the CounterCalculator
    * \return Count as a value of type T
@@ -361,6 +412,14 @@ CounterCalculator<T>::Update (const T i)
   // end CounterCalculator::Update
 }
 
+template <typename T>
+void
+CounterCalculator<T>::Merge (const CounterCalculator<T> &other)
+{
+  m_count += other.m_count;
+  // end CounterCalculator::Merge
+}
+
 template <typename T>
 T
 CounterCalculator<T>::GetCount () const
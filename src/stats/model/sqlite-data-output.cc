@@ -33,6 +33,9 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("SqliteDataOutput");
 
+/// Number of rows inserted in the Singletons table by a single statement
+#define SQLITE_BATCH_ROWS 64
+
 //--------------------------------------------------------------
 //----------------------------------------------
 SqliteDataOutput::SqliteDataOutput()
@@ -126,6 +129,8 @@ SqliteDataOutput::Output (DataCollector &dc)
       return;
     }
 
+  // a single transaction for all the rows of the run
+  Exec ("BEGIN");
   Exec ("create table if not exists Experiments (run, experiment, strategy, input, description text)");
 
   sqlite3_stmt *stmt;
@@ -172,12 +177,15 @@ SqliteDataOutput::Output (DataCollector &dc)
     }
   sqlite3_finalize (stmt);
 
-  Exec ("BEGIN");
-  SqliteOutputCallback callback (this, run);
-  for (DataCalculatorList::iterator i = dc.DataCalculatorBegin ();
-       i != dc.DataCalculatorEnd (); i++) {
-      (*i)->Output (callback);
-    }
+  {
+    // the statements of the callback must be finalized before the database is closed
+    SqliteOutputCallback callback (this, run);
+    for (DataCalculatorList::iterator i = dc.DataCalculatorBegin ();
+         i != dc.DataCalculatorEnd (); i++) {
+        (*i)->Output (callback);
+      }
+    callback.Flush ();
+  }
   Exec ("COMMIT");
 
   sqlite3_close (m_db);
@@ -200,14 +208,93 @@ SqliteDataOutput::SqliteOutputCallback::SqliteOutputCallback
     &m_insertSingletonStatement,
     NULL
   );
-  sqlite3_bind_text (m_insertSingletonStatement, 1, m_runLabel.c_str (), m_runLabel.length (), SQLITE_TRANSIENT);
+
+  std::ostringstream batch;
+  batch << "insert into Singletons (run, name, variable, value) values (?, ?, ?, ?)";
+  for (uint32_t i = 1; i < SQLITE_BATCH_ROWS; i++) {
+      batch << ", (?, ?, ?, ?)";
+    }
+  sqlite3_prepare_v2 (m_owner->m_db,
+    batch.str ().c_str (),
+    -1,
+    &m_insertBatchStatement,
+    NULL
+  );
 
   // end SqliteDataOutput::SqliteOutputCallback::SqliteOutputCallback
 }
 
 SqliteDataOutput::SqliteOutputCallback::~SqliteOutputCallback ()
 {
+  Flush ();
   sqlite3_finalize (m_insertSingletonStatement);
+  sqlite3_finalize (m_insertBatchStatement);
+}
+
+void
+SqliteDataOutput::SqliteOutputCallback::Bind (sqlite3_stmt *stmt, uint32_t row, int column)
+{
+  // the staged rows outlive the execution of the statement
+  sqlite3_bind_text (stmt, column, m_runLabel.c_str (), m_runLabel.length (), SQLITE_STATIC);
+  sqlite3_bind_text (stmt, column + 1, m_names[row].c_str (), m_names[row].length (), SQLITE_STATIC);
+  sqlite3_bind_text (stmt, column + 2, m_variables[row].c_str (), m_variables[row].length (), SQLITE_STATIC);
+  switch (m_types[row]) {
+    case INTEGER:
+      sqlite3_bind_int64 (stmt, column + 3, m_integers[row]);
+      break;
+    case REAL:
+      sqlite3_bind_double (stmt, column + 3, m_reals[row]);
+      break;
+    case TEXT:
+      sqlite3_bind_text (stmt, column + 3, m_texts[row].c_str (), m_texts[row].length (), SQLITE_STATIC);
+      break;
+    }
+}
+
+void
+SqliteDataOutput::SqliteOutputCallback::Stage (std::string key,
+                                               std::string variable,
+                                               ValueType type)
+{
+  m_names.push_back (key);
+  m_variables.push_back (variable);
+  m_types.push_back (type);
+  m_integers.resize (m_types.size (), 0);
+  m_reals.resize (m_types.size (), 0);
+  m_texts.resize (m_types.size ());
+}
+
+void
+SqliteDataOutput::SqliteOutputCallback::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_types.size ());
+
+  uint32_t rows = m_types.size ();
+  uint32_t row = 0;
+  for (; row + SQLITE_BATCH_ROWS <= rows; row += SQLITE_BATCH_ROWS) {
+      sqlite3_reset (m_insertBatchStatement);
+      for (uint32_t i = 0; i < SQLITE_BATCH_ROWS; i++) {
+          Bind (m_insertBatchStatement, row + i, 4 * i + 1);
+        }
+      sqlite3_step (m_insertBatchStatement);
+    }
+  for (; row < rows; row++) {
+      sqlite3_reset (m_insertSingletonStatement);
+      Bind (m_insertSingletonStatement, row, 1);
+      sqlite3_step (m_insertSingletonStatement);
+    }
+  // the statements must not refer to the staged rows anymore
+  sqlite3_reset (m_insertBatchStatement);
+  sqlite3_reset (m_insertSingletonStatement);
+  sqlite3_clear_bindings (m_insertBatchStatement);
+  sqlite3_clear_bindings (m_insertSingletonStatement);
+
+  m_names.clear ();
+  m_variables.clear ();
+  m_types.clear ();
+  m_integers.clear ();
+  m_reals.clear ();
+  m_texts.clear ();
 }
 
 void
@@ -238,11 +325,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  sqlite3_reset (m_insertSingletonStatement);
-  sqlite3_bind_text (m_insertSingletonStatement, 2, key.c_str (), key.length (), SQLITE_TRANSIENT);
-  sqlite3_bind_text (m_insertSingletonStatement, 3, variable.c_str (), variable.length (), SQLITE_TRANSIENT);
-  sqlite3_bind_int (m_insertSingletonStatement, 4, val);
-  sqlite3_step (m_insertSingletonStatement);
+  Stage (key, variable, INTEGER);
+  m_integers.back () = val;
+  if (m_types.size () >= SQLITE_BATCH_ROWS)
+    Flush ();
 }
 void
 SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
@@ -251,11 +337,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  sqlite3_reset (m_insertSingletonStatement);
-  sqlite3_bind_text (m_insertSingletonStatement, 2, key.c_str (), key.length (), SQLITE_TRANSIENT);
-  sqlite3_bind_text (m_insertSingletonStatement, 3, variable.c_str (), variable.length (), SQLITE_TRANSIENT);
-  sqlite3_bind_int64 (m_insertSingletonStatement, 4, val);
-  sqlite3_step (m_insertSingletonStatement);
+  Stage (key, variable, INTEGER);
+  m_integers.back () = val;
+  if (m_types.size () >= SQLITE_BATCH_ROWS)
+    Flush ();
 }
 
 void
@@ -265,11 +350,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  sqlite3_reset (m_insertSingletonStatement);
-  sqlite3_bind_text (m_insertSingletonStatement, 2, key.c_str (), key.length (), SQLITE_TRANSIENT);
-  sqlite3_bind_text (m_insertSingletonStatement, 3, variable.c_str (), variable.length (), SQLITE_TRANSIENT);
-  sqlite3_bind_double (m_insertSingletonStatement, 4, val);
-  sqlite3_step (m_insertSingletonStatement);
+  Stage (key, variable, REAL);
+  m_reals.back () = val;
+  if (m_types.size () >= SQLITE_BATCH_ROWS)
+    Flush ();
 }
 
 void
@@ -279,11 +363,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  sqlite3_reset (m_insertSingletonStatement);
-  sqlite3_bind_text (m_insertSingletonStatement, 2, key.c_str (), key.length (), SQLITE_TRANSIENT);
-  sqlite3_bind_text (m_insertSingletonStatement, 3, variable.c_str (), variable.length (), SQLITE_TRANSIENT);
-  sqlite3_bind_text (m_insertSingletonStatement, 4, val.c_str (), val.length (), SQLITE_TRANSIENT);
-  sqlite3_step (m_insertSingletonStatement);
+  Stage (key, variable, TEXT);
+  m_texts.back () = val;
+  if (m_types.size () >= SQLITE_BATCH_ROWS)
+    Flush ();
 }
 
 void
@@ -293,9 +376,8 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  sqlite3_reset (m_insertSingletonStatement);
-  sqlite3_bind_text (m_insertSingletonStatement, 2, key.c_str (), key.length (), SQLITE_TRANSIENT);
-  sqlite3_bind_text (m_insertSingletonStatement, 3, variable.c_str (), variable.length (), SQLITE_TRANSIENT);
-  sqlite3_bind_int64 (m_insertSingletonStatement, 4, val.GetTimeStep ());
-  sqlite3_step (m_insertSingletonStatement);
+  Stage (key, variable, INTEGER);
+  m_integers.back () = val.GetTimeStep ();
+  if (m_types.size () >= SQLITE_BATCH_ROWS)
+    Flush ();
 }
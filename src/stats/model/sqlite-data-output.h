@@ -28,6 +28,7 @@
 #define STATS_HAS_SQLITE3
 
 #include <sqlite3.h>
+#include <vector>
 
 namespace ns3 {
 
@@ -37,6 +38,10 @@ namespace ns3 {
  * \ingroup dataoutput
  * \class SqliteDataOutput
  * \brief Outputs data in a format compatible with SQLite
+ *
+ * All the rows of a run are written in a single transaction, and the
+ * values of the DataCalculators are staged in memory and inserted in
+ * batches of rows by a prepared multi-row statement.
  */
 class SqliteDataOutput : public DataOutputInterface {
 public:
@@ -134,10 +139,48 @@ public:
                           std::string variable,
                           Time val);
 
+    /**
+     * \brief Inserts the staged values in the database
+     */
+    void Flush (void);
+
 private:
+    /// Type of a staged value
+    enum ValueType
+    {
+      INTEGER,
+      REAL,
+      TEXT
+    };
+
+    /**
+     * \brief Adds a row to the staged values
+     * \param key the SQL key to use
+     * \param variable the variable name
+     * \param type the type of the value, to be set by the caller
+     */
+    void Stage (std::string key, std::string variable, ValueType type);
+
+    /**
+     * \brief Binds a staged row to the parameters of an insert statement
+     * \param stmt the insert statement
+     * \param row the index of the staged row
+     * \param column the index of the first parameter of the row
+     */
+    void Bind (sqlite3_stmt *stmt, uint32_t row, int column);
+
     Ptr<SqliteDataOutput> m_owner; //!< the instance this object belongs to
     std::string m_runLabel; //!< Run label
     sqlite3_stmt *m_insertSingletonStatement; //!< Prepared singleton insert statement
+    sqlite3_stmt *m_insertBatchStatement; //!< Prepared statement inserting a batch of singletons
+
+    // the staged values, column by column
+    std::vector<std::string> m_names; //!< names of the staged values
+    std::vector<std::string> m_variables; //!< variables of the staged values
+    std::vector<ValueType> m_types; //!< types of the staged values
+    std::vector<int64_t> m_integers; //!< staged values, if integer
+    std::vector<double> m_reals; //!< staged values, if real
+    std::vector<std::string> m_texts; //!< staged values, if text
 
     // end class SqliteOutputCallback
   };
@@ -84,6 +84,33 @@ TimeMinMaxAvgTotalCalculator::Update (const Time i)
     }
   // end TimeMinMaxAvgTotalCalculator::Update
 }
+void
+TimeMinMaxAvgTotalCalculator::Merge (const TimeMinMaxAvgTotalCalculator &other)
+{
+  NS_LOG_FUNCTION (this << &other);
+
+  if (other.m_count == 0)
+    {
+      return;
+    }
+  if (m_count) {
+      m_total += other.m_total;
+
+      if (other.m_min < m_min)
+        m_min = other.m_min;
+
+      if (other.m_max > m_max)
+        m_max = other.m_max;
+
+    } else {
+      m_min = other.m_min;
+      m_max = other.m_max;
+      m_total = other.m_total;
+    }
+  m_count += other.m_count;
+  // end TimeMinMaxAvgTotalCalculator::Merge
+}
+
 void
 TimeMinMaxAvgTotalCalculator::Output (DataOutputCallback &callback) const
 {
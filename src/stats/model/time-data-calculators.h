@@ -56,6 +56,13 @@ public:
    */
   void Update (const Time i);
 
+  /**
+   * Adds the values of another TimeMinMaxAvgTotalCalculator, as if
+   * they had been passed to Update
+   * \param other the calculator whose values to add
+   */
+  void Merge (const TimeMinMaxAvgTotalCalculator &other);
+
   /**
    * Outputs data based on the provided callback
    * \param callback
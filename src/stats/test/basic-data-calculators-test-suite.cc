@@ -239,6 +239,68 @@ FiveDoublesTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (calculator.getSqrSum(),   sqrSum,   TOLERANCE, "SqrSum value wrong");
 }
 
+// ===========================================================================
+// Test case for calculators accumulated in shards and merged.
+// ===========================================================================
+
+class MergeTestCase : public TestCase
+{
+public:
+  MergeTestCase ();
+  virtual ~MergeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MergeTestCase::MergeTestCase ()
+  : TestCase ("Basic Statistical Functions using Merged Calculators")
+
+{
+}
+
+MergeTestCase::~MergeTestCase ()
+{
+}
+
+void
+MergeTestCase::DoRun (void)
+{
+  MinMaxAvgTotalCalculator<double> calculator;
+  MinMaxAvgTotalCalculator<double> shards[3];
+  CounterCalculator<> counter;
+  CounterCalculator<> counterShards[3];
+
+  // Put the values into the calculator and two of the shards.
+  for (long i = 0; i < 20; i++)
+    {
+      double value = std::sqrt (i * 7.0) - 2;
+      calculator.Update (value);
+      shards[(i < 5) ? 0 : 2].Update (value);
+      counter.Update (i);
+      counterShards[i % 3].Update (i);
+    }
+
+  MinMaxAvgTotalCalculator<double> merged;
+  CounterCalculator<> mergedCounter;
+  for (int i = 0; i < 3; i++)
+    {
+      merged.Merge (shards[i]);
+      mergedCounter.Merge (counterShards[i]);
+    }
+
+  // Test the merged calculator.
+  NS_TEST_ASSERT_MSG_EQ (merged.getCount(), calculator.getCount(), "Count value wrong");
+  NS_TEST_ASSERT_MSG_EQ_TOL (merged.getSum(),      calculator.getSum(),      1e-9, "Sum value wrong");
+  NS_TEST_ASSERT_MSG_EQ_TOL (merged.getMin(),      calculator.getMin(),      TOLERANCE, "Min value wrong");
+  NS_TEST_ASSERT_MSG_EQ_TOL (merged.getMax(),      calculator.getMax(),      TOLERANCE, "Max value wrong");
+  NS_TEST_ASSERT_MSG_EQ_TOL (merged.getMean(),     calculator.getMean(),     1e-9, "Mean value wrong");
+  NS_TEST_ASSERT_MSG_EQ_TOL (merged.getStddev(),   calculator.getStddev(),   1e-9, "Stddev value wrong");
+  NS_TEST_ASSERT_MSG_EQ_TOL (merged.getVariance(), calculator.getVariance(), 1e-9, "Variance value wrong");
+  NS_TEST_ASSERT_MSG_EQ_TOL (merged.getSqrSum(),   calculator.getSqrSum(),   1e-9, "SqrSum value wrong");
+  NS_TEST_ASSERT_MSG_EQ (mergedCounter.GetCount (), counter.GetCount (), "Counter value wrong");
+}
+
 
 class BasicDataCalculatorsTestSuite : public TestSuite
 {
@@ -252,6 +314,7 @@ BasicDataCalculatorsTestSuite::BasicDataCalculatorsTestSuite ()
   AddTestCase (new OneIntegerTestCase, TestCase::QUICK);
   AddTestCase (new FiveIntegersTestCase, TestCase::QUICK);
   AddTestCase (new FiveDoublesTestCase, TestCase::QUICK);
+  AddTestCase (new MergeTestCase, TestCase::QUICK);
 }
 
 static BasicDataCalculatorsTestSuite basicDataCalculatorsTestSuite;
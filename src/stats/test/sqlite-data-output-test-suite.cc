@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/basic-data-calculators.h"
+#include "ns3/data-collector.h"
+#include "ns3/sqlite-data-output.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Test case for the rows written by SqliteDataOutput.
+// ===========================================================================
+
+class SqliteDataOutputTestCase : public TestCase
+{
+public:
+  SqliteDataOutputTestCase ();
+  virtual ~SqliteDataOutputTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Runs a query returning a single value
+   * \param db the database
+   * \param query the query
+   * \return the value returned by the query, as text
+   */
+  std::string Query (sqlite3 *db, std::string query);
+};
+
+SqliteDataOutputTestCase::SqliteDataOutputTestCase ()
+  : TestCase ("Rows written in batches by SqliteDataOutput")
+{
+}
+
+SqliteDataOutputTestCase::~SqliteDataOutputTestCase ()
+{
+}
+
+std::string
+SqliteDataOutputTestCase::Query (sqlite3 *db, std::string query)
+{
+  sqlite3_stmt *stmt;
+  std::string value;
+  sqlite3_prepare_v2 (db, query.c_str (), -1, &stmt, NULL);
+  if (sqlite3_step (stmt) == SQLITE_ROW)
+    {
+      value = reinterpret_cast<const char *> (sqlite3_column_text (stmt, 0));
+    }
+  sqlite3_finalize (stmt);
+  return value;
+}
+
+void
+SqliteDataOutputTestCase::DoRun (void)
+{
+  std::string prefix = CreateTempDirFilename ("sqlite-data-output");
+  std::remove ((prefix + ".db").c_str ());
+
+  DataCollector data;
+  data.DescribeRun ("experiment", "strategy", "input", "run-1");
+  data.AddMetadata ("author", "tester");
+
+  // more singletons than two batches
+  for (uint32_t i = 0; i < 150; i++)
+    {
+      Ptr<CounterCalculator<> > counter = CreateObject<CounterCalculator<> > ();
+      std::ostringstream key;
+      key << "counter-" << i;
+      counter->SetKey (key.str ());
+      counter->SetContext ("test");
+      counter->Update (i);
+      data.AddDataCalculator (counter);
+    }
+  Ptr<MinMaxAvgTotalCalculator<double> > delay = CreateObject<MinMaxAvgTotalCalculator<double> > ();
+  delay->SetKey ("delay");
+  delay->SetContext ("test");
+  delay->Update (1.5);
+  delay->Update (2.5);
+  data.AddDataCalculator (delay);
+
+  Ptr<SqliteDataOutput> output = CreateObject<SqliteDataOutput> ();
+  output->SetFilePrefix (prefix);
+  output->Output (data);
+
+  sqlite3 *db;
+  NS_TEST_ASSERT_MSG_EQ (sqlite3_open ((prefix + ".db").c_str (), &db), SQLITE_OK, "Unable to open the database");
+  NS_TEST_EXPECT_MSG_EQ (Query (db, "select count(*) from Experiments"), "1", "Wrong number of experiments");
+  NS_TEST_EXPECT_MSG_EQ (Query (db, "select value from Metadata where run='run-1' and key='author'"), "tester",
+                         "Wrong metadata");
+  NS_TEST_EXPECT_MSG_EQ (Query (db, "select count(*) from Singletons where run='run-1'"), "156",
+                         "Wrong number of singletons");
+  NS_TEST_EXPECT_MSG_EQ (Query (db, "select sum(value) from Singletons where variable like 'counter-%'"), "11175",
+                         "Wrong values of the counters");
+  NS_TEST_EXPECT_MSG_EQ (Query (db, "select value from Singletons where name='test' and variable='counter-149'"), "149",
+                         "Wrong value of the last counter");
+  NS_TEST_EXPECT_MSG_EQ (Query (db, "select value from Singletons where variable='delay-total'"), "4.0",
+                         "Wrong value of the statistic");
+  sqlite3_close (db);
+  std::remove ((prefix + ".db").c_str ());
+}
+
+
+class SqliteDataOutputTestSuite : public TestSuite
+{
+public:
+  SqliteDataOutputTestSuite ();
+};
+
+SqliteDataOutputTestSuite::SqliteDataOutputTestSuite ()
+  : TestSuite ("sqlite-data-output", UNIT)
+{
+  AddTestCase (new SqliteDataOutputTestCase, TestCase::QUICK);
+}
+
+static SqliteDataOutputTestSuite sqliteDataOutputTestSuite;
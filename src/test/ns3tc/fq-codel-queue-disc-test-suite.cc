@@ -33,6 +33,8 @@
 #include "ns3/udp-header.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 
 using namespace ns3;
 
@@ -513,6 +515,133 @@ FqCoDelQueueDiscUDPFlowsSeparation::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * Simple test packet filter returning the source address of IPv4 packets
+ * as their flow hash
+ */
+class Ipv4SourceHashPacketFilter : public Ipv4PacketFilter {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  Ipv4SourceHashPacketFilter ();
+  virtual ~Ipv4SourceHashPacketFilter ();
+
+private:
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const;
+};
+
+TypeId
+Ipv4SourceHashPacketFilter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Ipv4SourceHashPacketFilter")
+    .SetParent<Ipv4PacketFilter> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<Ipv4SourceHashPacketFilter> ()
+  ;
+  return tid;
+}
+
+Ipv4SourceHashPacketFilter::Ipv4SourceHashPacketFilter ()
+{
+}
+
+Ipv4SourceHashPacketFilter::~Ipv4SourceHashPacketFilter ()
+{
+}
+
+int32_t
+Ipv4SourceHashPacketFilter::DoClassify (Ptr<QueueDiscItem> item) const
+{
+  return DynamicCast<Ipv4QueueDiscItem> (item)->GetHeader ().GetSource ().Get ();
+}
+
+/**
+ * This class tests the set associative hash
+ */
+class FqCoDelQueueDiscSetLinearProbing : public TestCase
+{
+public:
+  FqCoDelQueueDiscSetLinearProbing ();
+  virtual ~FqCoDelQueueDiscSetLinearProbing ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Enqueue a packet whose flow hash is given by the filter
+   * \param queue the queue disc
+   * \param hash the flow hash
+   */
+  void AddPacket (Ptr<FqCoDelQueueDisc> queue, uint32_t hash);
+};
+
+FqCoDelQueueDiscSetLinearProbing::FqCoDelQueueDiscSetLinearProbing ()
+  : TestCase ("Test set associative hash")
+{
+}
+
+FqCoDelQueueDiscSetLinearProbing::~FqCoDelQueueDiscSetLinearProbing ()
+{
+}
+
+void
+FqCoDelQueueDiscSetLinearProbing::AddPacket (Ptr<FqCoDelQueueDisc> queue, uint32_t hash)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  Ipv4Header hdr;
+  hdr.SetPayloadSize (100);
+  hdr.SetSource (Ipv4Address (hash));
+  hdr.SetDestination (Ipv4Address ("10.10.1.2"));
+  hdr.SetProtocol (7);
+  Address dest;
+  Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (p, dest, 0, hdr);
+  queue->Enqueue (item);
+}
+
+void
+FqCoDelQueueDiscSetLinearProbing::DoRun (void)
+{
+  Ptr<FqCoDelQueueDisc> queueDisc = CreateObjectWithAttributes<FqCoDelQueueDisc> ("MaxSize", StringValue ("100p"),
+                                                                                  "Flows", UintegerValue (16),
+                                                                                  "EnableSetAssociativeHash", BooleanValue (true),
+                                                                                  "SetWays", UintegerValue (8));
+  queueDisc->AddPacketFilter (CreateObject<Ipv4SourceHashPacketFilter> ());
+  queueDisc->SetQuantum (1500);
+  queueDisc->Initialize ();
+
+  // Hashes 1, 17 and 33 are all mapped to the first set: each flow gets
+  // its own queue in the set
+  AddPacket (queueDisc, 1);
+  AddPacket (queueDisc, 17);
+  AddPacket (queueDisc, 17);
+  AddPacket (queueDisc, 33);
+  AddPacket (queueDisc, 1);
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetNQueueDiscClasses (), 3, "unexpected number of flow queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 2, "unexpected number of packets in the first flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 2, "unexpected number of packets in the second flow queue");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (2)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the third flow queue");
+
+  // A flow of the second set
+  AddPacket (queueDisc, 9);
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetNQueueDiscClasses (), 4, "unexpected number of flow queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (3)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the fourth flow queue");
+
+  // Fill the first set: the ninth flow shares the first queue of the set
+  for (uint32_t i = 3; i < 8; i++)
+    {
+      AddPacket (queueDisc, 1 + 16 * i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetNQueueDiscClasses (), 9, "unexpected number of flow queues");
+  AddPacket (queueDisc, 1 + 16 * 8);
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetNQueueDiscClasses (), 9, "unexpected number of flow queues");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 3, "unexpected number of packets in the shared flow queue");
+
+  Simulator::Destroy ();
+}
+
 class FqCoDelQueueDiscTestSuite : public TestSuite
 {
 public:
@@ -527,6 +656,7 @@ FqCoDelQueueDiscTestSuite::FqCoDelQueueDiscTestSuite ()
   AddTestCase (new FqCoDelQueueDiscDeficit, TestCase::QUICK);
   AddTestCase (new FqCoDelQueueDiscTCPFlowsSeparation, TestCase::QUICK);
   AddTestCase (new FqCoDelQueueDiscUDPFlowsSeparation, TestCase::QUICK);
+  AddTestCase (new FqCoDelQueueDiscSetLinearProbing, TestCase::QUICK);
 }
 
 static FqCoDelQueueDiscTestSuite fqCoDelQueueDiscTestSuite;
@@ -21,6 +21,7 @@
 
 #include "ns3/log.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
 #include "ns3/queue.h"
 #include "fq-codel-queue-disc.h"
 #include "codel-queue-disc.h"
@@ -44,7 +45,8 @@ TypeId FqCoDelFlow::GetTypeId (void)
 
 FqCoDelFlow::FqCoDelFlow ()
   : m_deficit (0),
-    m_status (INACTIVE)
+    m_status (INACTIVE),
+    m_next (nullptr)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -129,6 +131,16 @@ TypeId FqCoDelQueueDisc::GetTypeId (void)
                    UintegerValue (0),
                    MakeUintegerAccessor (&FqCoDelQueueDisc::m_perturbation),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("EnableSetAssociativeHash",
+                   "Enable/Disable Set Associative Hash",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FqCoDelQueueDisc::m_enableSetAssociativeHash),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SetWays",
+                   "The size of a set of queues (used by set associative hash)",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&FqCoDelQueueDisc::m_setWays),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -145,6 +157,18 @@ FqCoDelQueueDisc::~FqCoDelQueueDisc ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+FqCoDelQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the flows are owned by the classes, released by QueueDisc::DoDispose
+  m_newFlows = FlowList ();
+  m_oldFlows = FlowList ();
+  m_flowsIndices.clear ();
+  m_flowQueues.clear ();
+  QueueDisc::DoDispose ();
+}
+
 void
 FqCoDelQueueDisc::SetQuantum (uint32_t quantum)
 {
@@ -158,16 +182,71 @@ FqCoDelQueueDisc::GetQuantum (void) const
   return m_quantum;
 }
 
+void
+FqCoDelQueueDisc::FlowList::PushBack (FqCoDelFlow *flow)
+{
+  flow->m_next = nullptr;
+  if (tail == nullptr)
+    {
+      head = flow;
+    }
+  else
+    {
+      tail->m_next = flow;
+    }
+  tail = flow;
+}
+
+FqCoDelFlow *
+FqCoDelQueueDisc::FlowList::PopFront (void)
+{
+  FqCoDelFlow *flow = head;
+  head = flow->m_next;
+  if (head == nullptr)
+    {
+      tail = nullptr;
+    }
+  flow->m_next = nullptr;
+  return flow;
+}
+
+uint32_t
+FqCoDelQueueDisc::SetAssociativeHash (uint32_t flowHash)
+{
+  NS_LOG_FUNCTION (this << flowHash);
+
+  uint32_t h = flowHash % m_flows;
+  uint32_t innerHash = h % m_setWays;
+  uint32_t outerHash = h - innerHash;
+
+  for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
+    {
+      FqCoDelFlow *flow = m_flowsIndices[i];
+      if (flow == nullptr || m_tags[i] == flowHash
+          || flow->GetStatus () == FqCoDelFlow::INACTIVE)
+        {
+          // this queue has not been created yet or is associated with this flow
+          // or is inactive, hence we can use it
+          m_tags[i] = flowHash;
+          return i;
+        }
+    }
+
+  // all the queues of the set are used. Use the first queue of the set
+  m_tags[outerHash] = flowHash;
+  return outerHash;
+}
+
 bool
 FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 {
   NS_LOG_FUNCTION (this << item);
 
-  uint32_t h = 0;
+  uint32_t flowHash, h;
 
   if (GetNPacketFilters () == 0)
     {
-      h = item->Hash (m_perturbation) % m_flows;
+      flowHash = item->Hash (m_perturbation);
     }
   else
     {
@@ -175,7 +254,7 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 
       if (ret != PacketFilter::PF_NO_MATCH)
         {
-          h = ret % m_flows;
+          flowHash = static_cast<uint32_t> (ret);
         }
       else
         {
@@ -185,33 +264,41 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
         }
     }
 
-  Ptr<FqCoDelFlow> flow;
-  if (m_flowsIndices.find (h) == m_flowsIndices.end ())
+  if (m_enableSetAssociativeHash)
+    {
+      h = SetAssociativeHash (flowHash);
+    }
+  else
+    {
+      h = flowHash % m_flows;
+    }
+
+  FqCoDelFlow *flow = m_flowsIndices[h];
+  if (flow == nullptr)
     {
       NS_LOG_DEBUG ("Creating a new flow queue with index " << h);
-      flow = m_flowFactory.Create<FqCoDelFlow> ();
+      Ptr<FqCoDelFlow> newFlow = m_flowFactory.Create<FqCoDelFlow> ();
       Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc> ();
       qd->Initialize ();
-      flow->SetQueueDisc (qd);
-      AddQueueDiscClass (flow);
+      newFlow->SetQueueDisc (qd);
+      AddQueueDiscClass (newFlow);
 
-      m_flowsIndices[h] = GetNQueueDiscClasses () - 1;
-    }
-  else
-    {
-      flow = StaticCast<FqCoDelFlow> (GetQueueDiscClass (m_flowsIndices[h]));
+      // the class list holds a reference to the flow as long as this queue disc
+      flow = PeekPointer (newFlow);
+      m_flowsIndices[h] = flow;
+      m_flowQueues.push_back (flow);
     }
 
   if (flow->GetStatus () == FqCoDelFlow::INACTIVE)
     {
       flow->SetStatus (FqCoDelFlow::NEW_FLOW);
       flow->SetDeficit (m_quantum);
-      m_newFlows.push_back (flow);
+      m_newFlows.PushBack (flow);
     }
 
   flow->GetQueueDisc ()->Enqueue (item);
 
-  NS_LOG_DEBUG ("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+  NS_LOG_DEBUG ("Packet enqueued into flow " << h);
 
   if (GetCurrentSize () > GetMaxSize ())
     {
@@ -226,23 +313,22 @@ FqCoDelQueueDisc::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<FqCoDelFlow> flow;
+  FqCoDelFlow *flow = nullptr;
   Ptr<QueueDiscItem> item;
 
   do
     {
       bool found = false;
 
-      while (!found && !m_newFlows.empty ())
+      while (!found && !m_newFlows.Empty ())
         {
-          flow = m_newFlows.front ();
+          flow = m_newFlows.head;
 
           if (flow->GetDeficit () <= 0)
             {
               flow->IncreaseDeficit (m_quantum);
               flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              m_oldFlows.PushBack (m_newFlows.PopFront ());
             }
           else
             {
@@ -251,15 +337,14 @@ FqCoDelQueueDisc::DoDequeue (void)
             }
         }
 
-      while (!found && !m_oldFlows.empty ())
+      while (!found && !m_oldFlows.Empty ())
         {
-          flow = m_oldFlows.front ();
+          flow = m_oldFlows.head;
 
           if (flow->GetDeficit () <= 0)
             {
               flow->IncreaseDeficit (m_quantum);
-              m_oldFlows.push_back (flow);
-              m_oldFlows.pop_front ();
+              m_oldFlows.PushBack (m_oldFlows.PopFront ());
             }
           else
             {
@@ -279,16 +364,15 @@ FqCoDelQueueDisc::DoDequeue (void)
       if (!item)
         {
           NS_LOG_DEBUG ("Could not get a packet from the selected flow queue");
-          if (!m_newFlows.empty ())
+          if (!m_newFlows.Empty ())
             {
               flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              m_oldFlows.PushBack (m_newFlows.PopFront ());
             }
           else
             {
               flow->SetStatus (FqCoDelFlow::INACTIVE);
-              m_oldFlows.pop_front ();
+              m_oldFlows.PopFront ();
             }
         }
       else
@@ -339,6 +423,13 @@ FqCoDelQueueDisc::CheckConfig (void)
         }
     }
 
+  if (m_enableSetAssociativeHash && (m_flows % m_setWays != 0))
+    {
+      NS_LOG_ERROR ("The number of queues must be an integer multiple of the size "
+                    "of the set of queues used by set associative hash");
+      return false;
+    }
+
   return true;
 }
 
@@ -353,6 +444,10 @@ FqCoDelQueueDisc::InitializeParams (void)
   m_queueDiscFactory.Set ("MaxSize", QueueSizeValue (GetMaxSize ()));
   m_queueDiscFactory.Set ("Interval", StringValue (m_interval));
   m_queueDiscFactory.Set ("Target", StringValue (m_target));
+
+  m_flowsIndices.assign (m_flows, nullptr);
+  m_tags.assign (m_flows, 0);
+  m_flowQueues.reserve (m_flows);
 }
 
 uint32_t
@@ -364,10 +459,9 @@ FqCoDelQueueDisc::FqCoDelDrop (void)
   Ptr<QueueDisc> qd;
 
   /* Queue is full! Find the fat flow and drop packet(s) from it */
-  for (uint32_t i = 0; i < GetNQueueDiscClasses (); i++)
+  for (uint32_t i = 0; i < m_flowQueues.size (); i++)
     {
-      qd = GetQueueDiscClass (i)->GetQueueDisc ();
-      uint32_t bytes = qd->GetNBytes ();
+      uint32_t bytes = m_flowQueues[i]->GetQueueDisc ()->GetNBytes ();
       if (bytes > maxBacklog)
         {
           maxBacklog = bytes;
@@ -377,7 +471,7 @@ FqCoDelQueueDisc::FqCoDelDrop (void)
 
   /* Our goal is to drop half of this fat flow backlog */
   uint32_t len = 0, count = 0, threshold = maxBacklog >> 1;
-  qd = GetQueueDiscClass (index)->GetQueueDisc ();
+  qd = m_flowQueues[index]->GetQueueDisc ();
   Ptr<QueueDiscItem> item;
 
   do
@@ -24,8 +24,7 @@
 
 #include "ns3/queue-disc.h"
 #include "ns3/object-factory.h"
-#include <list>
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -87,8 +86,11 @@ public:
   FlowStatus GetStatus (void) const;
 
 private:
+  friend class FqCoDelQueueDisc;
+
   int32_t m_deficit;    //!< the deficit for this flow
   FlowStatus m_status;  //!< the status of this flow
+  FqCoDelFlow *m_next;  //!< the next flow in the list of new or old flows
 };
 
 
@@ -130,6 +132,12 @@ public:
   static constexpr const char* UNCLASSIFIED_DROP = "Unclassified drop";  //!< No packet filter able to classify packet
   static constexpr const char* OVERLIMIT_DROP = "Overlimit drop";        //!< Overlimit dropped packets
 
+protected:
+  /**
+   * \brief Dispose of the object
+   */
+  virtual void DoDispose (void);
+
 private:
   virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
   virtual Ptr<QueueDiscItem> DoDequeue (void);
@@ -142,17 +150,51 @@ private:
    */
   uint32_t FqCoDelDrop (void);
 
+  /**
+   * \brief Compute the index of the flow queue of a flow, sharing the
+   * queues of a set among the flows hashed to it
+   * \param flowHash the hash of the flow
+   * \return the index of the flow queue
+   */
+  uint32_t SetAssociativeHash (uint32_t flowHash);
+
+  /**
+   * \brief A FIFO list of flows, linked through the flows themselves
+   */
+  struct FlowList
+  {
+    FqCoDelFlow *head {nullptr}; //!< the first flow
+    FqCoDelFlow *tail {nullptr}; //!< the last flow
+
+    /**
+     * \return true if the list is empty
+     */
+    bool Empty (void) const { return head == nullptr; }
+    /**
+     * \param flow the flow to append
+     */
+    void PushBack (FqCoDelFlow *flow);
+    /**
+     * \return the first flow, removed from the list
+     */
+    FqCoDelFlow * PopFront (void);
+  };
+
   std::string m_interval;    //!< CoDel interval attribute
   std::string m_target;      //!< CoDel target attribute
   uint32_t m_quantum;        //!< Deficit assigned to flows at each round
   uint32_t m_flows;          //!< Number of flow queues
   uint32_t m_dropBatchSize;  //!< Max number of packets dropped from the fat flow
   uint32_t m_perturbation;   //!< hash perturbation value
+  bool m_enableSetAssociativeHash; //!< whether to enable set associative hash
+  uint32_t m_setWays;        //!< size of a set of queues (used by set associative hash)
 
-  std::list<Ptr<FqCoDelFlow> > m_newFlows;    //!< The list of new flows
-  std::list<Ptr<FqCoDelFlow> > m_oldFlows;    //!< The list of old flows
+  FlowList m_newFlows;    //!< The list of new flows
+  FlowList m_oldFlows;    //!< The list of old flows
 
-  std::map<uint32_t, uint32_t> m_flowsIndices;    //!< Map with the index of class for each flow
+  std::vector<FqCoDelFlow *> m_flowsIndices; //!< Flow queue of each flow index, null until created
+  std::vector<uint32_t> m_tags;              //!< Hash of the flow last assigned to each flow index
+  std::vector<FqCoDelFlow *> m_flowQueues;   //!< Flow queues, in the order of the classes
 
   ObjectFactory m_flowFactory;         //!< Factory to create a new flow
   ObjectFactory m_queueDiscFactory;    //!< Factory to create a new queue
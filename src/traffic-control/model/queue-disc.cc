@@ -29,6 +29,8 @@
 #include "queue-disc.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/queue.h"
+#include <algorithm>
+#include <limits>
 
 namespace ns3 {
 
@@ -270,6 +272,13 @@ TypeId QueueDisc::GetTypeId (void)
                    MakeUintegerAccessor (&QueueDisc::SetQuota,
                                          &QueueDisc::GetQuota),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxBatchSize",
+                   "The maximum number of packets sent in a batch to devices supporting "
+                   "batched transmissions (1 disables batching)",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&QueueDisc::SetMaxBatchSize,
+                                         &QueueDisc::GetMaxBatchSize),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddAttribute ("InternalQueueList", "The list of internal queues.",
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&QueueDisc::m_queues),
@@ -323,6 +332,7 @@ QueueDisc::QueueDisc (QueueDiscSizePolicy policy)
   :  m_nPackets (0),
      m_nBytes (0),
      m_maxSize (QueueSize ("1p")),         // to avoid that setting the mode at construction time is ignored
+     m_maxBatchSize (1),
      m_running (false),
      m_peeked (false),
      m_sizePolicy (policy),
@@ -383,6 +393,8 @@ QueueDisc::DoDispose (void)
   m_classes.clear ();
   m_devQueueIface = 0;
   m_send = nullptr;
+  m_sendBatch = nullptr;
+  m_batch.clear ();
   m_requeued = 0;
   m_internalQueueDbeFunctor = nullptr;
   m_internalQueueDadFunctor = nullptr;
@@ -558,6 +570,34 @@ QueueDisc::GetSendCallback (void) const
   return m_send;
 }
 
+void
+QueueDisc::SetSendBatchCallback (SendBatchCallback func)
+{
+  NS_LOG_FUNCTION (this);
+  m_sendBatch = func;
+}
+
+QueueDisc::SendBatchCallback
+QueueDisc::GetSendBatchCallback (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_sendBatch;
+}
+
+void
+QueueDisc::SetMaxBatchSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_maxBatchSize = size;
+}
+
+uint32_t
+QueueDisc::GetMaxBatchSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_maxBatchSize;
+}
+
 void
 QueueDisc::SetQuota (const uint32_t quota)
 {
@@ -951,6 +991,16 @@ QueueDisc::Run (void)
   if (RunBegin ())
     {
       uint32_t quota = m_quota;
+      // as in Linux, bulk dequeues are only performed for single queue devices
+      if (m_sendBatch && m_maxBatchSize > 1
+          && (!m_devQueueIface || m_devQueueIface->GetNTxQueues () == 1))
+        {
+          while (quota > 0 && RestartBatch (quota))
+            {
+            }
+          RunEnd ();
+          return;
+        }
       while (Restart ())
         {
           quota -= 1;
@@ -998,6 +1048,56 @@ QueueDisc::Restart (void)
   return Transmit (item);
 }
 
+bool
+QueueDisc::RestartBatch (uint32_t &quota)
+{
+  NS_LOG_FUNCTION (this << quota);
+
+  uint32_t maxItems = std::min (quota, m_maxBatchSize);
+  int64_t bytes = std::numeric_limits<int32_t>::max ();
+  Ptr<NetDeviceQueue> txq;
+  if (m_devQueueIface)
+    {
+      txq = m_devQueueIface->GetTxQueue (0);
+      // a stopped queue is detected by DequeuePacket, hence at least one
+      // packet is requested to the queue disc
+      maxItems = std::max<uint32_t> (std::min (maxItems, txq->GetAvailablePackets ()), 1);
+      bytes = txq->GetAvailableBytes ();
+    }
+
+  NS_ASSERT (m_batch.empty ());
+  Ptr<QueueDiscItem> item;
+  while (m_batch.size () < maxItems && (m_batch.empty () || bytes > 0)
+         && (item = DequeuePacket ()) != 0)
+    {
+      bytes -= item->GetSize ();
+      m_batch.push_back (item);
+    }
+
+  if (m_batch.empty ())
+    {
+      NS_LOG_LOGIC ("No packet to send");
+      return false;
+    }
+
+  // RestartBatch is only called for single queue devices, which make no use
+  // of the priority tag
+  for (auto& batchItem : m_batch)
+    {
+      SocketPriorityTag priorityTag;
+      batchItem->GetPacket ()->RemovePacketTag (priorityTag);
+    }
+
+  NS_LOG_LOGIC ("Sending a batch of " << m_batch.size () << " packets");
+  quota -= m_batch.size ();
+  m_sendBatch (m_batch);
+  m_batch.clear ();
+
+  // as in Transmit, return false if the queue disc is empty or the device
+  // queue is now stopped
+  return GetNPackets () != 0 && !(txq && txq->IsStopped ());
+}
+
 Ptr<QueueDiscItem>
 QueueDisc::DequeuePacket ()
 {
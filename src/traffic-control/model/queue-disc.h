@@ -372,6 +372,36 @@ public:
    */
   SendCallback GetSendCallback (void) const;
 
+  /// Callback invoked to send a batch of packets to the receiving object when Run is called
+  typedef std::function<void (const std::vector<Ptr<QueueDiscItem> > &)> SendBatchCallback;
+
+  /**
+   * \param func the callback to send a batch of packets to the receiving object.
+   *
+   * Set the callback used by the Run method to send a batch of packets to the
+   * receiving object. If this callback is set and the maximum batch size is
+   * greater than one, packets are dequeued and sent in batches; otherwise,
+   * they are sent one at a time through the send callback.
+   */
+  void SetSendBatchCallback (SendBatchCallback func);
+
+  /**
+   * \return the callback to send a batch of packets to the receiving object.
+   */
+  SendBatchCallback GetSendBatchCallback (void) const;
+
+  /**
+   * \brief Set the maximum number of packets sent to the receiving object in a batch
+   * \param size the maximum number of packets in a batch
+   */
+  void SetMaxBatchSize (uint32_t size);
+
+  /**
+   * \brief Get the maximum number of packets sent to the receiving object in a batch
+   * \return the maximum number of packets in a batch
+   */
+  uint32_t GetMaxBatchSize (void) const;
+
   /**
    * \brief Set the maximum number of dequeue operations following a packet enqueue
    * \param quota the maximum number of dequeue operations following a packet enqueue.
@@ -654,6 +684,19 @@ private:
    */
   bool Restart (void);
 
+  /**
+   * Modelled after the bulk dequeue performed by the Linux functions
+   * dequeue_skb and try_bulk_dequeue_skb (net/sched/sch_generic.c).
+   * Dequeue as many packets as the device transmission queue can accept
+   * (without exceeding the quota, the maximum batch size and, as in Linux,
+   * the bytes allowed by the queue limits by more than one packet) and send
+   * them to the device with a single call to the send batch callback.
+   * \param quota the remaining quota, decreased by the number of packets sent
+   * \return true if packets are successfully sent to the device, the device
+   *         queue is not stopped and the queue disc is not empty.
+   */
+  bool RestartBatch (uint32_t &quota);
+
   /**
    * Modelled after the Linux function dequeue_skb (net/sched/sch_generic.c)
    * \return the requeued packet, if any, or the packet dequeued by the queue disc, otherwise.
@@ -705,6 +748,9 @@ private:
   uint32_t m_quota;                 //!< Maximum number of packets dequeued in a qdisc run
   Ptr<NetDeviceQueueInterface> m_devQueueIface;   //!< NetDevice queue interface
   SendCallback m_send;              //!< Callback used to send a packet to the receiving object
+  SendBatchCallback m_sendBatch;    //!< Callback used to send a batch of packets to the receiving object
+  uint32_t m_maxBatchSize;          //!< Maximum number of packets sent in a batch
+  std::vector<Ptr<QueueDiscItem> > m_batch; //!< The batch of packets being sent
   bool m_running;                   //!< The queue disc is performing multiple dequeue operations
   Ptr<QueueDiscItem> m_requeued;    //!< The last packet that failed to be transmitted
   bool m_peeked;                    //!< A packet was dequeued because Peek was called
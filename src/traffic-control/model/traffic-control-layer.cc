@@ -193,6 +193,11 @@ TrafficControlLayer::ScanDevices (void)
               q->SetNetDeviceQueueInterface (ndqi);
               q->SetSendCallback ([dev] (Ptr<QueueDiscItem> item)
                                   { dev->Send (item->GetPacket (), item->GetAddress (), item->GetProtocol ()); });
+              if (dev->SupportsSendBatch ())
+                {
+                  q->SetSendBatchCallback ([dev] (const std::vector<Ptr<QueueDiscItem> > &items)
+                                           { dev->SendBatch (items); });
+                }
             }
         }
     }
@@ -257,6 +262,7 @@ TrafficControlLayer::DeleteRootQueueDiscOnDevice (Ptr<NetDevice> device)
     {
       q->SetNetDeviceQueueInterface (nullptr);
       q->SetSendCallback (nullptr);
+      q->SetSendBatchCallback (nullptr);
     }
   ndi->second.m_queueDiscsToWake.clear ();
 
@@ -0,0 +1,254 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/fifo-queue-disc.h"
+#include "ns3/queue-limits.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Queue Disc Batch Test Item
+ */
+class QueueDiscBatchTestItem : public QueueDiscItem {
+public:
+  /**
+   * Constructor
+   *
+   * \param p the packet stored in this item
+   */
+  QueueDiscBatchTestItem (Ptr<Packet> p);
+  virtual ~QueueDiscBatchTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+
+private:
+  QueueDiscBatchTestItem ();
+  /**
+   * \brief Copy constructor
+   * Disable default implementation to avoid misuse
+   */
+  QueueDiscBatchTestItem (const QueueDiscBatchTestItem &);
+  /**
+   * \brief Assignment operator
+   * \return this object
+   * Disable default implementation to avoid misuse
+   */
+  QueueDiscBatchTestItem &operator = (const QueueDiscBatchTestItem &);
+};
+
+QueueDiscBatchTestItem::QueueDiscBatchTestItem (Ptr<Packet> p)
+  : QueueDiscItem (p, Mac48Address (), 0)
+{
+}
+
+QueueDiscBatchTestItem::~QueueDiscBatchTestItem ()
+{
+}
+
+void
+QueueDiscBatchTestItem::AddHeader (void)
+{
+}
+
+bool
+QueueDiscBatchTestItem::Mark (void)
+{
+  return false;
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Queue limits with a fixed limit, in bytes
+ */
+class FixedQueueLimits : public QueueLimits
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param limit the limit, in bytes
+   */
+  FixedQueueLimits (uint32_t limit)
+    : m_limit (limit),
+      m_inFlight (0)
+  {
+  }
+
+  virtual void Reset ()
+  {
+    m_inFlight = 0;
+  }
+
+  virtual void Completed (uint32_t count)
+  {
+    m_inFlight -= count;
+  }
+
+  virtual int32_t Available () const
+  {
+    return static_cast<int32_t> (m_limit) - static_cast<int32_t> (m_inFlight);
+  }
+
+  virtual void Queued (uint32_t count)
+  {
+    m_inFlight += count;
+  }
+
+private:
+  uint32_t m_limit;     //!< the limit
+  uint32_t m_inFlight;  //!< the bytes queued and not completed
+};
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check the batched dequeue of a queue disc
+ *
+ * Packets are handed to the receiving object in batches no larger than the
+ * maximum batch size and the quota, and no more packets are sent than allowed
+ * by the device queue status and (exceeding them by at most one packet, as
+ * in Linux) by the queue limits.
+ */
+class QueueDiscBatchTestCase : public TestCase
+{
+public:
+  QueueDiscBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Enqueue packets in the queue disc
+   * \param qdisc the queue disc
+   * \param nPackets the number of packets
+   */
+  void Enqueue (Ptr<QueueDisc> qdisc, uint32_t nPackets);
+
+  std::vector<uint32_t> m_batches; //!< the size of the batches sent
+  uint32_t m_nSent;                //!< the number of packets sent one at a time
+};
+
+QueueDiscBatchTestCase::QueueDiscBatchTestCase ()
+  : TestCase ("Check the batched dequeue of a queue disc"),
+    m_nSent (0)
+{
+}
+
+void
+QueueDiscBatchTestCase::Enqueue (Ptr<QueueDisc> qdisc, uint32_t nPackets)
+{
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      qdisc->Enqueue (Create<QueueDiscBatchTestItem> (Create<Packet> (1000)));
+    }
+}
+
+void
+QueueDiscBatchTestCase::DoRun (void)
+{
+  Ptr<QueueDisc> qdisc = CreateObjectWithAttributes<FifoQueueDisc> ("MaxSize", StringValue ("100p"),
+                                                                    "Quota", UintegerValue (10));
+  qdisc->Initialize ();
+  qdisc->SetSendCallback ([this] (Ptr<QueueDiscItem> item) { m_nSent++; });
+  qdisc->SetSendBatchCallback ([this] (const std::vector<Ptr<QueueDiscItem> > &items)
+                               { m_batches.push_back (items.size ()); });
+
+  // without batching, packets are sent one at a time
+  Enqueue (qdisc, 3);
+  qdisc->Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_nSent, 3, "Packets must be sent one at a time");
+  NS_TEST_EXPECT_MSG_EQ (m_batches.size (), 0, "No batch must be sent");
+
+  // batches are limited by the maximum batch size and by the quota
+  qdisc->SetMaxBatchSize (4);
+  Enqueue (qdisc, 12);
+  qdisc->Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_nSent, 3, "Packets must be sent in batches");
+  NS_TEST_EXPECT_MSG_EQ (m_batches.size (), 3, "Unexpected number of batches");
+  NS_TEST_EXPECT_MSG_EQ (m_batches[0], 4, "Unexpected size of the first batch");
+  NS_TEST_EXPECT_MSG_EQ (m_batches[1], 4, "Unexpected size of the second batch");
+  NS_TEST_EXPECT_MSG_EQ (m_batches[2], 2, "Unexpected size of the last batch (quota)");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 2, "Two packets must be left in the queue disc");
+  qdisc->Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_batches.size (), 4, "Unexpected number of batches");
+  NS_TEST_EXPECT_MSG_EQ (m_batches[3], 2, "Unexpected size of the batch");
+  m_batches.clear ();
+
+  // no packet is sent if the device queue is stopped
+  Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface> ();
+  Ptr<NetDeviceQueue> txq = ndqi->GetTxQueue (0);
+  qdisc->SetNetDeviceQueueInterface (ndqi);
+  Enqueue (qdisc, 10);
+  txq->Stop ();
+  qdisc->Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_batches.size (), 0, "No batch must be sent to a stopped queue");
+  txq->Start ();
+
+  // batches do not exceed the queue limits by more than one packet
+  txq->SetQueueLimits (CreateObject<FixedQueueLimits> (2500));
+  qdisc->SetSendBatchCallback ([this, txq] (const std::vector<Ptr<QueueDiscItem> > &items)
+                               {
+                                 m_batches.push_back (items.size ());
+                                 for (auto &item : items)
+                                   {
+                                     txq->NotifyQueuedBytes (item->GetSize ());
+                                   }
+                               });
+  qdisc->Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_batches.size (), 1, "The queue limits must stop the queue");
+  NS_TEST_EXPECT_MSG_EQ (m_batches[0], 3, "Unexpected size of the batch");
+  NS_TEST_EXPECT_MSG_EQ (txq->IsStopped (), true, "The queue limits must stop the queue");
+
+  // 1500 bytes are available after the completion of 2000 bytes
+  txq->NotifyTransmittedBytes (2000);
+  NS_TEST_EXPECT_MSG_EQ (txq->IsStopped (), false, "The queue must be restarted");
+  qdisc->Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_batches.size (), 2, "Unexpected number of batches");
+  NS_TEST_EXPECT_MSG_EQ (m_batches[1], 2, "Unexpected size of the batch");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 5, "Five packets must be left in the queue disc");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Queue Disc Batch Test Suite
+ */
+static class QueueDiscBatchTestSuite : public TestSuite
+{
+public:
+  QueueDiscBatchTestSuite ()
+    : TestSuite ("queue-disc-batch", UNIT)
+  {
+    AddTestCase (new QueueDiscBatchTestCase (), TestCase::QUICK);
+  }
+} g_queueDiscBatchTestSuite; ///< the test suite
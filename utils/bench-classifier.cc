@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the multi-field packet
+// classifier (TupleSpaceClassifier) against a linear search over the
+// same rules, for rule sets of increasing size.
+// Sample usage:  ./waf --run 'bench-classifier --n=100000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tuple-space-classifier.h"
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+
+using namespace ns3;
+
+/**
+ * Fill a random IPv4 rule, typical of access control lists: a
+ * destination prefix, an optional source prefix, a protocol and either
+ * a single destination port or a port range
+ *
+ * \param rule the rule to fill
+ */
+static void
+FillRule (TupleSpaceClassifier::Rule &rule)
+{
+  const uint32_t prefixes[] = {0xff000000, 0xffff0000, 0xffffff00, 0xffffffff};
+  rule.SetDestination (Ipv4Address (rand ()), Ipv4Mask (prefixes[rand () % 4]));
+  if (rand () % 2)
+    {
+      rule.SetSource (Ipv4Address (rand ()), Ipv4Mask (prefixes[rand () % 4]));
+    }
+  rule.protocol = (rand () % 2) ? 6 : 17;
+  rule.protocolMask = 0xff;
+  if (rand () % 4)
+    {
+      rule.destinationPortStart = rule.destinationPortEnd = rand () % 65536;
+    }
+  else
+    {
+      rule.destinationPortStart = 1024;
+      rule.destinationPortEnd = 1024 + rand () % 10000;
+    }
+  rule.priority = rand () % 100;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 100000;
+  uint32_t maxRules = 10000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark TupleSpaceClassifier");
+  cmd.AddValue ("n", "number of lookups", n);
+  cmd.AddValue ("max-rules", "largest number of rules", maxRules);
+  cmd.Parse (argc, argv);
+
+  srand (1);
+  std::vector<TupleSpaceClassifier::Key> keys (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      keys[i].SetSource (Ipv4Address (rand ()));
+      keys[i].SetDestination (Ipv4Address (rand ()));
+      keys[i].sourcePort = rand () % 65536;
+      keys[i].destinationPort = rand () % 65536;
+      keys[i].protocol = (rand () % 2) ? 6 : 17;
+    }
+
+  std::cout << "rules\ttuples\tlookup (ms)\tlinear (ms)\tspeedup" << std::endl;
+  for (uint32_t nRules = 10; nRules <= maxRules; nRules *= 10)
+    {
+      TupleSpaceClassifier classifier;
+      for (uint32_t i = 0; i < nRules; ++i)
+        {
+          TupleSpaceClassifier::Rule rule;
+          FillRule (rule);
+          rule.value = i;
+          classifier.Add (rule);
+        }
+
+      std::vector<const TupleSpaceClassifier::Rule *> found (n);
+      SystemWallClockMs time;
+      time.Start ();
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          found[i] = classifier.Lookup (keys[i]);
+        }
+      int64_t lookupMs = time.End ();
+
+      std::vector<const TupleSpaceClassifier::Rule *> linearFound (n);
+      time.Start ();
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          linearFound[i] = classifier.LookupLinear (keys[i]);
+        }
+      int64_t linearMs = time.End ();
+
+      // both searches must pick the same rule for every key
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          if ((found[i] == 0) != (linearFound[i] == 0)
+              || (found[i] != 0 && found[i]->value != linearFound[i]->value))
+            {
+              std::cerr << "Error-- lookup and linear search disagree on key " << i
+                        << " with " << nRules << " rules" << std::endl;
+              exit (1);
+            }
+        }
+      std::cout << nRules << "\t" << classifier.GetNTuples () << "\t"
+                << lookupMs << "\t\t" << linearMs << "\t\t"
+                << static_cast<double> (linearMs) / std::max<int64_t> (lookupMs, 1)
+                << std::endl;
+    }
+
+  return 0;
+}
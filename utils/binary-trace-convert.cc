@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts the binary trace files written by the
+// BinaryTraceHelper to text, with one line per event in the layout of the
+// ascii traces, to CSV, or to binary trace files with another encoding.
+// Sample usage:
+//   ./waf --run 'binary-trace-convert --input=trace.btr --format=csv --output=trace.csv'
+
+#include "ns3/command-line.h"
+#include "ns3/nstime.h"
+#include "ns3/binary-trace-file.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  std::string format = "text";
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary trace file");
+  cmd.AddValue ("input", "the binary trace file", input);
+  cmd.AddValue ("output", "the converted file (standard output if empty)", output);
+  cmd.AddValue ("format", "the output format: text, csv, raw or compressed", format);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << "Error-- the binary trace file must be specified "
+                << "by command-line argument --input=(file name)" << std::endl;
+      exit (1);
+    }
+  bool binary = format == "raw" || format == "compressed";
+  if (format != "text" && format != "csv" && !binary)
+    {
+      std::cerr << "Error-- unknown format " << format << std::endl;
+      exit (1);
+    }
+  if (binary && output.empty ())
+    {
+      std::cerr << "Error-- binary output must be written to a file" << std::endl;
+      exit (1);
+    }
+
+  BinaryTraceFile in;
+  if (!in.Open (input))
+    {
+      std::cerr << "Error-- unable to read the binary trace file " << input << std::endl;
+      exit (1);
+    }
+  // print the times as the simulation which wrote the file would
+  Time::SetResolution (static_cast<Time::Unit> (in.GetResolution ()));
+
+  BinaryTraceEvent event;
+  if (binary)
+    {
+      BinaryTraceFile out;
+      if (!out.Create (output, format == "compressed"))
+        {
+          std::cerr << "Error-- unable to create " << output << std::endl;
+          exit (1);
+        }
+      while (in.Read (event))
+        {
+          out.Write (event);
+        }
+      out.Close ();
+    }
+  else
+    {
+      std::ofstream file;
+      if (!output.empty ())
+        {
+          file.open (output.c_str ());
+          if (!file)
+            {
+              std::cerr << "Error-- unable to create " << output << std::endl;
+              exit (1);
+            }
+        }
+      std::ostream &os = output.empty () ? std::cout : file;
+      if (format == "csv")
+        {
+          os << "time,type,node,device,uid,size" << std::endl;
+        }
+      while (in.Read (event))
+        {
+          double time = TimeStep (event.time).GetSeconds ();
+          if (format == "csv")
+            {
+              os << time << "," << event.type << "," << event.node << "," << event.device
+                 << "," << event.uid << "," << event.size << "\n";
+            }
+          else
+            {
+              os << event.type << " " << time << " /NodeList/" << event.node
+                 << "/DeviceList/" << event.device << " uid=" << event.uid
+                 << " size=" << event.size << "\n";
+            }
+        }
+    }
+
+  if (in.Fail ())
+    {
+      std::cerr << "Error-- the binary trace file " << input << " is corrupted" << std::endl;
+      exit (1);
+    }
+  return 0;
+}
@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts the animation traces written by the
+// AnimationInterface in BINARY_FORMAT to the XML read by NetAnim.
+// Sample usage:
+//   ./waf --run 'netanim-binary-convert --input=anim.bin --output=anim.xml'
+
+#include "ns3/command-line.h"
+#include "ns3/animation-interface.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary animation trace to the XML read by NetAnim");
+  cmd.AddValue ("input", "the binary animation trace", input);
+  cmd.AddValue ("output", "the XML animation trace", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      std::cerr << "Error-- the files must be specified by command-line "
+                << "arguments --input=(file name) --output=(file name)" << std::endl;
+      exit (1);
+    }
+
+  std::ifstream in (input.c_str (), std::ios::binary);
+  if (!in)
+    {
+      std::cerr << "Error-- unable to read the binary animation trace " << input << std::endl;
+      exit (1);
+    }
+  std::ofstream out (output.c_str ());
+  if (!out)
+    {
+      std::cerr << "Error-- unable to create " << output << std::endl;
+      exit (1);
+    }
+  if (!AnimationInterface::ConvertBinaryToXml (in, out))
+    {
+      std::cerr << "Error-- the binary animation trace " << input << " is corrupted" << std::endl;
+      exit (1);
+    }
+  return 0;
+}